@@ -31,6 +31,10 @@ static int g_queue_depth = 32;
  * be at least as much as the queue depth.
  */
 static int g_allocate_depth = 0;
+/* g_batch_size, if non-zero, makes workers build operations into batches of this size and
+ * submit each batch at once instead of submitting operations one by one.
+ */
+static int g_batch_size = 0;
 static int g_threads_per_core = 1;
 static int g_time_in_sec = 5;
 static uint32_t g_crc32c_seed = 0;
@@ -163,6 +167,9 @@ dump_user_config(void)
 	}
 	printf("Queue depth:    %u\n", g_queue_depth);
 	printf("Allocate depth: %u\n", g_allocate_depth);
+	if (g_batch_size > 0) {
+		printf("Batch size:     %u\n", g_batch_size);
+	}
 	printf("# threads/core: %u\n", g_threads_per_core);
 	printf("Run time:       %u seconds\n", g_time_in_sec);
 	printf("Verify:         %s\n\n", g_verify ? "Yes" : "No");
@@ -189,6 +196,7 @@ usage(void)
 	printf("\t[-y verify result if this switch is on]\n");
 	printf("\t[-a tasks to allocate per core (default: same value as -q)]\n");
 	printf("\t\tCan be used to spread operations across a wider range of memory.\n");
+	printf("\t[-b for copy, fill, crc32c, copy_crc32c and compare workloads, submit operations in batches of this size (default: 0, no batching)]\n");
 }
 
 static int
@@ -198,6 +206,7 @@ parse_args(int ch, char *arg)
 
 	switch (ch) {
 	case 'a':
+	case 'b':
 	case 'C':
 	case 'f':
 	case 'T':
@@ -222,6 +231,9 @@ parse_args(int ch, char *arg)
 	case 'a':
 		g_allocate_depth = argval;
 		break;
+	case 'b':
+		g_batch_size = argval;
+		break;
 	case 'C':
 		g_chained_count = argval;
 		break;
@@ -782,6 +794,74 @@ _submit_single(struct worker_thread *worker, struct ap_task *task)
 	}
 }
 
+/* Build a batch out of the tasks from the pool and submit it at once. */
+static int
+_submit_batch(struct worker_thread *worker)
+{
+	struct spdk_accel_batch batch;
+	struct ap_task *task;
+	int i, random_num;
+	int rc = 0;
+
+	spdk_accel_batch_init(&batch, worker->ch);
+
+	for (i = 0; i < g_batch_size; i++) {
+		task = _get_task(worker);
+		if (task == NULL) {
+			rc = -ENOMEM;
+			break;
+		}
+
+		switch (worker->workload) {
+		case SPDK_ACCEL_OPC_COPY:
+			rc = spdk_accel_batch_append_copy(&batch, task->dst, task->src,
+							  g_xfer_size_bytes, accel_done, task);
+			break;
+		case SPDK_ACCEL_OPC_FILL:
+			/* For fill use the first byte of the task->dst buffer */
+			rc = spdk_accel_batch_append_fill(&batch, task->dst, *(uint8_t *)task->src,
+							  g_xfer_size_bytes, accel_done, task);
+			break;
+		case SPDK_ACCEL_OPC_CRC32C:
+			rc = spdk_accel_batch_append_crc32cv(&batch, task->crc_dst, task->src_iovs,
+							     task->src_iovcnt, g_crc32c_seed,
+							     accel_done, task);
+			break;
+		case SPDK_ACCEL_OPC_COPY_CRC32C:
+			rc = spdk_accel_batch_append_copy_crc32cv(&batch, task->dst, task->src_iovs,
+					task->src_iovcnt, task->crc_dst,
+					g_crc32c_seed, accel_done, task);
+			break;
+		case SPDK_ACCEL_OPC_COMPARE:
+			random_num = rand() % 100;
+			if (random_num < g_fail_percent_goal) {
+				task->expected_status = -EILSEQ;
+				*(uint8_t *)task->dst = ~DATA_PATTERN;
+			} else {
+				task->expected_status = 0;
+				*(uint8_t *)task->dst = DATA_PATTERN;
+			}
+			rc = spdk_accel_batch_append_compare(&batch, task->dst, task->src,
+							     g_xfer_size_bytes, accel_done, task);
+			break;
+		default:
+			assert(false);
+			rc = -EINVAL;
+			break;
+		}
+
+		worker->current_queue_depth++;
+		if (rc) {
+			accel_done(task, rc);
+			break;
+		}
+	}
+
+	spdk_accel_batch_submit(&batch);
+
+	return rc;
+}
+
 static void
 _free_task_buffers(struct ap_task *task)
 {
@@ -995,6 +1075,16 @@ accel_done(void *arg1, int status)
 
 	worker->current_queue_depth--;
 
+	if (g_batch_size > 0) {
+		TAILQ_INSERT_TAIL(&worker->tasks_pool, task, link);
+		/* Wait for enough completions to refill a whole batch */
+		if (!worker->is_draining && status == 0 &&
+		    worker->current_queue_depth + g_batch_size <= (uint64_t)g_queue_depth) {
+			_submit_batch(worker);
+		}
+		return;
+	}
+
 	if (!worker->is_draining && status == 0) {
 		TAILQ_INSERT_TAIL(&worker->tasks_pool, task, link);
 		task = _get_task(worker);
@@ -1150,6 +1240,15 @@ _init_thread(void *arg1)
 			      g_time_in_sec * 1000000ULL);
 
 	/* Load up queue depth worth of operations. */
+	if (g_batch_size > 0) {
+		while (worker->current_queue_depth + g_batch_size <= (uint64_t)g_queue_depth) {
+			if (_submit_batch(worker)) {
+				break;
+			}
+		}
+		return;
+	}
+
 	for (i = 0; i < g_queue_depth; i++) {
 		task = _get_task(worker);
 		if (task == NULL) {
@@ -1497,7 +1596,7 @@ main(int argc, char **argv)
 	g_opts.shutdown_cb = shutdown_cb;
 	g_opts.rpc_addr = NULL;
 
-	rc = spdk_app_parse_args(argc, argv, &g_opts, "a:C:o:q:t:yw:M:P:f:T:l:S:x:", NULL,
+	rc = spdk_app_parse_args(argc, argv, &g_opts, "a:b:C:o:q:t:yw:M:P:f:T:l:S:x:", NULL,
 				 parse_args, usage);
 	if (rc != SPDK_APP_PARSE_ARGS_SUCCESS) {
 		return rc == SPDK_APP_PARSE_ARGS_HELP ? 0 : 1;
@@ -1519,6 +1618,24 @@ main(int argc, char **argv)
 		g_allocate_depth = g_queue_depth;
 	}
 
+	if (g_batch_size > 0) {
+		if (g_workload_selection != SPDK_ACCEL_OPC_COPY &&
+		    g_workload_selection != SPDK_ACCEL_OPC_FILL &&
+		    g_workload_selection != SPDK_ACCEL_OPC_CRC32C &&
+		    g_workload_selection != SPDK_ACCEL_OPC_COPY_CRC32C &&
+		    g_workload_selection != SPDK_ACCEL_OPC_COMPARE) {
+			fprintf(stderr, "Batch mode is not supported for the %s workload\n", g_workload_type);
+			usage();
+			return -1;
+		}
+
+		if (g_batch_size > g_queue_depth) {
+			fprintf(stdout, "queue depth must be at least as big as batch size\n");
+			usage();
+			return -1;
+		}
+	}
+
 	if ((g_workload_selection == SPDK_ACCEL_OPC_CRC32C ||
 	     g_workload_selection == SPDK_ACCEL_OPC_COPY_CRC32C ||
 	     g_workload_selection == SPDK_ACCEL_OPC_DIF_VERIFY ||
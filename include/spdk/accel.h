@@ -14,6 +14,7 @@
 #include "spdk/stdinc.h"
 #include "spdk/dma.h"
 #include "spdk/dif.h"
+#include "spdk/queue.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,7 +25,31 @@ extern "C" {
 
 enum spdk_accel_comp_algo {
 	SPDK_ACCEL_COMP_ALGO_DEFLATE = 0,
-	SPDK_ACCEL_COMP_ALGO_LZ4
+	SPDK_ACCEL_COMP_ALGO_LZ4,
+	SPDK_ACCEL_COMP_ALGO_ZSTD
+};
+
+enum spdk_accel_hash_algo {
+	/** SHA-256, 32 byte digest */
+	SPDK_ACCEL_HASH_ALGO_SHA256 = 0,
+	/** MurmurHash3 x64 128-bit variant with a seed of 0, 16 byte digest.  Not cryptographic. */
+	SPDK_ACCEL_HASH_ALGO_MURMUR3_128,
+};
+
+#define SPDK_ACCEL_SHA256_DIGEST_SIZE 32
+#define SPDK_ACCEL_MURMUR3_128_DIGEST_SIZE 16
+
+/** Parameters of content defined chunking */
+struct spdk_accel_cdc_params {
+	/** Minimum size of a chunk in bytes, must be greater than 0 */
+	uint32_t min_size;
+	/**
+	 * Expected average size of a chunk in bytes.  Must be a power of two, at least 64 and
+	 * within [min_size, max_size].
+	 */
+	uint32_t avg_size;
+	/** Maximum size of a chunk in bytes */
+	uint32_t max_size;
 };
 
 /** Data Encryption Key identifier */
@@ -56,7 +81,9 @@ enum spdk_accel_opcode {
 	SPDK_ACCEL_OPC_DIF_GENERATE_COPY	= 14,
 	SPDK_ACCEL_OPC_DIX_GENERATE		= 15,
 	SPDK_ACCEL_OPC_DIX_VERIFY		= 16,
-	SPDK_ACCEL_OPC_LAST			= 17,
+	SPDK_ACCEL_OPC_HASH			= 17,
+	SPDK_ACCEL_OPC_CDC			= 18,
+	SPDK_ACCEL_OPC_LAST			= 19,
 };
 
 enum spdk_accel_cipher {
@@ -608,6 +635,228 @@ int spdk_accel_submit_dix_verify(struct spdk_io_channel *ch, struct iovec *iovs,
 				 const struct spdk_dif_ctx *ctx, struct spdk_dif_error *err,
 				 spdk_accel_completion_cb cb_fn, void *cb_arg);
 
+/**
+ * Submit a hash calculation request.
+ *
+ * \param ch I/O channel associated with this call.
+ * \param algo Hash algorithm.
+ * \param digest Destination to write the digest to.  Its size depends on the algorithm, e.g.
+ * SPDK_ACCEL_SHA256_DIGEST_SIZE bytes for SHA-256.
+ * \param iovs The io vector array which stores the src data and len.
+ * \param iovcnt The size of the iov.
+ * \param cb_fn Called when this hash operation completes.
+ * \param cb_arg Callback argument.
+ *
+ * \return 0 on success, negative errno on failure.
+ */
+int spdk_accel_submit_hash(struct spdk_io_channel *ch, enum spdk_accel_hash_algo algo,
+			   uint8_t *digest, struct iovec *iovs, uint32_t iovcnt,
+			   spdk_accel_completion_cb cb_fn, void *cb_arg);
+
+/**
+ * Submit a content defined chunking request.
+ *
+ * This operation splits the data into chunks whose boundaries depend only on the data around
+ * them, so that inserting or removing bytes only moves the boundaries close to the change.  The
+ * boundaries are reported as offsets of the end of each chunk, relative to the beginning of the
+ * data.  The last one is always the end of the data.  For the same data and parameters, the
+ * boundaries are the same regardless of the module executing the operation.
+ *
+ * \param ch I/O channel associated with this call.
+ * \param params Chunking parameters.  Must remain valid until the operation completes.
+ * \param iovs The io vector array which stores the src data and len.  Total length must not
+ * exceed UINT32_MAX.
+ * \param iovcnt The size of the iov.
+ * \param cut_points Array to store the chunk boundaries in.
+ * \param max_cut_points Size of the `cut_points` array.  If the data contains more chunks, the
+ * operation is completed with -ENOSPC.
+ * \param num_cut_points Number of boundaries stored in `cut_points`.
+ * \param cb_fn Called when this operation completes.
+ * \param cb_arg Callback argument.
+ *
+ * \return 0 on success, negative errno on failure.
+ */
+int spdk_accel_submit_cdc(struct spdk_io_channel *ch, const struct spdk_accel_cdc_params *params,
+			  struct iovec *iovs, uint32_t iovcnt, uint32_t *cut_points,
+			  uint32_t max_cut_points, uint32_t *num_cut_points,
+			  spdk_accel_completion_cb cb_fn, void *cb_arg);
+
+/**
+ * Group of independent operations built by the caller and handed over to the accel modules at
+ * once.  Compared to the spdk_accel_submit_*() functions, which pass each operation to a module
+ * separately, a batch lets modules that accept lists of tasks (e.g. the software, DSA or IAA
+ * modules) process all of its consecutive operations within a single call.  The operations are
+ * not ordered with respect to each other and each one is completed through its own callback.
+ *
+ * The structure is owned by the caller and its fields must not be accessed directly.
+ */
+struct spdk_accel_batch {
+	struct spdk_io_channel			*ch;
+	STAILQ_HEAD(, spdk_accel_task)		tasks;
+	uint32_t				count;
+};
+
+/**
+ * Initialize an empty batch.
+ *
+ * \param batch Batch to initialize.
+ * \param ch I/O channel the batch's operations will be submitted on.
+ */
+void spdk_accel_batch_init(struct spdk_accel_batch *batch, struct spdk_io_channel *ch);
+
+/**
+ * Append a copy operation to a batch.
+ *
+ * \param batch Batch object.
+ * \param dst Destination to copy to.
+ * \param src Source to copy from.
+ * \param nbytes Length in bytes to copy.
+ * \param cb_fn Called when this copy operation completes.
+ * \param cb_arg Callback argument.
+ *
+ * \return 0 if the operation was appended, negative errno otherwise.
+ */
+int spdk_accel_batch_append_copy(struct spdk_accel_batch *batch, void *dst, void *src,
+				 uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg);
+
+/**
+ * Append a compare operation to a batch.
+ *
+ * \param batch Batch object.
+ * \param src1 First location to perform compare on.
+ * \param src2 Second location to perform compare on.
+ * \param nbytes Length in bytes to compare.
+ * \param cb_fn Called when this compare operation completes.
+ * \param cb_arg Callback argument.
+ *
+ * \return 0 if the operation was appended, negative errno otherwise.
+ */
+int spdk_accel_batch_append_compare(struct spdk_accel_batch *batch, void *src1, void *src2,
+				    uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg);
+
+/**
+ * Append a fill operation to a batch.
+ *
+ * \param batch Batch object.
+ * \param dst Destination to fill.
+ * \param fill Constant byte to fill to the destination.
+ * \param nbytes Length in bytes to fill.
+ * \param cb_fn Called when this fill operation completes.
+ * \param cb_arg Callback argument.
+ *
+ * \return 0 if the operation was appended, negative errno otherwise.
+ */
+int spdk_accel_batch_append_fill(struct spdk_accel_batch *batch, void *dst, uint8_t fill,
+				 uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg);
+
+/**
+ * Append a CRC-32C calculation to a batch.
+ *
+ * \param batch Batch object.
+ * \param crc_dst Destination to write the CRC-32C to.
+ * \param src The source address for the data.
+ * \param seed Four byte seed value.
+ * \param nbytes Length in bytes.
+ * \param cb_fn Called when this CRC-32C operation completes.
+ * \param cb_arg Callback argument.
+ *
+ * \return 0 if the operation was appended, negative errno otherwise.
+ */
+int spdk_accel_batch_append_crc32c(struct spdk_accel_batch *batch, uint32_t *crc_dst, void *src,
+				   uint32_t seed, uint64_t nbytes, spdk_accel_completion_cb cb_fn,
+				   void *cb_arg);
+
+/**
+ * Append a chained CRC-32C calculation to a batch.
+ *
+ * \param batch Batch object.
+ * \param crc_dst Destination to write the CRC-32C to.
+ * \param iovs The io vector array which stores the src data and len.  It must remain valid
+ * until the operation completes.
+ * \param iovcnt The size of the iov.
+ * \param seed Four byte seed value.
+ * \param cb_fn Called when this CRC-32C operation completes.
+ * \param cb_arg Callback argument.
+ *
+ * \return 0 if the operation was appended, negative errno otherwise.
+ */
+int spdk_accel_batch_append_crc32cv(struct spdk_accel_batch *batch, uint32_t *crc_dst,
+				    struct iovec *iovs, uint32_t iovcnt, uint32_t seed,
+				    spdk_accel_completion_cb cb_fn, void *cb_arg);
+
+/**
+ * Append a copy with CRC-32C calculation to a batch.
+ *
+ * \param batch Batch object.
+ * \param dst Destination to write the data to.
+ * \param src The source address for the data.
+ * \param crc_dst Destination to write the CRC-32C to.
+ * \param seed Four byte seed value.
+ * \param nbytes Length in bytes.
+ * \param cb_fn Called when this CRC-32C operation completes.
+ * \param cb_arg Callback argument.
+ *
+ * \return 0 if the operation was appended, negative errno otherwise.
+ */
+int spdk_accel_batch_append_copy_crc32c(struct spdk_accel_batch *batch, void *dst, void *src,
+					uint32_t *crc_dst, uint32_t seed, uint64_t nbytes,
+					spdk_accel_completion_cb cb_fn, void *cb_arg);
+
+/**
+ * Append a chained copy with CRC-32C calculation to a batch.
+ *
+ * \param batch Batch object.
+ * \param dst Destination to write the data to.
+ * \param src_iovs The io vector array which stores the src data and len.  It must remain valid
+ * until the operation completes.
+ * \param iovcnt The size of the io vectors.
+ * \param crc_dst Destination to write the CRC-32C to.
+ * \param seed Four byte seed value.
+ * \param cb_fn Called when this CRC-32C operation completes.
+ * \param cb_arg Callback argument.
+ *
+ * \return 0 if the operation was appended, negative errno otherwise.
+ */
+int spdk_accel_batch_append_copy_crc32cv(struct spdk_accel_batch *batch, void *dst,
+		struct iovec *src_iovs, uint32_t iovcnt, uint32_t *crc_dst,
+		uint32_t seed, spdk_accel_completion_cb cb_fn, void *cb_arg);
+
+/**
+ * Append a hash calculation to a batch.
+ *
+ * \param batch Batch object.
+ * \param algo Hash algorithm.
+ * \param digest Destination to write the digest to.
+ * \param iovs The io vector array which stores the src data and len.  It must remain valid
+ * until the operation completes.
+ * \param iovcnt The size of the iov.
+ * \param cb_fn Called when this hash operation completes.
+ * \param cb_arg Callback argument.
+ *
+ * \return 0 if the operation was appended, negative errno otherwise.
+ */
+int spdk_accel_batch_append_hash(struct spdk_accel_batch *batch, enum spdk_accel_hash_algo algo,
+				 uint8_t *digest, struct iovec *iovs, uint32_t iovcnt,
+				 spdk_accel_completion_cb cb_fn, void *cb_arg);
+
+/**
+ * Submit all operations appended to a batch.  Each operation's callback is executed once it
+ * completes, including the operations that couldn't be submitted, which are completed with an
+ * error.  Callbacks may be executed before this function returns.  The batch is left empty and
+ * can be reused to build another set of operations.
+ *
+ * \param batch Batch object.
+ */
+void spdk_accel_batch_submit(struct spdk_accel_batch *batch);
+
+/**
+ * Release all operations appended to a batch without executing them.  Their callbacks are not
+ * executed.  The batch is left empty and can be reused.
+ *
+ * \param batch Batch object.
+ */
+void spdk_accel_batch_abort(struct spdk_accel_batch *batch);
+
 /** Object grouping multiple accel operations to be executed at the same point in time */
 struct spdk_accel_sequence;
 
@@ -1007,6 +1256,54 @@ int spdk_accel_append_dix_verify(struct spdk_accel_sequence **seq, struct spdk_i
 				 const struct spdk_dif_ctx *ctx, struct spdk_dif_error *err,
 				 spdk_accel_step_cb cb_fn, void *cb_arg);
 
+/**
+ * Append a hash calculation to a sequence.
+ *
+ * \param seq Sequence object.  If NULL, a new sequence object will be created.
+ * \param ch I/O channel.
+ * \param algo Hash algorithm.
+ * \param digest Destination to write the digest to.
+ * \param iovs Source I/O vector array.
+ * \param iovcnt Size of the `iovs` array.
+ * \param domain Memory domain to which the source buffers belong.
+ * \param domain_ctx Source buffer domain context.
+ * \param cb_fn Callback to be executed once this operation is completed.
+ * \param cb_arg Argument to be passed to `cb_fn`.
+ *
+ * \return 0 if operation was successfully added to the sequence, negative errno otherwise.
+ */
+int spdk_accel_append_hash(struct spdk_accel_sequence **seq, struct spdk_io_channel *ch,
+			   enum spdk_accel_hash_algo algo, uint8_t *digest,
+			   struct iovec *iovs, uint32_t iovcnt,
+			   struct spdk_memory_domain *domain, void *domain_ctx,
+			   spdk_accel_step_cb cb_fn, void *cb_arg);
+
+/**
+ * Append a content defined chunking operation to a sequence.  See spdk_accel_submit_cdc() for
+ * the description of the operation.
+ *
+ * \param seq Sequence object.  If NULL, a new sequence object will be created.
+ * \param ch I/O channel.
+ * \param params Chunking parameters.  Must remain valid until the operation completes.
+ * \param iovs Source I/O vector array.
+ * \param iovcnt Size of the `iovs` array.
+ * \param domain Memory domain to which the source buffers belong.
+ * \param domain_ctx Source buffer domain context.
+ * \param cut_points Array to store the chunk boundaries in.
+ * \param max_cut_points Size of the `cut_points` array.
+ * \param num_cut_points Number of boundaries stored in `cut_points`.
+ * \param cb_fn Callback to be executed once this operation is completed.
+ * \param cb_arg Argument to be passed to `cb_fn`.
+ *
+ * \return 0 if operation was successfully added to the sequence, negative errno otherwise.
+ */
+int spdk_accel_append_cdc(struct spdk_accel_sequence **seq, struct spdk_io_channel *ch,
+			  const struct spdk_accel_cdc_params *params,
+			  struct iovec *iovs, uint32_t iovcnt,
+			  struct spdk_memory_domain *domain, void *domain_ctx,
+			  uint32_t *cut_points, uint32_t max_cut_points, uint32_t *num_cut_points,
+			  spdk_accel_step_cb cb_fn, void *cb_arg);
+
 /**
  * Finish a sequence and execute all its operations. After the completion callback is executed, the
  * sequence object is automatically freed.
@@ -1142,7 +1439,11 @@ struct spdk_accel_opts {
 	uint32_t	sequence_count;
 	/** Maximum number of accel buffers per IO channel */
 	uint32_t	buf_count;
-
+	/**
+	 * Dispatch operations to the module with the lowest measured cost for their size, among
+	 * all modules supporting them.  Ignored for operations explicitly assigned to a module.
+	 */
+	bool		cost_model;
 } __attribute__((packed));
 
 /**
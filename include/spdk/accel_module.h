@@ -95,7 +95,10 @@ struct spdk_accel_task {
 	uint8_t				op_code;
 	bool				has_aux;
 	int16_t				status;
-	uint8_t				reserved[4];
+	/* Module and size bucket the task was dispatched to by the cost model */
+	uint8_t				cost_module;
+	uint8_t				cost_bucket;
+	uint8_t				reserved[2];
 	struct accel_io_channel		*accel_ch;
 	struct spdk_accel_sequence	*seq;
 	union {
@@ -147,14 +150,26 @@ struct spdk_accel_task {
 			enum spdk_accel_comp_algo       algo; /* compresssion/decompression algorithm */
 			uint32_t                        level; /* compression alogrithm level */
 		} comp;
+		struct {
+			enum spdk_accel_hash_algo	algo;
+		} hash;
+		struct {
+			const struct spdk_accel_cdc_params	*params;
+			uint32_t				*num_cut_points;
+			uint32_t				max_cut_points;
+		} cdc;
 	};
 	union {
 		uint32_t		*crc_dst;
 		uint32_t		*output_size;
 		uint32_t		block_size; /* for crypto op */
+		uint8_t			*digest;
+		uint32_t		*cut_points;
 	};
 	uint64_t			iv; /* Initialization vector (tweak) for crypto op */
 	struct spdk_accel_task_aux_data	*aux;
+	/* Submission time of a task dispatched by the cost model */
+	uint64_t			cost_tsc;
 };
 
 struct spdk_accel_opcode_info {
@@ -216,6 +231,15 @@ struct spdk_accel_module_if {
 	 */
 	int (*submit_tasks)(struct spdk_io_channel *ch, struct spdk_accel_task *accel_task);
 
+	/**
+	 * Set if `submit_tasks()` accepts multiple tasks linked together through their `link`
+	 * field.  Such a module must take ownership of every task on the list (reporting any
+	 * per-task errors through `spdk_accel_task_complete()`) and return 0, or fail the whole
+	 * list without completing any of the tasks.  Batches built with `spdk_accel_batch_*()` are
+	 * submitted to these modules with a single call.
+	 */
+	bool supports_task_list;
+
 	/**
 	 * Create crypto key function. Module is responsible to fill all necessary parameters in
 	 * \b spdk_accel_crypto_key structure
@@ -240,6 +264,11 @@ struct spdk_accel_module_if {
 	 */
 	bool (*compress_supports_algo)(enum spdk_accel_comp_algo algo);
 
+	/**
+	 * Return true if hash algo is supported, false otherwise.
+	 */
+	bool (*hash_supports_algo)(enum spdk_accel_hash_algo algo);
+
 	/**
 	 * Returns the lowest and highest levels of the specified algorithm.
 	 */
@@ -28,6 +28,15 @@ enum {
 	SPDK_FTL_LIMIT_MAX
 };
 
+/* Policies of picking bands to garbage collect */
+enum spdk_ftl_gc_policy {
+	/* Pick bands with the most invalid data */
+	SPDK_FTL_GC_POLICY_GREEDY = 0,
+
+	/* Weigh the invalid data of bands against their valid data and their age */
+	SPDK_FTL_GC_POLICY_COST_BENEFIT = 1,
+};
+
 struct ftl_stats_error {
 	uint64_t media;
 	uint64_t crc;
@@ -138,8 +147,11 @@ struct spdk_ftl_conf {
 	/* Enable fast shutdown path */
 	bool					fast_shutdown;
 
-	/* Hole at bytes 0x79 - 0x7f. */
-	uint8_t					reserved2[7];
+	/* Policy of picking bands to garbage collect, see spdk_ftl_gc_policy enum */
+	uint8_t					gc_policy;
+
+	/* Hole at bytes 0x7a - 0x7f. */
+	uint8_t					reserved2[6];
 
 	/*
 	 * The size of spdk_ftl_conf according to the caller of this library is used for ABI
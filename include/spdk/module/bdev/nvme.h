@@ -26,6 +26,14 @@ enum spdk_bdev_nvme_multipath_policy {
 enum spdk_bdev_nvme_multipath_selector {
 	BDEV_NVME_MP_SELECTOR_ROUND_ROBIN = 1,
 	BDEV_NVME_MP_SELECTOR_QUEUE_DEPTH,
+	/* Pick the path with the smallest expected service time, i.e. the EWMA of its
+	 * completion latency weighted by the number of outstanding I/Os. */
+	BDEV_NVME_MP_SELECTOR_SERVICE_TIME,
+	/* Prefer paths whose controller is on the NUMA node of the calling thread,
+	 * balancing by queue depth among them. */
+	BDEV_NVME_MP_SELECTOR_NUMA,
+	/* Distribute I/Os across paths in proportion to per-path weights. */
+	BDEV_NVME_MP_SELECTOR_WEIGHTED,
 };
 
 struct spdk_bdev_nvme_ctrlr_opts {
@@ -79,7 +87,7 @@ int spdk_bdev_nvme_create(struct spdk_nvme_transport_id *trid,
  *
  * \param name NVMe bdev name.
  * \param policy Multipath policy (active-passive or active-active).
- * \param selector Multipath selector (round_robin, queue_depth).
+ * \param selector Multipath selector (round_robin, queue_depth, service_time, numa, weighted).
  * \param rr_min_io Number of IO to route to a path before switching to another for round-robin.
  * \param cb_fn Function to be called back after completion.
  * \param cb_arg Argument passed to the callback function.
@@ -51,6 +51,17 @@ extern "C" {
  */
 #define SPDK_NVME_DATASET_MANAGEMENT_RANGE_MAX_BLOCKS	0xFFFFFFFFu
 
+/**
+ * Indicates the maximum number of source ranges that may be specified
+ *  in the copy command.
+ */
+#define SPDK_NVME_SIMPLE_COPY_MAX_RANGES	256
+
+/**
+ * Maximum number of blocks that may be specified in a single copy source range.
+ */
+#define SPDK_NVME_SIMPLE_COPY_RANGE_MAX_BLOCKS	0x10000u
+
 /**
  * Maximum number of entries in the log page of Changed Namespace List.
  */
@@ -63,6 +63,11 @@ struct spdk_nvmf_target_opts {
 	uint32_t	discovery_filter;
 	uint32_t	dhchap_digests;
 	uint32_t	dhchap_dhgroups;
+	/**
+	 * Interval (in microseconds) at which an I/O qpair is moved from the most to the least
+	 * loaded poll group, if their load differs enough.  0 disables rebalancing.
+	 */
+	uint32_t	rebalance_period_us;
 };
 
 struct spdk_nvmf_transport_opts {
@@ -103,9 +108,11 @@ struct spdk_nvmf_transport_opts {
 	uint32_t acceptor_poll_rate;
 	/* Use zero-copy operations if the underlying bdev supports them */
 	bool zcopy;
+	/* Use zero-copy operations for reads only, even if zcopy is disabled */
+	bool zcopy_read;
 
-	/* Hole at bytes 61-63. */
-	uint8_t reserved61[3];
+	/* Hole at bytes 62-63. */
+	uint8_t reserved62[2];
 	/* ACK timeout in milliseconds */
 	uint32_t ack_timeout;
 	/* Size of RDMA data WR pool */
@@ -359,6 +366,33 @@ void spdk_nvmf_poll_group_destroy(struct spdk_nvmf_poll_group *group,
 int spdk_nvmf_poll_group_add(struct spdk_nvmf_poll_group *group,
 			     struct spdk_nvmf_qpair *qpair);
 
+typedef void (*spdk_nvmf_qpair_migrate_done_fn)(void *cb_arg, int status);
+
+/**
+ * Move an I/O qpair, together with its connection, to another poll group.
+ *
+ * New commands are held while the qpair drains the ones in flight. Once it is
+ * idle, it's detached from its current poll group and attached to the new one,
+ * where the held commands resume. The host is not aware of the move.
+ *
+ * This function must be called from the thread of the qpair's current poll
+ * group and cb_fn is called on that same thread. The transport must support
+ * migration and the target must not run in interrupt mode.
+ *
+ * \param qpair The I/O qpair to move.
+ * \param group The poll group to move the qpair to.
+ * \param cb_fn Called once the qpair has been moved or the move has failed.
+ * \param cb_arg Argument passed to cb_fn.
+ *
+ * \return 0 if the move has started, cb_fn will be called with its result.
+ * \return -EINVAL if the qpair is not an active I/O qpair or is already in the group.
+ * \return -EBUSY if the qpair is already being moved.
+ * \return -ENOTSUP if the transport doesn't support migration.
+ * \return -ENOMEM if the function specific context could not be allocated.
+ */
+int spdk_nvmf_qpair_migrate(struct spdk_nvmf_qpair *qpair, struct spdk_nvmf_poll_group *group,
+			    spdk_nvmf_qpair_migrate_done_fn cb_fn, void *cb_arg);
+
 typedef void (*nvmf_qpair_disconnect_cb)(void *ctx);
 
 /**
@@ -670,6 +704,23 @@ struct spdk_nvmf_subsystem_key_opts {
 int spdk_nvmf_subsystem_set_keys(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn,
 				 struct spdk_nvmf_subsystem_key_opts *opts);
 
+/**
+ * Set the weight of a host within a subsystem.
+ *
+ * Once a namespace's I/O depth is exhausted (see `spdk_nvmf_subsystem_set_ns_io_depth()`), the
+ * hosts sharing it are served by deficit round robin, each receiving a share of the bandwidth
+ * proportional to its weight.  Hosts that weren't added to the subsystem have a weight of 1.
+ *
+ * \param subsystem Subsystem the host was added to.
+ * \param hostnqn The NQN of the host.
+ * \param weight Weight of the host, must not be 0.
+ *
+ * \return 0 on success, -ENOENT if the host wasn't added to the subsystem, or negated errno
+ * value on other failures.
+ */
+int spdk_nvmf_subsystem_set_host_weight(struct spdk_nvmf_subsystem *subsystem,
+					const char *hostnqn, uint32_t weight);
+
 
 /**
  * Disconnect all connections originating from the provided hostnqn
@@ -979,6 +1030,22 @@ int spdk_nvmf_subsystem_get_ana_state(struct spdk_nvmf_subsystem *subsystem,
 int spdk_nvmf_subsystem_set_ns_ana_group(struct spdk_nvmf_subsystem *subsystem,
 		uint32_t nsid, uint32_t anagrpid);
 
+/**
+ * Limit the number of I/Os submitted to a namespace by each poll group.
+ *
+ * Requests exceeding the limit are queued per host and released in deficit round robin order,
+ * so that a single host cannot monopolize the namespace.  Can be changed at any time.
+ *
+ * \param subsystem Subsystem the namespace belongs to.
+ * \param nsid Namespace ID to change.
+ * \param io_depth Maximum number of I/Os outstanding on the namespace per poll group, 0 to
+ * disable the limit.
+ *
+ * \return 0 on success, negated errno on failure.
+ */
+int spdk_nvmf_subsystem_set_ns_io_depth(struct spdk_nvmf_subsystem *subsystem,
+					uint32_t nsid, uint32_t io_depth);
+
 /**
  * Sets the controller ID range for a subsystem.
  *
@@ -1180,6 +1247,15 @@ uint32_t spdk_nvmf_ns_get_id(const struct spdk_nvmf_ns *ns);
  */
 struct spdk_bdev *spdk_nvmf_ns_get_bdev(struct spdk_nvmf_ns *ns);
 
+/**
+ * Get the per poll group I/O depth limit of a namespace.
+ *
+ * \param ns Namespace to query.
+ *
+ * \return I/O depth limit, 0 if the namespace isn't limited.
+ */
+uint32_t spdk_nvmf_ns_get_io_depth(const struct spdk_nvmf_ns *ns);
+
 /**
  * Get the options specified for a namespace.
  *
@@ -89,7 +89,8 @@ struct spdk_nvmf_request {
 			uint8_t data_from_pool		: 1;
 			uint8_t dif_enabled		: 1;
 			uint8_t first_fused		: 1;
-			uint8_t rsvd			: 5;
+			uint8_t fair_sched		: 1;
+			uint8_t rsvd			: 4;
 		};
 	};
 	uint8_t				zcopy_phase; /* type enum spdk_nvmf_zcopy_phase */
@@ -142,6 +143,7 @@ enum spdk_nvmf_qpair_state {
 typedef void (*spdk_nvmf_state_change_done)(void *cb_arg, int status);
 
 struct spdk_nvmf_qpair_auth;
+struct spdk_nvmf_qpair_migrate;
 
 struct spdk_nvmf_qpair {
 	uint8_t					state; /* ref spdk_nvmf_qpair_state */
@@ -175,6 +177,13 @@ struct spdk_nvmf_qpair {
 
 	struct spdk_nvmf_qpair_auth		*auth;
 
+	/* Set while the qpair is being moved to another poll group */
+	struct spdk_nvmf_qpair_migrate		*migrate;
+
+	/* Fair scheduling flows of the qpair's host in its poll group, indexed by NSID - 1 */
+	struct nvmf_fair_flow			**fair_flows;
+	uint32_t				num_fair_flows;
+
 	struct {
 		/* Indicates whether numa.id is valid, needed for numa.id == 0 case */
 		uint32_t			id_valid : 1;
@@ -227,6 +236,16 @@ struct spdk_nvmf_poll_group {
 	TAILQ_ENTRY(spdk_nvmf_poll_group)		link;
 
 	pthread_mutex_t					mutex;
+
+	/* Load estimate used to place new qpairs. Refreshed periodically
+	 * by the poll group's thread and protected by mutex. */
+	struct {
+		struct spdk_poller			*poller;
+		uint64_t				busy_tsc;
+		uint64_t				idle_tsc;
+		uint32_t				busy_permille;
+		uint32_t				outstanding_io;
+	} load;
 };
 
 struct spdk_nvmf_listener {
@@ -492,6 +511,31 @@ struct spdk_nvmf_transport_ops {
 	void (*subsystem_dump_host)(struct spdk_nvmf_transport *transport,
 				    const struct spdk_nvmf_subsystem *subsystem,
 				    const char *hostnqn, struct spdk_json_write_ctx *w);
+
+	/*
+	 * Stop (or resume) starting new commands on the qpair, so that it can reach
+	 * a point where it has nothing in flight. Commands the host sends in the
+	 * meantime must be held, not failed.
+	 * This callback is optional and is required only to support qpair migration.
+	 */
+	void (*qpair_quiesce)(struct spdk_nvmf_qpair *qpair, bool quiesce);
+
+	/*
+	 * Detach a quiesced qpair from its poll group without tearing down the
+	 * connection. Returns -EBUSY while the qpair still has work in flight.
+	 * This callback is optional and is required only to support qpair migration.
+	 */
+	int (*poll_group_detach)(struct spdk_nvmf_transport_poll_group *group,
+				 struct spdk_nvmf_qpair *qpair);
+
+	/*
+	 * Attach a qpair detached by poll_group_detach to another poll group.
+	 * Called on the thread of the new poll group. On failure the qpair is
+	 * still considered part of the group and is disconnected right away.
+	 * This callback is optional and is required only to support qpair migration.
+	 */
+	int (*poll_group_attach)(struct spdk_nvmf_transport_poll_group *group,
+				 struct spdk_nvmf_qpair *qpair);
 };
 
 /**
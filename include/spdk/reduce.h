@@ -66,8 +66,9 @@ struct spdk_reduce_vol_params {
 	uint32_t		comp_level;
 
 	/**
-	 * Compression algorithm, when creating initialization, it is
-	 * specified by the user
+	 * Compression algorithm, enum spdk_accel_comp_algo value (deflate,
+	 * lz4 or zstd).  When creating initialization, it is specified by
+	 * the user and it's persisted with the volume.
 	 */
 	uint8_t                 comp_algo;
 	uint8_t                 reserved[3];
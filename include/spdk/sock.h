@@ -142,7 +142,8 @@ struct spdk_sock_impl_opts {
 	uint32_t tls_version;
 
 	/**
-	 * Enable or disable kernel TLS. Used by ssl socket modules.
+	 * Enable or disable kernel TLS. Used by ssl socket modules.  Once the handshake is done,
+	 * writes on sockets that have kernel TLS active bypass OpenSSL.
 	 */
 	bool enable_ktls;
 
@@ -189,6 +190,33 @@ struct spdk_sock_impl_opts {
 	 * example: "TLS_AES_256_GCM_SHA384:TLS_AES_128_GCM_SHA256"
 	 */
 	const char *tls_cipher_suites;
+
+	/**
+	 * Number of sockets in a sock group that need to have queued writes before the group
+	 * flushes them.  Writes are held back for at most flush_batch_timeout_us.  0 flushes
+	 * queued writes on every group poll.  Used by posix and uring socket modules.
+	 */
+	uint32_t flush_batch_size;
+
+	/**
+	 * Time in microseconds a queued write may be held back waiting for flush_batch_size
+	 * sockets to have writes.  Used by posix and uring socket modules.
+	 */
+	uint32_t flush_batch_timeout_us;
+
+	/**
+	 * Time in microseconds to busy poll the NIC receive queue of the sockets in a sock group.
+	 * Also makes the kernel prefer busy polling over interrupt driven softirq processing for
+	 * these queues.  Works best with placement_id set to incoming_napi.  0 disables busy polling.
+	 * Used by posix socket module.
+	 */
+	uint32_t busy_poll_usecs;
+
+	/**
+	 * Maximum number of packets processed per busy poll.  0 uses the kernel default.  Used by
+	 * posix socket module.
+	 */
+	uint32_t busy_poll_budget;
 };
 
 /**
@@ -99,6 +99,8 @@ struct nvme_tcp_pdu {
 
 	bool						has_hdgst;
 	bool						ddgst_enable;
+	/* Data digest is accumulated in data_digest_crc32 while the payload is received */
+	bool						ddgst_inline;
 	uint32_t					data_digest_crc32;
 	uint8_t						data_digest[SPDK_NVME_TCP_DIGEST_LEN];
 
@@ -201,11 +203,27 @@ nvme_tcp_pdu_calc_header_digest(struct nvme_tcp_pdu *pdu)
 	return crc32c;
 }
 
+static inline uint32_t
+nvme_tcp_pdu_pad_data_digest(struct nvme_tcp_pdu *pdu, uint32_t crc32c)
+{
+	uint32_t mod;
+
+	mod = pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT;
+	if (mod != 0) {
+		uint32_t pad_length = SPDK_NVME_TCP_DIGEST_ALIGNMENT - mod;
+		uint8_t pad[3] = {0, 0, 0};
+
+		assert(pad_length > 0);
+		assert(pad_length <= sizeof(pad));
+		crc32c = spdk_crc32c_update(pad, pad_length, crc32c);
+	}
+	return crc32c;
+}
+
 static uint32_t
 nvme_tcp_pdu_calc_data_digest(struct nvme_tcp_pdu *pdu)
 {
 	uint32_t crc32c = SPDK_CRC32C_XOR;
-	uint32_t mod;
 
 	assert(pdu->data_len != 0);
 
@@ -216,16 +234,7 @@ nvme_tcp_pdu_calc_data_digest(struct nvme_tcp_pdu *pdu)
 					      0, pdu->data_len, &crc32c, pdu->dif_ctx);
 	}
 
-	mod = pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT;
-	if (mod != 0) {
-		uint32_t pad_length = SPDK_NVME_TCP_DIGEST_ALIGNMENT - mod;
-		uint8_t pad[3] = {0, 0, 0};
-
-		assert(pad_length > 0);
-		assert(pad_length <= sizeof(pad));
-		crc32c = spdk_crc32c_update(pad, pad_length, crc32c);
-	}
-	return crc32c;
+	return nvme_tcp_pdu_pad_data_digest(pdu, crc32c);
 }
 
 static inline void
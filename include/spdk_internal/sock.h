@@ -30,6 +30,7 @@ extern "C" {
 #define MIN_SO_RCVBUF_SIZE (4 * 1024)
 #define MIN_SO_SNDBUF_SIZE (4 * 1024)
 #define IOV_BATCH_SIZE 64
+#define DEFAULT_FLUSH_BATCH_TIMEOUT_US 50
 
 struct spdk_sock {
 	struct spdk_net_impl		*net_impl;
@@ -38,6 +38,11 @@
 
 #define ACCEL_CRYPTO_TWEAK_MODE_DEFAULT	SPDK_ACCEL_CRYPTO_TWEAK_MODE_SIMPLE_LBA
 #define ACCEL_TASKS_IN_SEQUENCE_LIMIT	8
+/* Every Nth operation of a given size is sent to other than the cheapest module to measure it */
+#define ACCEL_COST_EXPLORE_INTERVAL	64
+/* Weight of a new sample in the moving average of the operation cost, as a power of 2 */
+#define ACCEL_COST_EWMA_SHIFT		3
+#define ACCEL_COST_MODULE_NONE		UINT8_MAX
 
 struct accel_module {
 	struct spdk_accel_module_if	*module;
@@ -64,6 +69,13 @@ static struct spdk_spinlock g_keyring_spin;
 /* Global array mapping capabilities to modules */
 static struct accel_module g_modules_opc[SPDK_ACCEL_OPC_LAST] = {};
 static char *g_modules_opc_override[SPDK_ACCEL_OPC_LAST] = {};
+
+/* Modules the cost model dispatches each opcode to, the one assigned to the opcode first */
+struct accel_cost_opc {
+	struct spdk_accel_module_if	*modules[ACCEL_COST_MAX_MODULES];
+	int				num_modules;
+};
+static struct accel_cost_opc g_cost_opc[SPDK_ACCEL_OPC_LAST];
 TAILQ_HEAD(, spdk_accel_driver) g_accel_drivers = TAILQ_HEAD_INITIALIZER(g_accel_drivers);
 static struct spdk_accel_driver *g_accel_driver;
 static struct spdk_accel_opts g_opts = {
@@ -72,6 +84,7 @@ static struct spdk_accel_opts g_opts = {
 	.task_count = ACCEL_TASKS_PER_CHANNEL,
 	.sequence_count = ACCEL_TASKS_PER_CHANNEL,
 	.buf_count = ACCEL_TASKS_PER_CHANNEL,
+	.cost_model = false,
 };
 static struct accel_stats g_stats;
 static struct spdk_spinlock g_stats_lock;
@@ -80,7 +93,7 @@ static const char *g_opcode_strings[SPDK_ACCEL_OPC_LAST] = {
 	"copy", "fill", "dualcast", "compare", "crc32c", "copy_crc32c",
 	"compress", "decompress", "encrypt", "decrypt", "xor",
 	"dif_verify", "dif_verify_copy", "dif_generate", "dif_generate_copy",
-	"dix_generate", "dix_verify"
+	"dix_generate", "dix_verify", "hash", "cdc"
 };
 
 enum accel_sequence_state {
@@ -141,8 +154,18 @@ struct accel_buffer {
 	struct accel_io_channel		*ch;
 };
 
+struct accel_cost_channel {
+	/* IO channels of the modules in g_cost_opc */
+	struct spdk_io_channel			*module_ch[ACCEL_COST_MAX_MODULES];
+	struct accel_cost_entry			entries[ACCEL_COST_MAX_MODULES][ACCEL_COST_NUM_BUCKETS];
+	uint32_t				submitted[ACCEL_COST_NUM_BUCKETS];
+	uint64_t				fallbacks;
+};
+
 struct accel_io_channel {
 	struct spdk_io_channel			*module_ch[SPDK_ACCEL_OPC_LAST];
+	/* Cost model state of opcodes dispatched to multiple modules */
+	struct accel_cost_channel		*cost[SPDK_ACCEL_OPC_LAST];
 	struct spdk_io_channel			*driver_channel;
 	void					*task_pool_base;
 	struct spdk_accel_sequence		*seq_pool_base;
@@ -295,6 +318,7 @@ _get_task(struct accel_io_channel *accel_ch, spdk_accel_completion_cb cb_fn, voi
 	accel_task->accel_ch = accel_ch;
 	accel_task->s.iovs = NULL;
 	accel_task->d.iovs = NULL;
+	accel_task->cost_module = ACCEL_COST_MODULE_NONE;
 
 	return accel_task;
 }
@@ -306,6 +330,34 @@ _put_task(struct accel_io_channel *ch, struct spdk_accel_task *task)
 	accel_update_stats(ch, task_outstanding, -1);
 }
 
+static inline uint8_t
+accel_cost_bucket(uint64_t nbytes)
+{
+	uint32_t shift;
+
+	if (nbytes <= (1ULL << ACCEL_COST_MIN_SIZE_SHIFT)) {
+		return 0;
+	}
+
+	shift = spdk_u64log2(nbytes - 1) + 1;
+
+	return spdk_min(shift - ACCEL_COST_MIN_SIZE_SHIFT, ACCEL_COST_NUM_BUCKETS - 1);
+}
+
+static void
+accel_cost_update(struct accel_cost_channel *cost, struct spdk_accel_task *task)
+{
+	struct accel_cost_entry *entry = &cost->entries[task->cost_module][task->cost_bucket];
+	int64_t ticks = spdk_get_ticks() - task->cost_tsc;
+
+	if (spdk_unlikely(entry->samples == 0)) {
+		entry->ticks = ticks;
+	} else {
+		entry->ticks += (ticks - (int64_t)entry->ticks) / (1 << ACCEL_COST_EWMA_SHIFT);
+	}
+	entry->samples++;
+}
+
 void
 spdk_accel_task_complete(struct spdk_accel_task *accel_task, int status)
 {
@@ -317,6 +369,9 @@ spdk_accel_task_complete(struct spdk_accel_task *accel_task, int status)
 	accel_update_task_stats(accel_ch, accel_task, num_bytes, accel_task->nbytes);
 	if (spdk_unlikely(status != 0)) {
 		accel_update_task_stats(accel_ch, accel_task, failed, 1);
+	} else if (accel_ch->cost[accel_task->op_code] != NULL &&
+		   accel_task->cost_module != ACCEL_COST_MODULE_NONE) {
+		accel_cost_update(accel_ch->cost[accel_task->op_code], accel_task);
 	}
 
 	if (accel_task->seq) {
@@ -342,6 +397,99 @@ spdk_accel_task_complete(struct spdk_accel_task *accel_task, int status)
 	cb_fn(cb_arg, status);
 }
 
+static bool
+accel_cost_module_supports_task(struct spdk_accel_module_if *module, struct spdk_accel_task *task)
+{
+	switch (task->op_code) {
+	case SPDK_ACCEL_OPC_COMPRESS:
+	case SPDK_ACCEL_OPC_DECOMPRESS:
+		return module->compress_supports_algo != NULL &&
+		       module->compress_supports_algo(task->comp.algo);
+	case SPDK_ACCEL_OPC_HASH:
+		return module->hash_supports_algo != NULL &&
+		       module->hash_supports_algo(task->hash.algo);
+	default:
+		return true;
+	}
+}
+
+static bool
+accel_cost_before(struct accel_cost_channel *cost, uint8_t bucket, int a, int b, int explore)
+{
+	struct accel_cost_entry *ea = &cost->entries[a][bucket];
+	struct accel_cost_entry *eb = &cost->entries[b][bucket];
+
+	if (a == explore || b == explore) {
+		return a == explore;
+	}
+
+	/* Modules without any samples go first, so that they get measured */
+	if (ea->samples == 0 || eb->samples == 0) {
+		return ea->samples == 0 && eb->samples != 0;
+	}
+
+	return ea->ticks < eb->ticks;
+}
+
+/* Orders the modules able to execute a task by their cost, cheapest first */
+static int
+accel_cost_rank(struct accel_cost_channel *cost, struct spdk_accel_task *task, uint8_t bucket,
+		uint8_t *order)
+{
+	struct accel_cost_opc *opc = &g_cost_opc[task->op_code];
+	int i, j, num = 0, explore = -1;
+
+	cost->submitted[bucket]++;
+	if (cost->submitted[bucket] % ACCEL_COST_EXPLORE_INTERVAL == 0) {
+		explore = (cost->submitted[bucket] / ACCEL_COST_EXPLORE_INTERVAL) % opc->num_modules;
+	}
+
+	for (i = 0; i < opc->num_modules; i++) {
+		if (i != 0 && !accel_cost_module_supports_task(opc->modules[i], task)) {
+			continue;
+		}
+
+		for (j = num; j > 0 && accel_cost_before(cost, bucket, i, order[j - 1], explore); j--) {
+			order[j] = order[j - 1];
+		}
+		order[j] = i;
+		num++;
+	}
+
+	return num;
+}
+
+static int
+accel_cost_submit_task(struct accel_io_channel *accel_ch, struct spdk_accel_task *task)
+{
+	struct accel_cost_channel *cost = accel_ch->cost[task->op_code];
+	struct spdk_accel_module_if *module;
+	uint8_t order[ACCEL_COST_MAX_MODULES];
+	uint8_t bucket = accel_cost_bucket(task->nbytes);
+	int i, num, rc = -EINVAL;
+
+	num = accel_cost_rank(cost, task, bucket, order);
+	for (i = 0; i < num; i++) {
+		module = g_cost_opc[task->op_code].modules[order[i]];
+		task->cost_module = order[i];
+		task->cost_bucket = bucket;
+		task->cost_tsc = spdk_get_ticks();
+
+		rc = module->submit_tasks(cost->module_ch[order[i]], task);
+		/* Fall back to the next cheapest module if this one is out of resources */
+		if (spdk_likely(rc != -EBUSY && rc != -ENOMEM)) {
+			break;
+		}
+		cost->fallbacks++;
+	}
+
+	if (spdk_unlikely(rc != 0)) {
+		task->cost_module = ACCEL_COST_MODULE_NONE;
+	}
+
+	return rc;
+}
+
 static inline int
 accel_submit_task(struct accel_io_channel *accel_ch, struct spdk_accel_task *task)
 {
@@ -349,7 +497,11 @@ accel_submit_task(struct accel_io_channel *accel_ch, struct spdk_accel_task *tas
 	struct spdk_accel_module_if *module = g_modules_opc[task->op_code].module;
 	int rc;
 
-	rc = module->submit_tasks(module_ch, task);
+	if (accel_ch->cost[task->op_code] != NULL) {
+		rc = accel_cost_submit_task(accel_ch, task);
+	} else {
+		rc = module->submit_tasks(module_ch, task);
+	}
 	if (spdk_unlikely(rc != 0)) {
 		accel_update_task_stats(accel_ch, task, failed, 1);
 	}
@@ -384,11 +536,10 @@ do {										\
 } while (0)
 
 /* Accel framework public API for copy function */
-int
-spdk_accel_submit_copy(struct spdk_io_channel *ch, void *dst, void *src,
-		       uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg)
+static int
+accel_prep_copy(struct accel_io_channel *accel_ch, struct spdk_accel_task **task, void *dst,
+		void *src, uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg)
 {
-	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
 	struct spdk_accel_task *accel_task;
 
 	accel_task = _get_task(accel_ch, cb_fn, cb_arg);
@@ -411,6 +562,24 @@ spdk_accel_submit_copy(struct spdk_io_channel *ch, void *dst, void *src,
 	accel_task->src_domain = NULL;
 	accel_task->dst_domain = NULL;
 
+	*task = accel_task;
+
+	return 0;
+}
+
+int
+spdk_accel_submit_copy(struct spdk_io_channel *ch, void *dst, void *src,
+		       uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_copy(accel_ch, &accel_task, dst, src, nbytes, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
 	return accel_submit_task(accel_ch, accel_task);
 }
 
@@ -457,12 +626,10 @@ spdk_accel_submit_dualcast(struct spdk_io_channel *ch, void *dst1,
 
 /* Accel framework public API for compare function */
 
-int
-spdk_accel_submit_compare(struct spdk_io_channel *ch, void *src1,
-			  void *src2, uint64_t nbytes, spdk_accel_completion_cb cb_fn,
-			  void *cb_arg)
+static int
+accel_prep_compare(struct accel_io_channel *accel_ch, struct spdk_accel_task **task, void *src1,
+		   void *src2, uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg)
 {
-	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
 	struct spdk_accel_task *accel_task;
 
 	accel_task = _get_task(accel_ch, cb_fn, cb_arg);
@@ -485,17 +652,34 @@ spdk_accel_submit_compare(struct spdk_io_channel *ch, void *src1,
 	accel_task->src_domain = NULL;
 	accel_task->dst_domain = NULL;
 
-	return accel_submit_task(accel_ch, accel_task);
+	*task = accel_task;
+
+	return 0;
 }
 
-/* Accel framework public API for fill function */
 int
-spdk_accel_submit_fill(struct spdk_io_channel *ch, void *dst,
-		       uint8_t fill, uint64_t nbytes,
-		       spdk_accel_completion_cb cb_fn, void *cb_arg)
+spdk_accel_submit_compare(struct spdk_io_channel *ch, void *src1,
+			  void *src2, uint64_t nbytes, spdk_accel_completion_cb cb_fn,
+			  void *cb_arg)
 {
 	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
 	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_compare(accel_ch, &accel_task, src1, src2, nbytes, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	return accel_submit_task(accel_ch, accel_task);
+}
+
+/* Accel framework public API for fill function */
+static int
+accel_prep_fill(struct accel_io_channel *accel_ch, struct spdk_accel_task **task, void *dst,
+		uint8_t fill, uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct spdk_accel_task *accel_task;
 
 	accel_task = _get_task(accel_ch, cb_fn, cb_arg);
 	if (spdk_unlikely(accel_task == NULL)) {
@@ -514,17 +698,35 @@ spdk_accel_submit_fill(struct spdk_io_channel *ch, void *dst,
 	accel_task->src_domain = NULL;
 	accel_task->dst_domain = NULL;
 
-	return accel_submit_task(accel_ch, accel_task);
+	*task = accel_task;
+
+	return 0;
 }
 
-/* Accel framework public API for CRC-32C function */
 int
-spdk_accel_submit_crc32c(struct spdk_io_channel *ch, uint32_t *crc_dst,
-			 void *src, uint32_t seed, uint64_t nbytes, spdk_accel_completion_cb cb_fn,
-			 void *cb_arg)
+spdk_accel_submit_fill(struct spdk_io_channel *ch, void *dst,
+		       uint8_t fill, uint64_t nbytes,
+		       spdk_accel_completion_cb cb_fn, void *cb_arg)
 {
 	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
 	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_fill(accel_ch, &accel_task, dst, fill, nbytes, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	return accel_submit_task(accel_ch, accel_task);
+}
+
+/* Accel framework public API for CRC-32C function */
+static int
+accel_prep_crc32c(struct accel_io_channel *accel_ch, struct spdk_accel_task **task,
+		  uint32_t *crc_dst, void *src, uint32_t seed, uint64_t nbytes,
+		  spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct spdk_accel_task *accel_task;
 
 	accel_task = _get_task(accel_ch, cb_fn, cb_arg);
 	if (spdk_unlikely(accel_task == NULL)) {
@@ -544,17 +746,35 @@ spdk_accel_submit_crc32c(struct spdk_io_channel *ch, uint32_t *crc_dst,
 	accel_task->src_domain = NULL;
 	accel_task->dst_domain = NULL;
 
-	return accel_submit_task(accel_ch, accel_task);
+	*task = accel_task;
+
+	return 0;
 }
 
-/* Accel framework public API for chained CRC-32C function */
 int
-spdk_accel_submit_crc32cv(struct spdk_io_channel *ch, uint32_t *crc_dst,
-			  struct iovec *iov, uint32_t iov_cnt, uint32_t seed,
-			  spdk_accel_completion_cb cb_fn, void *cb_arg)
+spdk_accel_submit_crc32c(struct spdk_io_channel *ch, uint32_t *crc_dst,
+			 void *src, uint32_t seed, uint64_t nbytes, spdk_accel_completion_cb cb_fn,
+			 void *cb_arg)
 {
 	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
 	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_crc32c(accel_ch, &accel_task, crc_dst, src, seed, nbytes, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	return accel_submit_task(accel_ch, accel_task);
+}
+
+/* Accel framework public API for chained CRC-32C function */
+static int
+accel_prep_crc32cv(struct accel_io_channel *accel_ch, struct spdk_accel_task **task,
+		   uint32_t *crc_dst, struct iovec *iov, uint32_t iov_cnt, uint32_t seed,
+		   spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct spdk_accel_task *accel_task;
 
 	if (iov == NULL) {
 		SPDK_ERRLOG("iov should not be NULL");
@@ -582,17 +802,35 @@ spdk_accel_submit_crc32cv(struct spdk_io_channel *ch, uint32_t *crc_dst,
 	accel_task->src_domain = NULL;
 	accel_task->dst_domain = NULL;
 
-	return accel_submit_task(accel_ch, accel_task);
+	*task = accel_task;
+
+	return 0;
 }
 
-/* Accel framework public API for copy with CRC-32C function */
 int
-spdk_accel_submit_copy_crc32c(struct spdk_io_channel *ch, void *dst,
-			      void *src, uint32_t *crc_dst, uint32_t seed, uint64_t nbytes,
-			      spdk_accel_completion_cb cb_fn, void *cb_arg)
+spdk_accel_submit_crc32cv(struct spdk_io_channel *ch, uint32_t *crc_dst,
+			  struct iovec *iov, uint32_t iov_cnt, uint32_t seed,
+			  spdk_accel_completion_cb cb_fn, void *cb_arg)
 {
 	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
 	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_crc32cv(accel_ch, &accel_task, crc_dst, iov, iov_cnt, seed, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	return accel_submit_task(accel_ch, accel_task);
+}
+
+/* Accel framework public API for copy with CRC-32C function */
+static int
+accel_prep_copy_crc32c(struct accel_io_channel *accel_ch, struct spdk_accel_task **task,
+		       void *dst, void *src, uint32_t *crc_dst, uint32_t seed, uint64_t nbytes,
+		       spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct spdk_accel_task *accel_task;
 
 	accel_task = _get_task(accel_ch, cb_fn, cb_arg);
 	if (spdk_unlikely(accel_task == NULL)) {
@@ -616,16 +854,35 @@ spdk_accel_submit_copy_crc32c(struct spdk_io_channel *ch, void *dst,
 	accel_task->src_domain = NULL;
 	accel_task->dst_domain = NULL;
 
-	return accel_submit_task(accel_ch, accel_task);
+	*task = accel_task;
+
+	return 0;
 }
 
-/* Accel framework public API for chained copy + CRC-32C function */
 int
-spdk_accel_submit_copy_crc32cv(struct spdk_io_channel *ch, void *dst,
-			       struct iovec *src_iovs, uint32_t iov_cnt, uint32_t *crc_dst,
-			       uint32_t seed, spdk_accel_completion_cb cb_fn, void *cb_arg)
+spdk_accel_submit_copy_crc32c(struct spdk_io_channel *ch, void *dst,
+			      void *src, uint32_t *crc_dst, uint32_t seed, uint64_t nbytes,
+			      spdk_accel_completion_cb cb_fn, void *cb_arg)
 {
 	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_copy_crc32c(accel_ch, &accel_task, dst, src, crc_dst, seed, nbytes,
+				    cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	return accel_submit_task(accel_ch, accel_task);
+}
+
+/* Accel framework public API for chained copy + CRC-32C function */
+static int
+accel_prep_copy_crc32cv(struct accel_io_channel *accel_ch, struct spdk_accel_task **task,
+			void *dst, struct iovec *src_iovs, uint32_t iov_cnt, uint32_t *crc_dst,
+			uint32_t seed, spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
 	struct spdk_accel_task *accel_task;
 	uint64_t nbytes;
 
@@ -663,6 +920,26 @@ spdk_accel_submit_copy_crc32cv(struct spdk_io_channel *ch, void *dst,
 	accel_task->src_domain = NULL;
 	accel_task->dst_domain = NULL;
 
+	*task = accel_task;
+
+	return 0;
+}
+
+int
+spdk_accel_submit_copy_crc32cv(struct spdk_io_channel *ch, void *dst,
+			       struct iovec *src_iovs, uint32_t iov_cnt, uint32_t *crc_dst,
+			       uint32_t seed, spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_copy_crc32cv(accel_ch, &accel_task, dst, src_iovs, iov_cnt, crc_dst, seed,
+				     cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
 	return accel_submit_task(accel_ch, accel_task);
 }
 
@@ -1017,36 +1294,406 @@ spdk_accel_submit_dix_generate(struct spdk_io_channel *ch, struct iovec *iovs,
 	accel_task->src_domain = NULL;
 	accel_task->dst_domain = NULL;
 
-	return accel_submit_task(accel_ch, accel_task);
+	return accel_submit_task(accel_ch, accel_task);
+}
+
+int
+spdk_accel_submit_dix_verify(struct spdk_io_channel *ch, struct iovec *iovs,
+			     size_t iovcnt, struct iovec *md_iov, uint32_t num_blocks,
+			     const struct spdk_dif_ctx *ctx, struct spdk_dif_error *err,
+			     spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *accel_task;
+
+	accel_task = _get_task(accel_ch, cb_fn, cb_arg);
+	if (accel_task == NULL) {
+		return -ENOMEM;
+	}
+
+	accel_task->s.iovs = iovs;
+	accel_task->s.iovcnt = iovcnt;
+	accel_task->d.iovs = md_iov;
+	accel_task->d.iovcnt = 1;
+	accel_task->dif.ctx = ctx;
+	accel_task->dif.err = err;
+	accel_task->dif.num_blocks = num_blocks;
+	accel_task->nbytes = num_blocks * ctx->block_size;
+	accel_task->op_code = SPDK_ACCEL_OPC_DIX_VERIFY;
+	accel_task->src_domain = NULL;
+	accel_task->dst_domain = NULL;
+
+	return accel_submit_task(accel_ch, accel_task);
+}
+
+static int
+_accel_check_hash_algo(enum spdk_accel_hash_algo algo)
+{
+	struct spdk_accel_module_if *module = g_modules_opc[SPDK_ACCEL_OPC_HASH].module;
+
+	if (!module->hash_supports_algo || !module->hash_supports_algo(algo)) {
+		SPDK_ERRLOG("Module %s doesn't support hash algo %d\n", module->name, algo);
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+static int
+_accel_check_cdc_params(const struct spdk_accel_cdc_params *params, uint64_t nbytes)
+{
+	if (params->min_size == 0 || params->avg_size < 64 ||
+	    !spdk_u32_is_pow2(params->avg_size) ||
+	    params->min_size > params->avg_size || params->avg_size > params->max_size) {
+		SPDK_ERRLOG("Invalid chunking parameters: min %"PRIu32", avg %"PRIu32", max %"PRIu32"\n",
+			    params->min_size, params->avg_size, params->max_size);
+		return -EINVAL;
+	}
+
+	if (nbytes > UINT32_MAX) {
+		SPDK_ERRLOG("Chunking is limited to %"PRIu32" bytes\n", UINT32_MAX);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int
+accel_prep_hash(struct accel_io_channel *accel_ch, struct spdk_accel_task **task,
+		enum spdk_accel_hash_algo algo, uint8_t *digest, struct iovec *iovs,
+		uint32_t iovcnt, spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	if (iovs == NULL || iovcnt == 0) {
+		SPDK_ERRLOG("iov should not be NULL or empty\n");
+		return -EINVAL;
+	}
+
+	rc = _accel_check_hash_algo(algo);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	accel_task = _get_task(accel_ch, cb_fn, cb_arg);
+	if (spdk_unlikely(accel_task == NULL)) {
+		return -ENOMEM;
+	}
+
+	accel_task->s.iovs = iovs;
+	accel_task->s.iovcnt = iovcnt;
+	accel_task->nbytes = accel_get_iovlen(iovs, iovcnt);
+	accel_task->digest = digest;
+	accel_task->hash.algo = algo;
+	accel_task->op_code = SPDK_ACCEL_OPC_HASH;
+	accel_task->src_domain = NULL;
+	accel_task->dst_domain = NULL;
+
+	*task = accel_task;
+
+	return 0;
+}
+
+int
+spdk_accel_submit_hash(struct spdk_io_channel *ch, enum spdk_accel_hash_algo algo,
+		       uint8_t *digest, struct iovec *iovs, uint32_t iovcnt,
+		       spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_hash(accel_ch, &accel_task, algo, digest, iovs, iovcnt, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	return accel_submit_task(accel_ch, accel_task);
+}
+
+int
+spdk_accel_submit_cdc(struct spdk_io_channel *ch, const struct spdk_accel_cdc_params *params,
+		      struct iovec *iovs, uint32_t iovcnt, uint32_t *cut_points,
+		      uint32_t max_cut_points, uint32_t *num_cut_points,
+		      spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *accel_task;
+	uint64_t nbytes;
+	int rc;
+
+	if (iovs == NULL || iovcnt == 0) {
+		SPDK_ERRLOG("iov should not be NULL or empty\n");
+		return -EINVAL;
+	}
+
+	nbytes = accel_get_iovlen(iovs, iovcnt);
+	rc = _accel_check_cdc_params(params, nbytes);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	accel_task = _get_task(accel_ch, cb_fn, cb_arg);
+	if (spdk_unlikely(accel_task == NULL)) {
+		return -ENOMEM;
+	}
+
+	accel_task->s.iovs = iovs;
+	accel_task->s.iovcnt = iovcnt;
+	accel_task->nbytes = nbytes;
+	accel_task->cut_points = cut_points;
+	accel_task->cdc.params = params;
+	accel_task->cdc.num_cut_points = num_cut_points;
+	accel_task->cdc.max_cut_points = max_cut_points;
+	accel_task->op_code = SPDK_ACCEL_OPC_CDC;
+	accel_task->src_domain = NULL;
+	accel_task->dst_domain = NULL;
+
+	return accel_submit_task(accel_ch, accel_task);
+}
+
+void
+spdk_accel_batch_init(struct spdk_accel_batch *batch, struct spdk_io_channel *ch)
+{
+	batch->ch = ch;
+	STAILQ_INIT(&batch->tasks);
+	batch->count = 0;
+}
+
+static inline void
+accel_batch_add_task(struct spdk_accel_batch *batch, struct spdk_accel_task *task)
+{
+	STAILQ_INSERT_TAIL(&batch->tasks, task, link);
+	batch->count++;
+}
+
+int
+spdk_accel_batch_append_copy(struct spdk_accel_batch *batch, void *dst, void *src,
+			     uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(batch->ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_copy(accel_ch, &accel_task, dst, src, nbytes, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	accel_batch_add_task(batch, accel_task);
+
+	return 0;
+}
+
+int
+spdk_accel_batch_append_compare(struct spdk_accel_batch *batch, void *src1, void *src2,
+				uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(batch->ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_compare(accel_ch, &accel_task, src1, src2, nbytes, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	accel_batch_add_task(batch, accel_task);
+
+	return 0;
+}
+
+int
+spdk_accel_batch_append_fill(struct spdk_accel_batch *batch, void *dst, uint8_t fill,
+			     uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(batch->ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_fill(accel_ch, &accel_task, dst, fill, nbytes, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	accel_batch_add_task(batch, accel_task);
+
+	return 0;
+}
+
+int
+spdk_accel_batch_append_crc32c(struct spdk_accel_batch *batch, uint32_t *crc_dst, void *src,
+			       uint32_t seed, uint64_t nbytes, spdk_accel_completion_cb cb_fn,
+			       void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(batch->ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_crc32c(accel_ch, &accel_task, crc_dst, src, seed, nbytes, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	accel_batch_add_task(batch, accel_task);
+
+	return 0;
+}
+
+int
+spdk_accel_batch_append_crc32cv(struct spdk_accel_batch *batch, uint32_t *crc_dst,
+				struct iovec *iovs, uint32_t iovcnt, uint32_t seed,
+				spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(batch->ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_crc32cv(accel_ch, &accel_task, crc_dst, iovs, iovcnt, seed, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	accel_batch_add_task(batch, accel_task);
+
+	return 0;
+}
+
+int
+spdk_accel_batch_append_copy_crc32c(struct spdk_accel_batch *batch, void *dst, void *src,
+				    uint32_t *crc_dst, uint32_t seed, uint64_t nbytes,
+				    spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(batch->ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_copy_crc32c(accel_ch, &accel_task, dst, src, crc_dst, seed, nbytes,
+				    cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	accel_batch_add_task(batch, accel_task);
+
+	return 0;
+}
+
+int
+spdk_accel_batch_append_copy_crc32cv(struct spdk_accel_batch *batch, void *dst,
+				     struct iovec *src_iovs, uint32_t iovcnt, uint32_t *crc_dst,
+				     uint32_t seed, spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(batch->ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_copy_crc32cv(accel_ch, &accel_task, dst, src_iovs, iovcnt, crc_dst, seed,
+				     cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	accel_batch_add_task(batch, accel_task);
+
+	return 0;
+}
+
+int
+spdk_accel_batch_append_hash(struct spdk_accel_batch *batch, enum spdk_accel_hash_algo algo,
+			     uint8_t *digest, struct iovec *iovs, uint32_t iovcnt,
+			     spdk_accel_completion_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(batch->ch);
+	struct spdk_accel_task *accel_task;
+	int rc;
+
+	rc = accel_prep_hash(accel_ch, &accel_task, algo, digest, iovs, iovcnt, cb_fn, cb_arg);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	accel_batch_add_task(batch, accel_task);
+
+	return 0;
+}
+
+static void
+accel_batch_fail_tasks(struct spdk_accel_task *task, int status)
+{
+	struct spdk_accel_task *next;
+
+	while (task != NULL) {
+		next = STAILQ_NEXT(task, link);
+		STAILQ_NEXT(task, link) = NULL;
+		spdk_accel_task_complete(task, status);
+		task = next;
+	}
+}
+
+void
+spdk_accel_batch_submit(struct spdk_accel_batch *batch)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(batch->ch);
+	struct spdk_accel_module_if *module;
+	struct spdk_io_channel *module_ch;
+	struct spdk_accel_task *task, *last, *next;
+	int rc;
+
+	task = STAILQ_FIRST(&batch->tasks);
+	STAILQ_INIT(&batch->tasks);
+	batch->count = 0;
+
+	while (task != NULL) {
+		module = g_modules_opc[task->op_code].module;
+		module_ch = accel_ch->module_ch[task->op_code];
+		last = task;
+
+		/* Hand consecutive tasks executed by the same module over in a single call, unless
+		 * they need to be dispatched one by one by the cost model.
+		 */
+		if (module->supports_task_list && accel_ch->cost[task->op_code] == NULL) {
+			while ((next = STAILQ_NEXT(last, link)) != NULL &&
+			       accel_ch->module_ch[next->op_code] == module_ch &&
+			       accel_ch->cost[next->op_code] == NULL) {
+				last = next;
+			}
+		}
+
+		next = STAILQ_NEXT(last, link);
+		STAILQ_NEXT(last, link) = NULL;
+
+		if (accel_ch->cost[task->op_code] != NULL) {
+			rc = accel_cost_submit_task(accel_ch, task);
+		} else {
+			rc = module->submit_tasks(module_ch, task);
+		}
+		if (spdk_unlikely(rc != 0)) {
+			accel_batch_fail_tasks(task, rc);
+		}
+
+		task = next;
+	}
 }
 
-int
-spdk_accel_submit_dix_verify(struct spdk_io_channel *ch, struct iovec *iovs,
-			     size_t iovcnt, struct iovec *md_iov, uint32_t num_blocks,
-			     const struct spdk_dif_ctx *ctx, struct spdk_dif_error *err,
-			     spdk_accel_completion_cb cb_fn, void *cb_arg)
+void
+spdk_accel_batch_abort(struct spdk_accel_batch *batch)
 {
-	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
-	struct spdk_accel_task *accel_task;
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(batch->ch);
+	struct spdk_accel_task *task;
 
-	accel_task = _get_task(accel_ch, cb_fn, cb_arg);
-	if (accel_task == NULL) {
-		return -ENOMEM;
+	while ((task = STAILQ_FIRST(&batch->tasks)) != NULL) {
+		STAILQ_REMOVE_HEAD(&batch->tasks, link);
+		if (task->has_aux) {
+			SLIST_INSERT_HEAD(&accel_ch->task_aux_data_pool, task->aux, link);
+			task->aux = NULL;
+			task->has_aux = false;
+		}
+		_put_task(accel_ch, task);
 	}
 
-	accel_task->s.iovs = iovs;
-	accel_task->s.iovcnt = iovcnt;
-	accel_task->d.iovs = md_iov;
-	accel_task->d.iovcnt = 1;
-	accel_task->dif.ctx = ctx;
-	accel_task->dif.err = err;
-	accel_task->dif.num_blocks = num_blocks;
-	accel_task->nbytes = num_blocks * ctx->block_size;
-	accel_task->op_code = SPDK_ACCEL_OPC_DIX_VERIFY;
-	accel_task->src_domain = NULL;
-	accel_task->dst_domain = NULL;
-
-	return accel_submit_task(accel_ch, accel_task);
+	batch->count = 0;
 }
 
 static inline struct accel_buffer *
@@ -1762,6 +2409,121 @@ spdk_accel_append_dix_verify(struct spdk_accel_sequence **seq, struct spdk_io_ch
 	return 0;
 }
 
+int
+spdk_accel_append_hash(struct spdk_accel_sequence **pseq, struct spdk_io_channel *ch,
+		       enum spdk_accel_hash_algo algo, uint8_t *digest,
+		       struct iovec *iovs, uint32_t iovcnt,
+		       struct spdk_memory_domain *domain, void *domain_ctx,
+		       spdk_accel_step_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *task;
+	struct spdk_accel_sequence *seq = *pseq;
+	int rc;
+
+	if (iovs == NULL || iovcnt == 0) {
+		SPDK_ERRLOG("iov should not be NULL or empty\n");
+		return -EINVAL;
+	}
+
+	rc = _accel_check_hash_algo(algo);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	if (seq == NULL) {
+		seq = accel_sequence_get(accel_ch);
+		if (spdk_unlikely(seq == NULL)) {
+			return -ENOMEM;
+		}
+	}
+
+	assert(seq->ch == accel_ch);
+	task = accel_sequence_get_task(accel_ch, seq, cb_fn, cb_arg);
+	if (spdk_unlikely(task == NULL)) {
+		if (*pseq == NULL) {
+			accel_sequence_put(seq);
+		}
+
+		return -ENOMEM;
+	}
+
+	task->s.iovs = iovs;
+	task->s.iovcnt = iovcnt;
+	task->src_domain = domain;
+	task->src_domain_ctx = domain_ctx;
+	task->nbytes = accel_get_iovlen(iovs, iovcnt);
+	task->digest = digest;
+	task->hash.algo = algo;
+	task->op_code = SPDK_ACCEL_OPC_HASH;
+	task->dst_domain = NULL;
+
+	TAILQ_INSERT_TAIL(&seq->tasks, task, seq_link);
+	*pseq = seq;
+
+	return 0;
+}
+
+int
+spdk_accel_append_cdc(struct spdk_accel_sequence **pseq, struct spdk_io_channel *ch,
+		      const struct spdk_accel_cdc_params *params,
+		      struct iovec *iovs, uint32_t iovcnt,
+		      struct spdk_memory_domain *domain, void *domain_ctx,
+		      uint32_t *cut_points, uint32_t max_cut_points, uint32_t *num_cut_points,
+		      spdk_accel_step_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *task;
+	struct spdk_accel_sequence *seq = *pseq;
+	uint64_t nbytes;
+	int rc;
+
+	if (iovs == NULL || iovcnt == 0) {
+		SPDK_ERRLOG("iov should not be NULL or empty\n");
+		return -EINVAL;
+	}
+
+	nbytes = accel_get_iovlen(iovs, iovcnt);
+	rc = _accel_check_cdc_params(params, nbytes);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	if (seq == NULL) {
+		seq = accel_sequence_get(accel_ch);
+		if (spdk_unlikely(seq == NULL)) {
+			return -ENOMEM;
+		}
+	}
+
+	assert(seq->ch == accel_ch);
+	task = accel_sequence_get_task(accel_ch, seq, cb_fn, cb_arg);
+	if (spdk_unlikely(task == NULL)) {
+		if (*pseq == NULL) {
+			accel_sequence_put(seq);
+		}
+
+		return -ENOMEM;
+	}
+
+	task->s.iovs = iovs;
+	task->s.iovcnt = iovcnt;
+	task->src_domain = domain;
+	task->src_domain_ctx = domain_ctx;
+	task->nbytes = nbytes;
+	task->cut_points = cut_points;
+	task->cdc.params = params;
+	task->cdc.num_cut_points = num_cut_points;
+	task->cdc.max_cut_points = max_cut_points;
+	task->op_code = SPDK_ACCEL_OPC_CDC;
+	task->dst_domain = NULL;
+
+	TAILQ_INSERT_TAIL(&seq->tasks, task, seq_link);
+	*pseq = seq;
+
+	return 0;
+}
+
 int
 spdk_accel_get_buf(struct spdk_io_channel *ch, uint64_t len, void **buf,
 		   struct spdk_memory_domain **domain, void **domain_ctx)
@@ -2457,9 +3219,14 @@ accel_task_set_dstbuf(struct spdk_accel_task *task, struct spdk_accel_task *next
 		task->dst_domain_ctx = next->dst_domain_ctx;
 		break;
 	case SPDK_ACCEL_OPC_CRC32C:
+	case SPDK_ACCEL_OPC_DIF_GENERATE:
+	case SPDK_ACCEL_OPC_DIF_VERIFY:
 	case SPDK_ACCEL_OPC_DIX_GENERATE:
 	case SPDK_ACCEL_OPC_DIX_VERIFY:
-		/* crc32 and dix_generate/verify are special, because they do not have a dst buffer */
+	case SPDK_ACCEL_OPC_HASH:
+	case SPDK_ACCEL_OPC_CDC:
+		/* crc32, hash, cdc and dif/dix_generate/verify are special, because they do not have
+		 * a dst buffer */
 		if (task->src_domain != next->src_domain) {
 			return false;
 		}
@@ -2487,6 +3254,71 @@ accel_task_set_dstbuf(struct spdk_accel_task *task, struct spdk_accel_task *next
 	return true;
 }
 
+static bool
+accel_sequence_can_fuse(enum spdk_accel_opcode opcode, struct spdk_accel_task *task,
+			struct spdk_accel_task *next)
+{
+	/* Both steps need to be reported at the same time, so only one of them can have a callback */
+	if (task->step_cb_fn != NULL && next->step_cb_fn != NULL) {
+		return false;
+	}
+
+	if (g_modules_opc[opcode].module == NULL) {
+		return false;
+	}
+
+	/* Don't fuse operations if that'd make us bounce the data */
+	if (!g_modules_opc[opcode].supports_memory_domains &&
+	    (g_modules_opc[task->op_code].supports_memory_domains ||
+	     g_modules_opc[next->op_code].supports_memory_domains)) {
+		return task->src_domain == NULL && task->dst_domain == NULL &&
+		       next->src_domain == NULL && next->dst_domain == NULL;
+	}
+
+	return true;
+}
+
+/* Replaces task and the next task with a single copy + crc32c.  One of them is a copy and the other
+ * one calculates the crc32c of either the copy's source or its destination, so their iovecs have
+ * already been checked by the caller. */
+static void
+accel_sequence_fuse_copy_crc32c(struct spdk_accel_sequence *seq, struct spdk_accel_task *task,
+				struct spdk_accel_task **next_task)
+{
+	struct spdk_accel_task *next = *next_task;
+	struct spdk_accel_task *copy, *crc;
+
+	if (task->op_code == SPDK_ACCEL_OPC_COPY) {
+		copy = task;
+		crc = next;
+	} else {
+		copy = next;
+		crc = task;
+		task->d.iovs = copy->d.iovs;
+		task->d.iovcnt = copy->d.iovcnt;
+		task->dst_domain = copy->dst_domain;
+		task->dst_domain_ctx = copy->dst_domain_ctx;
+	}
+
+	task->s.iovs = copy->s.iovs;
+	task->s.iovcnt = copy->s.iovcnt;
+	task->src_domain = copy->src_domain;
+	task->src_domain_ctx = copy->src_domain_ctx;
+	task->crc_dst = crc->crc_dst;
+	task->seed = crc->seed;
+	task->op_code = SPDK_ACCEL_OPC_COPY_CRC32C;
+
+	if (task->step_cb_fn == NULL) {
+		task->step_cb_fn = next->step_cb_fn;
+		task->cb_arg = next->cb_arg;
+		next->step_cb_fn = NULL;
+	}
+
+	*next_task = TAILQ_NEXT(next, seq_link);
+	accel_sequence_complete_task(seq, next);
+	accel_update_stats(seq->ch, sequence_ops_fused, 1);
+}
+
 static void
 accel_sequence_merge_tasks(struct spdk_accel_sequence *seq, struct spdk_accel_task *task,
 			   struct spdk_accel_task **next_task)
@@ -2495,6 +3327,14 @@ accel_sequence_merge_tasks(struct spdk_accel_sequence *seq, struct spdk_accel_ta
 
 	switch (task->op_code) {
 	case SPDK_ACCEL_OPC_COPY:
+		/* A copy followed by a crc32c of the data it copied can be done in a single pass */
+		if (next->op_code == SPDK_ACCEL_OPC_CRC32C &&
+		    task->dst_domain == next->src_domain &&
+		    accel_compare_iovs(task->d.iovs, task->d.iovcnt, next->s.iovs, next->s.iovcnt) &&
+		    accel_sequence_can_fuse(SPDK_ACCEL_OPC_COPY_CRC32C, task, next)) {
+			accel_sequence_fuse_copy_crc32c(seq, task, next_task);
+			break;
+		}
 		/* We only allow changing src of operations that actually have a src, e.g. we never
 		 * do it for fill.  Theoretically, it is possible, but we'd have to be careful to
 		 * change the src of the operation after fill (which in turn could also be a fill).
@@ -2521,27 +3361,41 @@ accel_sequence_merge_tasks(struct spdk_accel_sequence *seq, struct spdk_accel_ta
 		next->src_domain = task->src_domain;
 		next->src_domain_ctx = task->src_domain_ctx;
 		accel_sequence_complete_task(seq, task);
+		accel_update_stats(seq->ch, sequence_ops_elided, 1);
 		break;
 	case SPDK_ACCEL_OPC_DECOMPRESS:
 	case SPDK_ACCEL_OPC_FILL:
 	case SPDK_ACCEL_OPC_ENCRYPT:
 	case SPDK_ACCEL_OPC_DECRYPT:
 	case SPDK_ACCEL_OPC_CRC32C:
+	case SPDK_ACCEL_OPC_DIF_GENERATE:
+	case SPDK_ACCEL_OPC_DIF_VERIFY:
 	case SPDK_ACCEL_OPC_DIF_GENERATE_COPY:
 	case SPDK_ACCEL_OPC_DIF_VERIFY_COPY:
 	case SPDK_ACCEL_OPC_DIX_GENERATE:
 	case SPDK_ACCEL_OPC_DIX_VERIFY:
+	case SPDK_ACCEL_OPC_HASH:
+	case SPDK_ACCEL_OPC_CDC:
 		/* We can only merge tasks when one of them is a copy */
 		if (next->op_code != SPDK_ACCEL_OPC_COPY) {
 			break;
 		}
 		if (!accel_task_set_dstbuf(task, next)) {
+			/* If there's no previous operation to write to the copy's destination,
+			 * calculate the crc32c while copying the data instead */
+			if (task->op_code == SPDK_ACCEL_OPC_CRC32C &&
+			    task->src_domain == next->src_domain &&
+			    accel_compare_iovs(task->s.iovs, task->s.iovcnt, next->s.iovs, next->s.iovcnt) &&
+			    accel_sequence_can_fuse(SPDK_ACCEL_OPC_COPY_CRC32C, task, next)) {
+				accel_sequence_fuse_copy_crc32c(seq, task, next_task);
+			}
 			break;
 		}
 		/* We're removing next_task from the tasks queue, so we need to update its pointer,
 		 * so that the TAILQ_FOREACH_SAFE() loop below works correctly */
 		*next_task = TAILQ_NEXT(next, seq_link);
 		accel_sequence_complete_task(seq, next);
+		accel_update_stats(seq->ch, sequence_ops_elided, 1);
 		break;
 	default:
 		assert(0 && "bad opcode");
@@ -2971,6 +3825,61 @@ spdk_accel_module_list_add(struct spdk_accel_module_if *accel_module)
 	}
 }
 
+static void
+accel_cost_destroy_channel(struct accel_io_channel *accel_ch)
+{
+	struct accel_cost_channel *cost;
+	int op, i;
+
+	for (op = 0; op < SPDK_ACCEL_OPC_LAST; op++) {
+		cost = accel_ch->cost[op];
+		if (cost == NULL) {
+			continue;
+		}
+
+		/* The first channel is the one of the module assigned to the opcode */
+		for (i = 1; i < g_cost_opc[op].num_modules; i++) {
+			if (cost->module_ch[i] != NULL) {
+				spdk_put_io_channel(cost->module_ch[i]);
+			}
+		}
+		free(cost);
+		accel_ch->cost[op] = NULL;
+	}
+}
+
+static int
+accel_cost_create_channel(struct accel_io_channel *accel_ch)
+{
+	struct accel_cost_channel *cost;
+	struct spdk_accel_module_if *module;
+	int op, i;
+
+	for (op = 0; op < SPDK_ACCEL_OPC_LAST; op++) {
+		if (g_cost_opc[op].num_modules < 2) {
+			continue;
+		}
+
+		cost = calloc(1, sizeof(*cost));
+		if (cost == NULL) {
+			return -ENOMEM;
+		}
+		accel_ch->cost[op] = cost;
+
+		cost->module_ch[0] = accel_ch->module_ch[op];
+		for (i = 1; i < g_cost_opc[op].num_modules; i++) {
+			module = g_cost_opc[op].modules[i];
+			cost->module_ch[i] = module->get_io_channel();
+			if (cost->module_ch[i] == NULL) {
+				SPDK_ERRLOG("Module %s failed to get io channel\n", module->name);
+				return -ENOMEM;
+			}
+		}
+	}
+
+	return 0;
+}
+
 /* Framework level channel create callback. */
 static int
 accel_create_channel(void *io_device, void *ctx_buf)
@@ -3043,6 +3952,10 @@ accel_create_channel(void *io_device, void *ctx_buf)
 		}
 	}
 
+	if (accel_cost_create_channel(accel_ch) != 0) {
+		goto err;
+	}
+
 	if (g_accel_driver != NULL) {
 		accel_ch->driver_channel = g_accel_driver->get_io_channel();
 		if (accel_ch->driver_channel == NULL) {
@@ -3063,6 +3976,7 @@ err:
 	if (accel_ch->driver_channel != NULL) {
 		spdk_put_io_channel(accel_ch->driver_channel);
 	}
+	accel_cost_destroy_channel(accel_ch);
 	for (j = 0; j < i; j++) {
 		spdk_put_io_channel(accel_ch->module_ch[j]);
 	}
@@ -3081,6 +3995,8 @@ accel_add_stats(struct accel_stats *total, struct accel_stats *stats)
 
 	total->sequence_executed += stats->sequence_executed;
 	total->sequence_failed += stats->sequence_failed;
+	total->sequence_ops_elided += stats->sequence_ops_elided;
+	total->sequence_ops_fused += stats->sequence_ops_fused;
 	total->sequence_outstanding += stats->sequence_outstanding;
 	total->task_outstanding += stats->task_outstanding;
 	total->retry.task += stats->retry.task;
@@ -3107,6 +4023,8 @@ accel_destroy_channel(void *io_device, void *ctx_buf)
 		spdk_put_io_channel(accel_ch->driver_channel);
 	}
 
+	accel_cost_destroy_channel(accel_ch);
+
 	for (i = 0; i < SPDK_ACCEL_OPC_LAST; i++) {
 		assert(accel_ch->module_ch[i] != NULL);
 		spdk_put_io_channel(accel_ch->module_ch[i]);
@@ -3166,6 +4084,61 @@ accel_module_init_opcode(enum spdk_accel_opcode opcode)
 	}
 }
 
+static uint8_t
+accel_module_get_buf_align(struct spdk_accel_module_if *module, enum spdk_accel_opcode opcode)
+{
+	struct spdk_accel_operation_exec_ctx ctx = { .size = sizeof(ctx) };
+	struct spdk_accel_opcode_info info = {};
+
+	if (module->get_operation_info != NULL) {
+		module->get_operation_info(opcode, &ctx, &info);
+	}
+
+	return info.required_alignment;
+}
+
+static void
+accel_cost_init_opcode(enum spdk_accel_opcode opcode)
+{
+	struct accel_cost_opc *opc = &g_cost_opc[opcode];
+	struct spdk_accel_module_if *primary = g_modules_opc[opcode].module;
+	struct spdk_accel_module_if *module;
+
+	opc->num_modules = 0;
+	if (!g_opts.cost_model || g_modules_opc_override[opcode] != NULL) {
+		return;
+	}
+
+	/* Crypto keys are initialized by the module assigned to encrypt/decrypt only, while
+	 * tasks with buffers in memory domains can only be executed by modules supporting them. */
+	if (opcode == SPDK_ACCEL_OPC_ENCRYPT || opcode == SPDK_ACCEL_OPC_DECRYPT ||
+	    g_modules_opc[opcode].supports_memory_domains) {
+		return;
+	}
+
+	opc->modules[opc->num_modules++] = primary;
+	TAILQ_FOREACH(module, &spdk_accel_module_list, tailq) {
+		if (opc->num_modules == ACCEL_COST_MAX_MODULES) {
+			break;
+		}
+		if (module == primary || !module->supports_opcode(opcode)) {
+			continue;
+		}
+		/* Users align their buffers to what the assigned module requires */
+		if (accel_module_get_buf_align(module, opcode) >
+		    accel_module_get_buf_align(primary, opcode)) {
+			continue;
+		}
+
+		SPDK_DEBUGLOG(accel, "OPC 0x%x can be executed by %s\n", opcode, module->name);
+		opc->modules[opc->num_modules++] = module;
+	}
+
+	if (opc->num_modules < 2) {
+		opc->num_modules = 0;
+	}
+}
+
 static int
 accel_memory_domain_translate(struct spdk_memory_domain *src_domain, void *src_domain_ctx,
 			      struct spdk_memory_domain *dst_domain, struct spdk_memory_domain_translation_ctx *dst_domain_ctx,
@@ -3302,6 +4275,7 @@ spdk_accel_initialize(void)
 	for (op = 0; op < SPDK_ACCEL_OPC_LAST; op++) {
 		assert(g_modules_opc[op].module != NULL);
 		accel_module_init_opcode(op);
+		accel_cost_init_opcode(op);
 	}
 
 	rc = spdk_iobuf_register_module("accel");
@@ -3382,6 +4356,7 @@ accel_write_options(struct spdk_json_write_ctx *w)
 	spdk_json_write_named_uint32(w, "task_count", g_opts.task_count);
 	spdk_json_write_named_uint32(w, "sequence_count", g_opts.sequence_count);
 	spdk_json_write_named_uint32(w, "buf_count", g_opts.buf_count);
+	spdk_json_write_named_bool(w, "cost_model", g_opts.cost_model);
 	spdk_json_write_object_end(w);
 	spdk_json_write_object_end(w);
 }
@@ -3491,6 +4466,7 @@ accel_io_device_unregister_cb(void *io_device)
 			g_modules_opc_override[op] = NULL;
 		}
 		g_modules_opc[op].module = NULL;
+		g_cost_opc[op].num_modules = 0;
 	}
 
 	spdk_accel_module_finish();
@@ -3589,6 +4565,7 @@ spdk_accel_set_opts(const struct spdk_accel_opts *opts)
 	SET_FIELD(task_count);
 	SET_FIELD(sequence_count);
 	SET_FIELD(buf_count);
+	SET_FIELD(cost_model);
 
 	g_opts.opts_size = opts->opts_size;
 
@@ -3622,12 +4599,13 @@ spdk_accel_get_opts(struct spdk_accel_opts *opts, size_t opts_size)
 	SET_FIELD(task_count);
 	SET_FIELD(sequence_count);
 	SET_FIELD(buf_count);
+	SET_FIELD(cost_model);
 
 #undef SET_FIELD
 
 	/* Do not remove this statement, you should always update this statement when you adding a new field,
 	 * and do not forget to add the SET_FIELD statement for your added field. */
-	SPDK_STATIC_ASSERT(sizeof(struct spdk_accel_opts) == 28, "Incorrect size");
+	SPDK_STATIC_ASSERT(sizeof(struct spdk_accel_opts) == 29, "Incorrect size");
 }
 
 struct accel_get_stats_ctx {
@@ -3679,6 +4657,93 @@ accel_get_stats(accel_get_stats_cb cb_fn, void *cb_arg)
 	return 0;
 }
 
+struct accel_get_cost_model_ctx {
+	struct accel_cost_model		model;
+	accel_get_cost_model_cb		cb_fn;
+	void				*cb_arg;
+};
+
+static void
+accel_get_channel_cost_model_done(struct spdk_io_channel_iter *iter, int status)
+{
+	struct accel_get_cost_model_ctx *ctx = spdk_io_channel_iter_get_ctx(iter);
+	struct accel_cost_entry *entry;
+	int op, i, b;
+
+	/* Turn the sums weighted by the number of samples into averages */
+	for (op = 0; op < SPDK_ACCEL_OPC_LAST; op++) {
+		for (i = 0; i < ACCEL_COST_MAX_MODULES; i++) {
+			for (b = 0; b < ACCEL_COST_NUM_BUCKETS; b++) {
+				entry = &ctx->model.operations[op].entries[i][b];
+				if (entry->samples != 0) {
+					entry->ticks /= entry->samples;
+				}
+			}
+		}
+	}
+
+	ctx->cb_fn(&ctx->model, ctx->cb_arg);
+	free(ctx);
+}
+
+static void
+accel_get_channel_cost_model(struct spdk_io_channel_iter *iter)
+{
+	struct spdk_io_channel *ch = spdk_io_channel_iter_get_channel(iter);
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct accel_get_cost_model_ctx *ctx = spdk_io_channel_iter_get_ctx(iter);
+	struct accel_cost_channel *cost;
+	struct accel_cost_entry *entry;
+	int op, i, b;
+
+	for (op = 0; op < SPDK_ACCEL_OPC_LAST; op++) {
+		cost = accel_ch->cost[op];
+		if (cost == NULL) {
+			continue;
+		}
+
+		ctx->model.operations[op].fallbacks += cost->fallbacks;
+		for (i = 0; i < g_cost_opc[op].num_modules; i++) {
+			for (b = 0; b < ACCEL_COST_NUM_BUCKETS; b++) {
+				entry = &ctx->model.operations[op].entries[i][b];
+				entry->ticks += cost->entries[i][b].ticks * cost->entries[i][b].samples;
+				entry->samples += cost->entries[i][b].samples;
+			}
+		}
+	}
+
+	spdk_for_each_channel_continue(iter, 0);
+}
+
+int
+accel_get_cost_model(accel_get_cost_model_cb cb_fn, void *cb_arg)
+{
+	struct accel_get_cost_model_ctx *ctx;
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		return -ENOMEM;
+	}
+
+	ctx->cb_fn = cb_fn;
+	ctx->cb_arg = cb_arg;
+
+	spdk_for_each_channel(&spdk_accel_module_list, accel_get_channel_cost_model, ctx,
+			      accel_get_channel_cost_model_done);
+
+	return 0;
+}
+
+const char *
+accel_get_cost_module_name(enum spdk_accel_opcode opcode, int idx)
+{
+	if (idx >= g_cost_opc[opcode].num_modules) {
+		return NULL;
+	}
+
+	return g_cost_opc[opcode].modules[idx]->name;
+}
+
 void
 spdk_accel_get_opcode_stats(struct spdk_io_channel *ch, enum spdk_accel_opcode opcode,
 			    struct spdk_accel_opcode_stats *stats, size_t size)
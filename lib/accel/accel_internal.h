@@ -32,6 +32,9 @@ struct accel_stats {
 	struct accel_operation_stats	operations[SPDK_ACCEL_OPC_LAST];
 	uint64_t			sequence_executed;
 	uint64_t			sequence_failed;
+	/* Operations removed from sequences by merging them with other operations */
+	uint64_t			sequence_ops_elided;
+	uint64_t			sequence_ops_fused;
 	uint32_t			sequence_outstanding;
 	uint32_t			task_outstanding;
 
@@ -43,11 +46,34 @@ struct accel_stats {
 	} retry;
 };
 
+/* Maximum number of modules the cost model dispatches a single opcode to */
+#define ACCEL_COST_MAX_MODULES		4
+/* Operation size buckets, the first one holds operations up to 512B, each next one doubles it */
+#define ACCEL_COST_NUM_BUCKETS		12
+#define ACCEL_COST_MIN_SIZE_SHIFT	9
+
+struct accel_cost_entry {
+	/* Moving average of the time to complete an operation, in ticks */
+	uint64_t	ticks;
+	uint64_t	samples;
+};
+
+struct accel_cost_model {
+	struct {
+		struct accel_cost_entry	entries[ACCEL_COST_MAX_MODULES][ACCEL_COST_NUM_BUCKETS];
+		/* Submissions retried on another module, because the cheapest one was busy */
+		uint64_t		fallbacks;
+	} operations[SPDK_ACCEL_OPC_LAST];
+};
+
 typedef void (*_accel_for_each_module_fn)(struct module_info *info);
 void _accel_for_each_module(struct module_info *info, _accel_for_each_module_fn fn);
 void _accel_crypto_key_dump_param(struct spdk_json_write_ctx *w, struct spdk_accel_crypto_key *key);
 void _accel_crypto_keys_dump_param(struct spdk_json_write_ctx *w);
 typedef void (*accel_get_stats_cb)(struct accel_stats *stats, void *cb_arg);
 int accel_get_stats(accel_get_stats_cb cb_fn, void *cb_arg);
+typedef void (*accel_get_cost_model_cb)(struct accel_cost_model *model, void *cb_arg);
+int accel_get_cost_model(accel_get_cost_model_cb cb_fn, void *cb_arg);
+const char *accel_get_cost_module_name(enum spdk_accel_opcode opcode, int idx);
 
 #endif
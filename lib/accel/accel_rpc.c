@@ -361,6 +361,7 @@ struct rpc_accel_opts {
 	uint32_t	task_count;
 	uint32_t	sequence_count;
 	uint32_t	buf_count;
+	bool		cost_model;
 };
 
 static const struct spdk_json_object_decoder rpc_accel_set_options_decoders[] = {
@@ -369,6 +370,7 @@ static const struct spdk_json_object_decoder rpc_accel_set_options_decoders[] =
 	{"task_count", offsetof(struct rpc_accel_opts, task_count), spdk_json_decode_uint32, true},
 	{"sequence_count", offsetof(struct rpc_accel_opts, sequence_count), spdk_json_decode_uint32, true},
 	{"buf_count", offsetof(struct rpc_accel_opts, buf_count), spdk_json_decode_uint32, true},
+	{"cost_model", offsetof(struct rpc_accel_opts, cost_model), spdk_json_decode_bool, true},
 };
 
 static void
@@ -386,6 +388,7 @@ rpc_accel_set_options(struct spdk_jsonrpc_request *request, const struct spdk_js
 	rpc_opts.task_count = opts.task_count;
 	rpc_opts.sequence_count = opts.sequence_count;
 	rpc_opts.buf_count = opts.buf_count;
+	rpc_opts.cost_model = opts.cost_model;
 
 	if (spdk_json_decode_object(params, rpc_accel_set_options_decoders,
 				    SPDK_COUNTOF(rpc_accel_set_options_decoders), &rpc_opts)) {
@@ -399,6 +402,7 @@ rpc_accel_set_options(struct spdk_jsonrpc_request *request, const struct spdk_js
 	opts.task_count = rpc_opts.task_count;
 	opts.sequence_count = rpc_opts.sequence_count;
 	opts.buf_count = rpc_opts.buf_count;
+	opts.cost_model = rpc_opts.cost_model;
 
 	rc = spdk_accel_set_opts(&opts);
 	if (rc != 0) {
@@ -423,6 +427,8 @@ rpc_accel_get_stats_done(struct accel_stats *stats, void *cb_arg)
 
 	spdk_json_write_named_uint64(w, "sequence_executed", stats->sequence_executed);
 	spdk_json_write_named_uint64(w, "sequence_failed", stats->sequence_failed);
+	spdk_json_write_named_uint64(w, "sequence_ops_elided", stats->sequence_ops_elided);
+	spdk_json_write_named_uint64(w, "sequence_ops_fused", stats->sequence_ops_fused);
 	spdk_json_write_named_uint64(w, "sequence_outstanding", stats->sequence_outstanding);
 	spdk_json_write_named_uint64(w, "task_outstanding", stats->task_outstanding);
 	spdk_json_write_named_array_begin(w, "operations");
@@ -464,3 +470,62 @@ rpc_accel_get_stats(struct spdk_jsonrpc_request *request, const struct spdk_json
 	}
 }
 SPDK_RPC_REGISTER("accel_get_stats", rpc_accel_get_stats, SPDK_RPC_RUNTIME)
+
+static void
+rpc_accel_get_cost_model_done(struct accel_cost_model *model, void *cb_arg)
+{
+	struct spdk_jsonrpc_request *request = cb_arg;
+	struct spdk_json_write_ctx *w;
+	struct accel_cost_entry *entry;
+	const char *module_name;
+	uint64_t ticks_hz = spdk_get_ticks_hz();
+	int op, i, b;
+
+	w = spdk_jsonrpc_begin_result(request);
+	spdk_json_write_array_begin(w);
+	for (op = 0; op < SPDK_ACCEL_OPC_LAST; op++) {
+		if (accel_get_cost_module_name(op, 0) == NULL) {
+			continue;
+		}
+
+		spdk_json_write_object_begin(w);
+		spdk_json_write_named_string(w, "opcode", spdk_accel_get_opcode_name(op));
+		spdk_json_write_named_uint64(w, "fallbacks", model->operations[op].fallbacks);
+		spdk_json_write_named_array_begin(w, "modules");
+		for (i = 0; (module_name = accel_get_cost_module_name(op, i)) != NULL; i++) {
+			spdk_json_write_object_begin(w);
+			spdk_json_write_named_string(w, "module_name", module_name);
+			spdk_json_write_named_array_begin(w, "costs");
+			for (b = 0; b < ACCEL_COST_NUM_BUCKETS; b++) {
+				entry = &model->operations[op].entries[i][b];
+				if (entry->samples == 0) {
+					continue;
+				}
+				spdk_json_write_object_begin(w);
+				spdk_json_write_named_uint64(w, "size", 1ULL << (ACCEL_COST_MIN_SIZE_SHIFT + b));
+				spdk_json_write_named_uint64(w, "latency_ns",
+							     entry->ticks * SPDK_SEC_TO_NSEC / ticks_hz);
+				spdk_json_write_named_uint64(w, "samples", entry->samples);
+				spdk_json_write_object_end(w);
+			}
+			spdk_json_write_array_end(w);
+			spdk_json_write_object_end(w);
+		}
+		spdk_json_write_array_end(w);
+		spdk_json_write_object_end(w);
+	}
+	spdk_json_write_array_end(w);
+	spdk_jsonrpc_end_result(request, w);
+}
+
+static void
+rpc_accel_get_cost_model(struct spdk_jsonrpc_request *request, const struct spdk_json_val *params)
+{
+	int rc;
+
+	rc = accel_get_cost_model(rpc_accel_get_cost_model_done, request);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+	}
+}
+SPDK_RPC_REGISTER("accel_get_cost_model", rpc_accel_get_cost_model, SPDK_RPC_RUNTIME)
@@ -18,21 +18,34 @@
 #include "spdk/util.h"
 #include "spdk/xor.h"
 #include "spdk/dif.h"
+#include "spdk/endian.h"
 
 #ifdef SPDK_CONFIG_HAVE_LZ4
 #include <lz4.h>
 #endif
 
+#ifdef SPDK_CONFIG_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
 #ifdef SPDK_CONFIG_ISAL
 #include "../isa-l/include/igzip_lib.h"
 #ifdef SPDK_CONFIG_ISAL_CRYPTO
 #include "../isa-l-crypto/include/aes_xts.h"
+#include "../isa-l-crypto/include/aes_keyexp.h"
 #include "../isa-l-crypto/include/isal_crypto_api.h"
+#include "../isa-l-crypto/include/sha256_mb.h"
 #endif
 #endif
 
+#ifndef SPDK_CONFIG_ISAL_CRYPTO
+#include <openssl/evp.h>
+#endif
+
 /* Per the AES-XTS spec, the size of data unit cannot be bigger than 2^20 blocks, 128b each block */
 #define ACCEL_AES_XTS_MAX_BLOCK_SIZE (1 << 24)
+/* Size of an AES-256 key schedule: 15 round keys, 16 bytes each */
+#define ACCEL_AES_MAX_EXPANDED_KEY_SIZE (15 * 16)
 
 #ifdef SPDK_CONFIG_ISAL
 #define COMP_DEFLATE_MIN_LEVEL ISAL_DEF_MIN_LEVEL
@@ -44,11 +57,39 @@
 
 #define COMP_DEFLATE_LEVEL_NUM (COMP_DEFLATE_MAX_LEVEL + 1)
 
+/* Number of SHA-256 calculations interleaved by the multi-buffer manager, it matches the number
+ * of lanes of its AVX-512 implementation.
+ */
+#define SW_ACCEL_SHA256_JOBS 16
+
+#define MURMUR3_C1 0x87c37b91114253d5ULL
+#define MURMUR3_C2 0x4cf5ad432745937fULL
+
 struct comp_deflate_level_buf {
 	uint32_t size;
 	uint8_t  *buf;
 };
 
+#ifdef SPDK_CONFIG_ISAL_CRYPTO
+struct sw_accel_sha256_job {
+	ISAL_SHA256_HASH_CTX		ctx;
+	struct spdk_accel_task		*task;
+	uint32_t			iov_idx;
+	int				status;
+};
+#endif
+
+struct sw_accel_murmur3 {
+	uint64_t	h1;
+	uint64_t	h2;
+	uint64_t	len;
+	uint8_t		tail[16];
+	uint32_t	tail_len;
+};
+
+/* Gear hash table used by content defined chunking, filled by sw_accel_cdc_init_gear() */
+static uint64_t g_sw_cdc_gear[256];
+
 struct sw_accel_io_channel {
 	/* for ISAL */
 #ifdef SPDK_CONFIG_ISAL
@@ -63,6 +104,18 @@ struct sw_accel_io_channel {
 	/* for lz4 */
 	LZ4_stream_t                    *lz4_stream;
 	LZ4_streamDecode_t              *lz4_stream_decode;
+#endif
+#ifdef SPDK_CONFIG_HAVE_ZSTD
+	/* for zstd */
+	ZSTD_CCtx			*zstd_cctx;
+	ZSTD_DCtx			*zstd_dctx;
+#endif
+	/* for SHA-256, allocated on first use */
+#ifdef SPDK_CONFIG_ISAL_CRYPTO
+	ISAL_SHA256_HASH_CTX_MGR	*sha256_mgr;
+	struct sw_accel_sha256_job	*sha256_jobs;
+#else
+	EVP_MD_CTX			*sha256_ctx;
 #endif
 	struct spdk_poller		*completion_poller;
 	STAILQ_HEAD(, spdk_accel_task)	tasks_to_complete;
@@ -73,6 +126,12 @@ typedef int (*sw_accel_crypto_op)(const uint8_t *k2, const uint8_t *k1,
 				  const void *in, void *out);
 
 struct sw_accel_crypto_key_data {
+	/* Key schedules are expanded once, when the key is created, instead of on every data unit */
+	uint8_t key_enc[ACCEL_AES_MAX_EXPANDED_KEY_SIZE];
+	uint8_t key_dec[ACCEL_AES_MAX_EXPANDED_KEY_SIZE];
+	/* The tweak is always encrypted, key2_dec is only filled because the expansion needs it */
+	uint8_t key2_enc[ACCEL_AES_MAX_EXPANDED_KEY_SIZE];
+	uint8_t key2_dec[ACCEL_AES_MAX_EXPANDED_KEY_SIZE];
 	sw_accel_crypto_op encrypt;
 	sw_accel_crypto_op decrypt;
 };
@@ -113,6 +172,8 @@ sw_accel_supports_opcode(enum spdk_accel_opcode opc)
 	case SPDK_ACCEL_OPC_DIF_VERIFY_COPY:
 	case SPDK_ACCEL_OPC_DIX_GENERATE:
 	case SPDK_ACCEL_OPC_DIX_VERIFY:
+	case SPDK_ACCEL_OPC_HASH:
+	case SPDK_ACCEL_OPC_CDC:
 		return true;
 	default:
 		return false;
@@ -292,6 +353,157 @@ _sw_accel_decompress_lz4(struct sw_accel_io_channel *sw_ch, struct spdk_accel_ta
 #endif
 }
 
+static int
+_sw_accel_compress_zstd(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *accel_task)
+{
+#ifdef SPDK_CONFIG_HAVE_ZSTD
+	ZSTD_CCtx *cctx = sw_ch->zstd_cctx;
+	struct iovec *siov = accel_task->s.iovs;
+	struct iovec *diov = accel_task->d.iovs;
+	ZSTD_outBuffer out = { .dst = diov[0].iov_base, .size = diov[0].iov_len };
+	ZSTD_inBuffer in;
+	ZSTD_EndDirective mode;
+	uint32_t output_size = 0;
+	uint32_t i, d = 0;
+	size_t ret, in_pos, out_pos, src_size = 0;
+	int rc = 0;
+
+	if (accel_task->comp.level > (uint32_t)ZSTD_maxCLevel()) {
+		SPDK_ERRLOG("zstd doesn't support this algorithm level(%u)\n", accel_task->comp.level);
+		return -EINVAL;
+	}
+
+	ZSTD_CCtx_reset(cctx, ZSTD_reset_session_only);
+	ret = ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, accel_task->comp.level);
+	if (ZSTD_isError(ret)) {
+		SPDK_ERRLOG("ZSTD_CCtx_setParameter returned error %s.\n", ZSTD_getErrorName(ret));
+		return -EINVAL;
+	}
+
+	/* Knowing the size up front lets zstd tune its parameters to it, same as for a single
+	 * buffer, and records it in the frame header.
+	 */
+	for (i = 0; i < accel_task->s.iovcnt; i++) {
+		src_size += siov[i].iov_len;
+	}
+	ZSTD_CCtx_setPledgedSrcSize(cctx, src_size);
+
+	/* The frame is streamed from one source iovec after another and ended with the last one */
+	for (i = 0; i < accel_task->s.iovcnt && rc == 0; i++) {
+		in.src = siov[i].iov_base;
+		in.size = siov[i].iov_len;
+		in.pos = 0;
+		mode = (i == accel_task->s.iovcnt - 1) ? ZSTD_e_end : ZSTD_e_continue;
+		ret = 1;
+
+		/* With ZSTD_e_end, zstd returns 0 once the frame has been completely flushed */
+		while (in.pos < in.size || (mode == ZSTD_e_end && ret != 0)) {
+			if (out.pos == out.size && (d + 1) < accel_task->d.iovcnt) {
+				output_size += out.pos;
+				d++;
+				out.dst = diov[d].iov_base;
+				out.size = diov[d].iov_len;
+				out.pos = 0;
+			}
+
+			in_pos = in.pos;
+			out_pos = out.pos;
+			ret = ZSTD_compressStream2(cctx, &out, &in, mode);
+			if (ZSTD_isError(ret)) {
+				SPDK_ERRLOG("ZSTD_compressStream2 returned error %s.\n", ZSTD_getErrorName(ret));
+				rc = -EIO;
+				break;
+			}
+			if (in.pos == in_pos && out.pos == out_pos) {
+				SPDK_ERRLOG("Not enough destination buffer provided.\n");
+				rc = -ENOMEM;
+				break;
+			}
+		}
+	}
+	output_size += out.pos;
+
+	/* Get our total output size */
+	if (accel_task->output_size != NULL) {
+		*accel_task->output_size = output_size;
+	}
+
+	return rc;
+#else
+	SPDK_ERRLOG("zstd library is required to use software compression.\n");
+	return -EINVAL;
+#endif
+}
+
+static int
+_sw_accel_decompress_zstd(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *accel_task)
+{
+#ifdef SPDK_CONFIG_HAVE_ZSTD
+	ZSTD_DCtx *dctx = sw_ch->zstd_dctx;
+	struct iovec *siov = accel_task->s.iovs;
+	struct iovec *diov = accel_task->d.iovs;
+	ZSTD_outBuffer out = { .dst = diov[0].iov_base, .size = diov[0].iov_len };
+	ZSTD_inBuffer in = {};
+	uint32_t output_size = 0;
+	uint32_t i = 0, d = 0;
+	size_t ret = 1, in_pos, out_pos;
+	int rc = 0;
+
+	ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only);
+
+	/* Keep going after the last source iovec is consumed, as long as the decoder has data that
+	 * didn't fit into the destination yet, i.e. until the frame is complete.
+	 */
+	while (in.pos < in.size || i < accel_task->s.iovcnt || ret != 0) {
+		if (in.pos == in.size && i < accel_task->s.iovcnt) {
+			in.src = siov[i].iov_base;
+			in.size = siov[i].iov_len;
+			in.pos = 0;
+			i++;
+			continue;
+		}
+
+		if (out.pos == out.size && (d + 1) < accel_task->d.iovcnt) {
+			output_size += out.pos;
+			d++;
+			out.dst = diov[d].iov_base;
+			out.size = diov[d].iov_len;
+			out.pos = 0;
+		}
+
+		in_pos = in.pos;
+		out_pos = out.pos;
+		ret = ZSTD_decompressStream(dctx, &out, &in);
+		if (ZSTD_isError(ret)) {
+			SPDK_ERRLOG("ZSTD_decompressStream returned error %s.\n", ZSTD_getErrorName(ret));
+			rc = -EIO;
+			break;
+		}
+		if (in.pos == in_pos && out.pos == out_pos) {
+			if (out.pos == out.size) {
+				SPDK_ERRLOG("Not enough destination buffer provided.\n");
+				rc = -ENOMEM;
+			} else {
+				SPDK_ERRLOG("Truncated zstd frame.\n");
+				rc = -EIO;
+			}
+			break;
+		}
+	}
+	output_size += out.pos;
+
+	/* Get our total output size */
+	if (accel_task->output_size != NULL) {
+		*accel_task->output_size = output_size;
+	}
+
+	return rc;
+#else
+	SPDK_ERRLOG("zstd library is required to use software decompression.\n");
+	return -EINVAL;
+#endif
+}
+
 static int
 _sw_accel_compress_deflate(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *accel_task)
 {
@@ -447,6 +659,8 @@ _sw_accel_compress(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *ac
 		return _sw_accel_compress_deflate(sw_ch, accel_task);
 	case SPDK_ACCEL_COMP_ALGO_LZ4:
 		return _sw_accel_compress_lz4(sw_ch, accel_task);
+	case SPDK_ACCEL_COMP_ALGO_ZSTD:
+		return _sw_accel_compress_zstd(sw_ch, accel_task);
 	default:
 		assert(0);
 		return -EINVAL;
@@ -461,6 +675,8 @@ _sw_accel_decompress(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *
 		return _sw_accel_decompress_deflate(sw_ch, accel_task);
 	case SPDK_ACCEL_COMP_ALGO_LZ4:
 		return _sw_accel_decompress_lz4(sw_ch, accel_task);
+	case SPDK_ACCEL_COMP_ALGO_ZSTD:
+		return _sw_accel_decompress_zstd(sw_ch, accel_task);
 	default:
 		assert(0);
 		return -EINVAL;
@@ -468,7 +684,7 @@ _sw_accel_decompress(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *
 }
 
 static int
-_sw_accel_crypto_operation(struct spdk_accel_task *accel_task, struct spdk_accel_crypto_key *key,
+_sw_accel_crypto_operation(struct spdk_accel_task *accel_task, const uint8_t *k2, const uint8_t *k1,
 			   sw_accel_crypto_op op)
 {
 #ifdef SPDK_CONFIG_ISAL_CRYPTO
@@ -524,7 +740,7 @@ _sw_accel_crypto_operation(struct spdk_accel_task *accel_task, struct spdk_accel
 		src = (uint8_t *)src_iov->iov_base + src_offset;
 		dst = (uint8_t *)dst_iov->iov_base + dst_offset;
 
-		rc = op((uint8_t *)key->key2, (uint8_t *)key->key, (uint8_t *)iv, crypto_len, src, dst);
+		rc = op(k2, k1, (uint8_t *)iv, crypto_len, src, dst);
 		if (rc != ISAL_CRYPTO_ERR_NONE) {
 			break;
 		}
@@ -584,7 +800,8 @@ _sw_accel_encrypt(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *acc
 		return -ERANGE;
 	}
 	key_data = key->priv;
-	return _sw_accel_crypto_operation(accel_task, key, key_data->encrypt);
+	return _sw_accel_crypto_operation(accel_task, key_data->key2_enc, key_data->key_enc,
+					  key_data->encrypt);
 }
 
 static int
@@ -603,7 +820,8 @@ _sw_accel_decrypt(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *acc
 		return -ERANGE;
 	}
 	key_data = key->priv;
-	return _sw_accel_crypto_operation(accel_task, key, key_data->decrypt);
+	return _sw_accel_crypto_operation(accel_task, key_data->key2_enc, key_data->key_dec,
+					  key_data->decrypt);
 }
 
 static int
@@ -678,6 +896,406 @@ _sw_accel_dix_verify(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *
 			       accel_task->dif.err);
 }
 
+#ifdef SPDK_CONFIG_ISAL_CRYPTO
+static int
+_sw_accel_sha256_get_mgr(struct sw_accel_io_channel *sw_ch)
+{
+	int rc;
+
+	if (spdk_likely(sw_ch->sha256_mgr != NULL)) {
+		return 0;
+	}
+
+	rc = posix_memalign((void **)&sw_ch->sha256_jobs, 64,
+			    sizeof(*sw_ch->sha256_jobs) * SW_ACCEL_SHA256_JOBS);
+	if (rc != 0) {
+		sw_ch->sha256_jobs = NULL;
+		return -ENOMEM;
+	}
+
+	rc = posix_memalign((void **)&sw_ch->sha256_mgr, 64, sizeof(*sw_ch->sha256_mgr));
+	if (rc != 0) {
+		sw_ch->sha256_mgr = NULL;
+		free(sw_ch->sha256_jobs);
+		sw_ch->sha256_jobs = NULL;
+		return -ENOMEM;
+	}
+
+	rc = isal_sha256_ctx_mgr_init(sw_ch->sha256_mgr);
+	if (rc != ISAL_CRYPTO_ERR_NONE) {
+		SPDK_ERRLOG("Failed to initialize SHA-256 manager: %d\n", rc);
+		free(sw_ch->sha256_mgr);
+		sw_ch->sha256_mgr = NULL;
+		free(sw_ch->sha256_jobs);
+		sw_ch->sha256_jobs = NULL;
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* Hands the next buffer of a job's task over to the multi-buffer manager.  Returns a job, not
+ * necessarily the same one, whose buffer has been completely processed, if there is any.
+ */
+static struct sw_accel_sha256_job *
+_sw_accel_sha256_submit(struct sw_accel_io_channel *sw_ch, struct sw_accel_sha256_job *job)
+{
+	struct spdk_accel_task *task = job->task;
+	struct iovec *iov = &task->s.iovs[job->iov_idx];
+	ISAL_SHA256_HASH_CTX *ctx = NULL;
+	int flags = ISAL_HASH_UPDATE;
+	int rc;
+
+	if (job->iov_idx == 0) {
+		flags |= ISAL_HASH_FIRST;
+	}
+	if (job->iov_idx == task->s.iovcnt - 1) {
+		flags |= ISAL_HASH_LAST;
+	}
+	job->iov_idx++;
+
+	assert(iov->iov_len <= UINT32_MAX);
+	rc = isal_sha256_ctx_mgr_submit(sw_ch->sha256_mgr, &job->ctx, &ctx, iov->iov_base,
+					iov->iov_len, (ISAL_HASH_CTX_FLAG)flags);
+	if (spdk_unlikely(rc != ISAL_CRYPTO_ERR_NONE)) {
+		/* The manager didn't take the job, so it's done */
+		job->status = -EINVAL;
+		return job;
+	}
+
+	return ctx != NULL ? ctx->user_data : NULL;
+}
+
+/*
+ * Calculates SHA-256 of all the tasks on the list, interleaving up to SW_ACCEL_SHA256_JOBS of
+ * them in the SIMD lanes of the multi-buffer manager.  Each task's buffers are submitted one
+ * after another, as the manager hands the previous one back.
+ */
+static void
+_sw_accel_sha256_mb(struct sw_accel_io_channel *sw_ch, void *_tasks)
+{
+	STAILQ_HEAD(, spdk_accel_task) *tasks = _tasks;
+	struct sw_accel_sha256_job *free_jobs[SW_ACCEL_SHA256_JOBS], *job;
+	ISAL_SHA256_HASH_CTX *ctx;
+	struct spdk_accel_task *task;
+	int i, rc, num_free = 0;
+
+	rc = _sw_accel_sha256_get_mgr(sw_ch);
+	if (spdk_unlikely(rc != 0)) {
+		while ((task = STAILQ_FIRST(tasks))) {
+			STAILQ_REMOVE_HEAD(tasks, link);
+			_add_to_comp_list(sw_ch, task, rc);
+		}
+		return;
+	}
+
+	for (i = 0; i < SW_ACCEL_SHA256_JOBS; i++) {
+		free_jobs[num_free++] = &sw_ch->sha256_jobs[i];
+	}
+
+	while (true) {
+		if (!STAILQ_EMPTY(tasks) && num_free > 0) {
+			task = STAILQ_FIRST(tasks);
+			STAILQ_REMOVE_HEAD(tasks, link);
+
+			job = free_jobs[--num_free];
+			isal_hash_ctx_init(&job->ctx);
+			job->ctx.user_data = job;
+			job->task = task;
+			job->iov_idx = 0;
+			job->status = 0;
+			job = _sw_accel_sha256_submit(sw_ch, job);
+		} else if (num_free < SW_ACCEL_SHA256_JOBS) {
+			/* Either all lanes are busy or there are no more tasks, finish the jobs */
+			ctx = NULL;
+			isal_sha256_ctx_mgr_flush(sw_ch->sha256_mgr, &ctx);
+			if (spdk_unlikely(ctx == NULL)) {
+				assert(0);
+				break;
+			}
+			job = ctx->user_data;
+		} else {
+			break;
+		}
+
+		while (job != NULL) {
+			task = job->task;
+			if (job->status == 0 && job->iov_idx < task->s.iovcnt) {
+				job = _sw_accel_sha256_submit(sw_ch, job);
+				continue;
+			}
+
+			if (job->status == 0 && job->ctx.error != ISAL_HASH_CTX_ERROR_NONE) {
+				job->status = -EINVAL;
+			}
+			if (job->status == 0) {
+				for (i = 0; i < ISAL_SHA256_DIGEST_NWORDS; i++) {
+					to_be32(&task->digest[i * 4], job->ctx.job.result_digest[i]);
+				}
+			}
+
+			_add_to_comp_list(sw_ch, task, job->status);
+			free_jobs[num_free++] = job;
+			job = NULL;
+		}
+	}
+}
+#else
+static int
+_sw_accel_sha256(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *accel_task)
+{
+	EVP_MD_CTX *ctx = sw_ch->sha256_ctx;
+	uint32_t i;
+
+	if (spdk_unlikely(ctx == NULL)) {
+		ctx = sw_ch->sha256_ctx = EVP_MD_CTX_new();
+		if (ctx == NULL) {
+			return -ENOMEM;
+		}
+	}
+
+	if (EVP_DigestInit_ex(ctx, EVP_sha256(), NULL) != 1) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < accel_task->s.iovcnt; i++) {
+		if (EVP_DigestUpdate(ctx, accel_task->s.iovs[i].iov_base,
+				     accel_task->s.iovs[i].iov_len) != 1) {
+			return -EINVAL;
+		}
+	}
+
+	if (EVP_DigestFinal_ex(ctx, accel_task->digest, NULL) != 1) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+#endif
+
+static inline uint64_t
+murmur3_rotl64(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t
+murmur3_fmix64(uint64_t k)
+{
+	k ^= k >> 33;
+	k *= 0xff51afd7ed558ccdULL;
+	k ^= k >> 33;
+	k *= 0xc4ceb9fe1a85ec53ULL;
+	k ^= k >> 33;
+
+	return k;
+}
+
+static inline uint64_t
+murmur3_mix_k1(uint64_t k1)
+{
+	k1 *= MURMUR3_C1;
+	k1 = murmur3_rotl64(k1, 31);
+
+	return k1 * MURMUR3_C2;
+}
+
+static inline uint64_t
+murmur3_mix_k2(uint64_t k2)
+{
+	k2 *= MURMUR3_C2;
+	k2 = murmur3_rotl64(k2, 33);
+
+	return k2 * MURMUR3_C1;
+}
+
+static inline void
+murmur3_block(struct sw_accel_murmur3 *m, const uint8_t *block)
+{
+	m->h1 ^= murmur3_mix_k1(from_le64(block));
+	m->h1 = murmur3_rotl64(m->h1, 27) + m->h2;
+	m->h1 = m->h1 * 5 + 0x52dce729;
+
+	m->h2 ^= murmur3_mix_k2(from_le64(block + 8));
+	m->h2 = murmur3_rotl64(m->h2, 31) + m->h1;
+	m->h2 = m->h2 * 5 + 0x38495ab5;
+}
+
+static void
+murmur3_update(struct sw_accel_murmur3 *m, const uint8_t *buf, size_t len)
+{
+	size_t n;
+
+	m->len += len;
+	if (m->tail_len > 0) {
+		n = spdk_min(sizeof(m->tail) - m->tail_len, len);
+		memcpy(&m->tail[m->tail_len], buf, n);
+		m->tail_len += n;
+		buf += n;
+		len -= n;
+		if (m->tail_len < sizeof(m->tail)) {
+			return;
+		}
+		murmur3_block(m, m->tail);
+		m->tail_len = 0;
+	}
+
+	for (; len >= sizeof(m->tail); buf += sizeof(m->tail), len -= sizeof(m->tail)) {
+		murmur3_block(m, buf);
+	}
+
+	memcpy(m->tail, buf, len);
+	m->tail_len = len;
+}
+
+static void
+murmur3_final(struct sw_accel_murmur3 *m, uint8_t *digest)
+{
+	uint64_t k1 = 0, k2 = 0;
+	uint32_t i;
+
+	for (i = m->tail_len; i > 8; i--) {
+		k2 ^= (uint64_t)m->tail[i - 1] << ((i - 9) * 8);
+	}
+	for (i = spdk_min(m->tail_len, 8); i > 0; i--) {
+		k1 ^= (uint64_t)m->tail[i - 1] << ((i - 1) * 8);
+	}
+	if (m->tail_len > 8) {
+		m->h2 ^= murmur3_mix_k2(k2);
+	}
+	if (m->tail_len > 0) {
+		m->h1 ^= murmur3_mix_k1(k1);
+	}
+
+	m->h1 ^= m->len;
+	m->h2 ^= m->len;
+	m->h1 += m->h2;
+	m->h2 += m->h1;
+	m->h1 = murmur3_fmix64(m->h1);
+	m->h2 = murmur3_fmix64(m->h2);
+	m->h1 += m->h2;
+	m->h2 += m->h1;
+
+	to_le64(digest, m->h1);
+	to_le64(digest + 8, m->h2);
+}
+
+static int
+_sw_accel_murmur3_128(struct spdk_accel_task *accel_task)
+{
+	struct sw_accel_murmur3 m = {};
+	uint32_t i;
+
+	for (i = 0; i < accel_task->s.iovcnt; i++) {
+		murmur3_update(&m, accel_task->s.iovs[i].iov_base, accel_task->s.iovs[i].iov_len);
+	}
+	murmur3_final(&m, accel_task->digest);
+
+	return 0;
+}
+
+static int
+_sw_accel_hash(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *accel_task)
+{
+	switch (accel_task->hash.algo) {
+	case SPDK_ACCEL_HASH_ALGO_SHA256:
+#ifdef SPDK_CONFIG_ISAL_CRYPTO
+		/* SHA-256 tasks are handled by _sw_accel_sha256_mb() */
+		assert(0);
+		return -EINVAL;
+#else
+		return _sw_accel_sha256(sw_ch, accel_task);
+#endif
+	case SPDK_ACCEL_HASH_ALGO_MURMUR3_128:
+		return _sw_accel_murmur3_128(accel_task);
+	default:
+		assert(0);
+		return -EINVAL;
+	}
+}
+
+/* The gear table is generated with splitmix64 seeded with 0, so that the chunk boundaries never
+ * change between versions.
+ */
+static void
+sw_accel_cdc_init_gear(void)
+{
+	uint64_t x = 0, z;
+	int i;
+
+	for (i = 0; i < (int)SPDK_COUNTOF(g_sw_cdc_gear); i++) {
+		x += 0x9e3779b97f4a7c15ULL;
+		z = x;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		g_sw_cdc_gear[i] = z ^ (z >> 31);
+	}
+}
+
+/*
+ * FastCDC: a gear hash is rolled over the data starting min_size bytes into a chunk and a
+ * boundary is placed when its top bits are all zero.  Up to avg_size, log2(avg_size) + 2 bits are
+ * checked and past it log2(avg_size) - 2 bits, which narrows the distribution of chunk sizes
+ * around avg_size.  A chunk is cut unconditionally at max_size.
+ */
+static int
+_sw_accel_cdc(struct spdk_accel_task *accel_task)
+{
+	const struct spdk_accel_cdc_params *params = accel_task->cdc.params;
+	uint32_t bits = spdk_u32log2(params->avg_size);
+	uint64_t mask_s = UINT64_MAX << (64 - (bits + 2));
+	uint64_t mask_l = UINT64_MAX << (64 - (bits - 2));
+	uint64_t fp = 0;
+	uint32_t offset = 0, len = 0, num = 0, i, skip;
+	size_t pos, iov_len;
+	const uint8_t *buf;
+	bool cut;
+
+	for (i = 0; i < accel_task->s.iovcnt; i++) {
+		buf = accel_task->s.iovs[i].iov_base;
+		iov_len = accel_task->s.iovs[i].iov_len;
+		pos = 0;
+
+		while (pos < iov_len) {
+			if (len < params->min_size) {
+				/* No boundary can be placed before min_size, skip the bytes */
+				skip = spdk_min(params->min_size - len, iov_len - pos);
+				len += skip;
+				offset += skip;
+				pos += skip;
+				cut = len == params->max_size;
+			} else {
+				fp = (fp << 1) + g_sw_cdc_gear[buf[pos]];
+				len++;
+				offset++;
+				pos++;
+				cut = !(fp & (len <= params->avg_size ? mask_s : mask_l)) ||
+				      len == params->max_size;
+			}
+
+			if (cut) {
+				if (spdk_unlikely(num == accel_task->cdc.max_cut_points)) {
+					return -ENOSPC;
+				}
+				accel_task->cut_points[num++] = offset;
+				len = 0;
+				fp = 0;
+			}
+		}
+	}
+
+	if (len > 0) {
+		if (spdk_unlikely(num == accel_task->cdc.max_cut_points)) {
+			return -ENOSPC;
+		}
+		accel_task->cut_points[num++] = offset;
+	}
+
+	*accel_task->cdc.num_cut_points = num;
+
+	return 0;
+}
+
 static int
 accel_comp_poll(void *arg)
 {
@@ -705,6 +1323,9 @@ sw_accel_submit_tasks(struct spdk_io_channel *ch, struct spdk_accel_task *accel_
 {
 	struct sw_accel_io_channel *sw_ch = spdk_io_channel_get_ctx(ch);
 	struct spdk_accel_task *tmp;
+#ifdef SPDK_CONFIG_ISAL_CRYPTO
+	STAILQ_HEAD(, spdk_accel_task) sha256_tasks = STAILQ_HEAD_INITIALIZER(sha256_tasks);
+#endif
 	int rc = 0;
 
 	/*
@@ -716,6 +1337,8 @@ sw_accel_submit_tasks(struct spdk_io_channel *ch, struct spdk_accel_task *accel_
 	}
 
 	do {
+		tmp = STAILQ_NEXT(accel_task, link);
+
 		switch (accel_task->op_code) {
 		case SPDK_ACCEL_OPC_COPY:
 			_sw_accel_copy_iovs(accel_task->d.iovs, accel_task->d.iovcnt,
@@ -776,18 +1399,36 @@ sw_accel_submit_tasks(struct spdk_io_channel *ch, struct spdk_accel_task *accel_
 		case SPDK_ACCEL_OPC_DIX_VERIFY:
 			rc = _sw_accel_dix_verify(sw_ch, accel_task);
 			break;
+		case SPDK_ACCEL_OPC_HASH:
+#ifdef SPDK_CONFIG_ISAL_CRYPTO
+			if (accel_task->hash.algo == SPDK_ACCEL_HASH_ALGO_SHA256) {
+				/* Hashed together once all tasks have been gone through */
+				STAILQ_INSERT_TAIL(&sha256_tasks, accel_task, link);
+				accel_task = tmp;
+				continue;
+			}
+#endif
+			rc = _sw_accel_hash(sw_ch, accel_task);
+			break;
+		case SPDK_ACCEL_OPC_CDC:
+			rc = _sw_accel_cdc(accel_task);
+			break;
 		default:
 			assert(false);
 			break;
 		}
 
-		tmp = STAILQ_NEXT(accel_task, link);
-
 		_add_to_comp_list(sw_ch, accel_task, rc);
 
 		accel_task = tmp;
 	} while (accel_task);
 
+#ifdef SPDK_CONFIG_ISAL_CRYPTO
+	if (!STAILQ_EMPTY(&sha256_tasks)) {
+		_sw_accel_sha256_mb(sw_ch, &sha256_tasks);
+	}
+#endif
+
 	return 0;
 }
 
@@ -816,6 +1457,19 @@ sw_accel_create_cb(void *io_device, void *ctx_buf)
 		return -ENOMEM;
 	}
 #endif
+#ifdef SPDK_CONFIG_HAVE_ZSTD
+	sw_ch->zstd_cctx = ZSTD_createCCtx();
+	if (sw_ch->zstd_cctx == NULL) {
+		SPDK_ERRLOG("Failed to create the zstd context for compression\n");
+		goto err_zstd;
+	}
+	sw_ch->zstd_dctx = ZSTD_createDCtx();
+	if (sw_ch->zstd_dctx == NULL) {
+		SPDK_ERRLOG("Failed to create the zstd context for decompression\n");
+		ZSTD_freeCCtx(sw_ch->zstd_cctx);
+		goto err_zstd;
+	}
+#endif
 #ifdef SPDK_CONFIG_ISAL
 	sw_ch->deflate_level_bufs[0].buf = sw_ch->level_buf_mem;
 	deflate_level_bufs = sw_ch->deflate_level_bufs;
@@ -844,6 +1498,14 @@ sw_accel_create_cb(void *io_device, void *ctx_buf)
 #endif
 
 	return 0;
+#ifdef SPDK_CONFIG_HAVE_ZSTD
+err_zstd:
+#ifdef SPDK_CONFIG_HAVE_LZ4
+	LZ4_freeStream(sw_ch->lz4_stream);
+	LZ4_freeStreamDecode(sw_ch->lz4_stream_decode);
+#endif
+	return -ENOMEM;
+#endif
 }
 
 static void
@@ -854,6 +1516,16 @@ sw_accel_destroy_cb(void *io_device, void *ctx_buf)
 #ifdef SPDK_CONFIG_HAVE_LZ4
 	LZ4_freeStream(sw_ch->lz4_stream);
 	LZ4_freeStreamDecode(sw_ch->lz4_stream_decode);
+#endif
+#ifdef SPDK_CONFIG_HAVE_ZSTD
+	ZSTD_freeCCtx(sw_ch->zstd_cctx);
+	ZSTD_freeDCtx(sw_ch->zstd_dctx);
+#endif
+#ifdef SPDK_CONFIG_ISAL_CRYPTO
+	free(sw_ch->sha256_mgr);
+	free(sw_ch->sha256_jobs);
+#else
+	EVP_MD_CTX_free(sw_ch->sha256_ctx);
 #endif
 	spdk_poller_unregister(&sw_ch->completion_poller);
 }
@@ -873,6 +1545,7 @@ sw_accel_module_get_ctx_size(void)
 static int
 sw_accel_module_init(void)
 {
+	sw_accel_cdc_init_gear();
 	spdk_io_device_register(&g_sw_module, sw_accel_create_cb, sw_accel_destroy_cb,
 				sizeof(struct sw_accel_io_channel), "sw_accel_module");
 
@@ -891,6 +1564,7 @@ sw_accel_create_aes_xts(struct spdk_accel_crypto_key *key)
 {
 #ifdef SPDK_CONFIG_ISAL_CRYPTO
 	struct sw_accel_crypto_key_data *key_data;
+	int rc;
 
 	key_data = calloc(1, sizeof(*key_data));
 	if (!key_data) {
@@ -899,12 +1573,22 @@ sw_accel_create_aes_xts(struct spdk_accel_crypto_key *key)
 
 	switch (key->key_size) {
 	case SPDK_ACCEL_AES_XTS_128_KEY_SIZE:
-		key_data->encrypt = isal_aes_xts_enc_128;
-		key_data->decrypt = isal_aes_xts_dec_128;
+		rc = isal_aes_keyexp_128((uint8_t *)key->key, key_data->key_enc, key_data->key_dec);
+		if (rc == ISAL_CRYPTO_ERR_NONE) {
+			rc = isal_aes_keyexp_128((uint8_t *)key->key2, key_data->key2_enc,
+						 key_data->key2_dec);
+		}
+		key_data->encrypt = isal_aes_xts_enc_128_expanded_key;
+		key_data->decrypt = isal_aes_xts_dec_128_expanded_key;
 		break;
 	case SPDK_ACCEL_AES_XTS_256_KEY_SIZE:
-		key_data->encrypt = isal_aes_xts_enc_256;
-		key_data->decrypt = isal_aes_xts_dec_256;
+		rc = isal_aes_keyexp_256((uint8_t *)key->key, key_data->key_enc, key_data->key_dec);
+		if (rc == ISAL_CRYPTO_ERR_NONE) {
+			rc = isal_aes_keyexp_256((uint8_t *)key->key2, key_data->key2_enc,
+						 key_data->key2_dec);
+		}
+		key_data->encrypt = isal_aes_xts_enc_256_expanded_key;
+		key_data->decrypt = isal_aes_xts_dec_256_expanded_key;
 		break;
 	default:
 		assert(0);
@@ -912,6 +1596,13 @@ sw_accel_create_aes_xts(struct spdk_accel_crypto_key *key)
 		return -EINVAL;
 	}
 
+	if (rc != ISAL_CRYPTO_ERR_NONE) {
+		SPDK_ERRLOG("Failed to expand the key: %d\n", rc);
+		spdk_memset_s(key_data, sizeof(*key_data), 0, sizeof(*key_data));
+		free(key_data);
+		return -EINVAL;
+	}
+
 	key->priv = key_data;
 
 	return 0;
@@ -929,11 +1620,15 @@ sw_accel_crypto_key_init(struct spdk_accel_crypto_key *key)
 static void
 sw_accel_crypto_key_deinit(struct spdk_accel_crypto_key *key)
 {
+	struct sw_accel_crypto_key_data *key_data;
+
 	if (!key || key->module_if != &g_sw_module || !key->priv) {
 		return;
 	}
 
-	free(key->priv);
+	key_data = key->priv;
+	spdk_memset_s(key_data, sizeof(*key_data), 0, sizeof(*key_data));
+	free(key_data);
 }
 
 static bool
@@ -960,6 +1655,9 @@ sw_accel_compress_supports_algo(enum spdk_accel_comp_algo algo)
 	case SPDK_ACCEL_COMP_ALGO_DEFLATE:
 #ifdef SPDK_CONFIG_HAVE_LZ4
 	case SPDK_ACCEL_COMP_ALGO_LZ4:
+#endif
+#ifdef SPDK_CONFIG_HAVE_ZSTD
+	case SPDK_ACCEL_COMP_ALGO_ZSTD:
 #endif
 		return true;
 	default:
@@ -967,6 +1665,18 @@ sw_accel_compress_supports_algo(enum spdk_accel_comp_algo algo)
 	}
 }
 
+static bool
+sw_accel_hash_supports_algo(enum spdk_accel_hash_algo algo)
+{
+	switch (algo) {
+	case SPDK_ACCEL_HASH_ALGO_SHA256:
+	case SPDK_ACCEL_HASH_ALGO_MURMUR3_128:
+		return true;
+	default:
+		return false;
+	}
+}
+
 static int
 sw_accel_get_compress_level_range(enum spdk_accel_comp_algo algo,
 				  uint32_t *min_level, uint32_t *max_level)
@@ -989,6 +1699,16 @@ sw_accel_get_compress_level_range(enum spdk_accel_comp_algo algo,
 #else
 		SPDK_ERRLOG("LZ4 library is required to use software compression.\n");
 		return -EINVAL;
+#endif
+	case SPDK_ACCEL_COMP_ALGO_ZSTD:
+#ifdef SPDK_CONFIG_HAVE_ZSTD
+		/* Negative (fast) levels can't be expressed with an unsigned level */
+		*min_level = 1;
+		*max_level = ZSTD_maxCLevel();
+		return 0;
+#else
+		SPDK_ERRLOG("zstd library is required to use software compression.\n");
+		return -EINVAL;
 #endif
 	default:
 		return -EINVAL;
@@ -1015,11 +1735,13 @@ static struct spdk_accel_module_if g_sw_module = {
 	.supports_opcode		= sw_accel_supports_opcode,
 	.get_io_channel			= sw_accel_get_io_channel,
 	.submit_tasks			= sw_accel_submit_tasks,
+	.supports_task_list		= true,
 	.crypto_key_init		= sw_accel_crypto_key_init,
 	.crypto_key_deinit		= sw_accel_crypto_key_deinit,
 	.crypto_supports_tweak_mode	= sw_accel_crypto_supports_tweak_mode,
 	.crypto_supports_cipher		= sw_accel_crypto_supports_cipher,
 	.compress_supports_algo         = sw_accel_compress_supports_algo,
+	.hash_supports_algo		= sw_accel_hash_supports_algo,
 	.get_compress_level_range       = sw_accel_get_compress_level_range,
 	.get_operation_info		= sw_accel_get_operation_info,
 };
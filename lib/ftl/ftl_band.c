@@ -114,6 +114,7 @@ _ftl_band_set_closed_cb(struct ftl_band *band, bool valid)
 	assert(band->p2l_map.ref_cnt == 0);
 
 	TAILQ_INSERT_TAIL(&dev->shut_bands, band, queue_entry);
+	ftl_band_gc_index_update(band);
 }
 
 static void
@@ -189,6 +190,7 @@ ftl_band_set_state(struct ftl_band *band, enum ftl_band_state state)
 	}
 
 	band->md->state = state;
+	ftl_band_gc_index_update(band);
 }
 
 void
@@ -196,6 +198,7 @@ ftl_band_set_type(struct ftl_band *band, enum ftl_band_type type)
 {
 	switch (type) {
 	case FTL_BAND_TYPE_COMPACTION:
+	case FTL_BAND_TYPE_COMPACTION_HOT:
 	case FTL_BAND_TYPE_GC:
 		band->md->type = type;
 		break;
@@ -487,34 +490,6 @@ is_band_relocateable(struct ftl_band *band)
 	return true;
 }
 
-static void
-get_band_phys_info(struct spdk_ftl_dev *dev, uint64_t phys_id,
-		   double *invalidity, double *wr_cnt)
-{
-	struct ftl_band *band;
-	uint64_t band_id = phys_id * dev->num_logical_bands_in_physical;
-
-	*wr_cnt = *invalidity = 0.0L;
-	for (; band_id < ftl_get_num_bands(dev); band_id++) {
-		band = &dev->bands[band_id];
-
-		if (phys_id != band->phys_id) {
-			break;
-		}
-
-		*wr_cnt += band->md->wr_cnt;
-
-		if (!is_band_relocateable(band)) {
-			continue;
-		}
-
-		*invalidity += ftl_band_invalidity(band);
-	}
-
-	*invalidity /= dev->num_logical_bands_in_physical;
-	*wr_cnt /= dev->num_logical_bands_in_physical;
-}
-
 static bool
 band_cmp(double a_invalidity, double a_wr_cnt,
 	 double b_invalidity, double b_wr_cnt,
@@ -543,6 +518,202 @@ band_cmp(double a_invalidity, double a_wr_cnt,
 	return a_id < b_id;
 }
 
+static uint64_t
+gc_index_phys_id(struct spdk_ftl_dev *dev, const struct ftl_band_phys *phys)
+{
+	return phys - dev->gc_index.phys;
+}
+
+static uint64_t
+gc_index_phys_num_blocks(struct spdk_ftl_dev *dev)
+{
+	return ftl_band_user_blocks(dev->bands) * dev->num_logical_bands_in_physical;
+}
+
+static double
+gc_index_phys_invalidity(struct spdk_ftl_dev *dev, const struct ftl_band_phys *phys)
+{
+	return (double)phys->num_invalid / gc_index_phys_num_blocks(dev);
+}
+
+static void
+gc_index_place(struct spdk_ftl_dev *dev, struct ftl_band_phys *phys)
+{
+	uint32_t bucket = FTL_BAND_GC_BUCKETS;
+
+	if (phys->num_invalid != 0) {
+		bucket = spdk_min(phys->num_invalid * FTL_BAND_GC_BUCKETS / gc_index_phys_num_blocks(dev),
+				  FTL_BAND_GC_BUCKETS - 1);
+	}
+
+	if (bucket == phys->bucket) {
+		return;
+	}
+
+	if (phys->bucket < FTL_BAND_GC_BUCKETS) {
+		TAILQ_REMOVE(&dev->gc_index.buckets[phys->bucket], phys, bucket_entry);
+	}
+	if (bucket < FTL_BAND_GC_BUCKETS) {
+		TAILQ_INSERT_TAIL(&dev->gc_index.buckets[bucket], phys, bucket_entry);
+	}
+	phys->bucket = bucket;
+}
+
+void
+ftl_band_gc_index_update(struct ftl_band *band)
+{
+	struct spdk_ftl_dev *dev = band->dev;
+	struct ftl_band_phys *phys;
+	uint64_t band_id, end;
+
+	/* The index is built once all bands are loaded, see ftl_band_gc_index_init() */
+	if (dev->gc_index.phys == NULL) {
+		return;
+	}
+
+	assert(band->phys_id < dev->gc_index.num_phys);
+	phys = &dev->gc_index.phys[band->phys_id];
+	phys->num_invalid = 0;
+	phys->wr_cnt = 0;
+	phys->close_seq_id = 0;
+
+	band_id = band->phys_id * dev->num_logical_bands_in_physical;
+	end = band_id + dev->num_logical_bands_in_physical;
+	for (; band_id < end; band_id++) {
+		band = &dev->bands[band_id];
+		assert(gc_index_phys_id(dev, phys) == band->phys_id);
+
+		phys->wr_cnt += band->md->wr_cnt;
+
+		if (!is_band_relocateable(band)) {
+			continue;
+		}
+
+		phys->num_invalid += ftl_band_user_blocks(band) - band->p2l_map.num_valid;
+		phys->close_seq_id = spdk_max(phys->close_seq_id, band->md->close_seq_id);
+	}
+
+	gc_index_place(dev, phys);
+}
+
+void
+ftl_band_gc_index_invalidate(struct ftl_band *band)
+{
+	struct spdk_ftl_dev *dev = band->dev;
+	struct ftl_band_phys *phys;
+
+	if (dev->gc_index.phys == NULL || !is_band_relocateable(band)) {
+		return;
+	}
+
+	phys = &dev->gc_index.phys[band->phys_id];
+	phys->num_invalid++;
+	gc_index_place(dev, phys);
+}
+
+int
+ftl_band_gc_index_init(struct spdk_ftl_dev *dev)
+{
+	uint64_t i;
+
+	ftl_band_gc_index_fini(dev);
+
+	for (i = 0; i < FTL_BAND_GC_BUCKETS; i++) {
+		TAILQ_INIT(&dev->gc_index.buckets[i]);
+	}
+
+	dev->gc_index.num_phys = ftl_get_num_bands(dev) / dev->num_logical_bands_in_physical;
+	dev->gc_index.phys = calloc(dev->gc_index.num_phys, sizeof(*dev->gc_index.phys));
+	if (!dev->gc_index.phys) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < dev->gc_index.num_phys; i++) {
+		dev->gc_index.phys[i].bucket = FTL_BAND_GC_BUCKETS;
+		ftl_band_gc_index_update(&dev->bands[i * dev->num_logical_bands_in_physical]);
+	}
+
+	return 0;
+}
+
+void
+ftl_band_gc_index_fini(struct spdk_ftl_dev *dev)
+{
+	free(dev->gc_index.phys);
+	dev->gc_index.phys = NULL;
+	dev->gc_index.num_phys = 0;
+}
+
+static struct ftl_band_phys *
+gc_index_search_greedy(struct spdk_ftl_dev *dev)
+{
+	struct ftl_band_phys *phys, *best = NULL;
+	double invalidity, best_invalidity = 0.0L;
+	int bucket;
+
+	for (bucket = FTL_BAND_GC_BUCKETS - 1; bucket >= 0; bucket--) {
+		/* Bands more than 10% points less invalid than the best one can't win band_cmp() */
+		if (best != NULL &&
+		    (double)(bucket + 1) / FTL_BAND_GC_BUCKETS < best_invalidity - 0.1L) {
+			break;
+		}
+
+		TAILQ_FOREACH(phys, &dev->gc_index.buckets[bucket], bucket_entry) {
+			invalidity = gc_index_phys_invalidity(dev, phys);
+			if (best == NULL ||
+			    band_cmp(invalidity, phys->wr_cnt, best_invalidity, best->wr_cnt,
+				     gc_index_phys_id(dev, phys), gc_index_phys_id(dev, best))) {
+				best = phys;
+				best_invalidity = invalidity;
+			}
+		}
+	}
+
+	return best;
+}
+
+static double
+gc_cost_benefit(double invalidity, uint64_t age)
+{
+	/* Space reclaimed, weighted by how long the data stayed cold, per block that needs moving */
+	return invalidity * age / (1.0L - invalidity);
+}
+
+static struct ftl_band_phys *
+gc_index_search_cost_benefit(struct spdk_ftl_dev *dev)
+{
+	struct ftl_band_phys *phys, *best = NULL;
+	uint64_t seq_id = dev->sb->seq_id, age;
+	double invalidity, score, best_score = 0.0L;
+	int bucket;
+
+	for (bucket = FTL_BAND_GC_BUCKETS - 1; bucket >= 0; bucket--) {
+		/* Nothing in this bucket can beat the best band, even if it's the oldest one */
+		if (best != NULL && bucket + 1 < FTL_BAND_GC_BUCKETS &&
+		    gc_cost_benefit((double)(bucket + 1) / FTL_BAND_GC_BUCKETS, seq_id + 1) < best_score) {
+			break;
+		}
+
+		TAILQ_FOREACH(phys, &dev->gc_index.buckets[bucket], bucket_entry) {
+			if (phys->num_invalid == gc_index_phys_num_blocks(dev)) {
+				/* Nothing to move, no need to look any further */
+				return phys;
+			}
+
+			invalidity = gc_index_phys_invalidity(dev, phys);
+			age = seq_id - spdk_min(phys->close_seq_id, seq_id) + 1;
+			score = gc_cost_benefit(invalidity, age);
+			if (best == NULL || score > best_score ||
+			    (score == best_score && phys->wr_cnt < best->wr_cnt)) {
+				best = phys;
+				best_score = score;
+			}
+		}
+	}
+
+	return best;
+}
+
 static void
 band_start_gc(struct spdk_ftl_dev *dev, struct ftl_band *band)
 {
@@ -550,6 +721,7 @@ band_start_gc(struct spdk_ftl_dev *dev, struct ftl_band *band)
 
 	TAILQ_REMOVE(&dev->shut_bands, band, queue_entry);
 	band->reloc = true;
+	ftl_band_gc_index_update(band);
 
 	FTL_DEBUGLOG(dev, "Band to GC, id %u\n", band->id);
 }
@@ -588,11 +760,10 @@ ftl_band_reset_gc_iter(struct spdk_ftl_dev *dev)
 struct ftl_band *
 ftl_band_search_next_to_reloc(struct spdk_ftl_dev *dev)
 {
-	double invalidity, max_invalidity = 0.0L;
-	double wr_cnt, max_wr_cnt = 0.0L;
 	uint64_t phys_id = FTL_BAND_PHYS_ID_INVALID;
+	struct ftl_band_phys *phys;
 	struct ftl_band *band;
-	uint64_t i, band_count;
+	uint64_t band_count;
 	uint64_t phys_count;
 
 	band = gc_high_priority_band(dev);
@@ -618,24 +789,19 @@ ftl_band_search_next_to_reloc(struct spdk_ftl_dev *dev)
 		return band;
 	}
 
-	for (i = 0; i < band_count; i += phys_count) {
-		band = &dev->bands[i];
-
-		/* Calculate entire band physical group invalidity */
-		get_band_phys_info(dev, band->phys_id, &invalidity, &wr_cnt);
-
-		if (invalidity != 0.0L) {
-			if (phys_id == FTL_BAND_PHYS_ID_INVALID ||
-			    band_cmp(invalidity, wr_cnt, max_invalidity, max_wr_cnt,
-				     band->phys_id, phys_id)) {
-				max_wr_cnt = wr_cnt;
-				phys_id = band->phys_id;
+	assert(dev->gc_index.phys != NULL);
+	switch (dev->conf.gc_policy) {
+	case SPDK_FTL_GC_POLICY_COST_BENEFIT:
+		phys = gc_index_search_cost_benefit(dev);
+		break;
+	case SPDK_FTL_GC_POLICY_GREEDY:
+	default:
+		phys = gc_index_search_greedy(dev);
+		break;
+	}
 
-				if (invalidity > max_invalidity) {
-					max_invalidity = invalidity;
-				}
-			}
-		}
+	if (phys != NULL) {
+		phys_id = gc_index_phys_id(dev, phys);
 	}
 
 	if (FTL_BAND_PHYS_ID_INVALID != phys_id) {
@@ -95,6 +95,23 @@ SPDK_STATIC_ASSERT(sizeof(struct ftl_band_md) == FTL_BLOCK_SIZE, "Incorrect band
 SPDK_STATIC_ASSERT(offsetof(struct ftl_band_md, version) == 0,
 		   "Incorrect band metadata version offset");
 
+/* GC state of a group of logical bands sharing the same physical band */
+struct ftl_band_phys {
+	/* Number of invalid user blocks in the group's relocatable bands */
+	uint64_t				num_invalid;
+
+	/* Sum of the write counts of the group's bands */
+	uint64_t				wr_cnt;
+
+	/* Sequence ID of the most recently closed relocatable band */
+	uint64_t				close_seq_id;
+
+	/* Index of the bucket the group is in, FTL_BAND_GC_BUCKETS if it has nothing to relocate */
+	uint32_t				bucket;
+
+	TAILQ_ENTRY(ftl_band_phys)		bucket_entry;
+};
+
 struct ftl_band {
 	/* Device this band belongs to */
 	struct spdk_ftl_dev		*dev;
@@ -197,6 +214,10 @@ void ftl_band_get_next_gc(struct spdk_ftl_dev *dev, ftl_band_ops_cb cb, void *cn
 void ftl_band_read_tail_brq_md(struct ftl_band *band, ftl_band_md_cb cb, void *cntx);
 void ftl_band_initialize_free_state(struct ftl_band *band);
 double ftl_band_invalidity(struct ftl_band *band);
+int ftl_band_gc_index_init(struct spdk_ftl_dev *dev);
+void ftl_band_gc_index_fini(struct spdk_ftl_dev *dev);
+void ftl_band_gc_index_update(struct ftl_band *band);
+void ftl_band_gc_index_invalidate(struct ftl_band *band);
 
 static inline void
 ftl_band_set_owner(struct ftl_band *band,
@@ -78,9 +78,11 @@ ftl_shutdown_complete(struct spdk_ftl_dev *dev)
 		return false;
 	}
 
-	if (!ftl_writer_is_halted(&dev->writer_user)) {
-		ftl_writer_halt(&dev->writer_user);
-		return false;
+	for (i = 0; i < FTL_STREAM_COUNT; ++i) {
+		if (!ftl_writer_is_halted(&dev->writer_user[i])) {
+			ftl_writer_halt(&dev->writer_user[i]);
+			return false;
+		}
 	}
 
 	if (!ftl_reloc_is_halted(dev->reloc)) {
@@ -155,6 +157,7 @@ ftl_invalidate_addr(struct spdk_ftl_dev *dev, ftl_addr addr)
 		assert(p2l_map->num_valid > 0);
 		ftl_bitmap_clear(dev->valid_map, addr);
 		p2l_map->num_valid--;
+		ftl_band_gc_index_invalidate(band);
 	}
 
 	/* Invalidate open/full band p2l_map entry to keep p2l and l2p
@@ -359,6 +362,9 @@ start_io(struct ftl_io *io)
 		TAILQ_INSERT_TAIL(&dev->rd_sq, io, queue_entry);
 		break;
 	case FTL_IO_WRITE:
+		ftl_heat_update(dev->heat, io->lba, io->num_blocks);
+		io->stream = ftl_heat_is_hot(dev->heat, io->lba, io->num_blocks) ?
+			     FTL_STREAM_HOT : FTL_STREAM_COLD;
 		TAILQ_INSERT_TAIL(&dev->wr_sq, io, queue_entry);
 		break;
 	case FTL_IO_TRIM:
@@ -745,6 +751,7 @@ ftl_core_poller(void *ctx)
 {
 	struct spdk_ftl_dev *dev = ctx;
 	uint64_t io_activity_total_old = dev->stats.io_activity_total;
+	int i;
 
 	if (dev->halt && ftl_shutdown_complete(dev)) {
 		spdk_poller_unregister(&dev->core_poller);
@@ -752,7 +759,9 @@ ftl_core_poller(void *ctx)
 	}
 
 	ftl_process_io_queue(dev);
-	ftl_writer_run(&dev->writer_user);
+	for (i = 0; i < FTL_STREAM_COUNT; ++i) {
+		ftl_writer_run(&dev->writer_user[i]);
+	}
 	ftl_writer_run(&dev->writer_gc);
 	ftl_reloc(dev->reloc);
 	ftl_nv_cache_process(dev);
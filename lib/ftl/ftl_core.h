@@ -25,6 +25,7 @@
 #include "ftl_l2p.h"
 #include "base/ftl_base_dev.h"
 #include "utils/ftl_bitmap.h"
+#include "utils/ftl_heat.h"
 #include "utils/ftl_log.h"
 #include "utils/ftl_property.h"
 
@@ -41,7 +42,11 @@
 extern void *g_ftl_write_buf;
 extern void *g_ftl_read_buf;
 
+/* Number of buckets GC candidates are kept in, by the invalidity of their physical band */
+#define FTL_BAND_GC_BUCKETS 64
+
 struct ftl_layout_tracker_bdev;
+struct ftl_band_phys;
 
 struct spdk_ftl_dev {
 	/* Configuration */
@@ -115,6 +120,18 @@ struct spdk_ftl_dev {
 	/* Closed bands list */
 	TAILQ_HEAD(, ftl_band)		shut_bands;
 
+	/* GC victim index */
+	struct {
+		/* GC state of each physical band */
+		struct ftl_band_phys		*phys;
+
+		/* Number of physical bands */
+		uint64_t			num_phys;
+
+		/* Physical bands with data to relocate, bucketed by their invalidity */
+		TAILQ_HEAD(, ftl_band_phys)	buckets[FTL_BAND_GC_BUCKETS];
+	} gc_index;
+
 	/* Number of free bands */
 	uint64_t			num_free;
 
@@ -175,8 +192,11 @@ struct spdk_ftl_dev {
 	bool				trim_in_progress;
 	struct ftl_md_io_entry_ctx	trim_md_io_entry_ctx;
 
-	/* Writer for user IOs */
-	struct ftl_writer		writer_user;
+	/* Writers for user IOs, one per stream */
+	struct ftl_writer		writer_user[FTL_STREAM_COUNT];
+
+	/* Update frequency of LBA ranges, used to pick the stream of user writes */
+	struct ftl_heat			*heat;
 
 	/* Writer for GC IOs */
 	struct ftl_writer		writer_gc;
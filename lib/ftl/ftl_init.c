@@ -125,7 +125,10 @@ allocate_dev(const struct spdk_ftl_conf *conf, int *error)
 	TAILQ_INIT(&dev->trim_sq);
 	TAILQ_INIT(&dev->ioch_queue);
 
-	ftl_writer_init(dev, &dev->writer_user, SPDK_FTL_LIMIT_HIGH, FTL_BAND_TYPE_COMPACTION);
+	ftl_writer_init(dev, &dev->writer_user[FTL_STREAM_COLD], SPDK_FTL_LIMIT_HIGH,
+			FTL_BAND_TYPE_COMPACTION);
+	ftl_writer_init(dev, &dev->writer_user[FTL_STREAM_HOT], SPDK_FTL_LIMIT_HIGH,
+			FTL_BAND_TYPE_COMPACTION_HOT);
 	ftl_writer_init(dev, &dev->writer_gc, SPDK_FTL_LIMIT_CRIT, FTL_BAND_TYPE_GC);
 
 	return dev;
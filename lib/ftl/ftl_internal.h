@@ -48,7 +48,17 @@ enum ftl_md_type {
 
 enum ftl_band_type {
 	FTL_BAND_TYPE_GC = 1,
-	FTL_BAND_TYPE_COMPACTION
+	FTL_BAND_TYPE_COMPACTION,
+	FTL_BAND_TYPE_COMPACTION_HOT
+};
+
+/* Streams user data is separated into by update frequency */
+enum ftl_stream {
+	/* Rarely updated data, also data of unknown temperature */
+	FTL_STREAM_COLD,
+	/* Frequently updated data */
+	FTL_STREAM_HOT,
+	FTL_STREAM_COUNT
 };
 
 enum ftl_md_status {
@@ -122,6 +122,9 @@ struct ftl_io {
 	/* Reference to the chunk within NV cache */
 	struct ftl_nv_cache_chunk	*nv_cache_chunk;
 
+	/* Stream the write is placed in */
+	enum ftl_stream			stream;
+
 	/* For l2p pinning */
 	struct ftl_l2p_pin_ctx		l2p_pin_ctx;
 
@@ -20,6 +20,7 @@
 #include "mngt/ftl_mngt_steps.h"
 #include "utils/ftl_defs.h"
 #include "utils/ftl_addr_utils.h"
+#include "utils/ftl_l2p_extent.h"
 
 struct ftl_l2p_cache_page_io_ctx {
 	struct ftl_l2p_cache *cache;
@@ -28,6 +29,48 @@ struct ftl_l2p_cache_page_io_ctx {
 	struct spdk_bdev_io_wait_entry bdev_io_wait;
 };
 
+/*
+ * The cache uses a 2Q-like replacement policy. Pages read from disk start on the probation
+ * list and are evicted from it first, so a single scan through the L2P can't flush the working
+ * set. Pages faulted in again shortly after being evicted from probation (tracked by the ghost
+ * list of recently evicted page numbers) are placed on the protected list.
+ */
+enum ftl_l2p_page_lru {
+	L2P_CACHE_LRU_PROBATION,
+	L2P_CACHE_LRU_PROTECTED,
+	L2P_CACHE_LRU_COUNT
+};
+
+/* Percentage of resident pages kept on the probation list before protected pages are evicted */
+#define FTL_L2P_CACHE_PROBATION_RATIO		25
+/* Percentage of resident pages remembered on the ghost list after eviction */
+#define FTL_L2P_CACHE_GHOST_RATIO		50
+
+/* Maximum number of pages read by a single page in IO */
+#define FTL_L2P_CACHE_PAGE_IN_BATCH		8
+#define FTL_L2P_CACHE_PAGE_IN_BATCH_POOL	128
+
+/* Number of tracked sequential streams */
+#define FTL_L2P_CACHE_PREFETCH_STREAMS		8
+/* Number of consecutive pages a stream must access before read ahead starts */
+#define FTL_L2P_CACHE_PREFETCH_TRIGGER		2
+/* Number of pages read ahead of a sequential stream */
+#define FTL_L2P_CACHE_PREFETCH_DEPTH		FTL_L2P_CACHE_PAGE_IN_BATCH
+/* Read ahead is issued only below this number of page in IOs */
+#define FTL_L2P_CACHE_PREFETCH_MAX_QD		256
+
+/*
+ * Clean pages evicted from the cache are kept in memory encoded into extents, if they fit into
+ * a small slot. Slots are carved out of cache pages (slabs), so the same memory limit covers many
+ * more L2P pages of sequentially written regions. Encoded pages are decoded back into regular
+ * pages when pinned, without reading them from the disk.
+ */
+#define FTL_L2P_CACHE_ZPAGE_SIZE		256
+#define FTL_L2P_CACHE_ZPAGES_PER_SLAB		(FTL_BLOCK_SIZE / FTL_L2P_CACHE_ZPAGE_SIZE)
+/* Maximum percentage of resident pages used as slabs */
+#define FTL_L2P_CACHE_ZPAGE_RATIO		50
+#define FTL_L2P_CACHE_ZPAGE_NONE		UINT32_MAX
+
 enum ftl_l2p_page_state {
 	L2P_CACHE_PAGE_INIT,		/* Page in memory not initialized from disk page */
 	L2P_CACHE_PAGE_READY,		/* Page initialized from disk */
@@ -46,6 +89,8 @@ struct ftl_l2p_page {
 	uint64_t pin_ref_cnt;
 	struct ftl_l2p_cache_page_io_ctx ctx;
 	bool on_lru_list;
+	uint8_t lru; /* Rank list of the page, see enum ftl_l2p_page_lru */
+	bool prefetched; /* Page read ahead and not pinned since */
 	void *page_buffer;
 	uint64_t ckpt_seq_id;
 	ftl_df_obj_id obj_id;
@@ -80,6 +125,35 @@ struct ftl_l2p_page_set {
 	struct ftl_l2p_page_wait_ctx entry[L2P_MAX_PAGES_TO_PIN];
 };
 
+struct ftl_l2p_page_in_batch {
+	struct ftl_l2p_cache *cache;
+	uint64_t num_pages;
+	struct ftl_l2p_page *pages[FTL_L2P_CACHE_PAGE_IN_BATCH];
+	struct iovec iov[FTL_L2P_CACHE_PAGE_IN_BATCH];
+	struct spdk_bdev_io_wait_entry bdev_io_wait;
+};
+
+struct ftl_l2p_zslab {
+	/* Cache page providing memory of the slots, NULL if the slab isn't allocated */
+	struct ftl_l2p_page *page;
+	/* L2P page stored in each slot, UINT64_MAX if the slot is free */
+	uint64_t page_no[FTL_L2P_CACHE_ZPAGES_PER_SLAB];
+	uint32_t used;
+	bool on_free_list;
+	TAILQ_ENTRY(ftl_l2p_zslab) free_entry;
+};
+
+struct ftl_l2p_cache_stream {
+	/* Last page accessed by the stream */
+	uint64_t last_page;
+	/* Number of pages accessed sequentially */
+	uint64_t run;
+	/* Next page to be read ahead */
+	uint64_t prefetch_page;
+	/* Time of the last access */
+	uint64_t tick;
+};
+
 struct ftl_l2p_l1_map_entry {
 	ftl_df_obj_id page_obj_id;
 };
@@ -107,7 +181,40 @@ struct ftl_l2p_cache {
 	struct ftl_mempool *l2_ctx_pool;
 	struct ftl_md *l1_md;
 
-	TAILQ_HEAD(l2p_lru_list, ftl_l2p_page) lru_list;
+	TAILQ_HEAD(l2p_lru_list, ftl_l2p_page) lru_list[L2P_CACHE_LRU_COUNT];
+	uint32_t lru_count[L2P_CACHE_LRU_COUNT];
+	uint32_t probation_max;
+
+	/* Pages recently evicted from the probation list */
+	struct {
+		struct ftl_bitmap *bitmap;
+		void *bitmap_buf;
+		uint64_t *pages;
+		uint64_t size;
+		uint64_t pos;
+	} ghost;
+
+	/* Pages encoded into extents */
+	struct {
+		struct ftl_l2p_zslab *slabs;
+		uint32_t max_slabs;
+		uint32_t num_slabs;
+		/* IDs of slabs not allocated */
+		uint32_t *free_ids;
+		/* Slot of each L2P page, FTL_L2P_CACHE_ZPAGE_NONE if not encoded */
+		uint32_t *slot;
+		/* Slabs with free slots */
+		TAILQ_HEAD(, ftl_l2p_zslab) free_list;
+		/* Next slot to be reused when no slot is free */
+		uint64_t hand;
+	} zpages;
+
+	/* Sequential access detection for read ahead */
+	struct {
+		struct ftl_l2p_cache_stream stream[FTL_L2P_CACHE_PREFETCH_STREAMS];
+		uint64_t tick;
+	} prefetch;
+
 	/* TODO: A lot of / and % operations are done on this value, consider adding a shift based field and calculactions instead */
 	uint64_t lbas_in_page;
 	uint64_t num_pages;		/* num pages to hold the entire L2P */
@@ -119,6 +226,7 @@ struct ftl_l2p_cache {
 	uint32_t l2_pgs_resident_max;
 	uint32_t evict_keep;
 	struct ftl_mempool *page_sets_pool;
+	struct ftl_mempool *page_in_batch_pool;
 	TAILQ_HEAD(, ftl_l2p_page_set) deferred_page_set_list; /* for deferred page sets */
 
 	/* Process trim in background */
@@ -155,6 +263,7 @@ static void page_set_end(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
 			 struct ftl_l2p_page_set *page_set);
 static void page_out_io_retry(void *arg);
 static void page_in_io_retry(void *arg);
+static void page_in_batch_io_retry(void *arg);
 
 static inline void
 ftl_l2p_page_queue_wait_ctx(struct ftl_l2p_page *page,
@@ -187,7 +296,8 @@ ftl_l2p_cache_lru_remove_page(struct ftl_l2p_cache *cache, struct ftl_l2p_page *
 	assert(page);
 	assert(page->on_lru_list);
 
-	TAILQ_REMOVE(&cache->lru_list, page, list_entry);
+	TAILQ_REMOVE(&cache->lru_list[page->lru], page, list_entry);
+	cache->lru_count[page->lru]--;
 	page->on_lru_list = false;
 }
 
@@ -197,7 +307,8 @@ ftl_l2p_cache_lru_add_page(struct ftl_l2p_cache *cache, struct ftl_l2p_page *pag
 	assert(page);
 	assert(!page->on_lru_list);
 
-	TAILQ_INSERT_HEAD(&cache->lru_list, page, list_entry);
+	TAILQ_INSERT_HEAD(&cache->lru_list[page->lru], page, list_entry);
+	cache->lru_count[page->lru]++;
 
 	page->on_lru_list = true;
 }
@@ -223,23 +334,252 @@ ftl_l2p_cache_page_insert(struct ftl_l2p_cache *cache, struct ftl_l2p_page *page
 	me[page->page_no].page_obj_id = page->obj_id;
 }
 
+static inline bool
+ftl_l2p_cache_running(struct ftl_l2p_cache *cache)
+{
+	return cache->state == L2P_CACHE_RUNNING;
+}
+
+static void
+ftl_l2p_cache_ghost_add(struct ftl_l2p_cache *cache, uint64_t page_no)
+{
+	uint64_t *slot = &cache->ghost.pages[cache->ghost.pos];
+
+	if (*slot != UINT64_MAX) {
+		ftl_bitmap_clear(cache->ghost.bitmap, *slot);
+	}
+
+	*slot = page_no;
+	ftl_bitmap_set(cache->ghost.bitmap, page_no);
+	cache->ghost.pos = (cache->ghost.pos + 1) % cache->ghost.size;
+}
+
+static void
+ftl_l2p_cache_ghost_hit(struct ftl_l2p_cache *cache, struct ftl_l2p_page *page)
+{
+	if (ftl_bitmap_get(cache->ghost.bitmap, page->page_no)) {
+		/* The page was referenced again soon after its eviction, protect it */
+		ftl_bitmap_clear(cache->ghost.bitmap, page->page_no);
+		page->lru = L2P_CACHE_LRU_PROTECTED;
+	}
+}
+
+static struct ftl_l2p_page *ftl_l2p_cache_page_alloc(struct ftl_l2p_cache *cache,
+		size_t page_no);
+
+static inline void *
+zpage_slot_buffer(struct ftl_l2p_cache *cache, uint32_t slot)
+{
+	struct ftl_l2p_zslab *slab = &cache->zpages.slabs[slot / FTL_L2P_CACHE_ZPAGES_PER_SLAB];
+
+	assert(slab->page);
+	return (char *)slab->page->page_buffer +
+	       (slot % FTL_L2P_CACHE_ZPAGES_PER_SLAB) * FTL_L2P_CACHE_ZPAGE_SIZE;
+}
+
+static void
+zpage_slot_release(struct ftl_l2p_cache *cache, uint32_t slot)
+{
+	uint32_t slab_id = slot / FTL_L2P_CACHE_ZPAGES_PER_SLAB;
+	struct ftl_l2p_zslab *slab = &cache->zpages.slabs[slab_id];
+	uint64_t *page_no = &slab->page_no[slot % FTL_L2P_CACHE_ZPAGES_PER_SLAB];
+
+	assert(*page_no != UINT64_MAX);
+	assert(slab->used);
+
+	cache->zpages.slot[*page_no] = FTL_L2P_CACHE_ZPAGE_NONE;
+	*page_no = UINT64_MAX;
+	slab->used--;
+
+	if (slab->used) {
+		if (!slab->on_free_list) {
+			TAILQ_INSERT_TAIL(&cache->zpages.free_list, slab, free_entry);
+			slab->on_free_list = true;
+		}
+		return;
+	}
+
+	/* Slab is empty, give its memory back to the cache */
+	if (slab->on_free_list) {
+		TAILQ_REMOVE(&cache->zpages.free_list, slab, free_entry);
+		slab->on_free_list = false;
+	}
+	ftl_mempool_put(cache->l2_ctx_pool, slab->page);
+	cache->l2_pgs_avail++;
+	slab->page = NULL;
+	cache->zpages.free_ids[cache->zpages.max_slabs - cache->zpages.num_slabs] = slab_id;
+	cache->zpages.num_slabs--;
+}
+
+static struct ftl_l2p_zslab *
+zpage_slab_alloc(struct ftl_l2p_cache *cache)
+{
+	struct ftl_l2p_zslab *slab;
+	uint32_t slab_id, i;
+
+	if (cache->zpages.num_slabs == cache->zpages.max_slabs ||
+	    cache->l2_pgs_avail <= L2P_MAX_PAGES_TO_PIN) {
+		return NULL;
+	}
+
+	slab_id = cache->zpages.free_ids[cache->zpages.max_slabs - cache->zpages.num_slabs - 1];
+	slab = &cache->zpages.slabs[slab_id];
+	assert(!slab->page);
+
+	slab->page = ftl_l2p_cache_page_alloc(cache, UINT64_MAX);
+	slab->page->state = L2P_CACHE_PAGE_READY;
+	for (i = 0; i < FTL_L2P_CACHE_ZPAGES_PER_SLAB; i++) {
+		slab->page_no[i] = UINT64_MAX;
+	}
+	slab->used = 0;
+	TAILQ_INSERT_TAIL(&cache->zpages.free_list, slab, free_entry);
+	slab->on_free_list = true;
+	cache->zpages.num_slabs++;
+
+	return slab;
+}
+
+static uint32_t
+zpage_slot_get(struct ftl_l2p_cache *cache, uint64_t page_no)
+{
+	struct ftl_l2p_zslab *slab;
+	uint64_t num_slots = (uint64_t)cache->zpages.max_slabs * FTL_L2P_CACHE_ZPAGES_PER_SLAB;
+	uint32_t slot, i;
+
+	slab = TAILQ_FIRST(&cache->zpages.free_list);
+	if (!slab) {
+		slab = zpage_slab_alloc(cache);
+	}
+
+	if (slab) {
+		for (i = 0; i < FTL_L2P_CACHE_ZPAGES_PER_SLAB; i++) {
+			if (slab->page_no[i] == UINT64_MAX) {
+				break;
+			}
+		}
+		assert(i < FTL_L2P_CACHE_ZPAGES_PER_SLAB);
+
+		slab->used++;
+		if (slab->used == FTL_L2P_CACHE_ZPAGES_PER_SLAB) {
+			TAILQ_REMOVE(&cache->zpages.free_list, slab, free_entry);
+			slab->on_free_list = false;
+		}
+		slot = (slab - cache->zpages.slabs) * FTL_L2P_CACHE_ZPAGES_PER_SLAB + i;
+	} else {
+		if (!cache->zpages.num_slabs) {
+			return FTL_L2P_CACHE_ZPAGE_NONE;
+		}
+
+		/* All slots are used, reuse the oldest one */
+		while (true) {
+			slot = cache->zpages.hand;
+			cache->zpages.hand = (cache->zpages.hand + 1) % num_slots;
+
+			slab = &cache->zpages.slabs[slot / FTL_L2P_CACHE_ZPAGES_PER_SLAB];
+			if (slab->page && slab->page_no[slot % FTL_L2P_CACHE_ZPAGES_PER_SLAB] != UINT64_MAX) {
+				break;
+			}
+		}
+
+		cache->zpages.slot[slab->page_no[slot % FTL_L2P_CACHE_ZPAGES_PER_SLAB]] =
+			FTL_L2P_CACHE_ZPAGE_NONE;
+	}
+
+	slab->page_no[slot % FTL_L2P_CACHE_ZPAGES_PER_SLAB] = page_no;
+	cache->zpages.slot[page_no] = slot;
+
+	return slot;
+}
+
+static void
+ftl_l2p_cache_zpage_store(struct ftl_l2p_cache *cache, uint64_t page_no, const void *zpage,
+			  size_t size)
+{
+	uint32_t slot;
+
+	assert(cache->zpages.slot[page_no] == FTL_L2P_CACHE_ZPAGE_NONE);
+
+	slot = zpage_slot_get(cache, page_no);
+	if (slot != FTL_L2P_CACHE_ZPAGE_NONE) {
+		memcpy(zpage_slot_buffer(cache, slot), zpage, size);
+	}
+}
+
+static bool
+ftl_l2p_cache_zpage_load(struct ftl_l2p_cache *cache, struct ftl_l2p_page *page)
+{
+	uint32_t slot = cache->zpages.slot[page->page_no];
+
+	if (slot == FTL_L2P_CACHE_ZPAGE_NONE) {
+		return false;
+	}
+
+	ftl_l2p_extent_decode(page->page_buffer, zpage_slot_buffer(cache, slot),
+			      cache->lbas_in_page, cache->dev->layout.l2p.addr_size);
+	zpage_slot_release(cache, slot);
+	page->state = L2P_CACHE_PAGE_READY;
+
+	return true;
+}
+
+static void
+ftl_l2p_cache_zpage_drop_all(struct ftl_l2p_cache *cache)
+{
+	struct ftl_l2p_zslab *slab;
+	uint32_t slab_id, i;
+
+	for (slab_id = 0; slab_id < cache->zpages.max_slabs && cache->zpages.num_slabs; slab_id++) {
+		slab = &cache->zpages.slabs[slab_id];
+
+		for (i = 0; i < FTL_L2P_CACHE_ZPAGES_PER_SLAB && slab->page; i++) {
+			if (slab->page_no[i] != UINT64_MAX) {
+				zpage_slot_release(cache, slab_id * FTL_L2P_CACHE_ZPAGES_PER_SLAB + i);
+			}
+		}
+	}
+
+	cache->zpages.hand = 0;
+}
+
 static void
 ftl_l2p_cache_page_remove(struct ftl_l2p_cache *cache, struct ftl_l2p_page *page)
 {
 	struct ftl_l2p_l1_map_entry *me = cache->l2_mapping;
+	uint8_t zpage[FTL_L2P_CACHE_ZPAGE_SIZE];
+	uint64_t page_no = page->page_no;
+	size_t zpage_size = 0;
+
 	assert(me);
 	assert(me[page->page_no].page_obj_id != FTL_DF_OBJ_ID_INVALID);
 	assert(TAILQ_EMPTY(&page->ppe_list));
 
+	if (page->state == L2P_CACHE_PAGE_READY && ftl_l2p_cache_running(cache)) {
+		if (page->lru == L2P_CACHE_LRU_PROBATION && !page->prefetched) {
+			ftl_l2p_cache_ghost_add(cache, page->page_no);
+		}
+
+		zpage_size = ftl_l2p_extent_encode(zpage, sizeof(zpage), page->page_buffer,
+						   cache->lbas_in_page, cache->dev->layout.l2p.addr_size);
+	}
+
 	me[page->page_no].page_obj_id = FTL_DF_OBJ_ID_INVALID;
 	cache->l2_pgs_avail++;
 	ftl_mempool_put(cache->l2_ctx_pool, page);
+
+	if (zpage_size) {
+		ftl_l2p_cache_zpage_store(cache, page_no, zpage, zpage_size);
+	}
 }
 
 static inline struct ftl_l2p_page *
 ftl_l2p_cache_get_coldest_page(struct ftl_l2p_cache *cache)
 {
-	return TAILQ_LAST(&cache->lru_list, l2p_lru_list);
+	if (cache->lru_count[L2P_CACHE_LRU_PROBATION] > cache->probation_max ||
+	    TAILQ_EMPTY(&cache->lru_list[L2P_CACHE_LRU_PROTECTED])) {
+		return TAILQ_LAST(&cache->lru_list[L2P_CACHE_LRU_PROBATION], l2p_lru_list);
+	}
+
+	return TAILQ_LAST(&cache->lru_list[L2P_CACHE_LRU_PROTECTED], l2p_lru_list);
 }
 
 static inline struct ftl_l2p_page *
@@ -337,6 +677,7 @@ static inline void
 ftl_l2p_cache_page_pin(struct ftl_l2p_cache *cache, struct ftl_l2p_page *page)
 {
 	page->pin_ref_cnt++;
+	page->prefetched = false;
 	/* Pinned pages can't be evicted (since L2P sets/gets will be executed on it), so remove them from LRU */
 	if (page->on_lru_list) {
 		ftl_l2p_cache_lru_remove_page(cache, page);
@@ -431,6 +772,7 @@ ftl_l2p_cache_init(struct spdk_ftl_dev *dev)
 	void *l2p = _ftl_l2p_cache_init(dev, dev->layout.l2p.addr_size, l2p_size);
 	size_t page_sets_pool_size = 1 << 15;
 	size_t max_resident_size, max_resident_pgs;
+	uint64_t ghost_bitmap_size, i;
 
 	if (!l2p) {
 		return -1;
@@ -459,7 +801,8 @@ ftl_l2p_cache_init(struct spdk_ftl_dev *dev)
 		       max_resident_size >> 20, dev->conf.l2p_dram_limit);
 
 	TAILQ_INIT(&cache->deferred_page_set_list);
-	TAILQ_INIT(&cache->lru_list);
+	TAILQ_INIT(&cache->lru_list[L2P_CACHE_LRU_PROBATION]);
+	TAILQ_INIT(&cache->lru_list[L2P_CACHE_LRU_PROTECTED]);
 
 	cache->l2_ctx_md = ftl_md_create(dev,
 					 spdk_divide_round_up(max_resident_pgs * SPDK_ALIGN_CEIL(sizeof(struct ftl_l2p_page), 64),
@@ -479,6 +822,48 @@ ftl_l2p_cache_init(struct spdk_ftl_dev *dev)
 		return -1;
 	}
 
+	cache->probation_max = spdk_divide_round_up(max_resident_pgs * FTL_L2P_CACHE_PROBATION_RATIO,
+			       100);
+
+	cache->ghost.size = spdk_max(1, max_resident_pgs * FTL_L2P_CACHE_GHOST_RATIO / 100);
+	cache->ghost.pages = malloc(cache->ghost.size * sizeof(*cache->ghost.pages));
+	if (!cache->ghost.pages) {
+		return -1;
+	}
+	memset(cache->ghost.pages, 0xff, cache->ghost.size * sizeof(*cache->ghost.pages));
+
+	ghost_bitmap_size = ftl_bitmap_bits_to_size(cache->num_pages);
+	cache->ghost.bitmap_buf = calloc(1, ghost_bitmap_size);
+	if (!cache->ghost.bitmap_buf) {
+		return -1;
+	}
+	cache->ghost.bitmap = ftl_bitmap_create(cache->ghost.bitmap_buf, ghost_bitmap_size);
+	if (!cache->ghost.bitmap) {
+		return -1;
+	}
+
+	cache->zpages.max_slabs = max_resident_pgs * FTL_L2P_CACHE_ZPAGE_RATIO / 100;
+	cache->zpages.slabs = calloc(spdk_max(1, cache->zpages.max_slabs),
+				     sizeof(*cache->zpages.slabs));
+	cache->zpages.free_ids = calloc(spdk_max(1, cache->zpages.max_slabs),
+					sizeof(*cache->zpages.free_ids));
+	cache->zpages.slot = malloc(cache->num_pages * sizeof(*cache->zpages.slot));
+	if (!cache->zpages.slabs || !cache->zpages.free_ids || !cache->zpages.slot) {
+		return -1;
+	}
+	for (i = 0; i < cache->zpages.max_slabs; i++) {
+		cache->zpages.free_ids[i] = cache->zpages.max_slabs - i - 1;
+	}
+	memset(cache->zpages.slot, 0xff, cache->num_pages * sizeof(*cache->zpages.slot));
+	TAILQ_INIT(&cache->zpages.free_list);
+
+	cache->page_in_batch_pool = ftl_mempool_create(FTL_L2P_CACHE_PAGE_IN_BATCH_POOL,
+				    sizeof(struct ftl_l2p_page_in_batch),
+				    64, SPDK_ENV_NUMA_ID_ANY);
+	if (!cache->page_in_batch_pool) {
+		return -1;
+	}
+
 #define FTL_L2P_CACHE_PAGE_AVAIL_MAX            16UL << 10
 #define FTL_L2P_CACHE_PAGE_AVAIL_RATIO          5UL
 	cache->evict_keep = spdk_divide_round_up(cache->num_pages * FTL_L2P_CACHE_PAGE_AVAIL_RATIO, 100);
@@ -521,6 +906,23 @@ ftl_l2p_cache_deinit_l2(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache)
 
 	ftl_mempool_destroy(cache->page_sets_pool);
 	cache->page_sets_pool = NULL;
+
+	ftl_mempool_destroy(cache->page_in_batch_pool);
+	cache->page_in_batch_pool = NULL;
+
+	ftl_bitmap_destroy(cache->ghost.bitmap);
+	cache->ghost.bitmap = NULL;
+	free(cache->ghost.bitmap_buf);
+	cache->ghost.bitmap_buf = NULL;
+	free(cache->ghost.pages);
+	cache->ghost.pages = NULL;
+
+	free(cache->zpages.slabs);
+	cache->zpages.slabs = NULL;
+	free(cache->zpages.free_ids);
+	cache->zpages.free_ids = NULL;
+	free(cache->zpages.slot);
+	cache->zpages.slot = NULL;
 }
 
 static void
@@ -819,6 +1221,9 @@ l2p_shm_restore_clean(struct spdk_ftl_dev *dev)
 
 		page->pin_ref_cnt = 0;
 		page->on_lru_list = 0;
+		if (page->lru >= L2P_CACHE_LRU_COUNT) {
+			page->lru = L2P_CACHE_LRU_PROBATION;
+		}
 		memset(&page->ctx, 0, sizeof(page->ctx));
 
 		ftl_l2p_cache_lru_add_page(cache, page);
@@ -867,6 +1272,9 @@ l2p_shm_restore_dirty(struct spdk_ftl_dev *dev)
 
 		page->pin_ref_cnt = 0;
 		page->on_lru_list = 0;
+		if (page->lru >= L2P_CACHE_LRU_COUNT) {
+			page->lru = L2P_CACHE_LRU_PROBATION;
+		}
 		memset(&page->ctx, 0, sizeof(page->ctx));
 
 		ftl_l2p_cache_lru_add_page(cache, page);
@@ -951,6 +1359,8 @@ ftl_l2p_cache_halt(struct spdk_ftl_dev *dev)
 	struct ftl_l2p_cache *cache = (struct ftl_l2p_cache *)dev->l2p;
 
 	if (cache->state != L2P_CACHE_SHUTDOWN_DONE) {
+		/* Encoded pages aren't persisted, they're only clean copies of pages on the disk */
+		ftl_l2p_cache_zpage_drop_all(cache);
 		cache->state = L2P_CACHE_IN_SHUTDOWN;
 		if (!cache->ios_in_flight && !cache->l2_pgs_evicting) {
 			cache->state = L2P_CACHE_SHUTDOWN_DONE;
@@ -985,15 +1395,59 @@ ftl_l2p_cache_init_page_set(struct ftl_l2p_page_set *page_set, struct ftl_l2p_pi
 }
 
 static inline bool
-ftl_l2p_cache_running(struct ftl_l2p_cache *cache)
+ftl_l2p_cache_page_is_pinnable(struct ftl_l2p_page *page)
 {
-	return cache->state == L2P_CACHE_RUNNING;
+	return page->state != L2P_CACHE_PAGE_INIT;
 }
 
 static inline bool
-ftl_l2p_cache_page_is_pinnable(struct ftl_l2p_page *page)
+prefetch_stream_is_sequential(const struct ftl_l2p_cache_stream *stream)
 {
-	return page->state != L2P_CACHE_PAGE_INIT;
+	return stream->run >= FTL_L2P_CACHE_PREFETCH_TRIGGER;
+}
+
+static inline bool
+prefetch_stream_is_older(const struct ftl_l2p_cache_stream *stream,
+			 const struct ftl_l2p_cache_stream *other)
+{
+	/* Random accesses must not take over slots of sequential streams */
+	if (prefetch_stream_is_sequential(stream) != prefetch_stream_is_sequential(other)) {
+		return !prefetch_stream_is_sequential(stream);
+	}
+
+	return stream->tick < other->tick;
+}
+
+static void
+prefetch_track(struct ftl_l2p_cache *cache, uint64_t start, uint64_t end)
+{
+	struct ftl_l2p_cache_stream *stream, *victim = NULL;
+	uint64_t i;
+
+	cache->prefetch.tick++;
+
+	for (i = 0; i < FTL_L2P_CACHE_PREFETCH_STREAMS; i++) {
+		stream = &cache->prefetch.stream[i];
+
+		if (start == stream->last_page || start == stream->last_page + 1) {
+			if (end > stream->last_page) {
+				stream->run += end - stream->last_page;
+				stream->last_page = end;
+			}
+			stream->tick = cache->prefetch.tick;
+			return;
+		}
+
+		if (!victim || prefetch_stream_is_older(stream, victim)) {
+			victim = stream;
+		}
+	}
+
+	/* Start tracking a new stream */
+	victim->last_page = end;
+	victim->run = end - start;
+	victim->prefetch_page = end + 1;
+	victim->tick = cache->prefetch.tick;
 }
 
 void
@@ -1015,6 +1469,8 @@ ftl_l2p_cache_pin(struct spdk_ftl_dev *dev, struct ftl_l2p_pin_ctx *pin_ctx)
 		return;
 	}
 
+	prefetch_track(cache, start, end);
+
 	/* Get and initialize page sets */
 	assert(ftl_l2p_cache_running(cache));
 	page_set = ftl_mempool_get(cache->page_sets_pool);
@@ -1229,6 +1685,9 @@ page_in_io_complete(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
 	if (spdk_unlikely(!success)) {
 		ftl_bug(page->on_lru_list);
 		ftl_l2p_cache_page_remove(cache, page);
+	} else if (!page->pin_ref_cnt && !page->on_lru_list) {
+		/* Page read ahead and not requested yet */
+		ftl_l2p_cache_lru_add_page(cache, page);
 	}
 }
 
@@ -1289,8 +1748,121 @@ page_in_io_retry(void *arg)
 }
 
 static void
-page_in(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
-	struct ftl_l2p_page_set *page_set, struct ftl_l2p_page_wait_ctx *pentry)
+page_in_batch_io_cb(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct ftl_l2p_page_in_batch *batch = cb_arg;
+	struct ftl_l2p_cache *cache = batch->cache;
+	struct spdk_ftl_dev *dev = cache->dev;
+	uint64_t i;
+
+	ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_L2P, bdev_io);
+	spdk_bdev_free_io(bdev_io);
+
+	for (i = 0; i < batch->num_pages; i++) {
+		page_in_io_complete(dev, cache, batch->pages[i], success);
+	}
+
+	ftl_mempool_put(cache->page_in_batch_pool, batch);
+}
+
+static void
+page_in_batch_io(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
+		 struct ftl_l2p_page_in_batch *batch)
+{
+	struct spdk_io_channel *ioch;
+	struct spdk_bdev *bdev;
+	struct spdk_bdev_io_wait_entry *bdev_io_wait;
+	int rc;
+
+	rc = ftl_nv_cache_bdev_readv_blocks_with_md(dev, ftl_l2p_cache_get_bdev_desc(cache),
+			ftl_l2p_cache_get_bdev_iochannel(cache),
+			batch->iov, batch->num_pages, NULL,
+			ftl_l2p_cache_page_get_bdev_offset(cache, batch->pages[0]),
+			batch->num_pages, page_in_batch_io_cb, batch);
+	cache->ios_in_flight += batch->num_pages;
+	if (spdk_likely(0 == rc)) {
+		return;
+	}
+
+	if (rc == -ENOMEM) {
+		ioch = ftl_l2p_cache_get_bdev_iochannel(cache);
+		bdev = spdk_bdev_desc_get_bdev(ftl_l2p_cache_get_bdev_desc(cache));
+		bdev_io_wait = &batch->bdev_io_wait;
+		bdev_io_wait->bdev = bdev;
+		bdev_io_wait->cb_fn = page_in_batch_io_retry;
+		bdev_io_wait->cb_arg = batch;
+
+		rc = spdk_bdev_queue_io_wait(bdev, ioch, bdev_io_wait);
+		ftl_bug(rc);
+	} else {
+		ftl_abort();
+	}
+}
+
+static void
+page_in_batch_io_retry(void *arg)
+{
+	struct ftl_l2p_page_in_batch *batch = arg;
+	struct ftl_l2p_cache *cache = batch->cache;
+
+	cache->ios_in_flight -= batch->num_pages;
+	page_in_batch_io(cache->dev, cache, batch);
+}
+
+/* Reads pages with consecutive page numbers using a single IO */
+static void
+page_in_range(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
+	      struct ftl_l2p_page **pages, uint64_t num_pages)
+{
+	struct ftl_l2p_page_in_batch *batch = NULL;
+	uint64_t i;
+
+	assert(num_pages <= FTL_L2P_CACHE_PAGE_IN_BATCH);
+
+	if (num_pages > 1) {
+		batch = ftl_mempool_get(cache->page_in_batch_pool);
+	}
+
+	if (!batch) {
+		for (i = 0; i < num_pages; i++) {
+			page_in_io(dev, cache, pages[i]);
+		}
+		return;
+	}
+
+	batch->cache = cache;
+	batch->num_pages = num_pages;
+	for (i = 0; i < num_pages; i++) {
+		assert(pages[i]->page_no == pages[0]->page_no + i);
+		pages[i]->ctx.cache = cache;
+		batch->pages[i] = pages[i];
+		batch->iov[i].iov_base = pages[i]->page_buffer;
+		batch->iov[i].iov_len = FTL_BLOCK_SIZE;
+	}
+
+	page_in_batch_io(dev, cache, batch);
+}
+
+/* Reads the pages, merging runs of consecutive page numbers into batched IOs */
+static void
+page_in_pages(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
+	      struct ftl_l2p_page **pages, uint64_t num_pages)
+{
+	uint64_t i, first = 0;
+
+	for (i = 1; i <= num_pages; i++) {
+		if (i == num_pages || i - first == FTL_L2P_CACHE_PAGE_IN_BATCH ||
+		    pages[i]->page_no != pages[i - 1]->page_no + 1) {
+			page_in_range(dev, cache, &pages[first], i - first);
+			first = i;
+		}
+	}
+}
+
+/* Returns the page if it has to be read from the disk */
+static struct ftl_l2p_page *
+page_in(struct ftl_l2p_cache *cache, struct ftl_l2p_page_set *page_set,
+	struct ftl_l2p_page_wait_ctx *pentry)
 {
 	struct ftl_l2p_page *page;
 	bool page_in = false;
@@ -1300,7 +1872,8 @@ page_in(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
 	if (!page) {
 		/* Page not allocated yet, do it */
 		page = page_allocate(cache, pentry->pg_no);
-		page_in = true;
+		ftl_l2p_cache_ghost_hit(cache, page);
+		page_in = !ftl_l2p_cache_zpage_load(cache, page);
 	}
 
 	if (ftl_l2p_cache_page_is_pinnable(page)) {
@@ -1313,9 +1886,7 @@ page_in(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
 		ftl_l2p_page_queue_wait_ctx(page, pentry);
 	}
 
-	if (page_in) {
-		page_in_io(dev, cache, page);
-	}
+	return page_in ? page : NULL;
 }
 
 static int
@@ -1323,7 +1894,8 @@ ftl_l2p_cache_process_page_sets(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *
 {
 	struct ftl_l2p_page_set *page_set;
 	struct ftl_l2p_page_wait_ctx *pentry;
-	uint64_t i;
+	struct ftl_l2p_page *page, *pages[L2P_MAX_PAGES_TO_PIN];
+	uint64_t i, num_pages = 0;
 
 	page_set = TAILQ_FIRST(&cache->deferred_page_set_list);
 	if (!page_set) {
@@ -1350,10 +1922,14 @@ ftl_l2p_cache_process_page_sets(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *
 	pentry = page_set->entry;
 	for (i = 0; i < page_set->to_pin_cnt; i++, pentry++) {
 		if (!pentry->pg_pin_issued) {
-			page_in(dev, cache, page_set, pentry);
+			page = page_in(cache, page_set, pentry);
+			if (page) {
+				pages[num_pages++] = page;
+			}
 		}
 	}
 
+	page_in_pages(dev, cache, pages, num_pages);
 	page_set->locked = 0;
 
 	/* Check if page_set is done */
@@ -1364,6 +1940,51 @@ ftl_l2p_cache_process_page_sets(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *
 	return 0;
 }
 
+static void
+ftl_l2p_cache_process_prefetch(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache)
+{
+	struct ftl_l2p_cache_stream *stream;
+	struct ftl_l2p_page *page, *pages[FTL_L2P_CACHE_PREFETCH_DEPTH];
+	uint64_t i, page_no, last_page, num_pages;
+	uint64_t avail_min = spdk_max(cache->evict_keep / 2, L2P_MAX_PAGES_TO_PIN);
+
+	if (!TAILQ_EMPTY(&cache->deferred_page_set_list)) {
+		/* Pins waiting for pages take precedence */
+		return;
+	}
+
+	for (i = 0; i < FTL_L2P_CACHE_PREFETCH_STREAMS; i++) {
+		stream = &cache->prefetch.stream[i];
+		if (!prefetch_stream_is_sequential(stream)) {
+			continue;
+		}
+
+		page_no = spdk_max(stream->prefetch_page, stream->last_page + 1);
+		last_page = spdk_min(stream->last_page + FTL_L2P_CACHE_PREFETCH_DEPTH,
+				     cache->num_pages - 1);
+		num_pages = 0;
+
+		for (; page_no <= last_page; page_no++) {
+			if (cache->l2_pgs_avail <= avail_min ||
+			    cache->ios_in_flight + num_pages >= FTL_L2P_CACHE_PREFETCH_MAX_QD) {
+				break;
+			}
+
+			if (get_l2p_page_by_df_id(cache, page_no) ||
+			    cache->zpages.slot[page_no] != FTL_L2P_CACHE_ZPAGE_NONE) {
+				continue;
+			}
+
+			page = page_allocate(cache, page_no);
+			page->prefetched = true;
+			pages[num_pages++] = page;
+		}
+
+		stream->prefetch_page = page_no;
+		page_in_pages(dev, cache, pages, num_pages);
+	}
+}
+
 static struct ftl_l2p_page *
 eviction_get_page(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache)
 {
@@ -1582,6 +2203,7 @@ ftl_l2p_cache_process(struct spdk_ftl_dev *dev)
 		}
 	}
 
+	ftl_l2p_cache_process_prefetch(dev, cache);
 	ftl_l2p_cache_process_eviction(dev, cache);
 	ftl_l2p_lazy_trim_process(dev);
 }
@@ -302,6 +302,8 @@ ftl_nv_cache_init(struct spdk_ftl_dev *dev)
 
 #define FTL_MAX_OPEN_CHUNKS 2
 #define FTL_MAX_COMPACTED_CHUNKS 2
+	SPDK_STATIC_ASSERT(FTL_STREAM_COUNT <= FTL_MAX_OPEN_CHUNKS,
+			   "Not enough open chunks for all streams");
 	nv_cache->p2l_pool = ftl_mempool_create(FTL_MAX_OPEN_CHUNKS + FTL_MAX_COMPACTED_CHUNKS,
 						nv_cache_p2l_map_pool_elem_size(nv_cache),
 						FTL_BLOCK_SIZE,
@@ -340,6 +342,7 @@ ftl_nv_cache_init(struct spdk_ftl_dev *dev)
 	nv_cache->chunk_free_target = spdk_divide_round_up(nv_cache->chunk_count *
 				      dev->conf.nv_cache.chunk_free_target,
 				      100);
+	nv_cache->ctrl.compaction_target = FTL_NV_CACHE_NUM_COMPACTORS;
 
 	if (nv_cache->nvc_type->ops.init) {
 		return nv_cache->nvc_type->ops.init(dev);
@@ -396,16 +399,50 @@ chunk_is_closed(struct ftl_nv_cache_chunk *chunk)
 
 static void ftl_chunk_close(struct ftl_nv_cache_chunk *chunk);
 
+/*
+ * Returns another stream the IO can go to without overtaking a newer copy of its LBAs - one with
+ * a current chunk new enough and with enough space, or one without a current chunk, which will
+ * open a new one. Returns FTL_STREAM_COUNT if there's none.
+ */
+static enum ftl_stream
+get_newer_stream(struct ftl_nv_cache *nv_cache, enum ftl_stream stream, uint64_t min_seq_id,
+		 uint64_t num_blocks)
+{
+	struct ftl_nv_cache_chunk *chunk;
+	int i;
+
+	for (i = 0; i < FTL_STREAM_COUNT; i++) {
+		if (i == (int)stream) {
+			continue;
+		}
+
+		chunk = nv_cache->chunk_current[i];
+		if (!chunk || chunk_is_closed(chunk)) {
+			return i;
+		}
+
+		if (chunk->md->seq_id >= min_seq_id &&
+		    chunk_get_free_space(nv_cache, chunk) >= num_blocks) {
+			return i;
+		}
+	}
+
+	return FTL_STREAM_COUNT;
+}
+
 static uint64_t
 ftl_nv_cache_get_wr_buffer(struct ftl_nv_cache *nv_cache, struct ftl_io *io)
 {
+	struct spdk_ftl_dev *dev = SPDK_CONTAINEROF(nv_cache, struct spdk_ftl_dev, nv_cache);
 	uint64_t address = FTL_LBA_INVALID;
 	uint64_t num_blocks = io->num_blocks;
 	uint64_t free_space;
 	struct ftl_nv_cache_chunk *chunk;
+	enum ftl_stream stream = io->stream;
+	uint64_t min_seq_id = ftl_heat_get_seq_id(dev->heat, io->lba, num_blocks);
 
 	do {
-		chunk = nv_cache->chunk_current;
+		chunk = nv_cache->chunk_current[stream];
 		/* Chunk has been closed so pick new one */
 		if (chunk && chunk_is_closed(chunk))  {
 			chunk = NULL;
@@ -415,15 +452,33 @@ ftl_nv_cache_get_wr_buffer(struct ftl_nv_cache *nv_cache, struct ftl_io *io)
 			chunk = TAILQ_FIRST(&nv_cache->chunk_open_list);
 			if (chunk && chunk->md->state == FTL_CHUNK_STATE_OPEN) {
 				TAILQ_REMOVE(&nv_cache->chunk_open_list, chunk, entry);
-				nv_cache->chunk_current = chunk;
+				chunk->md->stream = stream;
+				nv_cache->chunk_current[stream] = chunk;
 			} else {
 				break;
 			}
 		}
 
+		/*
+		 * The LBAs may have been written by the other stream to a chunk opened after this one.
+		 * Recovery lets the chunk with the higher sequence id win, so the new data mustn't land
+		 * in an older chunk. That's usually a range flipping between hot and cold, so keep it
+		 * in the other stream rather than closing this chunk early and wasting its space.
+		 */
+		if (chunk->md->seq_id < min_seq_id) {
+			enum ftl_stream newer = get_newer_stream(nv_cache, stream, min_seq_id, num_blocks);
+
+			if (newer != FTL_STREAM_COUNT) {
+				stream = newer;
+				io->stream = stream;
+				continue;
+			}
+		}
+
 		free_space = chunk_get_free_space(nv_cache, chunk);
 
-		if (free_space >= num_blocks) {
+		/* If there's no newer chunk to go to, close this one and move on to a new one */
+		if (free_space >= num_blocks && chunk->md->seq_id >= min_seq_id) {
 			/* Enough space in chunk */
 
 			/* Calculate address in NV cache */
@@ -436,13 +491,15 @@ ftl_nv_cache_get_wr_buffer(struct ftl_nv_cache *nv_cache, struct ftl_io *io)
 			chunk->md->write_pointer += num_blocks;
 
 			if (free_space == num_blocks) {
-				nv_cache->chunk_current = NULL;
+				nv_cache->chunk_current[stream] = NULL;
 			}
+
+			ftl_heat_set_seq_id(dev->heat, io->lba, num_blocks, chunk->md->seq_id);
 			break;
 		}
 
-		/* Not enough space in nv_cache_chunk */
-		nv_cache->chunk_current = NULL;
+		/* Not enough space in nv_cache_chunk, or the chunk is too old */
+		nv_cache->chunk_current[stream] = NULL;
 
 		if (0 == free_space) {
 			continue;
@@ -705,7 +762,9 @@ is_compaction_required(struct ftl_nv_cache *nv_cache)
 		return is_compaction_required_for_upgrade(nv_cache);
 	}
 
-	if (nv_cache->chunk_full_count >= nv_cache->chunk_compaction_threshold) {
+	/* Start ahead of the threshold, as much as the current ingress fills up the cache */
+	if (nv_cache->chunk_full_count + nv_cache->ctrl.compaction_lead >=
+	    nv_cache->chunk_compaction_threshold) {
 		return true;
 	}
 
@@ -1020,8 +1079,9 @@ compaction_chunk_read_pos(struct spdk_ftl_dev *dev, struct ftl_nv_cache_chunk *c
 }
 
 static bool
-compaction_entry_read_pos(struct ftl_nv_cache *nv_cache, struct ftl_rq_entry *entry)
+compaction_entry_read_pos(struct ftl_nv_cache_compactor *compactor, struct ftl_rq_entry *entry)
 {
+	struct ftl_nv_cache *nv_cache = compactor->nv_cache;
 	struct spdk_ftl_dev *dev = SPDK_CONTAINEROF(nv_cache, struct spdk_ftl_dev, nv_cache);
 	struct ftl_nv_cache_chunk *chunk = NULL;
 	ftl_addr addr = FTL_ADDR_INVALID;
@@ -1032,6 +1092,13 @@ compaction_entry_read_pos(struct ftl_nv_cache *nv_cache, struct ftl_rq_entry *en
 		if (!chunk) {
 			return false;
 		}
+
+		/* Don't mix data of different streams within one request */
+		if (0 == compactor->rq->iter.count) {
+			compactor->stream = chunk->md->stream;
+		} else if (chunk->md->stream != compactor->stream) {
+			return false;
+		}
 		chunk->compaction_start_tsc = spdk_thread_get_last_tsc(spdk_get_thread());
 
 		/* Get next read position in chunk */
@@ -1058,12 +1125,11 @@ static void
 compaction_process_start(struct ftl_nv_cache_compactor *compactor)
 {
 	struct ftl_rq *rq = compactor->rq;
-	struct ftl_nv_cache *nv_cache = compactor->nv_cache;
 	struct ftl_rq_entry *entry;
 
 	assert(0 == compactor->rq->iter.count);
 	FTL_RQ_ENTRY_LOOP(rq, entry, rq->num_blocks) {
-		if (!compaction_entry_read_pos(nv_cache, entry)) {
+		if (!compaction_entry_read_pos(compactor, entry)) {
 			compaction_process_pad(compactor, entry->index);
 			break;
 		}
@@ -1088,6 +1154,11 @@ compaction_process(struct ftl_nv_cache *nv_cache)
 		return;
 	}
 
+	if (nv_cache->compaction_active_count >= nv_cache->ctrl.compaction_target &&
+	    spdk_likely(!nv_cache->halt)) {
+		return;
+	}
+
 	if (nv_cache->chunk_comp_count < FTL_MAX_COMPACTED_CHUNKS) {
 		prepare_chunk_for_compaction(nv_cache);
 	}
@@ -1119,7 +1190,7 @@ compaction_process_ftl_done(struct ftl_rq *rq)
 	if (spdk_unlikely(false == rq->success)) {
 		/* IO error retry writing */
 #ifdef SPDK_FTL_RETRY_ON_ERROR
-		ftl_writer_queue_rq(&dev->writer_user, rq);
+		ftl_writer_queue_rq(&dev->writer_user[compactor->stream], rq);
 		return;
 #else
 		ftl_abort();
@@ -1137,6 +1208,7 @@ compaction_process_ftl_done(struct ftl_rq *rq)
 			ftl_l2p_update_base(dev, entry->lba, addr, entry->addr);
 			ftl_l2p_unpin(dev, entry->lba, 1);
 			chunk_compaction_advance(chunk, 1);
+			dev->nv_cache.ctrl.blocks_compacted++;
 		} else {
 			assert(entry->addr == FTL_ADDR_INVALID);
 		}
@@ -1184,7 +1256,7 @@ compaction_process_finish_read(struct ftl_nv_cache_compactor *compactor)
 		/*
 		 * Request contains data to be placed on FTL, compact it
 		 */
-		ftl_writer_queue_rq(&dev->writer_user, rq);
+		ftl_writer_queue_rq(&dev->writer_user[compactor->stream], rq);
 	} else {
 		compactor_deactivate(compactor);
 	}
@@ -1416,13 +1488,73 @@ ftl_nv_cache_set_addr(struct spdk_ftl_dev *dev, uint64_t lba, ftl_addr addr)
 	ftl_bitmap_set(dev->valid_map, addr);
 }
 
+static double
+ctrl_ewma(double avg, double sample)
+{
+	return avg + FTL_NV_CACHE_CTRL_EWMA_WEIGHT * (sample - avg);
+}
+
+static void
+ftl_nv_cache_ctrl_update(struct ftl_nv_cache *nv_cache)
+{
+	double active, free_delta, needed;
+	uint64_t lead, target;
+	bool throttled;
+
+	/* The ingress is capped by the limit, so it shows the user demand only below the limit */
+	throttled = nv_cache->throttle.blocks_submitted >= nv_cache->throttle.blocks_submitted_limit;
+	nv_cache->ctrl.ingress_blocks = ctrl_ewma(nv_cache->ctrl.ingress_blocks,
+				       nv_cache->throttle.blocks_submitted);
+
+	free_delta = (double)nv_cache->chunk_free_count - nv_cache->ctrl.last_free_count;
+	nv_cache->ctrl.free_trend = ctrl_ewma(nv_cache->ctrl.free_trend, free_delta);
+	nv_cache->ctrl.last_free_count = nv_cache->chunk_free_count;
+
+	/* Only intervals with compaction running tell anything about the compactor bandwidth */
+	if (nv_cache->ctrl.active_sum) {
+		active = (double)nv_cache->ctrl.active_sum / nv_cache->ctrl.polls;
+		nv_cache->ctrl.compactor_blocks = ctrl_ewma(nv_cache->ctrl.compactor_blocks,
+						  nv_cache->ctrl.blocks_compacted / active);
+	}
+	nv_cache->ctrl.blocks_compacted = 0;
+	nv_cache->ctrl.active_sum = 0;
+	nv_cache->ctrl.polls = 0;
+
+	lead = nv_cache->ctrl.ingress_blocks * FTL_NV_CACHE_COMPACTION_LEAD_MS /
+	       FTL_NV_CACHE_THROTTLE_INTERVAL_MS / nv_cache->chunk_blocks;
+	nv_cache->ctrl.compaction_lead = spdk_min(lead, nv_cache->chunk_compaction_threshold / 2);
+
+	/*
+	 * Compact at full speed while there are no user writes to compete with, while user writes
+	 * are held back by the throttle or while the cache is short on free chunks
+	 */
+	if (nv_cache->ctrl.compactor_blocks == 0 || nv_cache->ctrl.ingress_blocks < 1.0 ||
+	    throttled || nv_cache->chunk_free_count < nv_cache->chunk_free_target) {
+		nv_cache->ctrl.compaction_target = FTL_NV_CACHE_NUM_COMPACTORS;
+		return;
+	}
+
+	/* Compactors needed to keep up with the ingress */
+	needed = nv_cache->ctrl.ingress_blocks / nv_cache->ctrl.compactor_blocks;
+	target = needed;
+	if (target < needed) {
+		target++;
+	}
+	nv_cache->ctrl.compaction_target = spdk_max(1, spdk_min(target, FTL_NV_CACHE_NUM_COMPACTORS));
+}
+
 static void
 ftl_nv_cache_throttle_update(struct ftl_nv_cache *nv_cache)
 {
 	double err;
 	double modifier;
+	double blocks_per_interval, prev_limit;
+
+	ftl_nv_cache_ctrl_update(nv_cache);
 
-	err = ((double)nv_cache->chunk_free_count - nv_cache->chunk_free_target) / nv_cache->chunk_count;
+	/* Free chunks error projected ahead by the free chunk trend */
+	err = ((double)nv_cache->chunk_free_count - nv_cache->chunk_free_target +
+	       FTL_NV_CACHE_THROTTLE_LOOKAHEAD * nv_cache->ctrl.free_trend) / nv_cache->chunk_count;
 	modifier = FTL_NV_CACHE_THROTTLE_MODIFIER_KP * err;
 
 	if (modifier < FTL_NV_CACHE_THROTTLE_MODIFIER_MIN) {
@@ -1431,13 +1563,32 @@ ftl_nv_cache_throttle_update(struct ftl_nv_cache *nv_cache)
 		modifier = FTL_NV_CACHE_THROTTLE_MODIFIER_MAX;
 	}
 
-	if (spdk_unlikely(nv_cache->compaction_sma == 0 || nv_cache->compaction_active_count == 0)) {
+	if (nv_cache->compaction_active_count == 0 && !is_compaction_required(nv_cache)) {
 		nv_cache->throttle.blocks_submitted_limit = UINT64_MAX;
+		return;
+	}
+
+	if (nv_cache->ctrl.compactor_blocks) {
+		blocks_per_interval = nv_cache->ctrl.compactor_blocks *
+				      nv_cache->ctrl.compaction_target;
+	} else if (nv_cache->compaction_sma) {
+		blocks_per_interval = nv_cache->compaction_sma * nv_cache->throttle.interval_tsc /
+				      FTL_BLOCK_SIZE;
 	} else {
-		double blocks_per_interval = nv_cache->compaction_sma * nv_cache->throttle.interval_tsc /
-					     FTL_BLOCK_SIZE;
-		nv_cache->throttle.blocks_submitted_limit = blocks_per_interval * (1.0 + modifier);
+		nv_cache->throttle.blocks_submitted_limit = UINT64_MAX;
+		return;
+	}
+	blocks_per_interval *= 1.0 + modifier;
+
+	/* Ramp the limit down from the current ingress instead of cutting user writes at once */
+	prev_limit = nv_cache->throttle.blocks_submitted_limit;
+	if (nv_cache->throttle.blocks_submitted_limit == UINT64_MAX) {
+		prev_limit = spdk_max(nv_cache->ctrl.ingress_blocks, blocks_per_interval);
 	}
+	blocks_per_interval = spdk_max(blocks_per_interval,
+				       prev_limit * (1.0 - FTL_NV_CACHE_THROTTLE_MAX_STEP));
+
+	nv_cache->throttle.blocks_submitted_limit = blocks_per_interval;
 }
 
 static void
@@ -1445,8 +1596,12 @@ ftl_nv_cache_process_throttle(struct ftl_nv_cache *nv_cache)
 {
 	uint64_t tsc = spdk_thread_get_last_tsc(spdk_get_thread());
 
+	nv_cache->ctrl.active_sum += nv_cache->compaction_active_count;
+	nv_cache->ctrl.polls++;
+
 	if (spdk_unlikely(!nv_cache->throttle.start_tsc)) {
 		nv_cache->throttle.start_tsc = tsc;
+		nv_cache->ctrl.last_free_count = nv_cache->chunk_free_count;
 	} else if (tsc - nv_cache->throttle.start_tsc >= nv_cache->throttle.interval_tsc) {
 		ftl_nv_cache_throttle_update(nv_cache);
 		nv_cache->throttle.start_tsc = tsc;
@@ -1486,11 +1641,19 @@ ftl_nv_cache_process(struct spdk_ftl_dev *dev)
 static bool
 ftl_nv_cache_full(struct ftl_nv_cache *nv_cache)
 {
-	if (0 == nv_cache->chunk_open_count && NULL == nv_cache->chunk_current) {
-		return true;
-	} else {
+	int i;
+
+	if (nv_cache->chunk_open_count) {
 		return false;
 	}
+
+	for (i = 0; i < FTL_STREAM_COUNT; i++) {
+		if (nv_cache->chunk_current[i]) {
+			return false;
+		}
+	}
+
+	return true;
 }
 
 bool
@@ -1656,7 +1819,7 @@ ftl_nv_cache_load_state(struct ftl_nv_cache *nv_cache)
 	int status = 0;
 	bool active;
 
-	nv_cache->chunk_current = NULL;
+	memset(nv_cache->chunk_current, 0, sizeof(nv_cache->chunk_current));
 	TAILQ_INIT(&nv_cache->chunk_free_list);
 	TAILQ_INIT(&nv_cache->chunk_full_list);
 	TAILQ_INIT(&nv_cache->chunk_inactive_list);
@@ -1756,7 +1919,9 @@ ftl_nv_cache_load_state(struct ftl_nv_cache *nv_cache)
 
 	chunks_number = nv_cache->chunk_free_count + nv_cache->chunk_full_count +
 			nv_cache->chunk_inactive_count;
-	assert(nv_cache->chunk_current == NULL);
+	for (i = 0; i < FTL_STREAM_COUNT; i++) {
+		assert(nv_cache->chunk_current[i] == NULL);
+	}
 
 	if (chunks_number != nv_cache->chunk_count) {
 		FTL_ERRLOG(dev, "Inconsistent NV cache metadata\n");
@@ -2052,6 +2217,7 @@ ftl_chunk_read_tail_md(struct ftl_nv_cache_chunk *chunk, struct ftl_basic_rq *br
 
 struct restore_chunk_md_ctx {
 	ftl_chunk_md_cb cb;
+	ftl_chunk_md_filter_cb filter;
 	void *cb_ctx;
 	int status;
 	uint64_t qd;
@@ -2096,7 +2262,8 @@ walk_tail_md_cb(struct ftl_basic_rq *brq)
 
 static void
 ftl_mngt_nv_cache_walk_tail_md(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt,
-			       uint64_t seq_id, ftl_chunk_md_cb cb, void *cb_ctx)
+			       uint64_t seq_id, ftl_chunk_md_cb cb, ftl_chunk_md_filter_cb filter,
+			       void *cb_ctx)
 {
 	struct ftl_nv_cache *nvc = &dev->nv_cache;
 	struct restore_chunk_md_ctx *ctx;
@@ -2111,6 +2278,7 @@ ftl_mngt_nv_cache_walk_tail_md(struct spdk_ftl_dev *dev, struct ftl_mngt_process
 		assert(ctx);
 
 		ctx->cb = cb;
+		ctx->filter = filter;
 		ctx->cb_ctx = cb_ctx;
 	}
 
@@ -2148,6 +2316,11 @@ ftl_mngt_nv_cache_walk_tail_md(struct spdk_ftl_dev *dev, struct ftl_mngt_process
 			continue;
 		}
 
+		if (ctx->filter && !ctx->filter(chunk, ctx->cb_ctx)) {
+			ctx->id++;
+			continue;
+		}
+
 		if (chunk_alloc_p2l_map(chunk)) {
 			/* No more free P2L map, break and continue later */
 			break;
@@ -2178,9 +2351,9 @@ ftl_mngt_nv_cache_walk_tail_md(struct spdk_ftl_dev *dev, struct ftl_mngt_process
 
 void
 ftl_mngt_nv_cache_restore_l2p(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt,
-			      ftl_chunk_md_cb cb, void *cb_ctx)
+			      ftl_chunk_md_cb cb, ftl_chunk_md_filter_cb filter, void *cb_ctx)
 {
-	ftl_mngt_nv_cache_walk_tail_md(dev, mngt, dev->sb->ckpt_seq_id, cb, cb_ctx);
+	ftl_mngt_nv_cache_walk_tail_md(dev, mngt, dev->sb->ckpt_seq_id, cb, filter, cb_ctx);
 }
 
 static void
@@ -2461,6 +2634,7 @@ ftl_nv_cache_halt(struct ftl_nv_cache *nv_cache)
 {
 	struct ftl_nv_cache_chunk *chunk;
 	uint64_t free_space;
+	int i;
 
 	nv_cache->halt = true;
 
@@ -2483,12 +2657,16 @@ ftl_nv_cache_halt(struct ftl_nv_cache *nv_cache)
 		nv_cache->chunk_open_count--;
 	}
 
-	/* Close current chunk by skipping all not written blocks */
-	chunk = nv_cache->chunk_current;
-	if (chunk != NULL) {
-		nv_cache->chunk_current = NULL;
+	/* Close current chunks by skipping all not written blocks */
+	for (i = 0; i < FTL_STREAM_COUNT; i++) {
+		chunk = nv_cache->chunk_current[i];
+		if (chunk == NULL) {
+			continue;
+		}
+
+		nv_cache->chunk_current[i] = NULL;
 		if (chunk_is_closed(chunk)) {
-			return;
+			continue;
 		}
 
 		free_space = chunk_get_free_space(nv_cache, chunk);
@@ -2502,35 +2680,49 @@ ftl_nv_cache_halt(struct ftl_nv_cache *nv_cache)
 uint64_t
 ftl_nv_cache_acquire_trim_seq_id(struct ftl_nv_cache *nv_cache)
 {
-	struct ftl_nv_cache_chunk *chunk = nv_cache->chunk_current;
-	uint64_t seq_id, free_space;
+	struct ftl_nv_cache_chunk *chunk;
+	uint64_t seq_id = 0, free_space;
+	int i;
 
-	if (!chunk) {
-		chunk = TAILQ_FIRST(&nv_cache->chunk_open_list);
-		if (chunk && chunk->md->state == FTL_CHUNK_STATE_OPEN) {
-			return chunk->md->seq_id;
-		} else {
+	for (i = 0; i < FTL_STREAM_COUNT; i++) {
+		chunk = nv_cache->chunk_current[i];
+		if (chunk && chunk_is_closed(chunk)) {
 			return 0;
 		}
 	}
 
-	if (chunk_is_closed(chunk)) {
-		return 0;
+	/*
+	 * Close current chunks of all streams, chunks opened later have higher sequence ids than
+	 * any of them
+	 */
+	for (i = 0; i < FTL_STREAM_COUNT; i++) {
+		chunk = nv_cache->chunk_current[i];
+		if (!chunk) {
+			continue;
+		}
+
+		seq_id = spdk_max(seq_id, chunk->md->seq_id + 1);
+		free_space = chunk_get_free_space(nv_cache, chunk);
+
+		chunk->md->blocks_skipped = free_space;
+		chunk->md->blocks_written += free_space;
+		chunk->md->write_pointer += free_space;
+		if (chunk->md->blocks_written == chunk_tail_md_offset(nv_cache)) {
+			ftl_chunk_close(chunk);
+		}
+		nv_cache->chunk_current[i] = NULL;
 	}
 
-	seq_id = nv_cache->chunk_current->md->seq_id;
-	free_space = chunk_get_free_space(nv_cache, chunk);
+	if (seq_id) {
+		return seq_id;
+	}
 
-	chunk->md->blocks_skipped = free_space;
-	chunk->md->blocks_written += free_space;
-	chunk->md->write_pointer += free_space;
-	if (chunk->md->blocks_written == chunk_tail_md_offset(nv_cache)) {
-		ftl_chunk_close(chunk);
+	chunk = TAILQ_FIRST(&nv_cache->chunk_open_list);
+	if (chunk && chunk->md->state == FTL_CHUNK_STATE_OPEN) {
+		return chunk->md->seq_id;
 	}
-	nv_cache->chunk_current = NULL;
 
-	seq_id++;
-	return seq_id;
+	return 0;
 }
 
 static double
@@ -33,13 +33,25 @@
 #define FTL_NV_CACHE_NUM_COMPACTORS 8
 
 /*
- * Parameters controlling nv cache write throttling.
+ * Parameters controlling nv cache compaction and write throttling.
+ *
+ * Every throttle interval the number of user blocks written to the cache (ingress), the number
+ * of blocks moved to the base device by a single compactor and the change of the free chunk count
+ * are measured and smoothed with an exponentially weighted moving average.
+ *
+ * Compaction starts ahead of the compaction threshold, as soon as the cache would reach it within
+ * FTL_NV_CACHE_COMPACTION_LEAD_MS at the current ingress. All compactors are active while user
+ * writes are throttled or free chunks are below the target. Otherwise the ingress shows the user
+ * demand and the number of active compactors is sized to keep up with it.
  *
  * The write throttle limit value is calculated as follows:
- * limit = compaction_average_bw * (1.0 + modifier)
+ * limit = compaction_bw * (1.0 + modifier)
  *
- * The modifier depends on the number of free chunks vs the configured threshold. Its value is
- * zero if the number of free chunks is at the threshold, negative if below and positive if above.
+ * The modifier depends on the number of free chunks vs the configured threshold, projected
+ * FTL_NV_CACHE_THROTTLE_LOOKAHEAD intervals ahead using the free chunk trend. Its value is zero
+ * if the projected number of free chunks is at the threshold, negative if below and positive if
+ * above. The limit is lowered by at most FTL_NV_CACHE_THROTTLE_MAX_STEP per interval, so user
+ * writes slow down gradually instead of dropping to the compaction bandwidth at once.
  */
 
 /* Interval in milliseconds between write throttle updates. */
@@ -49,6 +61,14 @@
 /* Min and max modifier values */
 #define FTL_NV_CACHE_THROTTLE_MODIFIER_MIN	-0.8
 #define FTL_NV_CACHE_THROTTLE_MODIFIER_MAX	0.5
+/* Number of intervals the free chunk trend is projected ahead */
+#define FTL_NV_CACHE_THROTTLE_LOOKAHEAD		10
+/* Max relative decrease of the throttle limit per interval */
+#define FTL_NV_CACHE_THROTTLE_MAX_STEP		0.25
+/* Weight of the most recent interval in the moving averages */
+#define FTL_NV_CACHE_CTRL_EWMA_WEIGHT		0.25
+/* Time in milliseconds compaction starts ahead of the cache reaching the threshold */
+#define FTL_NV_CACHE_COMPACTION_LEAD_MS		1000
 
 struct ftl_nvcache_restore;
 typedef void (*ftl_nv_cache_restore_fn)(struct ftl_nvcache_restore *, int, void *cb_arg);
@@ -95,8 +115,11 @@ struct ftl_nv_cache_chunk_md {
 	/* P2L IO log type */
 	enum ftl_layout_region_type p2l_log_type;
 
+	/* Stream of the data written to the chunk */
+	enum ftl_stream stream;
+
 	/* Reserved */
-	uint8_t reserved[4040];
+	uint8_t reserved[4036];
 } __attribute__((packed));
 
 SPDK_STATIC_ASSERT(sizeof(struct ftl_nv_cache_chunk_md) == FTL_BLOCK_SIZE,
@@ -137,6 +160,8 @@ struct ftl_nv_cache_chunk {
 struct ftl_nv_cache_compactor {
 	struct ftl_nv_cache *nv_cache;
 	struct ftl_rq *rq;
+	/* Stream of the chunks compacted by the request */
+	enum ftl_stream stream;
 	TAILQ_ENTRY(ftl_nv_cache_compactor) entry;
 	struct spdk_bdev_io_wait_entry bdev_io_wait;
 };
@@ -181,8 +206,8 @@ struct ftl_nv_cache {
 	/* Number of chunks */
 	uint64_t chunk_count;
 
-	/* Current processed chunk */
-	struct ftl_nv_cache_chunk *chunk_current;
+	/* Current processed chunk of each stream */
+	struct ftl_nv_cache_chunk *chunk_current[FTL_STREAM_COUNT];
 
 	/* Free chunks list */
 	TAILQ_HEAD(, ftl_nv_cache_chunk) chunk_free_list;
@@ -236,6 +261,26 @@ struct ftl_nv_cache {
 		uint64_t blocks_submitted;
 		uint64_t blocks_submitted_limit;
 	} throttle;
+
+	/* Feedback controller state for compaction and write throttling */
+	struct {
+		/* Moving average of user blocks written per interval */
+		double ingress_blocks;
+		/* Moving average of blocks compacted per interval by a single compactor */
+		double compactor_blocks;
+		/* Moving average of the free chunk count change per interval */
+		double free_trend;
+		/* Blocks compacted in the current interval */
+		uint64_t blocks_compacted;
+		/* Sum of active compactors sampled on each poll of the current interval */
+		uint64_t active_sum;
+		uint64_t polls;
+		uint64_t last_free_count;
+		/* Number of compactors allowed to be active */
+		uint64_t compaction_target;
+		/* Number of chunks ahead of the threshold compaction starts at */
+		uint64_t compaction_lead;
+	} ctrl;
 };
 
 typedef void (*nvc_scrub_cb)(struct spdk_ftl_dev *dev, void *cb_ctx, int status);
@@ -295,8 +340,11 @@ void ftl_mngt_nv_cache_recover_open_chunk(struct spdk_ftl_dev *dev, struct ftl_m
 
 typedef int (*ftl_chunk_md_cb)(struct ftl_nv_cache_chunk *chunk, void *cntx);
 
+/* Returns false if the chunk's P2L map doesn't need to be read */
+typedef bool (*ftl_chunk_md_filter_cb)(struct ftl_nv_cache_chunk *chunk, void *cntx);
+
 void ftl_mngt_nv_cache_restore_l2p(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt,
-				   ftl_chunk_md_cb cb, void *cb_ctx);
+				   ftl_chunk_md_cb cb, ftl_chunk_md_filter_cb filter, void *cb_ctx);
 
 struct ftl_nv_cache_chunk *ftl_nv_cache_get_chunk_from_addr(struct spdk_ftl_dev *dev,
 		ftl_addr addr);
@@ -8,6 +8,9 @@
 #include "ftl_writer.h"
 #include "ftl_band.h"
 
+SPDK_STATIC_ASSERT(FTL_STREAM_COUNT <= FTL_LAYOUT_REGION_TYPE_P2L_COUNT / 2,
+		   "Not enough open bands for all streams");
+
 void
 ftl_writer_init(struct spdk_ftl_dev *dev, struct ftl_writer *writer,
 		uint64_t limit, enum ftl_band_type type)
@@ -80,6 +83,35 @@ is_active(struct ftl_writer *writer)
 	return true;
 }
 
+static bool
+can_open_band(struct ftl_writer *writer)
+{
+	struct spdk_ftl_dev *dev = writer->dev;
+	struct ftl_writer *user;
+	uint64_t num_bands = 0;
+	int i;
+
+	/* Maximum number of opened bands is split between compaction and GC writers */
+	if (writer->writer_type == FTL_BAND_TYPE_GC) {
+		return writer->num_bands < FTL_LAYOUT_REGION_TYPE_P2L_COUNT / 2;
+	}
+
+	/*
+	 * Compaction writers of all streams share their half. A writer which has a band already
+	 * doesn't get another one while a writer of some other stream is waiting without any.
+	 */
+	for (i = 0; i < FTL_STREAM_COUNT; i++) {
+		user = &dev->writer_user[i];
+		num_bands += user->num_bands;
+
+		if (writer->num_bands && !user->num_bands && !TAILQ_EMPTY(&user->rq_queue)) {
+			return false;
+		}
+	}
+
+	return num_bands < FTL_LAYOUT_REGION_TYPE_P2L_COUNT / 2;
+}
+
 static struct ftl_band *
 get_band(struct ftl_writer *writer)
 {
@@ -100,10 +132,7 @@ get_band(struct ftl_writer *writer)
 			}
 		}
 
-		if (writer->num_bands >= FTL_LAYOUT_REGION_TYPE_P2L_COUNT / 2) {
-			/* Maximum number of opened band exceed (we split this
-			 * value between and compaction and GC writer
-			 */
+		if (!can_open_band(writer)) {
 			return NULL;
 		}
 
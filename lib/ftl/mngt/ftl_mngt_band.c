@@ -103,6 +103,7 @@ ftl_dev_init_bands_md(struct spdk_ftl_dev *dev)
 static void
 ftl_dev_deinit_bands(struct spdk_ftl_dev *dev)
 {
+	ftl_band_gc_index_fini(dev);
 	free(dev->bands);
 }
 
@@ -237,6 +238,7 @@ ftl_recover_max_seq(struct spdk_ftl_dev *dev)
 	uint64_t band_close_seq_id = 0, band_open_seq_id = 0;
 	uint64_t chunk_close_seq_id = 0, chunk_open_seq_id = 0;
 	uint64_t max = 0;
+	int i;
 
 	TAILQ_FOREACH(band, &dev->shut_bands, queue_entry) {
 		band_open_seq_id = spdk_max(band_open_seq_id, band->md->seq);
@@ -247,7 +249,9 @@ ftl_recover_max_seq(struct spdk_ftl_dev *dev)
 
 	dev->nv_cache.last_seq_id = chunk_close_seq_id;
 	dev->writer_gc.last_seq_id = band_close_seq_id;
-	dev->writer_user.last_seq_id = band_close_seq_id;
+	for (i = 0; i < FTL_STREAM_COUNT; ++i) {
+		dev->writer_user[i].last_seq_id = band_close_seq_id;
+	}
 
 	max = spdk_max(max, band_open_seq_id);
 	max = spdk_max(max, band_close_seq_id);
@@ -293,6 +297,11 @@ finalize_init_gc(struct spdk_ftl_dev *dev)
 	ftl_band_init_gc_iter(dev);
 	dev->sb_shm->gc_info.band_id_high_prio = FTL_BAND_ID_INVALID;
 
+	if (ftl_band_gc_index_init(dev)) {
+		FTL_ERRLOG(dev, "Failed to initialize GC victim index\n");
+		return -1;
+	}
+
 	if (0 == dev->num_free) {
 		/* Get number of available blocks in writer */
 		free_blocks = ftl_writer_get_free_blocks(&dev->writer_gc);
@@ -390,7 +399,9 @@ ftl_mngt_finalize_init_bands(struct spdk_ftl_dev *dev, struct ftl_mngt_process *
 		band = open_bands[i];
 
 		if (band->md->type == FTL_BAND_TYPE_COMPACTION) {
-			writer = &dev->writer_user;
+			writer = &dev->writer_user[FTL_STREAM_COLD];
+		} else if (band->md->type == FTL_BAND_TYPE_COMPACTION_HOT) {
+			writer = &dev->writer_user[FTL_STREAM_HOT];
 		} else if (band->md->type == FTL_BAND_TYPE_GC) {
 			writer = &dev->writer_gc;
 		} else {
@@ -178,6 +178,8 @@ ftl_mngt_scrub_nv_cache(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt)
 void
 ftl_mngt_finalize_startup(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt)
 {
+	int i;
+
 	if (ftl_bitmap_find_first_set(dev->trim_map, 0, UINT64_MAX) != UINT64_MAX) {
 		dev->trim_in_progress = true;
 	}
@@ -195,7 +197,9 @@ ftl_mngt_finalize_startup(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mng
 
 	ftl_l2p_resume(dev);
 	ftl_reloc_resume(dev->reloc);
-	ftl_writer_resume(&dev->writer_user);
+	for (i = 0; i < FTL_STREAM_COUNT; ++i) {
+		ftl_writer_resume(&dev->writer_user[i]);
+	}
 	ftl_writer_resume(&dev->writer_gc);
 	ftl_nv_cache_resume(&dev->nv_cache);
 
@@ -335,6 +339,28 @@ ftl_mngt_deinit_trim_map(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt
 	ftl_mngt_next_step(mngt);
 }
 
+void
+ftl_mngt_init_heat_map(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt)
+{
+	dev->heat = ftl_heat_create(dev->num_lbas, FTL_HEAT_MAX_RANGES);
+	if (!dev->heat) {
+		FTL_ERRLOG(dev, "Failed to create heat map\n");
+		ftl_mngt_fail_step(mngt);
+		return;
+	}
+
+	ftl_mngt_next_step(mngt);
+}
+
+void
+ftl_mngt_deinit_heat_map(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt)
+{
+	ftl_heat_destroy(dev->heat);
+	dev->heat = NULL;
+
+	ftl_mngt_next_step(mngt);
+}
+
 struct ftl_mngt_property_caller_ctx {
 	struct spdk_ftl_dev *dev;
 	struct spdk_jsonrpc_request *request;
@@ -15,6 +15,36 @@
 #include "ftl_mngt_steps.h"
 #include "utils/ftl_addr_utils.h"
 
+/*
+ * Range of LBAs found in a P2L map of a band or chunk. It's collected when the map is read in
+ * the first recovery iteration, next iterations skip reading maps not overlapping their LBAs.
+ */
+struct recovery_lba_range {
+	uint64_t first;
+	uint64_t last;
+	bool known;
+};
+
+enum recovery_phase {
+	RECOVERY_PHASE_LOAD_L2P,
+	RECOVERY_PHASE_INIT_SEQ_IDS,
+	RECOVERY_PHASE_CHUNK_L2P,
+	RECOVERY_PHASE_BAND_L2P,
+	RECOVERY_PHASE_VALID_MAP,
+	RECOVERY_PHASE_SAVE_L2P,
+	RECOVERY_PHASE_COUNT,
+	RECOVERY_PHASE_NONE = RECOVERY_PHASE_COUNT
+};
+
+static const char *g_recovery_phase_names[RECOVERY_PHASE_COUNT] = {
+	[RECOVERY_PHASE_LOAD_L2P] = "Load L2P",
+	[RECOVERY_PHASE_INIT_SEQ_IDS] = "Initialize sequence IDs",
+	[RECOVERY_PHASE_CHUNK_L2P] = "Restore chunk L2P",
+	[RECOVERY_PHASE_BAND_L2P] = "Restore band L2P",
+	[RECOVERY_PHASE_VALID_MAP] = "Restore valid map",
+	[RECOVERY_PHASE_SAVE_L2P] = "Save L2P",
+};
+
 struct ftl_mngt_recovery_ctx {
 	/* Main recovery FTL management process */
 	struct ftl_mngt_process *main;
@@ -35,12 +65,90 @@ struct ftl_mngt_recovery_ctx {
 		uint32_t i;
 	} iter;
 	uint64_t p2l_ckpt_seq_id[FTL_LAYOUT_REGION_TYPE_P2L_COUNT];
+	struct {
+		struct recovery_lba_range *band;
+		struct recovery_lba_range *chunk;
+		uint64_t bands_read;
+		uint64_t bands_skipped;
+		uint64_t chunks_read;
+		uint64_t chunks_skipped;
+	} range;
+	struct {
+		enum recovery_phase current;
+		uint64_t tsc_start;
+		uint64_t tsc[RECOVERY_PHASE_COUNT];
+	} phase;
 };
 
 static const struct ftl_mngt_process_desc g_desc_recovery_iteration;
 static const struct ftl_mngt_process_desc g_desc_recovery;
 static const struct ftl_mngt_process_desc g_desc_recovery_shm;
 
+static void
+recovery_phase_enter(struct ftl_mngt_recovery_ctx *ctx, enum recovery_phase phase)
+{
+	uint64_t tsc;
+
+	if (ctx->phase.current == phase) {
+		return;
+	}
+
+	tsc = spdk_get_ticks();
+	if (ctx->phase.current != RECOVERY_PHASE_NONE) {
+		ctx->phase.tsc[ctx->phase.current] += tsc - ctx->phase.tsc_start;
+	}
+
+	ctx->phase.current = phase;
+	ctx->phase.tsc_start = tsc;
+}
+
+static void
+recovery_phase_report(struct spdk_ftl_dev *dev, struct ftl_mngt_recovery_ctx *ctx)
+{
+	uint64_t hz = spdk_get_ticks_hz();
+	int phase;
+
+	recovery_phase_enter(ctx, RECOVERY_PHASE_NONE);
+
+	FTL_NOTICELOG(dev, "Recovery iterations time per phase:\n");
+	for (phase = 0; phase < RECOVERY_PHASE_COUNT; phase++) {
+		FTL_NOTICELOG(dev, "\t %s: %.3f ms\n", g_recovery_phase_names[phase],
+			      (double)ctx->phase.tsc[phase] * 1000 / hz);
+	}
+	FTL_NOTICELOG(dev, "Band P2L maps read: %"PRIu64", skipped: %"PRIu64"\n",
+		      ctx->range.bands_read, ctx->range.bands_skipped);
+	FTL_NOTICELOG(dev, "Chunk P2L maps read: %"PRIu64", skipped: %"PRIu64"\n",
+		      ctx->range.chunks_read, ctx->range.chunks_skipped);
+}
+
+static inline void
+recovery_lba_range_init(struct recovery_lba_range *range)
+{
+	range->first = UINT64_MAX;
+	range->last = 0;
+	range->known = false;
+}
+
+static inline void
+recovery_lba_range_update(struct recovery_lba_range *range, uint64_t lba)
+{
+	range->first = spdk_min(range->first, lba);
+	range->last = spdk_max(range->last, lba);
+}
+
+static inline bool
+recovery_lba_range_overlaps(const struct recovery_lba_range *range,
+			    const struct ftl_mngt_recovery_ctx *ctx)
+{
+	if (!range->known) {
+		return true;
+	}
+
+	/* Empty ranges (first > last) never overlap */
+	return range->first < ctx->iter.lba_last && range->last >= ctx->iter.lba_first &&
+	       range->first <= range->last;
+}
+
 static bool
 recovery_iter_done(struct spdk_ftl_dev *dev, struct ftl_mngt_recovery_ctx *ctx)
 {
@@ -79,7 +187,7 @@ ftl_mngt_recovery_init(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt)
 	struct ftl_mngt_recovery_ctx *ctx = ftl_mngt_get_process_ctx(mngt);
 	const uint64_t lbas_in_block = FTL_BLOCK_SIZE / dev->layout.l2p.addr_size;
 	uint64_t mem_limit, lba_limit, l2p_limit, iterations, seq_limit;
-	uint64_t l2p_limit_block, seq_limit_block, md_blocks;
+	uint64_t l2p_limit_block, seq_limit_block, md_blocks, i;
 	int md_flags;
 
 	ctx->main = mngt;
@@ -151,6 +259,20 @@ ftl_mngt_recovery_init(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt)
 	ctx->l2p_snippet.seq_id = (uint64_t *)((char *)ftl_md_get_buffer(ctx->l2p_snippet.md) +
 					       (l2p_limit_block * FTL_BLOCK_SIZE));
 
+	ctx->range.band = calloc(ftl_get_num_bands(dev), sizeof(*ctx->range.band));
+	ctx->range.chunk = calloc(dev->nv_cache.chunk_count, sizeof(*ctx->range.chunk));
+	if (!ctx->range.band || !ctx->range.chunk) {
+		ftl_mngt_fail_step(mngt);
+		return;
+	}
+	for (i = 0; i < ftl_get_num_bands(dev); i++) {
+		recovery_lba_range_init(&ctx->range.band[i]);
+	}
+	for (i = 0; i < dev->nv_cache.chunk_count; i++) {
+		recovery_lba_range_init(&ctx->range.chunk[i]);
+	}
+	ctx->phase.current = RECOVERY_PHASE_NONE;
+
 	TAILQ_INIT(&ctx->open_bands);
 	ftl_mngt_next_step(mngt);
 }
@@ -160,10 +282,19 @@ ftl_mngt_recovery_deinit(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt
 {
 	struct ftl_mngt_recovery_ctx *ctx = ftl_mngt_get_process_ctx(mngt);
 
+	if (ctx->l2p_snippet.md && recovery_iter_done(dev, ctx)) {
+		recovery_phase_report(dev, ctx);
+	}
+
 	ftl_md_destroy(ctx->l2p_snippet.md, 0);
 	ctx->l2p_snippet.md = NULL;
 	ctx->l2p_snippet.seq_id = NULL;
 
+	free(ctx->range.band);
+	ctx->range.band = NULL;
+	free(ctx->range.chunk);
+	ctx->range.chunk = NULL;
+
 	ftl_mngt_next_step(mngt);
 }
 
@@ -172,6 +303,7 @@ recovery_iteration_cb(struct spdk_ftl_dev *dev, void *_ctx, int status)
 {
 	struct ftl_mngt_recovery_ctx *ctx = _ctx;
 
+	recovery_phase_enter(ctx, RECOVERY_PHASE_NONE);
 	recovery_iter_advance(dev, ctx);
 
 	if (status) {
@@ -258,6 +390,7 @@ static void
 ftl_mngt_recovery_walk_band_tail_md(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt,
 				    ftl_band_md_cb cb)
 {
+	struct ftl_mngt_recovery_ctx *pctx = ftl_mngt_get_caller_ctx(mngt);
 	struct band_md_ctx *sctx = ftl_mngt_get_step_ctx(mngt);
 	uint64_t num_bands = ftl_get_num_bands(dev);
 
@@ -295,6 +428,13 @@ ftl_mngt_recovery_walk_band_tail_md(struct spdk_ftl_dev *dev, struct ftl_mngt_pr
 				continue;
 			}
 
+			if (!recovery_lba_range_overlaps(&pctx->range.band[band->id], pctx)) {
+				/* No LBAs of the current iteration in the band */
+				pctx->range.bands_skipped++;
+				sctx->id++;
+				continue;
+			}
+
 			band->md->df_p2l_map = FTL_DF_OBJ_ID_INVALID;
 			if (ftl_band_alloc_p2l_map(band)) {
 				/* No more free P2L map, try later */
@@ -303,6 +443,7 @@ ftl_mngt_recovery_walk_band_tail_md(struct spdk_ftl_dev *dev, struct ftl_mngt_pr
 		}
 
 		sctx->id++;
+		pctx->range.bands_read++;
 		ftl_band_read_tail_brq_md(band, cb, mngt);
 		sctx->qd++;
 	}
@@ -327,6 +468,8 @@ ftl_mngt_recovery_iteration_init_seq_ids(struct spdk_ftl_dev *dev, struct ftl_mn
 	uint32_t lbas_in_page = FTL_BLOCK_SIZE / dev->layout.l2p.addr_size;
 	uint64_t lba, lba_off;
 
+	recovery_phase_enter(ctx, RECOVERY_PHASE_INIT_SEQ_IDS);
+
 	if (dev->sb->ckpt_seq_id) {
 		FTL_ERRLOG(dev, "Checkpoint recovery not supported!\n");
 		ftl_mngt_fail_step(mngt);
@@ -369,6 +512,8 @@ ftl_mngt_recovery_iteration_load_l2p(struct spdk_ftl_dev *dev, struct ftl_mngt_p
 	struct ftl_md *md = ctx->l2p_snippet.md;
 	struct ftl_layout_region *region = &ctx->l2p_snippet.region;
 
+	recovery_phase_enter(ctx, RECOVERY_PHASE_LOAD_L2P);
+
 	FTL_NOTICELOG(dev, "L2P recovery, iteration %u\n", ctx->iter.i);
 	FTL_NOTICELOG(dev, "Load L2P, blocks [%"PRIu64", %"PRIu64"), LBAs [%"PRIu64", %"PRIu64")\n",
 		      region->current.offset, region->current.offset + region->current.blocks,
@@ -387,6 +532,8 @@ ftl_mngt_recovery_iteration_save_l2p(struct spdk_ftl_dev *dev, struct ftl_mngt_p
 	struct ftl_mngt_recovery_ctx *ctx = ftl_mngt_get_caller_ctx(mngt);
 	struct ftl_md *md = ctx->l2p_snippet.md;
 
+	recovery_phase_enter(ctx, RECOVERY_PHASE_SAVE_L2P);
+
 	md->owner.cb_ctx = mngt;
 	md->cb = l2p_cb;
 	ftl_md_persist(md);
@@ -399,6 +546,7 @@ restore_band_l2p_cb(struct ftl_band *band, void *cntx, enum ftl_md_status status
 	struct ftl_mngt_recovery_ctx *pctx = ftl_mngt_get_caller_ctx(mngt);
 	struct band_md_ctx *sctx = ftl_mngt_get_step_ctx(mngt);
 	struct spdk_ftl_dev *dev = band->dev;
+	struct recovery_lba_range *range = &pctx->range.band[band->id];
 	ftl_addr addr, curr_addr;
 	uint64_t i, lba, seq_id, num_blks_in_band;
 	uint32_t band_map_crc;
@@ -435,6 +583,7 @@ restore_band_l2p_cb(struct ftl_band *band, void *cntx, enum ftl_md_status status
 			rc = -EINVAL;
 			break;
 		}
+		recovery_lba_range_update(range, lba);
 		if (lba < pctx->iter.lba_first || lba >= pctx->iter.lba_last) {
 			continue;
 		}
@@ -473,6 +622,9 @@ restore_band_l2p_cb(struct ftl_band *band, void *cntx, enum ftl_md_status status
 		pctx->l2p_snippet.seq_id[lba_off] = seq_id;
 	}
 
+	if (!rc) {
+		range->known = true;
+	}
 
 cleanup:
 	ftl_band_release_p2l_map(band);
@@ -489,6 +641,7 @@ static void
 ftl_mngt_recovery_iteration_restore_band_l2p(struct spdk_ftl_dev *dev,
 		struct ftl_mngt_process *mngt)
 {
+	recovery_phase_enter(ftl_mngt_get_caller_ctx(mngt), RECOVERY_PHASE_BAND_L2P);
 	ftl_mngt_recovery_walk_band_tail_md(dev, mngt, restore_band_l2p_cb);
 }
 
@@ -498,12 +651,14 @@ restore_chunk_l2p_cb(struct ftl_nv_cache_chunk *chunk, void *ctx)
 	struct ftl_mngt_recovery_ctx *pctx = ctx;
 	struct spdk_ftl_dev *dev;
 	struct ftl_nv_cache *nv_cache = chunk->nv_cache;
+	struct recovery_lba_range *range = &pctx->range.chunk[chunk - nv_cache->chunks];
 	ftl_addr addr;
 	const uint64_t seq_id = chunk->md->seq_id;
 	uint64_t i, lba;
 	uint32_t chunk_map_crc;
 
 	dev = SPDK_CONTAINEROF(chunk->nv_cache, struct spdk_ftl_dev, nv_cache);
+	pctx->range.chunks_read++;
 
 	chunk_map_crc = spdk_crc32c_update(chunk->p2l_map.chunk_map,
 					   ftl_nv_cache_chunk_tail_md_num_blocks(chunk->nv_cache) * FTL_BLOCK_SIZE, 0);
@@ -524,6 +679,7 @@ restore_chunk_l2p_cb(struct ftl_nv_cache_chunk *chunk, void *ctx)
 			FTL_ERRLOG(dev, "L2P Chunk restore ERROR, LBA out of range\n");
 			return -1;
 		}
+		recovery_lba_range_update(range, lba);
 		if (lba < pctx->iter.lba_first || lba >= pctx->iter.lba_last) {
 			continue;
 		}
@@ -539,14 +695,33 @@ restore_chunk_l2p_cb(struct ftl_nv_cache_chunk *chunk, void *ctx)
 		pctx->l2p_snippet.seq_id[lba_off] = seq_id;
 	}
 
+	range->known = true;
 	return 0;
 }
 
+static bool
+restore_chunk_l2p_filter(struct ftl_nv_cache_chunk *chunk, void *ctx)
+{
+	struct ftl_mngt_recovery_ctx *pctx = ctx;
+	struct recovery_lba_range *range = &pctx->range.chunk[chunk - chunk->nv_cache->chunks];
+
+	if (!recovery_lba_range_overlaps(range, pctx)) {
+		/* No LBAs of the current iteration in the chunk */
+		pctx->range.chunks_skipped++;
+		return false;
+	}
+
+	return true;
+}
+
 static void
 ftl_mngt_recovery_iteration_restore_chunk_l2p(struct spdk_ftl_dev *dev,
 		struct ftl_mngt_process *mngt)
 {
-	ftl_mngt_nv_cache_restore_l2p(dev, mngt, restore_chunk_l2p_cb, ftl_mngt_get_caller_ctx(mngt));
+	struct ftl_mngt_recovery_ctx *pctx = ftl_mngt_get_caller_ctx(mngt);
+
+	recovery_phase_enter(pctx, RECOVERY_PHASE_CHUNK_L2P);
+	ftl_mngt_nv_cache_restore_l2p(dev, mngt, restore_chunk_l2p_cb, restore_chunk_l2p_filter, pctx);
 }
 
 static void
@@ -557,6 +732,8 @@ ftl_mngt_recovery_iteration_restore_valid_map(struct spdk_ftl_dev *dev,
 	uint64_t lba, lba_off;
 	ftl_addr addr;
 
+	recovery_phase_enter(pctx, RECOVERY_PHASE_VALID_MAP);
+
 	for (lba = pctx->iter.lba_first; lba < pctx->iter.lba_last; lba++) {
 		lba_off = lba - pctx->iter.lba_first;
 		addr = ftl_addr_load(dev, pctx->l2p_snippet.l2p, lba_off);
@@ -125,6 +125,11 @@ static const struct ftl_mngt_process_desc desc_startup = {
 			.action = ftl_mngt_init_trim_map,
 			.cleanup = ftl_mngt_deinit_trim_map
 		},
+		{
+			.name = "Initialize heat map",
+			.action = ftl_mngt_init_heat_map,
+			.cleanup = ftl_mngt_deinit_heat_map
+		},
 		{
 			.name = "Initialize bands metadata",
 			.action = ftl_mngt_init_bands_md,
@@ -0,0 +1,149 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+#include "spdk/util.h"
+
+#include "ftl_heat.h"
+
+struct ftl_heat {
+	/* Saturating write counter of each range */
+	uint8_t *counters;
+
+	/* Sequence id of the newest chunk each range was written to */
+	uint64_t *seq_ids;
+
+	/* Number of ranges */
+	uint64_t num_ranges;
+
+	/* Log2 of number of LBAs in a range */
+	uint64_t range_shift;
+
+	/* Next range to be aged */
+	uint64_t hand;
+};
+
+struct ftl_heat *
+ftl_heat_create(uint64_t num_lbas, uint64_t max_ranges)
+{
+	struct ftl_heat *heat;
+
+	if (!num_lbas || !max_ranges) {
+		return NULL;
+	}
+
+	heat = calloc(1, sizeof(*heat));
+	if (!heat) {
+		return NULL;
+	}
+
+	while (spdk_divide_round_up(num_lbas, 1ULL << heat->range_shift) > max_ranges) {
+		heat->range_shift++;
+	}
+
+	heat->num_ranges = spdk_divide_round_up(num_lbas, 1ULL << heat->range_shift);
+	heat->counters = calloc(heat->num_ranges, sizeof(*heat->counters));
+	heat->seq_ids = calloc(heat->num_ranges, sizeof(*heat->seq_ids));
+	if (!heat->counters || !heat->seq_ids) {
+		free(heat->counters);
+		free(heat->seq_ids);
+		free(heat);
+		return NULL;
+	}
+
+	return heat;
+}
+
+void
+ftl_heat_destroy(struct ftl_heat *heat)
+{
+	if (!heat) {
+		return;
+	}
+
+	free(heat->counters);
+	free(heat->seq_ids);
+	free(heat);
+}
+
+static void
+heat_decay(struct ftl_heat *heat)
+{
+	uint64_t i;
+
+	for (i = 0; i < FTL_HEAT_DECAY_STEP; i++) {
+		heat->counters[heat->hand] >>= 1;
+		if (++heat->hand == heat->num_ranges) {
+			heat->hand = 0;
+		}
+	}
+}
+
+void
+ftl_heat_update(struct ftl_heat *heat, uint64_t lba, uint64_t num_blocks)
+{
+	uint64_t range = lba >> heat->range_shift;
+	uint64_t last = (lba + num_blocks - 1) >> heat->range_shift;
+
+	assert(num_blocks);
+	assert(last < heat->num_ranges);
+
+	for (; range <= last; range++) {
+		if (heat->counters[range] < UINT8_MAX) {
+			heat->counters[range]++;
+		}
+	}
+
+	heat_decay(heat);
+}
+
+bool
+ftl_heat_is_hot(const struct ftl_heat *heat, uint64_t lba, uint64_t num_blocks)
+{
+	uint64_t range = lba >> heat->range_shift;
+	uint64_t last = (lba + num_blocks - 1) >> heat->range_shift;
+
+	assert(num_blocks);
+	assert(last < heat->num_ranges);
+
+	for (; range <= last; range++) {
+		if (heat->counters[range] >= FTL_HEAT_HOT_THRESHOLD) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+uint64_t
+ftl_heat_get_seq_id(const struct ftl_heat *heat, uint64_t lba, uint64_t num_blocks)
+{
+	uint64_t range = lba >> heat->range_shift;
+	uint64_t last = (lba + num_blocks - 1) >> heat->range_shift;
+	uint64_t seq_id = 0;
+
+	assert(num_blocks);
+	assert(last < heat->num_ranges);
+
+	for (; range <= last; range++) {
+		seq_id = spdk_max(seq_id, heat->seq_ids[range]);
+	}
+
+	return seq_id;
+}
+
+void
+ftl_heat_set_seq_id(struct ftl_heat *heat, uint64_t lba, uint64_t num_blocks, uint64_t seq_id)
+{
+	uint64_t range = lba >> heat->range_shift;
+	uint64_t last = (lba + num_blocks - 1) >> heat->range_shift;
+
+	assert(num_blocks);
+	assert(last < heat->num_ranges);
+
+	for (; range <= last; range++) {
+		heat->seq_ids[range] = spdk_max(heat->seq_ids[range], seq_id);
+	}
+}
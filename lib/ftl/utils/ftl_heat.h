@@ -0,0 +1,90 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#ifndef FTL_HEAT_H_
+#define FTL_HEAT_H_
+
+#include "spdk/stdinc.h"
+
+/*
+ * Heat map tracks how often LBA ranges are overwritten. Each range has a small saturating
+ * counter, incremented on every write touching the range. Counters are aged by halving them
+ * with a clock hand advanced on each update, so a range is considered hot only if it keeps
+ * being written faster than the whole map is swept.
+ *
+ * The map also remembers, per range, the sequence id of the newest NV cache chunk the range was
+ * written to. Hot and cold data go to different chunks, so this is what keeps a rewrite from
+ * landing in a chunk older than the one holding the previous copy.
+ */
+struct ftl_heat;
+
+/* Maximum number of ranges, i.e. memory used by the heat map */
+#define FTL_HEAT_MAX_RANGES		(1ULL << 20)
+/* Number of counters aged on each update */
+#define FTL_HEAT_DECAY_STEP		4
+/* Counter value from which a range is hot */
+#define FTL_HEAT_HOT_THRESHOLD		4
+
+/**
+ * @brief Creates a heat map
+ *
+ * @param num_lbas Number of LBAs to track
+ * @param max_ranges Maximum number of tracked ranges, LBAs are grouped into power of two sized
+ * ranges so that they fit into that number
+ *
+ * @return On success - pointer to the heat map, otherwise NULL
+ */
+struct ftl_heat *ftl_heat_create(uint64_t num_lbas, uint64_t max_ranges);
+
+/**
+ * @brief Destroys the heat map
+ *
+ * @param heat The heat map
+ */
+void ftl_heat_destroy(struct ftl_heat *heat);
+
+/**
+ * @brief Records a write of a range of LBAs
+ *
+ * @param heat The heat map
+ * @param lba First LBA written
+ * @param num_blocks Number of LBAs written
+ */
+void ftl_heat_update(struct ftl_heat *heat, uint64_t lba, uint64_t num_blocks);
+
+/**
+ * @brief Checks if a range of LBAs is hot
+ *
+ * @param heat The heat map
+ * @param lba First LBA of the range
+ * @param num_blocks Number of LBAs in the range
+ *
+ * @return True if any of the tracked ranges covering the LBAs is hot
+ */
+bool ftl_heat_is_hot(const struct ftl_heat *heat, uint64_t lba, uint64_t num_blocks);
+
+/**
+ * @brief Returns the sequence id of the newest chunk a range of LBAs was written to
+ *
+ * @param heat The heat map
+ * @param lba First LBA of the range
+ * @param num_blocks Number of LBAs in the range
+ *
+ * @return Highest sequence id recorded for the tracked ranges covering the LBAs, 0 if none
+ */
+uint64_t ftl_heat_get_seq_id(const struct ftl_heat *heat, uint64_t lba, uint64_t num_blocks);
+
+/**
+ * @brief Records the sequence id of the chunk a range of LBAs was written to
+ *
+ * @param heat The heat map
+ * @param lba First LBA written
+ * @param num_blocks Number of LBAs written
+ * @param seq_id Sequence id of the chunk, lower than the recorded one is ignored
+ */
+void ftl_heat_set_seq_id(struct ftl_heat *heat, uint64_t lba, uint64_t num_blocks,
+			 uint64_t seq_id);
+
+#endif /* FTL_HEAT_H_ */
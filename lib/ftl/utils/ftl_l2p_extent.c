@@ -0,0 +1,107 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+#include "spdk/assert.h"
+
+#include "ftl_l2p_extent.h"
+
+SPDK_STATIC_ASSERT(sizeof(struct ftl_l2p_extent) == 8, "Incorrect size");
+
+static inline uint64_t
+entry_load(const void *page, uint64_t idx, uint64_t addr_size)
+{
+	uint32_t addr32;
+
+	if (addr_size == sizeof(uint32_t)) {
+		addr32 = ((const uint32_t *)page)[idx];
+		return addr32 == UINT32_MAX ? UINT64_MAX : addr32;
+	}
+
+	return ((const uint64_t *)page)[idx];
+}
+
+static inline void
+entry_store(void *page, uint64_t idx, uint64_t addr_size, uint64_t addr)
+{
+	if (addr_size == sizeof(uint32_t)) {
+		((uint32_t *)page)[idx] = addr;
+	} else {
+		((uint64_t *)page)[idx] = addr;
+	}
+}
+
+static inline bool
+extent_continues(const struct ftl_l2p_extent *extent, uint64_t idx, uint64_t addr)
+{
+	if (extent->addr == FTL_L2P_EXTENT_ADDR_INVALID) {
+		return addr == FTL_L2P_EXTENT_ADDR_INVALID;
+	}
+
+	return addr != FTL_L2P_EXTENT_ADDR_INVALID && addr == extent->addr + (idx - extent->offset);
+}
+
+size_t
+ftl_l2p_extent_encode(void *buf, size_t buf_size, const void *page, uint64_t num_entries,
+		      uint64_t addr_size)
+{
+	struct ftl_l2p_extent_hdr *hdr = buf;
+	struct ftl_l2p_extent *extent = (struct ftl_l2p_extent *)(hdr + 1);
+	uint64_t max_extents, num_extents = 0;
+	uint64_t i, addr;
+
+	assert(num_entries <= (1ULL << 16));
+
+	if (buf_size < sizeof(*hdr) + sizeof(*extent)) {
+		return 0;
+	}
+	max_extents = (buf_size - sizeof(*hdr)) / sizeof(*extent);
+
+	for (i = 0; i < num_entries; i++) {
+		addr = entry_load(page, i, addr_size);
+		if (addr == UINT64_MAX) {
+			addr = FTL_L2P_EXTENT_ADDR_INVALID;
+		} else if (addr >= FTL_L2P_EXTENT_ADDR_INVALID) {
+			return 0;
+		}
+
+		if (num_extents && extent_continues(&extent[num_extents - 1], i, addr)) {
+			continue;
+		}
+
+		if (num_extents == max_extents) {
+			return 0;
+		}
+
+		extent[num_extents].addr = addr;
+		extent[num_extents].offset = i;
+		num_extents++;
+	}
+
+	hdr->num_extents = num_extents;
+	hdr->reserved = 0;
+
+	return sizeof(*hdr) + num_extents * sizeof(*extent);
+}
+
+void
+ftl_l2p_extent_decode(void *page, const void *buf, uint64_t num_entries, uint64_t addr_size)
+{
+	const struct ftl_l2p_extent_hdr *hdr = buf;
+	const struct ftl_l2p_extent *extent = (const struct ftl_l2p_extent *)(hdr + 1);
+	uint64_t i, idx, end;
+
+	for (i = 0; i < hdr->num_extents; i++) {
+		end = i + 1 < hdr->num_extents ? extent[i + 1].offset : num_entries;
+
+		for (idx = extent[i].offset; idx < end; idx++) {
+			if (extent[i].addr == FTL_L2P_EXTENT_ADDR_INVALID) {
+				entry_store(page, idx, addr_size, UINT64_MAX);
+			} else {
+				entry_store(page, idx, addr_size, extent[i].addr + (idx - extent[i].offset));
+			}
+		}
+	}
+}
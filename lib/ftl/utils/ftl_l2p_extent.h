@@ -0,0 +1,54 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#ifndef FTL_L2P_EXTENT_H_
+#define FTL_L2P_EXTENT_H_
+
+#include "spdk/stdinc.h"
+
+/*
+ * Extent encoding of an L2P page. Consecutive entries mapped to consecutive addresses (or all
+ * unmapped) are stored as a single extent holding the index of its first entry and its first
+ * address. Sequentially written regions need only a few extents per page.
+ */
+struct ftl_l2p_extent_hdr {
+	uint32_t num_extents;
+	uint32_t reserved;
+};
+
+struct ftl_l2p_extent {
+	/* Address of the first entry, FTL_L2P_EXTENT_ADDR_INVALID if the entries are unmapped */
+	uint64_t addr : 48;
+	/* Index of the first entry in the page */
+	uint64_t offset : 16;
+};
+
+#define FTL_L2P_EXTENT_ADDR_INVALID	((1ULL << 48) - 1)
+
+/**
+ * @brief Encodes an L2P page into extents
+ *
+ * @param buf Buffer for the encoded page
+ * @param buf_size Size of the buffer
+ * @param page L2P page
+ * @param num_entries Number of entries in the page
+ * @param addr_size Size of an entry of the page (4 or 8 bytes)
+ *
+ * @return Size of the encoded page, 0 if it doesn't fit into the buffer
+ */
+size_t ftl_l2p_extent_encode(void *buf, size_t buf_size, const void *page, uint64_t num_entries,
+			     uint64_t addr_size);
+
+/**
+ * @brief Decodes extents into an L2P page
+ *
+ * @param page L2P page
+ * @param buf Encoded page
+ * @param num_entries Number of entries in the page
+ * @param addr_size Size of an entry of the page (4 or 8 bytes)
+ */
+void ftl_l2p_extent_decode(void *page, const void *buf, uint64_t num_entries, uint64_t addr_size);
+
+#endif /* FTL_L2P_EXTENT_H_ */
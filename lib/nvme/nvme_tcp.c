@@ -585,6 +585,7 @@ pdu_accel_compute_crc32_done(void *cb_arg, int status)
 		return;
 	}
 
+	pdu->data_digest_crc32 = nvme_tcp_pdu_pad_data_digest(pdu, pdu->data_digest_crc32);
 	pdu->data_digest_crc32 ^= SPDK_CRC32C_XOR;
 	MAKE_DIGEST_WORD(pdu->data_digest, pdu->data_digest_crc32);
 
@@ -619,6 +620,7 @@ pdu_accel_seq_compute_crc32_done(void *cb_arg)
 {
 	struct nvme_tcp_pdu *pdu = cb_arg;
 
+	pdu->data_digest_crc32 = nvme_tcp_pdu_pad_data_digest(pdu, pdu->data_digest_crc32);
 	pdu->data_digest_crc32 ^= SPDK_CRC32C_XOR;
 	MAKE_DIGEST_WORD(pdu->data_digest, pdu->data_digest_crc32);
 }
@@ -633,8 +635,7 @@ pdu_accel_compute_crc32(struct nvme_tcp_pdu *pdu)
 
 	/* Only support this limited case for the first step */
 	if (spdk_unlikely(nvme_qpair_get_state(&tqpair->qpair) < NVME_QPAIR_CONNECTED ||
-			  pdu->dif_ctx != NULL ||
-			  pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT != 0)) {
+			  pdu->dif_ctx != NULL)) {
 		return false;
 	}
 
@@ -1434,6 +1435,7 @@ nvme_tcp_accel_recv_compute_crc32_done(void *cb_arg, int status)
 		goto end;
 	}
 
+	pdu->data_digest_crc32 = nvme_tcp_pdu_pad_data_digest(pdu, pdu->data_digest_crc32);
 	pdu->data_digest_crc32 ^= SPDK_CRC32C_XOR;
 	rc = MATCH_DIGEST_WORD(pdu->data_digest, pdu->data_digest_crc32);
 	if (rc == 0) {
@@ -1464,6 +1466,7 @@ nvme_tcp_accel_seq_recv_compute_crc32_done(void *cb_arg)
 	struct nvme_tcp_pdu *pdu = treq->pdu;
 	bool result;
 
+	pdu->data_digest_crc32 = nvme_tcp_pdu_pad_data_digest(pdu, pdu->data_digest_crc32);
 	pdu->data_digest_crc32 ^= SPDK_CRC32C_XOR;
 	result = MATCH_DIGEST_WORD(pdu->data_digest, pdu->data_digest_crc32);
 	if (spdk_unlikely(!result)) {
@@ -1483,7 +1486,6 @@ nvme_tcp_accel_recv_compute_crc32(struct nvme_tcp_req *treq, struct nvme_tcp_pdu
 	/* Only support this limited case that the request has only one c2h pdu */
 	if (spdk_unlikely(nvme_qpair_get_state(&tqpair->qpair) < NVME_QPAIR_CONNECTED ||
 			  tqpair->qpair.poll_group == NULL || pdu->dif_ctx != NULL ||
-			  pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT != 0 ||
 			  pdu->data_len != req->payload_size)) {
 		return false;
 	}
@@ -44,6 +44,11 @@
 
 #define NVMF_ABORT_COMMAND_LIMIT 3
 
+/* Bytes a host with weight 1 may submit per round when a namespace's I/O depth is exhausted */
+#define NVMF_FAIR_QUANTUM (128 * 1024)
+/* Fixed cost charged per I/O, so that hosts issuing small I/Os are limited as well */
+#define NVMF_FAIR_IO_COST 4096
+
 /*
  * Support for custom admin command handlers
  */
@@ -317,7 +322,13 @@ nvmf_ctrlr_add_qpair(struct spdk_nvmf_qpair *qpair,
 	spdk_bit_array_set(ctrlr->qpair_mask, qpair->qid);
 	SPDK_DEBUGLOG(nvmf, "qpair_mask set, qid %u\n", qpair->qid);
 
-	spdk_thread_send_msg(qpair->group->thread, nvmf_ctrlr_send_connect_rsp, req);
+	/* Admin qpairs, and I/O qpairs sharing the admin qpair's poll group, are already on the
+	 * right thread, so save them a message hop. */
+	if (qpair->group->thread == spdk_get_thread()) {
+		nvmf_ctrlr_send_connect_rsp(req);
+	} else {
+		spdk_thread_send_msg(qpair->group->thread, nvmf_ctrlr_send_connect_rsp, req);
+	}
 }
 
 static int
@@ -367,6 +378,53 @@ _nvmf_subsystem_add_ctrlr(void *ctx)
 	spdk_thread_send_msg(ctrlr->thread, _nvmf_ctrlr_add_admin_qpair, req);
 }
 
+static void _nvmf_ctrlr_add_io_qpair(void *ctx);
+
+static void
+nvmf_subsystem_process_connects(void *ctx)
+{
+	struct spdk_nvmf_subsystem *subsystem = ctx;
+	struct spdk_nvmf_request *req;
+	STAILQ_HEAD(, spdk_nvmf_request) connects;
+
+	STAILQ_INIT(&connects);
+
+	pthread_mutex_lock(&subsystem->mutex);
+	STAILQ_SWAP(&connects, &subsystem->pending_connects, spdk_nvmf_request);
+	subsystem->connect_msg_pending = false;
+	pthread_mutex_unlock(&subsystem->mutex);
+
+	while ((req = STAILQ_FIRST(&connects)) != NULL) {
+		STAILQ_REMOVE_HEAD(&connects, buf_link);
+		if (req->qpair->qid == 0) {
+			_nvmf_subsystem_add_ctrlr(req);
+		} else {
+			_nvmf_ctrlr_add_io_qpair(req);
+		}
+	}
+}
+
+/*
+ * Hand a CONNECT request over to the subsystem's thread.  When many hosts connect at
+ * once, the requests queued by all poll groups are handled by a single message instead
+ * of one message each.
+ */
+static void
+nvmf_subsystem_queue_connect(struct spdk_nvmf_subsystem *subsystem, struct spdk_nvmf_request *req)
+{
+	bool send_msg;
+
+	pthread_mutex_lock(&subsystem->mutex);
+	STAILQ_INSERT_TAIL(&subsystem->pending_connects, req, buf_link);
+	send_msg = !subsystem->connect_msg_pending;
+	subsystem->connect_msg_pending = true;
+	pthread_mutex_unlock(&subsystem->mutex);
+
+	if (send_msg) {
+		spdk_thread_send_msg(subsystem->thread, nvmf_subsystem_process_connects, subsystem);
+	}
+}
+
 static void
 nvmf_ctrlr_cdata_init(struct spdk_nvmf_transport *transport, struct spdk_nvmf_subsystem *subsystem,
 		      struct spdk_nvmf_ctrlr_data *cdata)
@@ -590,7 +648,7 @@ nvmf_ctrlr_create(struct spdk_nvmf_subsystem *subsystem,
 	}
 
 	nvmf_qpair_set_ctrlr(req->qpair, ctrlr);
-	spdk_thread_send_msg(subsystem->thread, _nvmf_subsystem_add_ctrlr, req);
+	nvmf_subsystem_queue_connect(subsystem, req);
 
 	return ctrlr;
 err_listener:
@@ -635,6 +693,7 @@ _nvmf_ctrlr_destruct(void *ctx)
 		free(event);
 	}
 	spdk_bit_array_free(&ctrlr->visible_ns);
+	free(ctrlr->disc_log_cache.log_page);
 	free(ctrlr);
 }
 
@@ -939,7 +998,7 @@ _nvmf_ctrlr_connect(struct spdk_nvmf_request *req)
 			return SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS;
 		}
 	} else {
-		spdk_thread_send_msg(subsystem->thread, _nvmf_ctrlr_add_io_qpair, req);
+		nvmf_subsystem_queue_connect(subsystem, req);
 		return SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS;
 	}
 }
@@ -2080,7 +2139,7 @@ nvmf_ctrlr_set_features_number_of_queues(struct spdk_nvmf_request *req)
 	return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
 }
 
-SPDK_STATIC_ASSERT(sizeof(struct spdk_nvmf_ctrlr) == 4928,
+SPDK_STATIC_ASSERT(sizeof(struct spdk_nvmf_ctrlr) == 4952,
 		   "Please check migration fields that need to be added or not");
 
 static void
@@ -2683,8 +2742,8 @@ nvmf_ctrlr_get_log_page(struct spdk_nvmf_request *req)
 				response->status.sc = SPDK_NVME_SC_INTERNAL_DEVICE_ERROR;
 				return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
 			}
-			nvmf_get_discovery_log_page(subsystem->tgt, ctrlr->hostnqn, req->iov, req->iovcnt,
-						    offset, len, &cmd_source_trid);
+			nvmf_get_discovery_log_page(subsystem->tgt, ctrlr->hostnqn, &ctrlr->disc_log_cache,
+						    req->iov, req->iovcnt, offset, len, &cmd_source_trid);
 			if (!rae) {
 				nvmf_ctrlr_unmask_aen(ctrlr, SPDK_NVME_ASYNC_EVENT_DISCOVERY_LOG_CHANGE_MASK_BIT);
 			}
@@ -4418,7 +4477,8 @@ nvmf_ctrlr_use_zcopy(struct spdk_nvmf_request *req)
 
 	assert(req->zcopy_phase == NVMF_ZCOPY_PHASE_NONE);
 
-	if (!transport->opts.zcopy) {
+	if (!transport->opts.zcopy &&
+	    !(transport->opts.zcopy_read && req->cmd->nvme_cmd.opc == SPDK_NVME_OPC_READ)) {
 		return false;
 	}
 
@@ -4467,6 +4527,232 @@ spdk_nvmf_request_zcopy_end(struct spdk_nvmf_request *req, bool commit)
 	nvmf_bdev_ctrlr_zcopy_end(req, commit);
 }
 
+void
+nvmf_fair_qpair_reset(struct spdk_nvmf_qpair *qpair)
+{
+	free(qpair->fair_flows);
+	qpair->fair_flows = NULL;
+	qpair->num_fair_flows = 0;
+}
+
+void
+nvmf_fair_sched_free(struct spdk_nvmf_poll_group *group,
+		     struct spdk_nvmf_subsystem_pg_ns_info *ns_info)
+{
+	struct nvmf_fair_sched *sched = ns_info->fair;
+	struct nvmf_fair_flow *flow, *tmp;
+	struct spdk_nvmf_qpair *qpair;
+
+	if (sched == NULL) {
+		return;
+	}
+
+	/* Drop the flows the poll group's qpairs cached */
+	TAILQ_FOREACH(qpair, &group->qpairs, link) {
+		if (qpair->ctrlr != NULL && qpair->ctrlr->subsys == sched->subsystem &&
+		    sched->nsid <= qpair->num_fair_flows) {
+			qpair->fair_flows[sched->nsid - 1] = NULL;
+		}
+	}
+
+	assert(TAILQ_EMPTY(&sched->active));
+	TAILQ_FOREACH_SAFE(flow, &sched->flows, link, tmp) {
+		TAILQ_REMOVE(&sched->flows, flow, link);
+		free(flow);
+	}
+
+	free(sched);
+	ns_info->fair = NULL;
+}
+
+static void
+nvmf_fair_qpair_cache_flow(struct nvmf_fair_sched *sched, struct spdk_nvmf_qpair *qpair,
+			   struct nvmf_fair_flow *flow)
+{
+	struct nvmf_fair_flow **flows;
+	uint32_t idx = sched->nsid - 1, num;
+
+	if (idx >= qpair->num_fair_flows) {
+		num = spdk_max(sched->subsystem->max_nsid, idx + 1);
+		flows = realloc(qpair->fair_flows, num * sizeof(*flows));
+		if (flows == NULL) {
+			/* Not fatal, the flow is just looked up again next time */
+			return;
+		}
+
+		memset(&flows[qpair->num_fair_flows], 0,
+		       (num - qpair->num_fair_flows) * sizeof(*flows));
+		qpair->fair_flows = flows;
+		qpair->num_fair_flows = num;
+	}
+
+	qpair->fair_flows[idx] = flow;
+}
+
+static struct nvmf_fair_flow *
+nvmf_fair_get_flow(struct nvmf_fair_sched *sched, struct spdk_nvmf_qpair *qpair)
+{
+	struct spdk_nvmf_ctrlr *ctrlr = qpair->ctrlr;
+	struct nvmf_fair_flow *flow;
+	uint32_t idx = sched->nsid - 1;
+
+	if (spdk_likely(idx < qpair->num_fair_flows && qpair->fair_flows[idx] != NULL)) {
+		return qpair->fair_flows[idx];
+	}
+
+	TAILQ_FOREACH(flow, &sched->flows, link) {
+		if (strcmp(flow->hostnqn, ctrlr->hostnqn) == 0) {
+			nvmf_fair_qpair_cache_flow(sched, qpair, flow);
+			return flow;
+		}
+	}
+
+	flow = calloc(1, sizeof(*flow));
+	if (flow == NULL) {
+		return NULL;
+	}
+
+	snprintf(flow->hostnqn, sizeof(flow->hostnqn), "%s", ctrlr->hostnqn);
+	flow->weight_gen = sched->subsystem->host_weight_gen;
+	flow->weight = nvmf_subsystem_get_host_weight(sched->subsystem, flow->hostnqn);
+	STAILQ_INIT(&flow->queued);
+	TAILQ_INSERT_TAIL(&sched->flows, flow, link);
+	nvmf_fair_qpair_cache_flow(sched, qpair, flow);
+
+	return flow;
+}
+
+static uint64_t
+nvmf_fair_flow_quantum(struct nvmf_fair_sched *sched, struct nvmf_fair_flow *flow)
+{
+	uint32_t gen = sched->subsystem->host_weight_gen;
+
+	if (spdk_unlikely(flow->weight_gen != gen)) {
+		flow->weight_gen = gen;
+		flow->weight = nvmf_subsystem_get_host_weight(sched->subsystem, flow->hostnqn);
+	}
+
+	return (uint64_t)spdk_max(flow->weight, 1) * NVMF_FAIR_QUANTUM;
+}
+
+static void
+nvmf_fair_start(struct nvmf_fair_sched *sched, struct nvmf_fair_flow *flow,
+		struct spdk_nvmf_request *req)
+{
+	req->fair_sched = 1;
+	sched->io_inflight++;
+	flow->stat.submitted_ios++;
+	flow->stat.submitted_bytes += req->length;
+}
+
+static inline bool
+nvmf_fair_has_slot(struct nvmf_fair_sched *sched)
+{
+	return sched->io_depth == 0 || sched->io_inflight < sched->io_depth;
+}
+
+static void
+nvmf_fair_dispatch(struct nvmf_fair_sched *sched)
+{
+	struct nvmf_fair_flow *flow;
+	struct spdk_nvmf_request *req;
+	uint64_t cost;
+
+	/* Requests completing synchronously from within the loop must not recurse into it */
+	if (sched->dispatching) {
+		return;
+	}
+
+	sched->dispatching = true;
+	while (!TAILQ_EMPTY(&sched->active) && nvmf_fair_has_slot(sched)) {
+		flow = TAILQ_FIRST(&sched->active);
+		req = STAILQ_FIRST(&flow->queued);
+		assert(req != NULL);
+
+		cost = req->length + NVMF_FAIR_IO_COST;
+		if (flow->deficit < cost) {
+			flow->deficit += nvmf_fair_flow_quantum(sched, flow);
+			TAILQ_REMOVE(&sched->active, flow, active_link);
+			TAILQ_INSERT_TAIL(&sched->active, flow, active_link);
+			continue;
+		}
+
+		flow->deficit -= cost;
+		STAILQ_REMOVE_HEAD(&flow->queued, buf_link);
+		flow->stat.queued_ios--;
+		if (STAILQ_EMPTY(&flow->queued)) {
+			/* An idle host doesn't get to bank its unused share */
+			TAILQ_REMOVE(&sched->active, flow, active_link);
+			flow->active = false;
+			flow->deficit = 0;
+		}
+
+		nvmf_fair_start(sched, flow, req);
+		if (nvmf_ctrlr_process_io_cmd(req) == SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE) {
+			_nvmf_request_complete(req);
+		}
+	}
+	sched->dispatching = false;
+}
+
+/* Returns false if the request has been queued behind the I/O of other hosts */
+static bool
+nvmf_fair_admit(struct spdk_nvmf_subsystem_pg_ns_info *ns_info, struct spdk_nvmf_ns *ns,
+		struct spdk_nvmf_request *req)
+{
+	struct nvmf_fair_sched *sched = ns_info->fair;
+	struct nvmf_fair_flow *flow;
+
+	if (sched == NULL) {
+		sched = calloc(1, sizeof(*sched));
+		if (sched == NULL) {
+			return true;
+		}
+
+		sched->subsystem = ns->subsystem;
+		sched->nsid = ns->nsid;
+		TAILQ_INIT(&sched->active);
+		TAILQ_INIT(&sched->flows);
+		ns_info->fair = sched;
+	}
+
+	sched->io_depth = ns->fair_io_depth;
+	flow = nvmf_fair_get_flow(sched, req->qpair);
+	if (spdk_unlikely(flow == NULL)) {
+		return true;
+	}
+
+	if (TAILQ_EMPTY(&sched->active) && nvmf_fair_has_slot(sched)) {
+		nvmf_fair_start(sched, flow, req);
+		return true;
+	}
+
+	STAILQ_INSERT_TAIL(&flow->queued, req, buf_link);
+	flow->stat.queued_ios++;
+	flow->stat.deferred_ios++;
+	if (!flow->active) {
+		flow->active = true;
+		TAILQ_INSERT_TAIL(&sched->active, flow, active_link);
+	}
+
+	/* The I/O depth might have just been raised */
+	nvmf_fair_dispatch(sched);
+
+	return false;
+}
+
+static void
+nvmf_fair_complete(struct spdk_nvmf_subsystem_pg_ns_info *ns_info, struct spdk_nvmf_request *req)
+{
+	struct nvmf_fair_sched *sched = ns_info->fair;
+
+	assert(sched != NULL && sched->io_inflight > 0);
+	req->fair_sched = 0;
+	sched->io_inflight--;
+
+	nvmf_fair_dispatch(sched);
+}
+
 int
 nvmf_ctrlr_process_io_cmd(struct spdk_nvmf_request *req)
 {
@@ -4528,6 +4814,14 @@ nvmf_ctrlr_process_io_cmd(struct spdk_nvmf_request *req)
 		return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
 	}
 
+	/* Once the limit is lifted, requests still queued drain as the admitted ones complete */
+	if (spdk_unlikely(ns->fair_io_depth != 0) && !req->fair_sched &&
+	    !(cmd->fuse & SPDK_NVME_CMD_FUSE_MASK) && req->zcopy_phase == NVMF_ZCOPY_PHASE_NONE) {
+		if (!nvmf_fair_admit(ns_info, ns, req)) {
+			return SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS;
+		}
+	}
+
 	bdev = ns->bdev;
 	desc = ns->desc;
 	ch = ns_info->channel;
@@ -4727,7 +5021,11 @@ _nvmf_request_complete(void *ctx)
 
 				/* NOTE: This implicitly also checks for 0, since 0 - 1 wraps around to UINT32_MAX. */
 				if (spdk_likely(nsid - 1 < sgroup->num_ns)) {
-					sgroup->ns_info[nsid - 1].io_outstanding--;
+					ns_info = &sgroup->ns_info[nsid - 1];
+					if (spdk_unlikely(req->fair_sched)) {
+						nvmf_fair_complete(ns_info, req);
+					}
+					ns_info->io_outstanding--;
 				}
 			}
 		}
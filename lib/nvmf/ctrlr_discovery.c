@@ -27,6 +27,7 @@ nvmf_update_discovery_log(struct spdk_nvmf_tgt *tgt, const char *hostnqn)
 	struct spdk_nvmf_ctrlr *ctrlr;
 
 	tgt->discovery_genctr++;
+	tgt->discovery_log_gen++;
 	discovery_subsystem = spdk_nvmf_tgt_find_subsystem(tgt, SPDK_NVMF_DISCOVERY_NQN);
 
 	if (discovery_subsystem) {
@@ -93,23 +94,46 @@ nvmf_discovery_compare_trid(uint32_t filter,
 	return true;
 }
 
+/* Make room for one more entry in the log page, growing it exponentially to avoid
+ * reallocating it for every entry on targets with many subsystems. */
+static struct spdk_nvmf_discovery_log_page_entry *
+nvmf_discovery_log_get_entry(struct spdk_nvmf_discovery_log_page **disc_log, uint64_t numrec,
+			     uint64_t *max_numrec)
+{
+	struct spdk_nvmf_discovery_log_page *new_log_page;
+	uint64_t new_max_numrec;
+
+	if (numrec == *max_numrec) {
+		new_max_numrec = spdk_max(*max_numrec * 2, 4);
+		new_log_page = realloc(*disc_log, sizeof(**disc_log) +
+				       new_max_numrec * sizeof((*disc_log)->entries[0]));
+		if (new_log_page == NULL) {
+			SPDK_ERRLOG("Discovery log page memory allocation error\n");
+			return NULL;
+		}
+
+		*disc_log = new_log_page;
+		*max_numrec = new_max_numrec;
+	}
+
+	return &(*disc_log)->entries[numrec];
+}
+
 static struct spdk_nvmf_discovery_log_page *
 nvmf_generate_discovery_log(struct spdk_nvmf_tgt *tgt, const char *hostnqn, size_t *log_page_size,
 			    struct spdk_nvme_transport_id *cmd_source_trid)
 {
-	uint64_t numrec = 0;
+	uint64_t numrec = 0, max_numrec = 0;
 	struct spdk_nvmf_subsystem *subsystem;
 	struct spdk_nvmf_subsystem_listener *listener;
 	struct spdk_nvmf_discovery_log_page_entry *entry;
 	struct spdk_nvmf_discovery_log_page *disc_log;
-	size_t cur_size;
 	struct spdk_nvmf_referral *referral;
 
 	SPDK_DEBUGLOG(nvmf, "Generating log page for genctr %" PRIu64 "\n",
 		      tgt->discovery_genctr);
 
-	cur_size = sizeof(struct spdk_nvmf_discovery_log_page);
-	disc_log = calloc(1, cur_size);
+	disc_log = calloc(1, sizeof(struct spdk_nvmf_discovery_log_page));
 	if (disc_log == NULL) {
 		SPDK_ERRLOG("Discovery log page memory allocation error\n");
 		return NULL;
@@ -137,18 +161,11 @@ nvmf_generate_discovery_log(struct spdk_nvmf_tgt *tgt, const char *hostnqn, size
 			SPDK_DEBUGLOG(nvmf, "listener %s:%s trtype %s\n", listener->trid->traddr, listener->trid->trsvcid,
 				      listener->trid->trstring);
 
-			size_t new_size = cur_size + sizeof(*entry);
-			void *new_log_page = realloc(disc_log, new_size);
-
-			if (new_log_page == NULL) {
-				SPDK_ERRLOG("Discovery log page memory allocation error\n");
+			entry = nvmf_discovery_log_get_entry(&disc_log, numrec, &max_numrec);
+			if (entry == NULL) {
 				break;
 			}
 
-			disc_log = new_log_page;
-			cur_size = new_size;
-
-			entry = &disc_log->entries[numrec];
 			memset(entry, 0, sizeof(*entry));
 			entry->portid = listener->id;
 			entry->cntlid = 0xffff;
@@ -177,18 +194,11 @@ nvmf_generate_discovery_log(struct spdk_nvmf_tgt *tgt, const char *hostnqn, size
 		SPDK_DEBUGLOG(nvmf, "referral %s:%s trtype %s\n", referral->trid.traddr, referral->trid.trsvcid,
 			      referral->trid.trstring);
 
-		size_t new_size = cur_size + sizeof(*entry);
-		void *new_log_page = realloc(disc_log, new_size);
-
-		if (new_log_page == NULL) {
-			SPDK_ERRLOG("Discovery log page memory allocation error\n");
+		entry = nvmf_discovery_log_get_entry(&disc_log, numrec, &max_numrec);
+		if (entry == NULL) {
 			break;
 		}
 
-		disc_log = new_log_page;
-		cur_size = new_size;
-
-		entry = &disc_log->entries[numrec];
 		memcpy(entry, &referral->entry, sizeof(*entry));
 
 		numrec++;
@@ -197,13 +207,14 @@ nvmf_generate_discovery_log(struct spdk_nvmf_tgt *tgt, const char *hostnqn, size
 
 	disc_log->numrec = numrec;
 	disc_log->genctr = tgt->discovery_genctr;
-	*log_page_size = cur_size;
+	*log_page_size = sizeof(*disc_log) + numrec * sizeof(*entry);
 
 	return disc_log;
 }
 
 void
-nvmf_get_discovery_log_page(struct spdk_nvmf_tgt *tgt, const char *hostnqn, struct iovec *iov,
+nvmf_get_discovery_log_page(struct spdk_nvmf_tgt *tgt, const char *hostnqn,
+			    struct nvmf_discovery_log_cache *cache, struct iovec *iov,
 			    uint32_t iovcnt, uint64_t offset, uint32_t length,
 			    struct spdk_nvme_transport_id *cmd_source_trid)
 {
@@ -212,8 +223,23 @@ nvmf_get_discovery_log_page(struct spdk_nvmf_tgt *tgt, const char *hostnqn, stru
 	struct iovec *tmp;
 	size_t log_page_size = 0;
 	struct spdk_nvmf_discovery_log_page *discovery_log_page;
+	uint64_t gen = tgt->discovery_log_gen;
 
-	discovery_log_page = nvmf_generate_discovery_log(tgt, hostnqn, &log_page_size, cmd_source_trid);
+	/* Hosts usually read the log page in several pieces and then read its header
+	 * again to make sure it didn't change, so don't regenerate it each time. */
+	if (cache != NULL && cache->log_page != NULL && cache->gen == gen) {
+		discovery_log_page = cache->log_page;
+		log_page_size = cache->size;
+	} else {
+		discovery_log_page = nvmf_generate_discovery_log(tgt, hostnqn, &log_page_size,
+				     cmd_source_trid);
+		if (cache != NULL && discovery_log_page != NULL) {
+			free(cache->log_page);
+			cache->log_page = discovery_log_page;
+			cache->size = log_page_size;
+			cache->gen = gen;
+		}
+	}
 
 	/* Copy the valid part of the discovery log page, if any */
 	if (discovery_log_page) {
@@ -239,6 +265,8 @@ nvmf_get_discovery_log_page(struct spdk_nvmf_tgt *tgt, const char *hostnqn, stru
 			memset((char *)tmp->iov_base, 0, tmp->iov_len);
 		}
 
-		free(discovery_log_page);
+		if (cache == NULL) {
+			free(discovery_log_page);
+		}
 	}
 }
@@ -22,6 +22,18 @@ SPDK_LOG_REGISTER_COMPONENT(nvmf)
 
 #define SPDK_NVMF_DEFAULT_MAX_SUBSYSTEMS 1024
 
+#define NVMF_POLL_GROUP_LOAD_PERIOD_US	(100 * 1000)
+/* Poll groups whose busy ratio (in permille) falls in the same step are considered equally busy */
+#define NVMF_POLL_GROUP_LOAD_BUSY_STEP	100
+
+#define NVMF_QPAIR_MIGRATE_POLL_US	100
+#define NVMF_QPAIR_MIGRATE_TIMEOUT_US	(1000 * 1000)
+
+/* Poll groups are rebalanced if their busy ratios are at least this many steps apart... */
+#define NVMF_POLL_GROUP_REBALANCE_BUSY_STEPS	2
+/* ...or if one of them has at least this many I/O qpairs more than the other */
+#define NVMF_POLL_GROUP_REBALANCE_IO_QPAIRS	2
+
 static TAILQ_HEAD(, spdk_nvmf_tgt) g_nvmf_tgts = TAILQ_HEAD_INITIALIZER(g_nvmf_tgts);
 
 typedef void (*nvmf_qpair_disconnect_cpl)(void *ctx, int status);
@@ -45,6 +57,32 @@ struct nvmf_qpair_disconnect_many_ctx {
 	void *cpl_ctx;
 };
 
+/* Tracks a qpair while it is moved between poll groups by spdk_nvmf_qpair_migrate() */
+struct spdk_nvmf_qpair_migrate {
+	struct spdk_nvmf_qpair		*qpair;
+	struct spdk_nvmf_poll_group	*src;
+	struct spdk_nvmf_poll_group	*dst;
+	struct spdk_thread		*thread;
+	struct spdk_poller		*poller;
+	uint64_t			timeout_tsc;
+	/* The qpair has left the source poll group, but hasn't been attached to the destination yet */
+	bool				in_flight;
+	bool				disconnect_pending;
+	int				status;
+	spdk_nvmf_qpair_migrate_done_fn	cb_fn;
+	void				*cb_arg;
+};
+
+struct nvmf_tgt_rebalance_ctx {
+	struct spdk_nvmf_tgt		*tgt;
+	struct spdk_nvmf_poll_group	*src;
+	struct spdk_nvmf_poll_group	*dst;
+	struct spdk_io_channel_iter	*iter;
+};
+
+static bool nvmf_qpair_migrate_abort(struct spdk_nvmf_qpair *qpair);
+static int nvmf_tgt_rebalance_poll_groups(void *ctx);
+
 static struct spdk_nvmf_referral *
 nvmf_tgt_find_referral(struct spdk_nvmf_tgt *tgt,
 		       const struct spdk_nvme_transport_id *trid)
@@ -164,6 +202,80 @@ nvmf_poll_group_poll(void *ctx)
 	return count > 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
 }
 
+static int
+nvmf_poll_group_update_load(void *ctx)
+{
+	struct spdk_nvmf_poll_group *group = ctx;
+	struct spdk_nvmf_qpair *qpair;
+	struct spdk_thread_stats stats;
+	uint64_t busy_tsc, idle_tsc;
+	uint32_t outstanding_io = 0;
+
+	if (spdk_thread_get_stats(&stats) != 0) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	TAILQ_FOREACH(qpair, &group->qpairs, link) {
+		if (qpair->qid != 0) {
+			outstanding_io += qpair->queue_depth;
+		}
+	}
+
+	busy_tsc = stats.busy_tsc - group->load.busy_tsc;
+	idle_tsc = stats.idle_tsc - group->load.idle_tsc;
+
+	pthread_mutex_lock(&group->mutex);
+	group->load.busy_tsc = stats.busy_tsc;
+	group->load.idle_tsc = stats.idle_tsc;
+	if (busy_tsc + idle_tsc > 0) {
+		group->load.busy_permille = busy_tsc * 1000 / (busy_tsc + idle_tsc);
+	}
+	group->load.outstanding_io = outstanding_io;
+	pthread_mutex_unlock(&group->mutex);
+
+	/* Don't let the load estimate count towards the busy time it measures */
+	return SPDK_POLLER_IDLE;
+}
+
+struct nvmf_poll_group_load {
+	uint32_t	busy_step;
+	uint32_t	outstanding_io;
+	uint32_t	io_qpairs;
+};
+
+static void
+nvmf_poll_group_get_load(struct spdk_nvmf_poll_group *group, struct nvmf_poll_group_load *load)
+{
+	pthread_mutex_lock(&group->mutex);
+	load->busy_step = group->load.busy_permille / NVMF_POLL_GROUP_LOAD_BUSY_STEP;
+	load->outstanding_io = group->load.outstanding_io;
+	/* Just assume that unassociated qpairs will eventually be io qpairs */
+	load->io_qpairs = group->stat.current_io_qpairs + group->current_unassociated_qpairs;
+	pthread_mutex_unlock(&group->mutex);
+}
+
+int
+nvmf_poll_group_load_cmp(struct spdk_nvmf_poll_group *group1,
+			 struct spdk_nvmf_poll_group *group2)
+{
+	struct nvmf_poll_group_load load1, load2;
+
+	nvmf_poll_group_get_load(group1, &load1);
+	nvmf_poll_group_get_load(group2, &load2);
+
+	if (load1.busy_step != load2.busy_step) {
+		return load1.busy_step < load2.busy_step ? -1 : 1;
+	}
+	if (load1.outstanding_io != load2.outstanding_io) {
+		return load1.outstanding_io < load2.outstanding_io ? -1 : 1;
+	}
+	if (load1.io_qpairs != load2.io_qpairs) {
+		return load1.io_qpairs < load2.io_qpairs ? -1 : 1;
+	}
+
+	return 0;
+}
+
 /*
  * Reset and clean up the poll group (I/O channel code will actually free the
  * group).
@@ -190,6 +302,7 @@ nvmf_tgt_cleanup_poll_group(struct spdk_nvmf_poll_group *group)
 				spdk_put_io_channel(sgroup->ns_info[nsid].channel);
 				sgroup->ns_info[nsid].channel = NULL;
 			}
+			nvmf_fair_sched_free(group, &sgroup->ns_info[nsid]);
 		}
 
 		free(sgroup->ns_info);
@@ -198,6 +311,7 @@ nvmf_tgt_cleanup_poll_group(struct spdk_nvmf_poll_group *group)
 	free(group->sgroups);
 
 	spdk_poller_unregister(&group->poller);
+	spdk_poller_unregister(&group->load.poller);
 
 	if (group->destroy_cb_fn) {
 		group->destroy_cb_fn(group->destroy_cb_arg, 0);
@@ -216,6 +330,9 @@ nvmf_tgt_destroy_poll_group(void *io_device, void *ctx_buf)
 	SPDK_DTRACE_PROBE1_TICKS(nvmf_destroy_poll_group, spdk_thread_get_id(group->thread));
 
 	pthread_mutex_lock(&tgt->mutex);
+	if (tgt->next_poll_group == group) {
+		tgt->next_poll_group = TAILQ_NEXT(group, link);
+	}
 	TAILQ_REMOVE(&tgt->poll_groups, group, link);
 	tgt->num_poll_groups--;
 	pthread_mutex_unlock(&tgt->mutex);
@@ -268,6 +385,8 @@ nvmf_tgt_create_poll_group(void *io_device, void *ctx_buf)
 
 	group->poller = SPDK_POLLER_REGISTER(nvmf_poll_group_poll, group, 0);
 	spdk_poller_register_interrupt(group->poller, NULL, NULL);
+	group->load.poller = SPDK_POLLER_REGISTER(nvmf_poll_group_update_load, group,
+			     NVMF_POLL_GROUP_LOAD_PERIOD_US);
 
 	SPDK_DTRACE_PROBE1_TICKS(nvmf_create_poll_group, spdk_thread_get_id(thread));
 
@@ -367,6 +486,13 @@ spdk_nvmf_tgt_create(struct spdk_nvmf_target_opts *_opts)
 		return NULL;
 	}
 
+	/* Rebalancing more often than the load estimates are refreshed would act on stale data */
+	if (opts.rebalance_period_us != 0 && opts.rebalance_period_us < NVMF_POLL_GROUP_LOAD_PERIOD_US) {
+		SPDK_ERRLOG("Poll group rebalance period must be at least %u us.\n",
+			    NVMF_POLL_GROUP_LOAD_PERIOD_US);
+		return NULL;
+	}
+
 	TAILQ_FOREACH(tmp_tgt, &g_nvmf_tgts, link) {
 		if (!strncmp(opts.name, tmp_tgt->name, NVMF_TGT_NAME_MAX_LENGTH)) {
 			SPDK_ERRLOG("Provided target name must be unique.\n");
@@ -407,6 +533,17 @@ spdk_nvmf_tgt_create(struct spdk_nvmf_target_opts *_opts)
 
 	RB_INIT(&tgt->subsystems);
 
+	if (opts.rebalance_period_us != 0) {
+		tgt->rebalance_poller = SPDK_POLLER_REGISTER(nvmf_tgt_rebalance_poll_groups, tgt,
+					opts.rebalance_period_us);
+		if (tgt->rebalance_poller == NULL) {
+			SPDK_ERRLOG("Failed to register the poll group rebalance poller\n");
+			spdk_bit_array_free(&tgt->subsystem_ids);
+			free(tgt);
+			return NULL;
+		}
+	}
+
 	pthread_mutex_init(&tgt->mutex, NULL);
 
 	spdk_io_device_register(tgt,
@@ -495,6 +632,7 @@ spdk_nvmf_tgt_destroy(struct spdk_nvmf_tgt *tgt,
 	tgt->destroy_cb_fn = cb_fn;
 	tgt->destroy_cb_arg = cb_arg;
 
+	spdk_poller_unregister(&tgt->rebalance_poller);
 	TAILQ_REMOVE(&g_nvmf_tgts, tgt, link);
 
 	spdk_io_device_unregister(tgt, nvmf_tgt_destroy_cb);
@@ -614,6 +752,17 @@ nvmf_write_nvme_subsystem_config(struct spdk_json_write_ctx *w,
 
 		/* } */
 		spdk_json_write_object_end(w);
+
+		if (host->weight != 1) {
+			spdk_json_write_object_begin(w);
+			spdk_json_write_named_string(w, "method", "nvmf_subsystem_set_host_weight");
+			spdk_json_write_named_object_begin(w, "params");
+			spdk_json_write_named_string(w, "nqn", spdk_nvmf_subsystem_get_nqn(subsystem));
+			spdk_json_write_named_string(w, "host", spdk_nvmf_host_get_nqn(host));
+			spdk_json_write_named_uint32(w, "weight", host->weight);
+			spdk_json_write_object_end(w);
+			spdk_json_write_object_end(w);
+		}
 	}
 
 	for (ns = spdk_nvmf_subsystem_get_first_ns(subsystem); ns != NULL;
@@ -668,6 +817,17 @@ nvmf_write_nvme_subsystem_config(struct spdk_json_write_ctx *w,
 		/* } */
 		spdk_json_write_object_end(w);
 
+		if (ns->fair_io_depth != 0) {
+			spdk_json_write_object_begin(w);
+			spdk_json_write_named_string(w, "method", "nvmf_subsystem_set_ns_io_depth");
+			spdk_json_write_named_object_begin(w, "params");
+			spdk_json_write_named_string(w, "nqn", spdk_nvmf_subsystem_get_nqn(subsystem));
+			spdk_json_write_named_uint32(w, "nsid", spdk_nvmf_ns_get_id(ns));
+			spdk_json_write_named_uint32(w, "io_depth", ns->fair_io_depth);
+			spdk_json_write_object_end(w);
+			spdk_json_write_object_end(w);
+		}
+
 		TAILQ_FOREACH(host, &ns->hosts, link) {
 			spdk_json_write_object_begin(w);
 			spdk_json_write_named_string(w, "method", "nvmf_ns_add_host");
@@ -1150,6 +1310,40 @@ _nvmf_poll_group_add(void *_ctx)
 	}
 }
 
+static struct spdk_nvmf_poll_group *
+nvmf_tgt_get_least_loaded_poll_group(struct spdk_nvmf_tgt *tgt)
+{
+	struct spdk_nvmf_poll_group *group, *start, *result;
+
+	pthread_mutex_lock(&tgt->mutex);
+	start = tgt->next_poll_group;
+	if (start == NULL) {
+		start = TAILQ_FIRST(&tgt->poll_groups);
+		if (start == NULL) {
+			pthread_mutex_unlock(&tgt->mutex);
+			return NULL;
+		}
+	}
+
+	/* Start from the round-robin position, so that equally loaded groups are still rotated */
+	result = start;
+	group = start;
+	do {
+		if (nvmf_poll_group_load_cmp(group, result) < 0) {
+			result = group;
+		}
+		group = TAILQ_NEXT(group, link);
+		if (group == NULL) {
+			group = TAILQ_FIRST(&tgt->poll_groups);
+		}
+	} while (group != start);
+
+	tgt->next_poll_group = TAILQ_NEXT(result, link);
+	pthread_mutex_unlock(&tgt->mutex);
+
+	return result;
+}
+
 void
 spdk_nvmf_tgt_new_qpair(struct spdk_nvmf_tgt *tgt, struct spdk_nvmf_qpair *qpair)
 {
@@ -1158,16 +1352,12 @@ spdk_nvmf_tgt_new_qpair(struct spdk_nvmf_tgt *tgt, struct spdk_nvmf_qpair *qpair
 
 	group = spdk_nvmf_get_optimal_poll_group(qpair);
 	if (group == NULL) {
-		if (tgt->next_poll_group == NULL) {
-			tgt->next_poll_group = TAILQ_FIRST(&tgt->poll_groups);
-			if (tgt->next_poll_group == NULL) {
-				SPDK_ERRLOG("No poll groups exist.\n");
-				spdk_nvmf_qpair_disconnect(qpair);
-				return;
-			}
+		group = nvmf_tgt_get_least_loaded_poll_group(tgt);
+		if (group == NULL) {
+			SPDK_ERRLOG("No poll groups exist.\n");
+			spdk_nvmf_qpair_disconnect(qpair);
+			return;
 		}
-		group = tgt->next_poll_group;
-		tgt->next_poll_group = TAILQ_NEXT(group, link);
 	}
 
 	ctx = calloc(1, sizeof(*ctx));
@@ -1375,6 +1565,7 @@ _nvmf_qpair_destroy(void *ctx, int status)
 	}
 
 	nvmf_qpair_auth_destroy(qpair);
+	nvmf_fair_qpair_reset(qpair);
 	qpair_ctx->ctrlr = ctrlr;
 	spdk_nvmf_poll_group_remove(qpair);
 	nvmf_transport_qpair_fini(qpair, _nvmf_transport_qpair_fini_complete, qpair_ctx);
@@ -1419,6 +1610,12 @@ spdk_nvmf_qpair_disconnect(struct spdk_nvmf_qpair *qpair)
 		return 0;
 	}
 
+	if (spdk_unlikely(qpair->migrate != NULL) && !nvmf_qpair_migrate_abort(qpair)) {
+		/* The qpair is on its way to this poll group, it'll be disconnected once it arrives */
+		__atomic_clear(&qpair->disconnect_started, __ATOMIC_RELAXED);
+		return 0;
+	}
+
 	SPDK_DTRACE_PROBE2_TICKS(nvmf_qpair_disconnect, qpair, spdk_thread_get_id(group->thread));
 	assert(spdk_nvmf_qpair_is_active(qpair));
 	nvmf_qpair_set_state(qpair, SPDK_NVMF_QPAIR_DEACTIVATING);
@@ -1446,6 +1643,337 @@ spdk_nvmf_qpair_disconnect(struct spdk_nvmf_qpair *qpair)
 	return 0;
 }
 
+static void
+nvmf_qpair_migrate_done(void *ctx)
+{
+	struct spdk_nvmf_qpair_migrate *migrate = ctx;
+
+	migrate->cb_fn(migrate->cb_arg, migrate->status);
+	free(migrate);
+}
+
+static void
+nvmf_qpair_migrate_finish(struct spdk_nvmf_qpair_migrate *migrate, int status)
+{
+	struct spdk_nvmf_qpair *qpair = migrate->qpair;
+
+	assert(spdk_get_thread() == qpair->group->thread);
+
+	qpair->migrate = NULL;
+	nvmf_transport_qpair_quiesce(qpair, false);
+
+	migrate->status = status;
+	spdk_thread_send_msg(migrate->thread, nvmf_qpair_migrate_done, migrate);
+}
+
+static void
+nvmf_qpair_migrate_attach(void *ctx)
+{
+	struct spdk_nvmf_qpair_migrate *migrate = ctx;
+	struct spdk_nvmf_qpair *qpair = migrate->qpair;
+	struct spdk_nvmf_poll_group *group = migrate->dst;
+	struct spdk_nvmf_transport_poll_group *tgroup;
+	bool disconnect;
+	int rc = -EINVAL;
+
+	assert(qpair->group == group);
+	TAILQ_INSERT_TAIL(&group->qpairs, qpair, link);
+	group->stat.current_io_qpairs++;
+	migrate->in_flight = false;
+
+	tgroup = nvmf_get_transport_poll_group(group, qpair->transport);
+	if (tgroup != NULL) {
+		rc = nvmf_transport_poll_group_attach(tgroup, qpair);
+	}
+	if (rc != 0) {
+		SPDK_ERRLOG("Unable to attach qpair %p to poll group %p: %s\n", qpair, group,
+			    spdk_strerror(-rc));
+	}
+
+	/* A controller teardown might have missed the qpair while it was in flight */
+	disconnect = rc != 0 || migrate->disconnect_pending ||
+		     qpair->ctrlr->vcprop.csts.bits.cfs || !qpair->ctrlr->vcprop.cc.bits.en;
+
+	nvmf_qpair_migrate_finish(migrate, rc);
+
+	if (disconnect) {
+		spdk_nvmf_qpair_disconnect(qpair);
+	}
+}
+
+static int
+nvmf_qpair_migrate_poll(void *ctx)
+{
+	struct spdk_nvmf_qpair_migrate *migrate = ctx;
+	struct spdk_nvmf_qpair *qpair = migrate->qpair;
+	struct spdk_nvmf_poll_group *group = migrate->src;
+	struct spdk_nvmf_transport_poll_group *tgroup;
+	int rc = -EBUSY;
+
+	if (TAILQ_EMPTY(&qpair->outstanding)) {
+		tgroup = nvmf_get_transport_poll_group(group, qpair->transport);
+		assert(tgroup != NULL);
+		rc = nvmf_transport_poll_group_detach(tgroup, qpair);
+	}
+
+	if (rc == -EBUSY && spdk_get_ticks() < migrate->timeout_tsc) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	spdk_poller_unregister(&migrate->poller);
+	if (rc != 0) {
+		SPDK_NOTICELOG("Unable to detach qpair %p from poll group %p: %s\n", qpair, group,
+			       rc == -EBUSY ? "timed out" : spdk_strerror(-rc));
+		nvmf_qpair_migrate_finish(migrate, rc == -EBUSY ? -ETIMEDOUT : rc);
+		return SPDK_POLLER_BUSY;
+	}
+
+	TAILQ_REMOVE(&group->qpairs, qpair, link);
+	assert(group->stat.current_io_qpairs > 0);
+	group->stat.current_io_qpairs--;
+	/* The flows it cached belong to the source poll group */
+	nvmf_fair_qpair_reset(qpair);
+
+	/* Anything sent to the qpair's poll group from now on is queued behind the attach */
+	migrate->in_flight = true;
+	qpair->group = migrate->dst;
+	spdk_thread_send_msg(migrate->dst->thread, nvmf_qpair_migrate_attach, migrate);
+
+	return SPDK_POLLER_BUSY;
+}
+
+/* Called when a qpair that is being moved gets disconnected. Returns false if the
+ * disconnect has to wait until the qpair reaches its new poll group. */
+static bool
+nvmf_qpair_migrate_abort(struct spdk_nvmf_qpair *qpair)
+{
+	struct spdk_nvmf_qpair_migrate *migrate = qpair->migrate;
+
+	if (migrate->in_flight) {
+		migrate->disconnect_pending = true;
+		return false;
+	}
+
+	spdk_poller_unregister(&migrate->poller);
+	nvmf_qpair_migrate_finish(migrate, -ECONNABORTED);
+
+	return true;
+}
+
+int
+spdk_nvmf_qpair_migrate(struct spdk_nvmf_qpair *qpair, struct spdk_nvmf_poll_group *group,
+			spdk_nvmf_qpair_migrate_done_fn cb_fn, void *cb_arg)
+{
+	struct spdk_nvmf_qpair_migrate *migrate;
+
+	assert(spdk_get_thread() == qpair->group->thread);
+
+	if (qpair->qid == 0 || qpair->state != SPDK_NVMF_QPAIR_ENABLED ||
+	    qpair->disconnect_started || group == qpair->group) {
+		return -EINVAL;
+	}
+
+	if (qpair->migrate != NULL) {
+		return -EBUSY;
+	}
+
+	if (!nvmf_transport_supports_migration(qpair->transport) || spdk_interrupt_mode_is_enabled()) {
+		return -ENOTSUP;
+	}
+
+	if (nvmf_get_transport_poll_group(group, qpair->transport) == NULL) {
+		return -EINVAL;
+	}
+
+	migrate = calloc(1, sizeof(*migrate));
+	if (migrate == NULL) {
+		return -ENOMEM;
+	}
+
+	migrate->qpair = qpair;
+	migrate->src = qpair->group;
+	migrate->dst = group;
+	migrate->thread = spdk_get_thread();
+	migrate->cb_fn = cb_fn;
+	migrate->cb_arg = cb_arg;
+	migrate->timeout_tsc = spdk_get_ticks() + NVMF_QPAIR_MIGRATE_TIMEOUT_US *
+			       spdk_get_ticks_hz() / SPDK_SEC_TO_USEC;
+
+	migrate->poller = SPDK_POLLER_REGISTER(nvmf_qpair_migrate_poll, migrate,
+					       NVMF_QPAIR_MIGRATE_POLL_US);
+	if (migrate->poller == NULL) {
+		free(migrate);
+		return -ENOMEM;
+	}
+
+	SPDK_DEBUGLOG(nvmf, "Moving qpair %p (qid %u) from poll group %p to %p\n", qpair, qpair->qid,
+		      qpair->group, group);
+
+	qpair->migrate = migrate;
+	nvmf_transport_qpair_quiesce(qpair, true);
+
+	return 0;
+}
+
+/* Picks the most and the least loaded poll group, if moving a qpair between them is worth it */
+static bool
+nvmf_tgt_get_rebalance_poll_groups(struct spdk_nvmf_tgt *tgt, struct spdk_nvmf_poll_group **_src,
+				   struct spdk_nvmf_poll_group **_dst)
+{
+	struct spdk_nvmf_poll_group *group, *src = NULL, *dst = NULL;
+	struct nvmf_poll_group_load src_load, dst_load;
+	bool rebalance = false;
+
+	pthread_mutex_lock(&tgt->mutex);
+	TAILQ_FOREACH(group, &tgt->poll_groups, link) {
+		if (src == NULL || nvmf_poll_group_load_cmp(group, src) > 0) {
+			src = group;
+		}
+		if (dst == NULL || nvmf_poll_group_load_cmp(group, dst) < 0) {
+			dst = group;
+		}
+	}
+
+	if (src != dst) {
+		nvmf_poll_group_get_load(src, &src_load);
+		nvmf_poll_group_get_load(dst, &dst_load);
+
+		/* Moving the only qpair of a poll group would just move the hot spot elsewhere */
+		rebalance = src_load.io_qpairs > 1 &&
+			    (src_load.busy_step >= dst_load.busy_step + NVMF_POLL_GROUP_REBALANCE_BUSY_STEPS ||
+			     src_load.io_qpairs >= dst_load.io_qpairs + NVMF_POLL_GROUP_REBALANCE_IO_QPAIRS);
+	}
+	pthread_mutex_unlock(&tgt->mutex);
+
+	*_src = src;
+	*_dst = dst;
+
+	return rebalance;
+}
+
+/* Picks the qpair whose queue depth is closest to half the difference in outstanding I/O */
+static struct spdk_nvmf_qpair *
+nvmf_poll_group_get_rebalance_qpair(struct spdk_nvmf_poll_group *src,
+				    struct spdk_nvmf_poll_group *dst)
+{
+	struct nvmf_poll_group_load src_load, dst_load;
+	struct spdk_nvmf_qpair *qpair, *result = NULL;
+	uint32_t target = 0, diff, best = UINT32_MAX;
+
+	nvmf_poll_group_get_load(src, &src_load);
+	nvmf_poll_group_get_load(dst, &dst_load);
+	if (src_load.outstanding_io > dst_load.outstanding_io) {
+		target = (src_load.outstanding_io - dst_load.outstanding_io) / 2;
+	}
+
+	TAILQ_FOREACH(qpair, &src->qpairs, link) {
+		if (qpair->qid == 0 || qpair->state != SPDK_NVMF_QPAIR_ENABLED ||
+		    qpair->disconnect_started || qpair->migrate != NULL ||
+		    !nvmf_transport_supports_migration(qpair->transport)) {
+			continue;
+		}
+
+		diff = qpair->queue_depth > target ? qpair->queue_depth - target :
+		       target - qpair->queue_depth;
+		if (diff < best) {
+			best = diff;
+			result = qpair;
+		}
+	}
+
+	return result;
+}
+
+static void
+nvmf_tgt_rebalance_migrate_done(void *cb_arg, int status)
+{
+	struct nvmf_tgt_rebalance_ctx *ctx = cb_arg;
+
+	if (status != 0) {
+		SPDK_DEBUGLOG(nvmf, "Failed to move a qpair from poll group %p to %p: %s\n",
+			      ctx->src, ctx->dst, spdk_strerror(-status));
+	}
+
+	spdk_for_each_channel_continue(ctx->iter, 0);
+}
+
+static void
+nvmf_tgt_rebalance_on_pg(struct spdk_io_channel_iter *i)
+{
+	struct nvmf_tgt_rebalance_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+	struct spdk_io_channel *ch = spdk_io_channel_iter_get_channel(i);
+	struct spdk_nvmf_poll_group *group = spdk_io_channel_get_ctx(ch), *tmp;
+	struct spdk_nvmf_qpair *qpair;
+	int rc;
+
+	if (group != ctx->src) {
+		spdk_for_each_channel_continue(i, 0);
+		return;
+	}
+
+	/* The destination might have been destroyed since it was picked */
+	pthread_mutex_lock(&ctx->tgt->mutex);
+	TAILQ_FOREACH(tmp, &ctx->tgt->poll_groups, link) {
+		if (tmp == ctx->dst) {
+			break;
+		}
+	}
+	pthread_mutex_unlock(&ctx->tgt->mutex);
+
+	qpair = tmp != NULL ? nvmf_poll_group_get_rebalance_qpair(group, ctx->dst) : NULL;
+	if (qpair == NULL) {
+		spdk_for_each_channel_continue(i, 0);
+		return;
+	}
+
+	ctx->iter = i;
+	rc = spdk_nvmf_qpair_migrate(qpair, ctx->dst, nvmf_tgt_rebalance_migrate_done, ctx);
+	if (rc != 0) {
+		nvmf_tgt_rebalance_migrate_done(ctx, rc);
+	}
+}
+
+static void
+nvmf_tgt_rebalance_done(struct spdk_io_channel_iter *i, int status)
+{
+	struct nvmf_tgt_rebalance_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+
+	ctx->tgt->rebalance_in_progress = false;
+	free(ctx);
+}
+
+static int
+nvmf_tgt_rebalance_poll_groups(void *arg)
+{
+	struct spdk_nvmf_tgt *tgt = arg;
+	struct spdk_nvmf_poll_group *src, *dst;
+	struct nvmf_tgt_rebalance_ctx *ctx;
+
+	if (tgt->rebalance_in_progress || tgt->state != NVMF_TGT_RUNNING ||
+	    spdk_interrupt_mode_is_enabled()) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	if (!nvmf_tgt_get_rebalance_poll_groups(tgt, &src, &dst)) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	ctx->tgt = tgt;
+	ctx->src = src;
+	ctx->dst = dst;
+	tgt->rebalance_in_progress = true;
+
+	/* Iterating the channels keeps the source poll group alive until the qpair has moved */
+	spdk_for_each_channel(tgt, nvmf_tgt_rebalance_on_pg, ctx, nvmf_tgt_rebalance_done);
+
+	return SPDK_POLLER_BUSY;
+}
+
 int
 spdk_nvmf_qpair_get_peer_trid(struct spdk_nvmf_qpair *qpair,
 			      struct spdk_nvme_transport_id *trid)
@@ -1528,6 +2056,7 @@ poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
 			/* A namespace was here before, but was replaced by a new one. */
 			ns_changed = true;
 			spdk_put_io_channel(ns_info->channel);
+			nvmf_fair_sched_free(group, ns_info);
 			memset(ns_info, 0, sizeof(*ns_info));
 
 			ch = spdk_bdev_get_io_channel(ns->desc);
@@ -1559,6 +2088,7 @@ poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
 		}
 
 		if (ns == NULL) {
+			nvmf_fair_sched_free(group, ns_info);
 			memset(ns_info, 0, sizeof(*ns_info));
 		} else {
 			ns_info->uuid = *spdk_bdev_get_uuid(ns->bdev);
@@ -1679,6 +2209,7 @@ _nvmf_poll_group_remove_subsystem_cb(void *ctx, int status)
 			spdk_put_io_channel(sgroup->ns_info[nsid].channel);
 			sgroup->ns_info[nsid].channel = NULL;
 		}
+		nvmf_fair_sched_free(group, &sgroup->ns_info[nsid]);
 	}
 
 	sgroup->num_ns = 0;
@@ -1897,6 +2428,51 @@ spdk_nvmf_get_optimal_poll_group(struct spdk_nvmf_qpair *qpair)
 	return tgroup->group;
 }
 
+static void
+nvmf_poll_group_dump_fair_stat(struct spdk_nvmf_poll_group *group, struct spdk_json_write_ctx *w)
+{
+	struct spdk_nvmf_subsystem_poll_group *sgroup;
+	struct nvmf_fair_sched *sched;
+	struct nvmf_fair_flow *flow;
+	uint32_t sid, nsid;
+
+	spdk_json_write_named_array_begin(w, "namespaces");
+
+	for (sid = 0; sid < group->num_sgroups; sid++) {
+		sgroup = &group->sgroups[sid];
+
+		for (nsid = 0; nsid < sgroup->num_ns; nsid++) {
+			sched = sgroup->ns_info[nsid].fair;
+			if (sched == NULL) {
+				continue;
+			}
+
+			spdk_json_write_object_begin(w);
+			spdk_json_write_named_string(w, "nqn", spdk_nvmf_subsystem_get_nqn(sched->subsystem));
+			spdk_json_write_named_uint32(w, "nsid", sched->nsid);
+			spdk_json_write_named_uint32(w, "io_depth", sched->io_depth);
+			spdk_json_write_named_uint32(w, "io_inflight", sched->io_inflight);
+
+			spdk_json_write_named_array_begin(w, "hosts");
+			TAILQ_FOREACH(flow, &sched->flows, link) {
+				spdk_json_write_object_begin(w);
+				spdk_json_write_named_string(w, "nqn", flow->hostnqn);
+				spdk_json_write_named_uint32(w, "weight", flow->weight);
+				spdk_json_write_named_uint64(w, "submitted_ios", flow->stat.submitted_ios);
+				spdk_json_write_named_uint64(w, "submitted_bytes", flow->stat.submitted_bytes);
+				spdk_json_write_named_uint64(w, "deferred_ios", flow->stat.deferred_ios);
+				spdk_json_write_named_uint32(w, "queued_ios", flow->stat.queued_ios);
+				spdk_json_write_object_end(w);
+			}
+			spdk_json_write_array_end(w);
+
+			spdk_json_write_object_end(w);
+		}
+	}
+
+	spdk_json_write_array_end(w);
+}
+
 void
 spdk_nvmf_poll_group_dump_stat(struct spdk_nvmf_poll_group *group, struct spdk_json_write_ctx *w)
 {
@@ -1912,6 +2488,8 @@ spdk_nvmf_poll_group_dump_stat(struct spdk_nvmf_poll_group *group, struct spdk_j
 	spdk_json_write_named_uint64(w, "pending_bdev_io", group->stat.pending_bdev_io);
 	spdk_json_write_named_uint64(w, "completed_nvme_io", group->stat.completed_nvme_io);
 
+	nvmf_poll_group_dump_fair_stat(group, w);
+
 	spdk_json_write_named_array_begin(w, "transports");
 
 	TAILQ_FOREACH(tgroup, &group->tgroups, link) {
@@ -55,6 +55,9 @@ struct spdk_nvmf_tgt {
 
 	uint64_t				discovery_genctr;
 
+	/* Incremented on every change that may alter the content of discovery log pages */
+	uint64_t				discovery_log_gen;
+
 	uint32_t				max_subsystems;
 
 	uint32_t				discovery_filter;
@@ -82,6 +85,10 @@ struct spdk_nvmf_tgt {
 	uint32_t				dhchap_digests;
 	uint32_t				dhchap_dhgroups;
 
+	/* Periodically moves a qpair from the most to the least loaded poll group */
+	struct spdk_poller			*rebalance_poller;
+	bool					rebalance_in_progress;
+
 	TAILQ_ENTRY(spdk_nvmf_tgt)		link;
 };
 
@@ -89,6 +96,8 @@ struct spdk_nvmf_host {
 	char				nqn[SPDK_NVMF_NQN_MAX_LEN + 1];
 	struct spdk_key			*dhchap_key;
 	struct spdk_key			*dhchap_ctrlr_key;
+	/* Share of the namespaces' I/O depth the host gets relative to the other hosts */
+	uint32_t			weight;
 	TAILQ_ENTRY(spdk_nvmf_host)	link;
 };
 
@@ -113,6 +122,38 @@ struct spdk_nvmf_referral {
 	TAILQ_ENTRY(spdk_nvmf_referral) link;
 };
 
+/* I/O of a single host to a namespace, scheduled by deficit round robin */
+struct nvmf_fair_flow {
+	char					hostnqn[SPDK_NVMF_NQN_MAX_LEN + 1];
+	uint32_t				weight;
+	uint32_t				weight_gen;
+	/* Number of bytes the flow may submit before yielding to the next host */
+	uint64_t				deficit;
+	bool					active;
+	/* Requests waiting for a free slot, linked through buf_link */
+	STAILQ_HEAD(, spdk_nvmf_request)	queued;
+	struct {
+		uint64_t			submitted_ios;
+		uint64_t			submitted_bytes;
+		uint64_t			deferred_ios;
+		uint32_t			queued_ios;
+	} stat;
+	TAILQ_ENTRY(nvmf_fair_flow)		active_link;
+	TAILQ_ENTRY(nvmf_fair_flow)		link;
+};
+
+/* Per poll group fairness scheduler of a namespace with a limited I/O depth */
+struct nvmf_fair_sched {
+	struct spdk_nvmf_subsystem		*subsystem;
+	uint32_t				nsid;
+	uint32_t				io_depth;
+	uint32_t				io_inflight;
+	bool					dispatching;
+	/* Flows with queued requests, in round robin order */
+	TAILQ_HEAD(, nvmf_fair_flow)		active;
+	TAILQ_HEAD(, nvmf_fair_flow)		flows;
+};
+
 struct spdk_nvmf_subsystem_pg_ns_info {
 	struct spdk_io_channel		*channel;
 	struct spdk_uuid		uuid;
@@ -130,6 +171,9 @@ struct spdk_nvmf_subsystem_pg_ns_info {
 	/* I/O outstanding to this namespace */
 	uint64_t			io_outstanding;
 	enum spdk_nvmf_subsystem_state	state;
+
+	/* Allocated once the namespace limits its I/O depth */
+	struct nvmf_fair_sched		*fair;
 };
 
 typedef void(*spdk_nvmf_poll_group_mod_done)(void *cb_arg, int status);
@@ -188,6 +232,8 @@ struct spdk_nvmf_ns {
 	bool always_visible;
 	/* Namespace id of the underlying device, used for passthrough commands */
 	uint32_t passthrough_nsid;
+	/* Maximum number of I/Os submitted per poll group before hosts are scheduled fairly */
+	uint32_t fair_io_depth;
 };
 
 /*
@@ -207,6 +253,16 @@ struct spdk_nvmf_async_event_completion {
 	STAILQ_ENTRY(spdk_nvmf_async_event_completion)	link;
 };
 
+/*
+ * Discovery log page generated for a controller, reused until the target's
+ * discovery_log_gen changes.
+ */
+struct nvmf_discovery_log_cache {
+	struct spdk_nvmf_discovery_log_page	*log_page;
+	size_t					size;
+	uint64_t				gen;
+};
+
 /*
  * This structure represents an NVMe-oF controller,
  * which is like a "session" in networking terms.
@@ -242,6 +298,8 @@ struct spdk_nvmf_ctrlr {
 	uint8_t num_avail_log_pages;
 	TAILQ_HEAD(log_page_head, spdk_nvmf_reservation_log) log_head;
 
+	struct nvmf_discovery_log_cache	disc_log_cache;
+
 	/* Time to trigger keep-alive--poller_time = now_tick + period */
 	uint64_t			last_keep_alive_tick;
 	struct spdk_poller		*keep_alive_poller;
@@ -333,6 +391,9 @@ struct spdk_nvmf_subsystem {
 	TAILQ_HEAD(, spdk_nvmf_host)			hosts;
 	TAILQ_HEAD(, spdk_nvmf_subsystem_listener)	listeners;
 	struct spdk_bit_array				*used_listener_ids;
+	/* CONNECT requests waiting to be handled on the subsystem's thread, protected by ->mutex */
+	STAILQ_HEAD(, spdk_nvmf_request)		pending_connects;
+	bool						connect_msg_pending;
 
 	TAILQ_ENTRY(spdk_nvmf_subsystem)		entries;
 
@@ -351,6 +412,8 @@ struct spdk_nvmf_subsystem {
 	TAILQ_HEAD(, nvmf_subsystem_state_change_ctx)	state_changes;
 	/* In-band authentication sequence number, protected by ->mutex */
 	uint32_t					auth_seqnum;
+	/* Incremented under ->mutex whenever a host's weight changes */
+	uint32_t					host_weight_gen;
 	bool						passthrough;
 };
 
@@ -376,8 +439,22 @@ void nvmf_poll_group_pause_subsystem(struct spdk_nvmf_poll_group *group,
 void nvmf_poll_group_resume_subsystem(struct spdk_nvmf_poll_group *group,
 				      struct spdk_nvmf_subsystem *subsystem, spdk_nvmf_poll_group_mod_done cb_fn, void *cb_arg);
 
+/**
+ * Compare the load of two poll groups.
+ *
+ * Groups are ordered by how busy their threads were recently (in coarse steps,
+ * so that noise doesn't dominate), then by the number of outstanding I/O and
+ * finally by the number of I/O qpairs, including the ones still connecting.
+ *
+ * \return negative if group1 is less loaded than group2, positive if it is
+ * more loaded and 0 if they're equivalent.
+ */
+int nvmf_poll_group_load_cmp(struct spdk_nvmf_poll_group *group1,
+			     struct spdk_nvmf_poll_group *group2);
+
 void nvmf_update_discovery_log(struct spdk_nvmf_tgt *tgt, const char *hostnqn);
-void nvmf_get_discovery_log_page(struct spdk_nvmf_tgt *tgt, const char *hostnqn, struct iovec *iov,
+void nvmf_get_discovery_log_page(struct spdk_nvmf_tgt *tgt, const char *hostnqn,
+				 struct nvmf_discovery_log_cache *cache, struct iovec *iov,
 				 uint32_t iovcnt, uint64_t offset, uint32_t length,
 				 struct spdk_nvme_transport_id *cmd_source_trid);
 
@@ -389,6 +466,9 @@ bool nvmf_ctrlr_write_zeroes_supported(struct spdk_nvmf_ctrlr *ctrlr);
 bool nvmf_ctrlr_copy_supported(struct spdk_nvmf_ctrlr *ctrlr);
 void nvmf_ctrlr_ns_changed(struct spdk_nvmf_ctrlr *ctrlr, uint32_t nsid);
 bool nvmf_ctrlr_use_zcopy(struct spdk_nvmf_request *req);
+void nvmf_fair_sched_free(struct spdk_nvmf_poll_group *group,
+			  struct spdk_nvmf_subsystem_pg_ns_info *ns_info);
+void nvmf_fair_qpair_reset(struct spdk_nvmf_qpair *qpair);
 
 void nvmf_bdev_ctrlr_identify_ns(struct spdk_nvmf_ns *ns, struct spdk_nvme_ns_data *nsdata,
 				 bool dif_insert_or_strip);
@@ -425,6 +505,7 @@ void nvmf_subsystem_remove_all_listeners(struct spdk_nvmf_subsystem *subsystem,
 struct spdk_nvmf_ctrlr *nvmf_subsystem_get_ctrlr(struct spdk_nvmf_subsystem *subsystem,
 		uint16_t cntlid);
 bool nvmf_subsystem_host_auth_required(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn);
+uint32_t nvmf_subsystem_get_host_weight(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn);
 enum nvmf_auth_key_type {
 	NVMF_AUTH_KEY_HOST,
 	NVMF_AUTH_KEY_CTRLR,
@@ -253,6 +253,10 @@ dump_nvmf_subsystem(struct spdk_json_write_ctx *w, struct spdk_nvmf_subsystem *s
 				spdk_json_write_named_uint32(w, "anagrpid", ns_opts.anagrpid);
 			}
 
+			if (spdk_nvmf_ns_get_io_depth(ns) != 0) {
+				spdk_json_write_named_uint32(w, "io_depth", spdk_nvmf_ns_get_io_depth(ns));
+			}
+
 			spdk_json_write_object_end(w);
 		}
 		spdk_json_write_array_end(w);
@@ -1698,6 +1702,66 @@ rpc_nvmf_subsystem_set_ns_ana_group(struct spdk_jsonrpc_request *request,
 SPDK_RPC_REGISTER("nvmf_subsystem_set_ns_ana_group", rpc_nvmf_subsystem_set_ns_ana_group,
 		  SPDK_RPC_RUNTIME)
 
+struct nvmf_rpc_ns_io_depth_ctx {
+	char *nqn;
+	char *tgt_name;
+	uint32_t nsid;
+	uint32_t io_depth;
+};
+
+static const struct spdk_json_object_decoder nvmf_rpc_subsystem_ns_io_depth_decoder[] = {
+	{"nqn", offsetof(struct nvmf_rpc_ns_io_depth_ctx, nqn), spdk_json_decode_string},
+	{"nsid", offsetof(struct nvmf_rpc_ns_io_depth_ctx, nsid), spdk_json_decode_uint32},
+	{"io_depth", offsetof(struct nvmf_rpc_ns_io_depth_ctx, io_depth), spdk_json_decode_uint32},
+	{"tgt_name", offsetof(struct nvmf_rpc_ns_io_depth_ctx, tgt_name), spdk_json_decode_string, true},
+};
+
+static void
+rpc_nvmf_subsystem_set_ns_io_depth(struct spdk_jsonrpc_request *request,
+				   const struct spdk_json_val *params)
+{
+	struct nvmf_rpc_ns_io_depth_ctx ctx = {};
+	struct spdk_nvmf_subsystem *subsystem;
+	struct spdk_nvmf_tgt *tgt;
+	int rc;
+
+	if (spdk_json_decode_object(params, nvmf_rpc_subsystem_ns_io_depth_decoder,
+				    SPDK_COUNTOF(nvmf_rpc_subsystem_ns_io_depth_decoder), &ctx)) {
+		SPDK_ERRLOG("spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+		goto out;
+	}
+
+	tgt = spdk_nvmf_get_tgt(ctx.tgt_name);
+	if (!tgt) {
+		SPDK_ERRLOG("Unable to find a target object.\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "Unable to find a target.");
+		goto out;
+	}
+
+	subsystem = spdk_nvmf_tgt_find_subsystem(tgt, ctx.nqn);
+	if (!subsystem) {
+		SPDK_ERRLOG("Unable to find subsystem with NQN %s\n", ctx.nqn);
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+		goto out;
+	}
+
+	rc = spdk_nvmf_subsystem_set_ns_io_depth(subsystem, ctx.nsid, ctx.io_depth);
+	if (rc != 0) {
+		SPDK_ERRLOG("Unable to set I/O depth of namespace %u: %s\n", ctx.nsid, spdk_strerror(-rc));
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+		goto out;
+	}
+
+	spdk_jsonrpc_send_bool_response(request, true);
+out:
+	free(ctx.nqn);
+	free(ctx.tgt_name);
+}
+SPDK_RPC_REGISTER("nvmf_subsystem_set_ns_io_depth", rpc_nvmf_subsystem_set_ns_io_depth,
+		  SPDK_RPC_RUNTIME)
+
 struct nvmf_rpc_remove_ns_ctx {
 	char *nqn;
 	char *tgt_name;
@@ -2195,6 +2259,64 @@ out:
 }
 SPDK_RPC_REGISTER("nvmf_subsystem_set_keys", rpc_nvmf_subsystem_set_keys, SPDK_RPC_RUNTIME)
 
+struct nvmf_rpc_host_weight_ctx {
+	char *nqn;
+	char *host;
+	char *tgt_name;
+	uint32_t weight;
+};
+
+static const struct spdk_json_object_decoder nvmf_rpc_subsystem_host_weight_decoder[] = {
+	{"nqn", offsetof(struct nvmf_rpc_host_weight_ctx, nqn), spdk_json_decode_string},
+	{"host", offsetof(struct nvmf_rpc_host_weight_ctx, host), spdk_json_decode_string},
+	{"weight", offsetof(struct nvmf_rpc_host_weight_ctx, weight), spdk_json_decode_uint32},
+	{"tgt_name", offsetof(struct nvmf_rpc_host_weight_ctx, tgt_name), spdk_json_decode_string, true},
+};
+
+static void
+rpc_nvmf_subsystem_set_host_weight(struct spdk_jsonrpc_request *request,
+				   const struct spdk_json_val *params)
+{
+	struct nvmf_rpc_host_weight_ctx ctx = {};
+	struct spdk_nvmf_subsystem *subsystem;
+	struct spdk_nvmf_tgt *tgt;
+	int rc;
+
+	if (spdk_json_decode_object(params, nvmf_rpc_subsystem_host_weight_decoder,
+				    SPDK_COUNTOF(nvmf_rpc_subsystem_host_weight_decoder), &ctx)) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "Invalid parameters");
+		goto out;
+	}
+
+	tgt = spdk_nvmf_get_tgt(ctx.tgt_name);
+	if (!tgt) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "Invalid parameters");
+		goto out;
+	}
+	subsystem = spdk_nvmf_tgt_find_subsystem(tgt, ctx.nqn);
+	if (!subsystem) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "Invalid parameters");
+		goto out;
+	}
+
+	rc = spdk_nvmf_subsystem_set_host_weight(subsystem, ctx.host, ctx.weight);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		goto out;
+	}
+
+	spdk_jsonrpc_send_bool_response(request, true);
+out:
+	free(ctx.nqn);
+	free(ctx.host);
+	free(ctx.tgt_name);
+}
+SPDK_RPC_REGISTER("nvmf_subsystem_set_host_weight", rpc_nvmf_subsystem_set_host_weight,
+		  SPDK_RPC_RUNTIME)
+
 static const struct spdk_json_object_decoder nvmf_rpc_subsystem_any_host_decoder[] = {
 	{"nqn", offsetof(struct nvmf_rpc_host_ctx, nqn), spdk_json_decode_string},
 	{"allow_any_host", offsetof(struct nvmf_rpc_host_ctx, allow_any_host), spdk_json_decode_bool},
@@ -2506,6 +2628,10 @@ static const struct spdk_json_object_decoder nvmf_rpc_create_transport_decoder[]
 		"zcopy", offsetof(struct nvmf_rpc_create_transport_ctx, opts.zcopy),
 		spdk_json_decode_bool, true
 	},
+	{
+		"zcopy_read", offsetof(struct nvmf_rpc_create_transport_ctx, opts.zcopy_read),
+		spdk_json_decode_bool, true
+	},
 	{
 		"tgt_name", offsetof(struct nvmf_rpc_create_transport_ctx, tgt_name),
 		spdk_json_decode_string, true
@@ -38,6 +38,13 @@ const struct spdk_nvmf_transport_ops spdk_nvmf_transport_rdma;
 
 #define NVMF_RDMA_MAX_EVENTS_PER_POLL	32
 
+/* Number of receives (and in capsule data buffers) a shared receive queue grows by */
+#define NVMF_RDMA_SRQ_GROW_DEPTH	256
+
+/* Bounds of the delay before growing a shared receive queue is retried after a failure */
+#define NVMF_RDMA_SRQ_GROW_MIN_BACKOFF_US	1000
+#define NVMF_RDMA_SRQ_GROW_MAX_BACKOFF_US	(1000 * 1000)
+
 SPDK_STATIC_ASSERT(NVMF_DEFAULT_MSDBD <= SPDK_NVMF_MAX_SGL_ENTRIES,
 		   "MSDBD must not exceed SPDK_NVMF_MAX_SGL_ENTRIES");
 
@@ -293,6 +300,19 @@ struct spdk_nvmf_rdma_resources {
 	 */
 	void					*bufs;
 
+	/* A shared receive queue starts with NVMF_RDMA_SRQ_GROW_DEPTH receives and allocates
+	 * in capsule data buffers for more of them only once the arrival rate requires it.
+	 * Each array element holds the buffers of NVMF_RDMA_SRQ_GROW_DEPTH receives.
+	 */
+	void					**buf_chunks;
+	uint32_t				num_buf_chunks;
+
+	/* Number of receives set up and posted, up to max_queue_depth */
+	uint32_t				active_depth;
+	uint32_t				max_queue_depth;
+	uint32_t				in_capsule_data_size;
+	struct spdk_rdma_utils_mem_map		*map;
+
 	/* Receives that are waiting for a request object */
 	STAILQ_HEAD(, spdk_nvmf_rdma_recv)	incoming_queue;
 
@@ -418,6 +438,14 @@ struct spdk_nvmf_rdma_poller {
 	uint16_t				max_srq_depth;
 	bool					need_destroy;
 
+	/* Number of receives completed on the shared receive queue */
+	uint64_t				srq_recvs_completed;
+
+	/* Growing the shared receive queue is not retried before srq_grow_retry_tsc after it
+	 * failed, the delay doubles with each consecutive failure. */
+	uint64_t				srq_grow_retry_tsc;
+	uint64_t				srq_grow_backoff_us;
+
 	/* Shared receive queue */
 	struct spdk_rdma_provider_srq		*srq;
 
@@ -660,6 +688,12 @@ nvmf_rdma_dump_qpair_contents(struct spdk_nvmf_rdma_qpair *rqpair)
 static void
 nvmf_rdma_resources_destroy(struct spdk_nvmf_rdma_resources *resources)
 {
+	uint32_t i;
+
+	for (i = 0; i < resources->num_buf_chunks; i++) {
+		spdk_free(resources->buf_chunks[i]);
+	}
+	free(resources->buf_chunks);
 	spdk_free(resources->cmds);
 	spdk_free(resources->cpls);
 	spdk_free(resources->bufs);
@@ -668,13 +702,102 @@ nvmf_rdma_resources_destroy(struct spdk_nvmf_rdma_resources *resources)
 	free(resources);
 }
 
+static int
+nvmf_rdma_resources_init_recv(struct spdk_nvmf_rdma_resources *resources,
+			      struct spdk_nvmf_rdma_qpair *rqpair, uint32_t i, void *buf)
+{
+	struct spdk_nvmf_rdma_recv		*rdma_recv = &resources->recvs[i];
+	struct spdk_rdma_utils_memory_translation translation;
+	int					rc;
+
+	rdma_recv->qpair = rqpair;
+
+	/* Set up memory to receive commands */
+	rdma_recv->buf = buf;
+
+	rdma_recv->rdma_wr.type = RDMA_WR_TYPE_RECV;
+
+	rdma_recv->sgl[0].addr = (uintptr_t)&resources->cmds[i];
+	rdma_recv->sgl[0].length = sizeof(resources->cmds[i]);
+	rc = spdk_rdma_utils_get_translation(resources->map, &resources->cmds[i],
+					     sizeof(resources->cmds[i]), &translation);
+	if (rc) {
+		return rc;
+	}
+	rdma_recv->sgl[0].lkey = spdk_rdma_utils_memory_translation_get_lkey(&translation);
+	rdma_recv->wr.num_sge = 1;
+
+	if (rdma_recv->buf) {
+		rdma_recv->sgl[1].addr = (uintptr_t)rdma_recv->buf;
+		rdma_recv->sgl[1].length = resources->in_capsule_data_size;
+		rc = spdk_rdma_utils_get_translation(resources->map, rdma_recv->buf,
+						     resources->in_capsule_data_size, &translation);
+		if (rc) {
+			return rc;
+		}
+		rdma_recv->sgl[1].lkey = spdk_rdma_utils_memory_translation_get_lkey(&translation);
+		rdma_recv->wr.num_sge++;
+	}
+
+	rdma_recv->wr.wr_id = (uintptr_t)&rdma_recv->rdma_wr;
+	rdma_recv->wr.sg_list = rdma_recv->sgl;
+
+	return 0;
+}
+
+/* Set up the next NVMF_RDMA_SRQ_GROW_DEPTH receives of a shared receive queue and queue them
+ * for posting. */
+static int
+nvmf_rdma_resources_grow_srq(struct spdk_nvmf_rdma_resources *resources,
+			     struct spdk_rdma_provider_srq *srq)
+{
+	uint32_t	start = resources->active_depth;
+	uint32_t	count, i;
+	uint8_t		*buf = NULL;
+	int		rc;
+
+	assert(start % NVMF_RDMA_SRQ_GROW_DEPTH == 0);
+	if (start == resources->max_queue_depth) {
+		return -ENOSPC;
+	}
+
+	count = spdk_min(NVMF_RDMA_SRQ_GROW_DEPTH, resources->max_queue_depth - start);
+	if (resources->in_capsule_data_size > 0) {
+		buf = spdk_zmalloc(count * resources->in_capsule_data_size, 0x1000, NULL,
+				   SPDK_ENV_LCORE_ID_ANY, SPDK_MALLOC_DMA);
+		if (!buf) {
+			return -ENOMEM;
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		rc = nvmf_rdma_resources_init_recv(resources, NULL, start + i,
+						   buf ? buf + i * resources->in_capsule_data_size : NULL);
+		if (rc) {
+			spdk_free(buf);
+			return rc;
+		}
+	}
+
+	resources->buf_chunks[start / NVMF_RDMA_SRQ_GROW_DEPTH] = buf;
+	resources->num_buf_chunks++;
+	resources->active_depth += count;
+
+	for (i = 0; i < count; i++) {
+		spdk_rdma_provider_srq_queue_recv_wrs(srq, &resources->recvs[start + i].wr);
+	}
+
+	SPDK_DEBUGLOG(rdma, "Shared receive queue %p has %u receives posted out of %u\n",
+		      srq, resources->active_depth, resources->max_queue_depth);
+
+	return 0;
+}
 
 static struct spdk_nvmf_rdma_resources *
 nvmf_rdma_resources_create(struct spdk_nvmf_rdma_resource_opts *opts)
 {
 	struct spdk_nvmf_rdma_resources		*resources;
 	struct spdk_nvmf_rdma_request		*rdma_req;
-	struct spdk_nvmf_rdma_recv		*rdma_recv;
 	struct spdk_rdma_provider_qp		*qp = NULL;
 	struct spdk_rdma_provider_srq		*srq = NULL;
 	struct ibv_recv_wr			*bad_wr = NULL;
@@ -688,6 +811,10 @@ nvmf_rdma_resources_create(struct spdk_nvmf_rdma_resource_opts *opts)
 		return NULL;
 	}
 
+	resources->max_queue_depth = opts->max_queue_depth;
+	resources->in_capsule_data_size = opts->in_capsule_data_size;
+	resources->map = opts->map;
+
 	resources->reqs = spdk_zmalloc(opts->max_queue_depth * sizeof(*resources->reqs),
 				       0x1000, NULL, SPDK_ENV_LCORE_ID_ANY, SPDK_MALLOC_DMA);
 	resources->recvs = spdk_zmalloc(opts->max_queue_depth * sizeof(*resources->recvs),
@@ -697,14 +824,21 @@ nvmf_rdma_resources_create(struct spdk_nvmf_rdma_resource_opts *opts)
 	resources->cpls = spdk_zmalloc(opts->max_queue_depth * sizeof(*resources->cpls),
 				       0x1000, NULL, SPDK_ENV_LCORE_ID_ANY, SPDK_MALLOC_DMA);
 
-	if (opts->in_capsule_data_size > 0) {
+	if (opts->shared) {
+		resources->buf_chunks = calloc(SPDK_CEIL_DIV(opts->max_queue_depth, NVMF_RDMA_SRQ_GROW_DEPTH),
+					       sizeof(*resources->buf_chunks));
+		if (!resources->buf_chunks) {
+			SPDK_ERRLOG("Unable to allocate sufficient memory for RDMA queue.\n");
+			goto cleanup;
+		}
+	} else if (opts->in_capsule_data_size > 0) {
 		resources->bufs = spdk_zmalloc(opts->max_queue_depth * opts->in_capsule_data_size,
 					       0x1000, NULL, SPDK_ENV_LCORE_ID_ANY,
 					       SPDK_MALLOC_DMA);
 	}
 
-	if (!resources->reqs || !resources->recvs || !resources->cmds ||
-	    !resources->cpls || (opts->in_capsule_data_size && !resources->bufs)) {
+	if (!resources->reqs || !resources->recvs || !resources->cmds || !resources->cpls ||
+	    (!opts->shared && opts->in_capsule_data_size && !resources->bufs)) {
 		SPDK_ERRLOG("Unable to allocate sufficient memory for RDMA queue.\n");
 		goto cleanup;
 	}
@@ -725,51 +859,23 @@ nvmf_rdma_resources_create(struct spdk_nvmf_rdma_resource_opts *opts)
 
 	if (opts->shared) {
 		srq = (struct spdk_rdma_provider_srq *)opts->qp;
-	} else {
-		qp = (struct spdk_rdma_provider_qp *)opts->qp;
-	}
-
-	for (i = 0; i < opts->max_queue_depth; i++) {
-		rdma_recv = &resources->recvs[i];
-		rdma_recv->qpair = opts->qpair;
-
-		/* Set up memory to receive commands */
-		if (resources->bufs) {
-			rdma_recv->buf = (void *)((uintptr_t)resources->bufs + (i *
-						  opts->in_capsule_data_size));
-		}
-
-		rdma_recv->rdma_wr.type = RDMA_WR_TYPE_RECV;
-
-		rdma_recv->sgl[0].addr = (uintptr_t)&resources->cmds[i];
-		rdma_recv->sgl[0].length = sizeof(resources->cmds[i]);
-		rc = spdk_rdma_utils_get_translation(opts->map, &resources->cmds[i], sizeof(resources->cmds[i]),
-						     &translation);
+		rc = nvmf_rdma_resources_grow_srq(resources, srq);
 		if (rc) {
+			SPDK_ERRLOG("Unable to set up receives for shared receive queue.\n");
 			goto cleanup;
 		}
-		rdma_recv->sgl[0].lkey = spdk_rdma_utils_memory_translation_get_lkey(&translation);
-		rdma_recv->wr.num_sge = 1;
-
-		if (rdma_recv->buf) {
-			rdma_recv->sgl[1].addr = (uintptr_t)rdma_recv->buf;
-			rdma_recv->sgl[1].length = opts->in_capsule_data_size;
-			rc = spdk_rdma_utils_get_translation(opts->map, rdma_recv->buf, opts->in_capsule_data_size,
-							     &translation);
+	} else {
+		qp = (struct spdk_rdma_provider_qp *)opts->qp;
+		for (i = 0; i < opts->max_queue_depth; i++) {
+			rc = nvmf_rdma_resources_init_recv(resources, opts->qpair, i,
+							   resources->bufs ? (uint8_t *)resources->bufs +
+							   i * opts->in_capsule_data_size : NULL);
 			if (rc) {
 				goto cleanup;
 			}
-			rdma_recv->sgl[1].lkey = spdk_rdma_utils_memory_translation_get_lkey(&translation);
-			rdma_recv->wr.num_sge++;
-		}
-
-		rdma_recv->wr.wr_id = (uintptr_t)&rdma_recv->rdma_wr;
-		rdma_recv->wr.sg_list = rdma_recv->sgl;
-		if (srq) {
-			spdk_rdma_provider_srq_queue_recv_wrs(srq, &rdma_recv->wr);
-		} else {
-			spdk_rdma_provider_qp_queue_recv_wrs(qp, &rdma_recv->wr);
+			spdk_rdma_provider_qp_queue_recv_wrs(qp, &resources->recvs[i].wr);
 		}
+		resources->active_depth = opts->max_queue_depth;
 	}
 
 	for (i = 0; i < opts->max_queue_depth; i++) {
@@ -4126,29 +4232,12 @@ nvmf_rdma_poll_group_create(struct spdk_nvmf_transport *transport,
 	return &rgroup->group;
 }
 
-static uint32_t
-nvmf_poll_group_get_io_qpair_count(struct spdk_nvmf_poll_group *pg)
-{
-	uint32_t count;
-
-	/* Just assume that unassociated qpairs will eventually be io
-	 * qpairs.  This is close enough for the use cases for this
-	 * function.
-	 */
-	pthread_mutex_lock(&pg->mutex);
-	count = pg->stat.current_io_qpairs + pg->current_unassociated_qpairs;
-	pthread_mutex_unlock(&pg->mutex);
-
-	return count;
-}
-
 static struct spdk_nvmf_transport_poll_group *
 nvmf_rdma_get_optimal_poll_group(struct spdk_nvmf_qpair *qpair)
 {
 	struct spdk_nvmf_rdma_transport *rtransport;
 	struct spdk_nvmf_rdma_poll_group **pg;
 	struct spdk_nvmf_transport_poll_group *result;
-	uint32_t count;
 
 	rtransport = SPDK_CONTAINEROF(qpair->transport, struct spdk_nvmf_rdma_transport, transport);
 
@@ -4160,19 +4249,14 @@ nvmf_rdma_get_optimal_poll_group(struct spdk_nvmf_qpair *qpair)
 		pg = &rtransport->conn_sched.next_admin_pg;
 	} else {
 		struct spdk_nvmf_rdma_poll_group *pg_min, *pg_start, *pg_current;
-		uint32_t min_value;
 
 		pg = &rtransport->conn_sched.next_io_pg;
 		pg_min = *pg;
 		pg_start = *pg;
 		pg_current = *pg;
-		min_value = nvmf_poll_group_get_io_qpair_count(pg_current->group.group);
 
-		while (1) {
-			count = nvmf_poll_group_get_io_qpair_count(pg_current->group.group);
-
-			if (count < min_value) {
-				min_value = count;
+		do {
+			if (nvmf_poll_group_load_cmp(pg_current->group.group, pg_min->group.group) < 0) {
 				pg_min = pg_current;
 			}
 
@@ -4180,11 +4264,7 @@ nvmf_rdma_get_optimal_poll_group(struct spdk_nvmf_qpair *qpair)
 			if (pg_current == NULL) {
 				pg_current = TAILQ_FIRST(&rtransport->poll_groups);
 			}
-
-			if (pg_current == pg_start || min_value == 0) {
-				break;
-			}
-		}
+		} while (pg_current != pg_start);
 		*pg = pg_min;
 	}
 
@@ -4633,6 +4713,47 @@ nvmf_rdma_log_wc_status(struct spdk_nvmf_rdma_qpair *rqpair, struct ibv_wc *wc)
 	}
 }
 
+/* Add receives to the shared receive queue once fewer than a quarter of the active ones
+ * are left posted, so that the arrival rate rather than max_srq_depth determines how much
+ * in capsule data buffer memory a poller keeps. */
+static void
+nvmf_rdma_poller_grow_srq(struct spdk_nvmf_rdma_poller *rpoller)
+{
+	struct spdk_nvmf_rdma_resources *resources = rpoller->resources;
+	uint64_t posted, backoff_us;
+	int rc;
+
+	if (spdk_likely(resources->active_depth == resources->max_queue_depth)) {
+		return;
+	}
+
+	posted = rpoller->stat.qp_stats.recv.num_submitted_wrs - rpoller->srq_recvs_completed;
+	if (posted * 4 >= resources->active_depth) {
+		return;
+	}
+
+	if (spdk_unlikely(rpoller->srq_grow_backoff_us != 0) &&
+	    spdk_get_ticks() < rpoller->srq_grow_retry_tsc) {
+		return;
+	}
+
+	rc = nvmf_rdma_resources_grow_srq(resources, rpoller->srq);
+	if (spdk_unlikely(rc != 0)) {
+		/* Most likely a transient shortage of memory, try again later */
+		backoff_us = spdk_min(rpoller->srq_grow_backoff_us * 2, NVMF_RDMA_SRQ_GROW_MAX_BACKOFF_US);
+		backoff_us = spdk_max(backoff_us, NVMF_RDMA_SRQ_GROW_MIN_BACKOFF_US);
+		rpoller->srq_grow_backoff_us = backoff_us;
+		rpoller->srq_grow_retry_tsc = spdk_get_ticks() +
+					      backoff_us * spdk_get_ticks_hz() / SPDK_SEC_TO_USEC;
+		SPDK_WARNLOG("Unable to grow shared receive queue of poller %p (%d), keeping %u receives "
+			     "for %" PRIu64 " us\n", rpoller, rc, resources->active_depth,
+			     rpoller->srq_grow_backoff_us);
+		return;
+	}
+
+	rpoller->srq_grow_backoff_us = 0;
+}
+
 static int
 nvmf_rdma_poller_poll(struct spdk_nvmf_rdma_transport *rtransport,
 		      struct spdk_nvmf_rdma_poller *rpoller)
@@ -4699,6 +4820,7 @@ nvmf_rdma_poller_poll(struct spdk_nvmf_rdma_transport *rtransport,
 			/* rdma_recv->qpair will be invalid if using an SRQ.  In that case we have to get the qpair from the wc. */
 			rdma_recv = SPDK_CONTAINEROF(rdma_wr, struct spdk_nvmf_rdma_recv, rdma_wr);
 			if (rpoller->srq != NULL) {
+				rpoller->srq_recvs_completed++;
 				rdma_recv->qpair = get_rdma_qpair_from_wc(rpoller, &wc[i]);
 				/* It is possible that there are still some completions for destroyed QP
 				 * associated with SRQ. We just ignore these late completions and re-post
@@ -4816,6 +4938,10 @@ nvmf_rdma_poller_poll(struct spdk_nvmf_rdma_transport *rtransport,
 		nvmf_rdma_poller_process_pending_buf_queue(rtransport, rpoller);
 	}
 
+	if (rpoller->srq != NULL) {
+		nvmf_rdma_poller_grow_srq(rpoller);
+	}
+
 	/* submit outstanding work requests. */
 	_poller_submit_recvs(rtransport, rpoller);
 	_poller_submit_sends(rtransport, rpoller);
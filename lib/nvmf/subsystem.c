@@ -271,6 +271,7 @@ spdk_nvmf_subsystem_create(struct spdk_nvmf_tgt *tgt,
 	TAILQ_INIT(&subsystem->hosts);
 	TAILQ_INIT(&subsystem->ctrlrs);
 	TAILQ_INIT(&subsystem->state_changes);
+	STAILQ_INIT(&subsystem->pending_connects);
 	subsystem->used_listener_ids = spdk_bit_array_create(NVMF_MAX_LISTENERS_PER_SUBSYSTEM);
 	if (subsystem->used_listener_ids == NULL) {
 		pthread_mutex_destroy(&subsystem->mutex);
@@ -583,6 +584,12 @@ nvmf_subsystem_set_state(struct spdk_nvmf_subsystem *subsystem,
 					    __ATOMIC_RELAXED, __ATOMIC_RELAXED);
 	}
 	assert(actual_old_state == expected_old_state);
+
+	/* Inactive subsystems are left out of discovery log pages */
+	if (state == SPDK_NVMF_SUBSYSTEM_ACTIVATING || state == SPDK_NVMF_SUBSYSTEM_DEACTIVATING) {
+		subsystem->tgt->discovery_log_gen++;
+	}
+
 	return actual_old_state - expected_old_state;
 }
 
@@ -1037,6 +1044,7 @@ spdk_nvmf_subsystem_add_host_ext(struct spdk_nvmf_subsystem *subsystem,
 	}
 
 	snprintf(host->nqn, sizeof(host->nqn), "%s", hostnqn);
+	host->weight = 1;
 
 	SPDK_DTRACE_PROBE2(nvmf_subsystem_add_host, subsystem->subnqn, host->nqn);
 
@@ -1167,6 +1175,47 @@ spdk_nvmf_subsystem_set_keys(struct spdk_nvmf_subsystem *subsystem, const char *
 	return 0;
 }
 
+int
+spdk_nvmf_subsystem_set_host_weight(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn,
+				    uint32_t weight)
+{
+	struct spdk_nvmf_host *host;
+
+	if (weight == 0) {
+		return -EINVAL;
+	}
+
+	pthread_mutex_lock(&subsystem->mutex);
+	host = nvmf_subsystem_find_host(subsystem, hostnqn);
+	if (host == NULL) {
+		pthread_mutex_unlock(&subsystem->mutex);
+		return -ENOENT;
+	}
+
+	host->weight = weight;
+	/* Poll groups pick up the new weight the next time they refill the host's deficit */
+	subsystem->host_weight_gen++;
+	pthread_mutex_unlock(&subsystem->mutex);
+
+	return 0;
+}
+
+uint32_t
+nvmf_subsystem_get_host_weight(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn)
+{
+	struct spdk_nvmf_host *host;
+	uint32_t weight = 1;
+
+	pthread_mutex_lock(&subsystem->mutex);
+	host = nvmf_subsystem_find_host(subsystem, hostnqn);
+	if (host != NULL) {
+		weight = host->weight;
+	}
+	pthread_mutex_unlock(&subsystem->mutex);
+
+	return weight;
+}
+
 struct nvmf_subsystem_disconnect_host_ctx {
 	struct spdk_nvmf_subsystem		*subsystem;
 	char					*hostnqn;
@@ -2348,6 +2397,29 @@ spdk_nvmf_subsystem_set_ns_ana_group(struct spdk_nvmf_subsystem *subsystem,
 	return 0;
 }
 
+int
+spdk_nvmf_subsystem_set_ns_io_depth(struct spdk_nvmf_subsystem *subsystem, uint32_t nsid,
+				    uint32_t io_depth)
+{
+	struct spdk_nvmf_ns *ns;
+
+	ns = spdk_nvmf_subsystem_get_ns(subsystem, nsid);
+	if (ns == NULL) {
+		return -ENOENT;
+	}
+
+	/* Read by the poll groups on the I/O path, they apply it to the next request */
+	ns->fair_io_depth = io_depth;
+
+	return 0;
+}
+
+uint32_t
+spdk_nvmf_ns_get_io_depth(const struct spdk_nvmf_ns *ns)
+{
+	return ns->fair_io_depth;
+}
+
 static uint32_t
 nvmf_subsystem_get_next_allocated_nsid(struct spdk_nvmf_subsystem *subsystem,
 				       uint32_t prev_nsid)
@@ -326,6 +326,9 @@ struct spdk_nvmf_tcp_qpair {
 
 	TAILQ_ENTRY(spdk_nvmf_tcp_qpair)	link;
 	bool					pending_flush;
+
+	/* New commands are held in the AWAIT_REQ state while the qpair is being migrated */
+	bool					quiesced;
 };
 
 struct spdk_nvmf_tcp_control_msg {
@@ -347,6 +350,8 @@ struct spdk_nvmf_tcp_poll_group {
 
 	struct spdk_io_channel			*accel_channel;
 	struct spdk_nvmf_tcp_control_msg_list	*control_msg_list;
+	/* CRC32C is executed by the software accel module */
+	bool					inline_ddgst;
 
 	TAILQ_ENTRY(spdk_nvmf_tcp_poll_group)	link;
 };
@@ -1246,6 +1251,19 @@ data_crc32_accel_done(void *cb_arg, int status)
 	_tcp_write_pdu(pdu);
 }
 
+static void
+data_crc32_accel_pad_done(void *cb_arg, int status)
+{
+	struct nvme_tcp_pdu *pdu = cb_arg;
+
+	/* The accel module only covers the data, the digest padding is added here */
+	if (spdk_likely(status == 0)) {
+		pdu->data_digest_crc32 = nvme_tcp_pdu_pad_data_digest(pdu, pdu->data_digest_crc32);
+	}
+
+	data_crc32_accel_done(pdu, status);
+}
+
 static void
 pdu_data_crc32_compute(struct nvme_tcp_pdu *pdu)
 {
@@ -1255,10 +1273,9 @@ pdu_data_crc32_compute(struct nvme_tcp_pdu *pdu)
 	/* Data Digest */
 	if (pdu->data_len > 0 && g_nvme_tcp_ddgst[pdu->hdr.common.pdu_type] && tqpair->host_ddgst_enable) {
 		/* Only support this limitated case for the first step */
-		if (spdk_likely(!pdu->dif_ctx && (pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT == 0)
-				&& tqpair->group)) {
+		if (spdk_likely(!pdu->dif_ctx && tqpair->group)) {
 			rc = spdk_accel_submit_crc32cv(tqpair->group->accel_channel, &pdu->data_digest_crc32, pdu->data_iov,
-						       pdu->data_iovcnt, 0, data_crc32_accel_done, pdu);
+						       pdu->data_iovcnt, 0, data_crc32_accel_pad_done, pdu);
 			if (spdk_likely(rc == 0)) {
 				return;
 			}
@@ -1636,6 +1653,7 @@ nvmf_tcp_poll_group_create(struct spdk_nvmf_transport *transport,
 {
 	struct spdk_nvmf_tcp_transport	*ttransport;
 	struct spdk_nvmf_tcp_poll_group *tgroup;
+	const char *module_name = NULL;
 	int rc;
 
 	tgroup = calloc(1, sizeof(*tgroup));
@@ -1669,6 +1687,13 @@ nvmf_tcp_poll_group_create(struct spdk_nvmf_transport *transport,
 		goto cleanup;
 	}
 
+	/* Offloading the data digest to the software module only adds a task round trip,
+	 * so compute it while the payload is received and still hot in the cache instead. */
+	if (spdk_accel_get_opc_module_name(SPDK_ACCEL_OPC_CRC32C, &module_name) == 0 &&
+	    module_name != NULL && strcmp(module_name, "software") == 0) {
+		tgroup->inline_ddgst = true;
+	}
+
 	TAILQ_INSERT_TAIL(&ttransport->poll_groups, tgroup, link);
 	if (ttransport->next_pg == NULL) {
 		ttransport->next_pg = tgroup;
@@ -1690,6 +1715,31 @@ cleanup:
 	return NULL;
 }
 
+static struct spdk_nvmf_tcp_poll_group *
+nvmf_tcp_get_least_loaded_poll_group(struct spdk_nvmf_tcp_transport *ttransport,
+				     struct spdk_nvmf_tcp_poll_group *start)
+{
+	struct spdk_nvmf_tcp_poll_group *tgroup, *result;
+
+	/* Start from the round-robin position, so that equally loaded groups are still rotated */
+	result = start;
+	tgroup = start;
+	do {
+		/* Skip poll groups that are still being set up */
+		if (tgroup->group.group != NULL &&
+		    (result->group.group == NULL ||
+		     nvmf_poll_group_load_cmp(tgroup->group.group, result->group.group) < 0)) {
+			result = tgroup;
+		}
+		tgroup = TAILQ_NEXT(tgroup, link);
+		if (tgroup == NULL) {
+			tgroup = TAILQ_FIRST(&ttransport->poll_groups);
+		}
+	} while (tgroup != start);
+
+	return result;
+}
+
 static struct spdk_nvmf_transport_poll_group *
 nvmf_tcp_get_optimal_poll_group(struct spdk_nvmf_qpair *qpair)
 {
@@ -1707,6 +1757,7 @@ nvmf_tcp_get_optimal_poll_group(struct spdk_nvmf_qpair *qpair)
 
 	pg = &ttransport->next_pg;
 	assert(*pg != NULL);
+	*pg = nvmf_tcp_get_least_loaded_poll_group(ttransport, *pg);
 	hint = (*pg)->sock_group;
 
 	tqpair = SPDK_CONTAINEROF(qpair, struct spdk_nvmf_tcp_qpair, qpair);
@@ -1871,6 +1922,10 @@ nvmf_tcp_capsule_cmd_hdr_handle(struct spdk_nvmf_tcp_transport *ttransport,
 	assert(pdu->psh_valid_bytes == pdu->psh_len);
 	assert(pdu->hdr.common.pdu_type == SPDK_NVME_TCP_PDU_TYPE_CAPSULE_CMD);
 
+	if (spdk_unlikely(tqpair->quiesced)) {
+		return;
+	}
+
 	tcp_req = nvmf_tcp_req_get(tqpair);
 	if (!tcp_req) {
 		/* Directly return and make the allocation retry again.  This can happen if we're
@@ -2238,6 +2293,48 @@ data_crc32_calc_done(void *cb_arg, int status)
 	_nvmf_tcp_pdu_payload_handle(tqpair, pdu);
 }
 
+static void
+data_crc32_accel_calc_done(void *cb_arg, int status)
+{
+	struct nvme_tcp_pdu *pdu = cb_arg;
+
+	/* The accel module only covers the data, the digest padding is added here */
+	if (spdk_likely(status == 0)) {
+		pdu->data_digest_crc32 = nvme_tcp_pdu_pad_data_digest(pdu, pdu->data_digest_crc32);
+	}
+
+	data_crc32_calc_done(pdu, status);
+}
+
+static inline bool
+nvmf_tcp_pdu_ddgst_offload(struct spdk_nvmf_tcp_qpair *tqpair, struct nvme_tcp_pdu *pdu)
+{
+	return tqpair->qpair.qid != 0 && !pdu->dif_ctx && tqpair->group &&
+	       !tqpair->group->inline_ddgst;
+}
+
+/* Fold len bytes of the payload, starting at offset, into the running data digest */
+static void
+nvmf_tcp_pdu_update_data_digest(struct nvme_tcp_pdu *pdu, uint32_t offset, uint32_t len)
+{
+	struct iovec *iov;
+	uint32_t i, seg_len;
+
+	for (i = 0; i < pdu->data_iovcnt && len > 0; i++) {
+		iov = &pdu->data_iov[i];
+		if (offset >= iov->iov_len) {
+			offset -= iov->iov_len;
+			continue;
+		}
+
+		seg_len = spdk_min(iov->iov_len - offset, len);
+		pdu->data_digest_crc32 = spdk_crc32c_update((uint8_t *)iov->iov_base + offset, seg_len,
+					 pdu->data_digest_crc32);
+		len -= seg_len;
+		offset = 0;
+	}
+}
+
 static void
 nvmf_tcp_pdu_payload_handle(struct spdk_nvmf_tcp_qpair *tqpair, struct nvme_tcp_pdu *pdu)
 {
@@ -2248,10 +2345,11 @@ nvmf_tcp_pdu_payload_handle(struct spdk_nvmf_tcp_qpair *tqpair, struct nvme_tcp_
 	SPDK_DEBUGLOG(nvmf_tcp, "enter\n");
 	/* check data digest if need */
 	if (pdu->ddgst_enable) {
-		if (tqpair->qpair.qid != 0 && !pdu->dif_ctx && tqpair->group &&
-		    (pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT == 0)) {
+		if (pdu->ddgst_inline) {
+			pdu->data_digest_crc32 = nvme_tcp_pdu_pad_data_digest(pdu, pdu->data_digest_crc32);
+		} else if (nvmf_tcp_pdu_ddgst_offload(tqpair, pdu)) {
 			rc = spdk_accel_submit_crc32cv(tqpair->group->accel_channel, &pdu->data_digest_crc32, pdu->data_iov,
-						       pdu->data_iovcnt, 0, data_crc32_calc_done, pdu);
+						       pdu->data_iovcnt, 0, data_crc32_accel_calc_done, pdu);
 			if (spdk_likely(rc == 0)) {
 				return;
 			}
@@ -2592,11 +2690,22 @@ nvmf_tcp_sock_process(struct spdk_nvmf_tcp_qpair *tqpair)
 				pdu->ddgst_enable = true;
 			}
 
+			if (pdu->rw_offset == 0) {
+				/* Without an offload the digest is accumulated as the data arrives */
+				pdu->ddgst_inline = pdu->ddgst_enable && !pdu->dif_ctx &&
+						    !nvmf_tcp_pdu_ddgst_offload(tqpair, pdu);
+				pdu->data_digest_crc32 = SPDK_CRC32C_XOR;
+			}
+
 			rc = nvme_tcp_read_payload_data(tqpair->sock, pdu);
 			if (rc < 0) {
 				nvmf_tcp_qpair_set_recv_state(tqpair, NVME_TCP_PDU_RECV_STATE_QUIESCING);
 				break;
 			}
+			if (pdu->ddgst_inline && pdu->rw_offset < pdu->data_len) {
+				nvmf_tcp_pdu_update_data_digest(pdu, pdu->rw_offset,
+								spdk_min((uint32_t)rc, pdu->data_len - pdu->rw_offset));
+			}
 			pdu->rw_offset += rc;
 
 			if (pdu->rw_offset < data_len) {
@@ -3456,6 +3565,108 @@ nvmf_tcp_poll_group_add(struct spdk_nvmf_transport_poll_group *group,
 	return 0;
 }
 
+static void
+nvmf_tcp_qpair_quiesce(struct spdk_nvmf_qpair *qpair, bool quiesce)
+{
+	struct spdk_nvmf_tcp_qpair *tqpair = SPDK_CONTAINEROF(qpair, struct spdk_nvmf_tcp_qpair, qpair);
+
+	/* The await_req list is polled, so held commands are picked up again without a kick */
+	tqpair->quiesced = quiesce;
+}
+
+static bool
+nvmf_tcp_qpair_is_idle(struct spdk_nvmf_tcp_qpair *tqpair)
+{
+	/* Besides the PDU being received, everything in flight is tied to a request */
+	if (tqpair->state != NVMF_TCP_QPAIR_STATE_RUNNING || tqpair->qpair.queue_depth != 0 ||
+	    tqpair->pending_flush ||
+	    tqpair->tcp_pdu_working_count != (tqpair->pdu_in_progress != NULL ? 1 : 0)) {
+		return false;
+	}
+
+	switch (tqpair->recv_state) {
+	case NVME_TCP_PDU_RECV_STATE_AWAIT_PDU_READY:
+	case NVME_TCP_PDU_RECV_STATE_AWAIT_PDU_CH:
+	case NVME_TCP_PDU_RECV_STATE_AWAIT_PDU_PSH:
+	case NVME_TCP_PDU_RECV_STATE_AWAIT_REQ:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static int
+nvmf_tcp_poll_group_detach(struct spdk_nvmf_transport_poll_group *group,
+			   struct spdk_nvmf_qpair *qpair)
+{
+	struct spdk_nvmf_tcp_poll_group	*tgroup;
+	struct spdk_nvmf_tcp_qpair	*tqpair;
+	int				rc;
+
+	tgroup = SPDK_CONTAINEROF(group, struct spdk_nvmf_tcp_poll_group, group);
+	tqpair = SPDK_CONTAINEROF(qpair, struct spdk_nvmf_tcp_qpair, qpair);
+
+	assert(tqpair->group == tgroup);
+	assert(tqpair->quiesced);
+
+	if (!nvmf_tcp_qpair_is_idle(tqpair)) {
+		return -EBUSY;
+	}
+
+	rc = spdk_sock_group_remove_sock(tgroup->sock_group, tqpair->sock);
+	if (rc != 0) {
+		SPDK_ERRLOG("Could not remove sock from sock_group: %s (%d)\n",
+			    spdk_strerror(errno), errno);
+		return -errno;
+	}
+
+	if (tqpair->recv_state == NVME_TCP_PDU_RECV_STATE_AWAIT_REQ) {
+		TAILQ_REMOVE(&tgroup->await_req, tqpair, link);
+	} else {
+		TAILQ_REMOVE(&tgroup->qpairs, tqpair, link);
+	}
+	tqpair->group = NULL;
+
+	SPDK_DEBUGLOG(nvmf_tcp, "detached tqpair=%p from the tgroup=%p\n", tqpair, tgroup);
+
+	return 0;
+}
+
+static int
+nvmf_tcp_poll_group_attach(struct spdk_nvmf_transport_poll_group *group,
+			   struct spdk_nvmf_qpair *qpair)
+{
+	struct spdk_nvmf_tcp_poll_group	*tgroup;
+	struct spdk_nvmf_tcp_qpair	*tqpair;
+	int				rc;
+
+	tgroup = SPDK_CONTAINEROF(group, struct spdk_nvmf_tcp_poll_group, group);
+	tqpair = SPDK_CONTAINEROF(qpair, struct spdk_nvmf_tcp_qpair, qpair);
+
+	assert(tqpair->group == NULL);
+
+	/* The qpair belongs to the group even if the socket can't be added, so that
+	 * it can be removed from it when it's disconnected. */
+	tqpair->group = tgroup;
+	if (tqpair->recv_state == NVME_TCP_PDU_RECV_STATE_AWAIT_REQ) {
+		TAILQ_INSERT_TAIL(&tgroup->await_req, tqpair, link);
+	} else {
+		TAILQ_INSERT_TAIL(&tgroup->qpairs, tqpair, link);
+	}
+
+	rc = spdk_sock_group_add_sock(tgroup->sock_group, tqpair->sock,
+				      nvmf_tcp_sock_cb, tqpair);
+	if (rc != 0) {
+		SPDK_ERRLOG("Could not add sock to sock_group: %s (%d)\n",
+			    spdk_strerror(errno), errno);
+		return -errno;
+	}
+
+	SPDK_DEBUGLOG(nvmf_tcp, "attached tqpair=%p to the tgroup=%p\n", tqpair, tgroup);
+
+	return 0;
+}
+
 static int
 nvmf_tcp_poll_group_remove(struct spdk_nvmf_transport_poll_group *group,
 			   struct spdk_nvmf_qpair *qpair)
@@ -3962,6 +4173,8 @@ const struct spdk_nvmf_transport_ops spdk_nvmf_transport_tcp = {
 	.poll_group_destroy = nvmf_tcp_poll_group_destroy,
 	.poll_group_add = nvmf_tcp_poll_group_add,
 	.poll_group_remove = nvmf_tcp_poll_group_remove,
+	.poll_group_detach = nvmf_tcp_poll_group_detach,
+	.poll_group_attach = nvmf_tcp_poll_group_attach,
 	.poll_group_poll = nvmf_tcp_poll_group_poll,
 
 	.req_free = nvmf_tcp_req_free,
@@ -3973,6 +4186,7 @@ const struct spdk_nvmf_transport_ops spdk_nvmf_transport_tcp = {
 	.qpair_get_peer_trid = nvmf_tcp_qpair_get_peer_trid,
 	.qpair_get_listen_trid = nvmf_tcp_qpair_get_listen_trid,
 	.qpair_abort_request = nvmf_tcp_qpair_abort_request,
+	.qpair_quiesce = nvmf_tcp_qpair_quiesce,
 	.subsystem_add_host = nvmf_tcp_subsystem_add_host,
 	.subsystem_remove_host = nvmf_tcp_subsystem_remove_host,
 	.subsystem_dump_host = nvmf_tcp_subsystem_dump_host,
@@ -87,6 +87,7 @@ nvmf_transport_dump_opts(struct spdk_nvmf_transport *transport, struct spdk_json
 	spdk_json_write_named_uint32(w, "buf_cache_size", opts->buf_cache_size);
 	spdk_json_write_named_bool(w, "dif_insert_or_strip", opts->dif_insert_or_strip);
 	spdk_json_write_named_bool(w, "zcopy", opts->zcopy);
+	spdk_json_write_named_bool(w, "zcopy_read", opts->zcopy_read);
 
 	if (transport->ops->dump_opts) {
 		transport->ops->dump_opts(transport, w);
@@ -151,6 +152,7 @@ nvmf_transport_opts_copy(struct spdk_nvmf_transport_opts *opts,
 	SET_FIELD(transport_specific);
 	SET_FIELD(acceptor_poll_rate);
 	SET_FIELD(zcopy);
+	SET_FIELD(zcopy_read);
 	SET_FIELD(ack_timeout);
 	SET_FIELD(data_wr_pool_size);
 
@@ -735,6 +737,36 @@ nvmf_transport_poll_group_poll(struct spdk_nvmf_transport_poll_group *group)
 	return group->transport->ops->poll_group_poll(group);
 }
 
+bool
+nvmf_transport_supports_migration(struct spdk_nvmf_transport *transport)
+{
+	return transport->ops->qpair_quiesce != NULL &&
+	       transport->ops->poll_group_detach != NULL &&
+	       transport->ops->poll_group_attach != NULL;
+}
+
+void
+nvmf_transport_qpair_quiesce(struct spdk_nvmf_qpair *qpair, bool quiesce)
+{
+	qpair->transport->ops->qpair_quiesce(qpair, quiesce);
+}
+
+int
+nvmf_transport_poll_group_detach(struct spdk_nvmf_transport_poll_group *group,
+				 struct spdk_nvmf_qpair *qpair)
+{
+	assert(qpair->transport == group->transport);
+	return group->transport->ops->poll_group_detach(group, qpair);
+}
+
+int
+nvmf_transport_poll_group_attach(struct spdk_nvmf_transport_poll_group *group,
+				 struct spdk_nvmf_qpair *qpair)
+{
+	assert(qpair->transport == group->transport);
+	return group->transport->ops->poll_group_attach(group, qpair);
+}
+
 int
 nvmf_transport_req_free(struct spdk_nvmf_request *req)
 {
@@ -31,6 +31,16 @@ int nvmf_transport_poll_group_remove(struct spdk_nvmf_transport_poll_group *grou
 
 int nvmf_transport_poll_group_poll(struct spdk_nvmf_transport_poll_group *group);
 
+bool nvmf_transport_supports_migration(struct spdk_nvmf_transport *transport);
+
+void nvmf_transport_qpair_quiesce(struct spdk_nvmf_qpair *qpair, bool quiesce);
+
+int nvmf_transport_poll_group_detach(struct spdk_nvmf_transport_poll_group *group,
+				     struct spdk_nvmf_qpair *qpair);
+
+int nvmf_transport_poll_group_attach(struct spdk_nvmf_transport_poll_group *group,
+				     struct spdk_nvmf_qpair *qpair);
+
 int nvmf_transport_req_free(struct spdk_nvmf_request *req);
 
 int nvmf_transport_req_complete(struct spdk_nvmf_request *req);
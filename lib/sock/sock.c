@@ -936,6 +936,10 @@ spdk_sock_write_config_json(struct spdk_json_write_ctx *w)
 			spdk_json_write_named_uint32(w, "zerocopy_threshold", opts.zerocopy_threshold);
 			spdk_json_write_named_uint32(w, "tls_version", opts.tls_version);
 			spdk_json_write_named_bool(w, "enable_ktls", opts.enable_ktls);
+			spdk_json_write_named_uint32(w, "flush_batch_size", opts.flush_batch_size);
+			spdk_json_write_named_uint32(w, "flush_batch_timeout_us", opts.flush_batch_timeout_us);
+			spdk_json_write_named_uint32(w, "busy_poll_usecs", opts.busy_poll_usecs);
+			spdk_json_write_named_uint32(w, "busy_poll_budget", opts.busy_poll_budget);
 			spdk_json_write_object_end(w);
 			spdk_json_write_object_end(w);
 		} else {
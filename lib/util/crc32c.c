@@ -28,8 +28,12 @@ spdk_crc32c_update(const void *buf, size_t len, uint32_t crc)
 	 * passed to _mm_crc32_u64 is 8 byte aligned. This can avoid unaligned loads.
 	 */
 	count_pre = ((uint64_t)buf & 7) == 0 ? 0 : 8 - ((uint64_t)buf & 7);
-	count_post = (uint64_t)((uintptr_t)buf + len) & 7;
-	count_mid = (len - count_pre - count_post) / 8;
+	/* A buffer shorter than its unaligned head is processed byte by byte */
+	if (count_pre > len) {
+		count_pre = len;
+	}
+	count_post = (len - count_pre) & 7;
+	count_mid = (len - count_pre) / 8;
 
 	while (count_pre--) {
 		crc = _mm_crc32_u8(crc, *(const uint8_t *)buf);
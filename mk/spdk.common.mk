@@ -350,6 +350,10 @@ ifeq ($(CONFIG_HAVE_LZ4),y)
 SYS_LIBS += -llz4
 endif
 
+ifeq ($(CONFIG_HAVE_ZSTD),y)
+SYS_LIBS += -lzstd
+endif
+
 ifeq ($(CONFIG_DPDK_UADK),y)
 SYS_LIBS += -lwd -lwd_crypto -lwd_comp
 endif
@@ -901,6 +901,7 @@ static struct spdk_accel_module_if g_compress_module = {
 	.supports_opcode             = compress_supports_opcode,
 	.get_io_channel	             = compress_get_io_channel,
 	.submit_tasks                = compress_submit_tasks,
+	.supports_task_list          = true,
 	.compress_supports_algo      = compress_supports_algo,
 	.get_compress_level_range    = compress_get_level_range,
 };
@@ -383,31 +383,51 @@ _process_single_task(struct spdk_io_channel *ch, struct spdk_accel_task *task)
 }
 
 static int
-dsa_submit_task(struct spdk_io_channel *ch, struct spdk_accel_task *task)
+dsa_submit_tasks(struct spdk_io_channel *ch, struct spdk_accel_task *first_task)
 {
 	struct idxd_io_channel *chan = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *task, *tmp;
 	int rc = 0;
 
-	assert(STAILQ_NEXT(task, link) == NULL);
+	task = first_task;
 
 	if (spdk_unlikely(chan->state == IDXD_CHANNEL_ERROR)) {
-		spdk_accel_task_complete(task, -EINVAL);
+		while (task) {
+			tmp = STAILQ_NEXT(task, link);
+			spdk_accel_task_complete(task, -EINVAL);
+			task = tmp;
+		}
 		return 0;
 	}
 
 	if (!STAILQ_EMPTY(&chan->queued_tasks)) {
-		STAILQ_INSERT_TAIL(&chan->queued_tasks, task, link);
-		return 0;
+		goto queue_tasks;
 	}
 
-	rc = _process_single_task(ch, task);
-	if (rc == -EBUSY) {
-		STAILQ_INSERT_TAIL(&chan->queued_tasks, task, link);
-	} else if (rc) {
-		spdk_accel_task_complete(task, rc);
+	/* Tasks submitted as a list are handed to the idxd library back to back, which
+	 * accumulates them into a single batch descriptor.
+	 */
+	while (task) {
+		tmp = STAILQ_NEXT(task, link);
+		rc = _process_single_task(ch, task);
+
+		if (rc == -EBUSY) {
+			goto queue_tasks;
+		} else if (rc) {
+			spdk_accel_task_complete(task, rc);
+		}
+		task = tmp;
 	}
 
 	return 0;
+
+queue_tasks:
+	while (task != NULL) {
+		tmp = STAILQ_NEXT(task, link);
+		STAILQ_INSERT_TAIL(&chan->queued_tasks, task, link);
+		task = tmp;
+	}
+	return 0;
 }
 
 static int
@@ -505,7 +525,8 @@ static struct spdk_accel_module_if g_dsa_module = {
 	.name			= "dsa",
 	.supports_opcode	= dsa_supports_opcode,
 	.get_io_channel		= dsa_get_io_channel,
-	.submit_tasks		= dsa_submit_task
+	.submit_tasks		= dsa_submit_tasks,
+	.supports_task_list	= true,
 };
 
 static int
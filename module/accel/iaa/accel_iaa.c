@@ -296,6 +296,7 @@ static struct spdk_accel_module_if g_iaa_module = {
 	.supports_opcode             = iaa_supports_opcode,
 	.get_io_channel	             = iaa_get_io_channel,
 	.submit_tasks                = iaa_submit_tasks,
+	.supports_task_list          = true,
 	.compress_supports_algo      = iaa_compress_supports_algo,
 	.get_compress_level_range    = iaa_get_compress_level_range,
 };
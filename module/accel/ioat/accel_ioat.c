@@ -91,7 +91,8 @@ static struct spdk_accel_module_if g_ioat_module = {
 	.name			= "ioat",
 	.supports_opcode	= ioat_supports_opcode,
 	.get_io_channel		= ioat_get_io_channel,
-	.submit_tasks		= ioat_submit_tasks
+	.submit_tasks		= ioat_submit_tasks,
+	.supports_task_list	= true,
 };
 
 static void
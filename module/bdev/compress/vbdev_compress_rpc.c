@@ -96,6 +96,8 @@ rpc_decode_comp_algo(const struct spdk_json_val *val, void *out)
 		*algo = SPDK_ACCEL_COMP_ALGO_DEFLATE;
 	} else if (strcmp(name, "lz4") == 0) {
 		*algo = SPDK_ACCEL_COMP_ALGO_LZ4;
+	} else if (strcmp(name, "zstd") == 0) {
+		*algo = SPDK_ACCEL_COMP_ALGO_ZSTD;
 	} else {
 		rc = -EINVAL;
 	}
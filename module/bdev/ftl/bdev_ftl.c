@@ -234,6 +234,9 @@ bdev_ftl_write_config_json(struct spdk_bdev *bdev, struct spdk_json_write_ctx *w
 
 	spdk_json_write_named_bool(w, "fast_shutdown", conf.fast_shutdown);
 
+	spdk_json_write_named_string(w, "gc_policy",
+				     conf.gc_policy == SPDK_FTL_GC_POLICY_COST_BENEFIT ? "cost_benefit" : "greedy");
+
 	spdk_json_write_named_string(w, "base_bdev", conf.base_bdev);
 
 	if (conf.cache_bdev) {
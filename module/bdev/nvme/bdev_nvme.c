@@ -794,6 +794,8 @@ _bdev_nvme_add_io_path(struct nvme_bdev_channel *nbdev_ch, struct nvme_ns *nvme_
 	}
 
 	io_path->nvme_ns = nvme_ns;
+	io_path->weight = nvme_ns->weight;
+	io_path->numa_id = spdk_nvme_ctrlr_get_numa_id(nvme_ns->ctrlr->ctrlr);
 
 	ch = spdk_get_io_channel(nvme_ns->ctrlr);
 	if (ch == NULL) {
@@ -896,6 +898,7 @@ bdev_nvme_create_bdev_channel_cb(void *io_device, void *ctx_buf)
 	nbdev_ch->mp_policy = nbdev->mp_policy;
 	nbdev_ch->mp_selector = nbdev->mp_selector;
 	nbdev_ch->rr_min_io = nbdev->rr_min_io;
+	nbdev_ch->numa_id = spdk_env_get_numa_id(spdk_env_get_current_core());
 
 	TAILQ_FOREACH(nvme_ns, &nbdev->nvme_ns_list, tailq) {
 		rc = _bdev_nvme_add_io_path(nbdev_ch, nvme_ns);
@@ -1172,6 +1175,124 @@ _bdev_nvme_find_io_path_min_qd(struct nvme_bdev_channel *nbdev_ch)
 	return non_optimized;
 }
 
+static inline bool
+nvme_io_path_is_numa_local(struct nvme_bdev_channel *nbdev_ch, struct nvme_io_path *io_path)
+{
+	/* Treat a path as local if either side does not know its NUMA node. */
+	return io_path->numa_id == SPDK_ENV_NUMA_ID_ANY ||
+	       nbdev_ch->numa_id == SPDK_ENV_NUMA_ID_ANY ||
+	       io_path->numa_id == nbdev_ch->numa_id;
+}
+
+/* Return the cost of submitting the next I/O to the io_path for the service_time
+ * and numa selectors. The lowest cost path wins.
+ */
+static inline uint64_t
+nvme_io_path_get_cost(struct nvme_bdev_channel *nbdev_ch, struct nvme_io_path *io_path)
+{
+	uint64_t num_outstanding_reqs;
+
+	num_outstanding_reqs = spdk_nvme_qpair_get_num_outstanding_reqs(io_path->qpair->qpair);
+
+	switch (nbdev_ch->mp_selector) {
+	case BDEV_NVME_MP_SELECTOR_SERVICE_TIME:
+		/* Paths with no latency sample yet cost nothing so that they get probed. */
+		return (num_outstanding_reqs + 1) * io_path->ewma_latency_ticks;
+	case BDEV_NVME_MP_SELECTOR_NUMA:
+		/* Any local path is preferred over any remote path. Among paths of the
+		 * same locality, the one with the minimum queue depth is chosen.
+		 */
+		if (!nvme_io_path_is_numa_local(nbdev_ch, io_path)) {
+			num_outstanding_reqs += UINT32_MAX;
+		}
+		return num_outstanding_reqs;
+	default:
+		assert(false);
+		return 0;
+	}
+}
+
+static struct nvme_io_path *
+_bdev_nvme_find_io_path_min_cost(struct nvme_bdev_channel *nbdev_ch)
+{
+	struct nvme_io_path *io_path;
+	struct nvme_io_path *optimized = NULL, *non_optimized = NULL;
+	uint64_t opt_min_cost = UINT64_MAX, non_opt_min_cost = UINT64_MAX;
+	uint64_t cost;
+
+	STAILQ_FOREACH(io_path, &nbdev_ch->io_path_list, stailq) {
+		if (spdk_unlikely(!nvme_io_path_is_available(io_path))) {
+			continue;
+		}
+
+		cost = nvme_io_path_get_cost(nbdev_ch, io_path);
+		switch (io_path->nvme_ns->ana_state) {
+		case SPDK_NVME_ANA_OPTIMIZED_STATE:
+			if (cost < opt_min_cost || optimized == NULL) {
+				opt_min_cost = cost;
+				optimized = io_path;
+			}
+			break;
+		case SPDK_NVME_ANA_NON_OPTIMIZED_STATE:
+			if (cost < non_opt_min_cost || non_optimized == NULL) {
+				non_opt_min_cost = cost;
+				non_optimized = io_path;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	/* The cost changes with every I/O. Hence don't cache io path for these selectors. */
+	if (optimized != NULL) {
+		return optimized;
+	}
+
+	return non_optimized;
+}
+
+/* Smooth weighted round-robin. Each selection adds every candidate's weight to its
+ * current weight, picks the candidate with the largest current weight, and then
+ * charges the picked one the total weight. This interleaves paths instead of
+ * sending bursts of weight I/Os to each path in turn.
+ */
+static struct nvme_io_path *
+_bdev_nvme_find_io_path_weighted(struct nvme_bdev_channel *nbdev_ch)
+{
+	struct nvme_io_path *io_path, *selected = NULL;
+	enum spdk_nvme_ana_state ana_state = SPDK_NVME_ANA_NON_OPTIMIZED_STATE;
+	int64_t total_weight = 0;
+
+	STAILQ_FOREACH(io_path, &nbdev_ch->io_path_list, stailq) {
+		if (nvme_io_path_is_available(io_path) &&
+		    io_path->nvme_ns->ana_state == SPDK_NVME_ANA_OPTIMIZED_STATE) {
+			ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+			break;
+		}
+	}
+
+	STAILQ_FOREACH(io_path, &nbdev_ch->io_path_list, stailq) {
+		if (spdk_unlikely(!nvme_io_path_is_available(io_path)) ||
+		    io_path->nvme_ns->ana_state != ana_state) {
+			continue;
+		}
+
+		io_path->current_weight += io_path->weight;
+		total_weight += io_path->weight;
+
+		if (selected == NULL || io_path->current_weight > selected->current_weight) {
+			selected = io_path;
+		}
+	}
+
+	if (selected != NULL) {
+		selected->current_weight -= total_weight;
+	}
+
+	return selected;
+}
+
 static inline struct nvme_io_path *
 bdev_nvme_find_io_path(struct nvme_bdev_channel *nbdev_ch)
 {
@@ -1186,11 +1307,20 @@ bdev_nvme_find_io_path(struct nvme_bdev_channel *nbdev_ch)
 		}
 	}
 
-	if (nbdev_ch->mp_policy == BDEV_NVME_MP_POLICY_ACTIVE_PASSIVE ||
-	    nbdev_ch->mp_selector == BDEV_NVME_MP_SELECTOR_ROUND_ROBIN) {
+	if (nbdev_ch->mp_policy == BDEV_NVME_MP_POLICY_ACTIVE_PASSIVE) {
 		return _bdev_nvme_find_io_path(nbdev_ch);
-	} else {
+	}
+
+	switch (nbdev_ch->mp_selector) {
+	case BDEV_NVME_MP_SELECTOR_QUEUE_DEPTH:
 		return _bdev_nvme_find_io_path_min_qd(nbdev_ch);
+	case BDEV_NVME_MP_SELECTOR_SERVICE_TIME:
+	case BDEV_NVME_MP_SELECTOR_NUMA:
+		return _bdev_nvme_find_io_path_min_cost(nbdev_ch);
+	case BDEV_NVME_MP_SELECTOR_WEIGHTED:
+		return _bdev_nvme_find_io_path_weighted(nbdev_ch);
+	default:
+		return _bdev_nvme_find_io_path(nbdev_ch);
 	}
 }
 
@@ -1456,6 +1586,34 @@ bdev_nvme_update_io_path_stat(struct nvme_bdev_io *bio)
 	}
 }
 
+/* Weight of a new latency sample in the per-path EWMA is 1/2^SHIFT. */
+#define NVME_IO_PATH_EWMA_SHIFT	3
+
+static inline void
+bdev_nvme_update_io_path_latency(struct nvme_bdev_io *bio)
+{
+	struct nvme_io_path *io_path = bio->io_path;
+	uint64_t tsc_diff, ewma;
+
+	/* The io_path may have been removed from the channel while the I/O was outstanding. */
+	if (io_path->nbdev_ch == NULL ||
+	    io_path->nbdev_ch->mp_selector != BDEV_NVME_MP_SELECTOR_SERVICE_TIME) {
+		return;
+	}
+
+	tsc_diff = spdk_get_ticks() - bio->submit_tsc;
+
+	if (io_path->ewma_latency_ticks == 0) {
+		ewma = tsc_diff;
+	} else {
+		ewma = io_path->ewma_latency_ticks;
+		ewma = (ewma * ((1 << NVME_IO_PATH_EWMA_SHIFT) - 1) + tsc_diff) >> NVME_IO_PATH_EWMA_SHIFT;
+	}
+
+	/* Zero is reserved for paths which have no latency sample yet. */
+	io_path->ewma_latency_ticks = spdk_max(ewma, 1);
+}
+
 static bool
 bdev_nvme_check_retry_io(struct nvme_bdev_io *bio,
 			 const struct spdk_nvme_cpl *cpl,
@@ -1508,6 +1666,7 @@ bdev_nvme_io_complete_nvme_status(struct nvme_bdev_io *bio,
 
 	if (spdk_likely(spdk_nvme_cpl_is_success(cpl))) {
 		bdev_nvme_update_io_path_stat(bio);
+		bdev_nvme_update_io_path_latency(bio);
 		goto complete;
 	}
 
@@ -3943,6 +4102,12 @@ nvme_bdev_get_mp_selector_str(struct nvme_bdev *nbdev)
 		return "round_robin";
 	case BDEV_NVME_MP_SELECTOR_QUEUE_DEPTH:
 		return "queue_depth";
+	case BDEV_NVME_MP_SELECTOR_SERVICE_TIME:
+		return "service_time";
+	case BDEV_NVME_MP_SELECTOR_NUMA:
+		return "numa";
+	case BDEV_NVME_MP_SELECTOR_WEIGHTED:
+		return "weighted";
 	default:
 		assert(false);
 		return "invalid";
@@ -4251,6 +4416,34 @@ nvme_generate_uuid(const char *sn, uint32_t nsid, struct spdk_uuid *uuid)
 	return rc;
 }
 
+static uint32_t
+bdev_nvme_get_max_single_source_range(const struct spdk_nvme_ns_data *nsdata)
+{
+	if (nsdata->mssrl == 0) {
+		return SPDK_NVME_SIMPLE_COPY_RANGE_MAX_BLOCKS;
+	}
+
+	return nsdata->mssrl;
+}
+
+/* A single copy command may describe multiple source ranges. Hence the maximum
+ * copy size is bounded by MSSRL multiplied by MSRC, and by MCL if it is reported.
+ */
+static uint32_t
+bdev_nvme_get_max_copy(const struct spdk_nvme_ns_data *nsdata)
+{
+	uint64_t max_copy;
+	uint32_t max_ranges;
+
+	max_ranges = spdk_min((uint32_t)nsdata->msrc + 1, SPDK_NVME_SIMPLE_COPY_MAX_RANGES);
+	max_copy = (uint64_t)bdev_nvme_get_max_single_source_range(nsdata) * max_ranges;
+	if (nsdata->mcl != 0) {
+		max_copy = spdk_min(max_copy, nsdata->mcl);
+	}
+
+	return spdk_min(max_copy, UINT32_MAX);
+}
+
 static int
 nvme_disk_create(struct spdk_bdev *disk, const char *base_name,
 		 struct spdk_nvme_ctrlr *ctrlr, struct spdk_nvme_ns *ns,
@@ -4389,8 +4582,7 @@ nvme_disk_create(struct spdk_bdev *disk, const char *base_name,
 	}
 
 	if (cdata->oncs.copy) {
-		/* For now bdev interface allows only single segment copy */
-		disk->max_copy = nsdata->mssrl;
+		disk->max_copy = bdev_nvme_get_max_copy(nsdata);
 	}
 
 	disk->ctxt = ctx;
@@ -4615,6 +4807,8 @@ nvme_ns_alloc(void)
 		return NULL;
 	}
 
+	nvme_ns->weight = 1;
+
 	if (g_opts.io_path_stat) {
 		nvme_ns->stat = calloc(1, sizeof(struct spdk_bdev_io_stat));
 		if (nvme_ns->stat == NULL) {
@@ -5261,6 +5455,133 @@ err_alloc:
 	cb_fn(cb_arg, rc);
 }
 
+struct bdev_nvme_set_path_weight_ctx {
+	struct spdk_bdev_desc *desc;
+	struct nvme_ns *nvme_ns;
+	uint32_t weight;
+	bdev_nvme_set_path_weight_cb cb_fn;
+	void *cb_arg;
+};
+
+static void
+bdev_nvme_set_path_weight_done(struct nvme_bdev *nbdev, void *_ctx, int status)
+{
+	struct bdev_nvme_set_path_weight_ctx *ctx = _ctx;
+
+	assert(ctx != NULL);
+	assert(ctx->desc != NULL);
+	assert(ctx->cb_fn != NULL);
+
+	spdk_bdev_close(ctx->desc);
+
+	ctx->cb_fn(ctx->cb_arg, status);
+
+	free(ctx);
+}
+
+static void
+_bdev_nvme_set_path_weight(struct nvme_bdev_channel_iter *i,
+			   struct nvme_bdev *nbdev,
+			   struct nvme_bdev_channel *nbdev_ch, void *_ctx)
+{
+	struct bdev_nvme_set_path_weight_ctx *ctx = _ctx;
+	struct nvme_io_path *io_path;
+
+	STAILQ_FOREACH(io_path, &nbdev_ch->io_path_list, stailq) {
+		if (io_path->nvme_ns == ctx->nvme_ns) {
+			io_path->weight = ctx->weight;
+		}
+		/* Restart smooth weighted round-robin with the new set of weights. */
+		io_path->current_weight = 0;
+	}
+
+	nvme_bdev_for_each_channel_continue(i, 0);
+}
+
+void
+bdev_nvme_set_path_weight(const char *name, uint16_t cntlid, uint32_t weight,
+			  bdev_nvme_set_path_weight_cb cb_fn, void *cb_arg)
+{
+	struct bdev_nvme_set_path_weight_ctx *ctx;
+	const struct spdk_nvme_ctrlr_data *cdata;
+	struct spdk_bdev *bdev;
+	struct nvme_bdev *nbdev;
+	struct nvme_ns *nvme_ns;
+	int rc = 0;
+
+	assert(cb_fn != NULL);
+
+	if (weight == 0) {
+		SPDK_ERRLOG("Weight of I/O path must be greater than zero.\n");
+		rc = -EINVAL;
+		goto err_alloc;
+	}
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		SPDK_ERRLOG("Failed to alloc context.\n");
+		rc = -ENOMEM;
+		goto err_alloc;
+	}
+
+	ctx->weight = weight;
+	ctx->cb_fn = cb_fn;
+	ctx->cb_arg = cb_arg;
+
+	rc = spdk_bdev_open_ext(name, false, dummy_bdev_event_cb, NULL, &ctx->desc);
+	if (rc != 0) {
+		SPDK_ERRLOG("Failed to open bdev %s.\n", name);
+		goto err_open;
+	}
+
+	bdev = spdk_bdev_desc_get_bdev(ctx->desc);
+
+	if (bdev->module != &nvme_if) {
+		SPDK_ERRLOG("bdev %s is not registered in this module.\n", name);
+		rc = -ENODEV;
+		goto err_bdev;
+	}
+
+	nbdev = SPDK_CONTAINEROF(bdev, struct nvme_bdev, disk);
+
+	pthread_mutex_lock(&nbdev->mutex);
+
+	TAILQ_FOREACH(nvme_ns, &nbdev->nvme_ns_list, tailq) {
+		cdata = spdk_nvme_ctrlr_get_data(nvme_ns->ctrlr->ctrlr);
+
+		if (cdata->cntlid == cntlid) {
+			break;
+		}
+	}
+
+	if (nvme_ns == NULL) {
+		pthread_mutex_unlock(&nbdev->mutex);
+
+		SPDK_ERRLOG("bdev %s does not have namespace to controller %u.\n", name, cntlid);
+		rc = -ENODEV;
+		goto err_bdev;
+	}
+
+	/* NVMe bdev channels created after this point pick up the weight from nvme_ns. */
+	nvme_ns->weight = weight;
+	ctx->nvme_ns = nvme_ns;
+
+	pthread_mutex_unlock(&nbdev->mutex);
+
+	nvme_bdev_for_each_channel(nbdev,
+				   _bdev_nvme_set_path_weight,
+				   ctx,
+				   bdev_nvme_set_path_weight_done);
+	return;
+
+err_bdev:
+	spdk_bdev_close(ctx->desc);
+err_open:
+	free(ctx);
+err_alloc:
+	cb_fn(cb_arg, rc);
+}
+
 struct bdev_nvme_set_multipath_policy_ctx {
 	struct spdk_bdev_desc *desc;
 	spdk_bdev_nvme_set_multipath_policy_cb cb_fn;
@@ -5288,11 +5609,19 @@ _bdev_nvme_set_multipath_policy(struct nvme_bdev_channel_iter *i,
 				struct nvme_bdev *nbdev,
 				struct nvme_bdev_channel *nbdev_ch, void *ctx)
 {
+	struct nvme_io_path *io_path;
+
 	nbdev_ch->mp_policy = nbdev->mp_policy;
 	nbdev_ch->mp_selector = nbdev->mp_selector;
 	nbdev_ch->rr_min_io = nbdev->rr_min_io;
 	bdev_nvme_clear_current_io_path(nbdev_ch);
 
+	/* Restart selector state from scratch. */
+	STAILQ_FOREACH(io_path, &nbdev_ch->io_path_list, stailq) {
+		io_path->ewma_latency_ticks = 0;
+		io_path->current_weight = 0;
+	}
+
 	nvme_bdev_for_each_channel_continue(i, 0);
 }
 
@@ -5322,6 +5651,9 @@ spdk_bdev_nvme_set_multipath_policy(const char *name, enum spdk_bdev_nvme_multip
 			}
 			break;
 		case BDEV_NVME_MP_SELECTOR_QUEUE_DEPTH:
+		case BDEV_NVME_MP_SELECTOR_SERVICE_TIME:
+		case BDEV_NVME_MP_SELECTOR_NUMA:
+		case BDEV_NVME_MP_SELECTOR_WEIGHTED:
 			break;
 		default:
 			rc = -EINVAL;
@@ -8464,15 +8796,60 @@ static int
 bdev_nvme_copy(struct nvme_bdev_io *bio, uint64_t dst_offset_blocks, uint64_t src_offset_blocks,
 	       uint64_t num_blocks)
 {
-	struct spdk_nvme_scc_source_range range = {
-		.slba = src_offset_blocks,
-		.nlb = num_blocks - 1
-	};
+	struct spdk_nvme_scc_source_range single_range, *ranges, *range;
+	struct spdk_nvme_ns *ns = bio->io_path->nvme_ns->ns;
+	const struct spdk_nvme_ns_data *nsdata = spdk_nvme_ns_get_data(ns);
+	uint64_t offset, remaining, range_max_blocks;
+	uint64_t num_ranges_u64;
+	uint16_t num_ranges;
+	int rc;
 
-	return spdk_nvme_ns_cmd_copy(bio->io_path->nvme_ns->ns,
-				     bio->io_path->qpair->qpair,
-				     &range, 1, dst_offset_blocks,
-				     bdev_nvme_queued_done, bio);
+	range_max_blocks = bdev_nvme_get_max_single_source_range(nsdata);
+
+	/* The bdev layer splits copies by the max_copy size, which is bounded by MSRC */
+	num_ranges_u64 = spdk_divide_round_up(num_blocks, range_max_blocks);
+	if (num_ranges_u64 > (uint64_t)nsdata->msrc + 1) {
+		SPDK_ERRLOG("Copy request for %" PRIu64 " blocks is too large\n", num_blocks);
+		return -EINVAL;
+	}
+	num_ranges = (uint16_t)num_ranges_u64;
+
+	/* The ranges are copied into the request when the command is built, so they only have to
+	 * outlive the submission.  Most copies fit into a single range, don't allocate for them.
+	 */
+	if (num_ranges == 1) {
+		ranges = &single_range;
+	} else {
+		ranges = calloc(num_ranges, sizeof(*ranges));
+		if (ranges == NULL) {
+			return -ENOMEM;
+		}
+	}
+
+	offset = src_offset_blocks;
+	remaining = num_blocks;
+	range = &ranges[0];
+
+	/* Split the source into as few ranges as possible and copy them by a single command */
+	while (remaining > 0) {
+		memset(range, 0, sizeof(*range));
+		range->slba = offset;
+		range->nlb = spdk_min(remaining, range_max_blocks) - 1;
+
+		offset += range->nlb + 1;
+		remaining -= range->nlb + 1;
+		range++;
+	}
+
+	rc = spdk_nvme_ns_cmd_copy(ns, bio->io_path->qpair->qpair,
+				   ranges, num_ranges, dst_offset_blocks,
+				   bdev_nvme_queued_done, bio);
+
+	if (ranges != &single_range) {
+		free(ranges);
+	}
+
+	return rc;
 }
 
 static void
@@ -9022,6 +9399,7 @@ nvme_io_path_info_json(struct spdk_json_write_ctx *w, struct nvme_io_path *io_pa
 	spdk_json_write_named_bool(w, "current", nvme_io_path_is_current(io_path));
 	spdk_json_write_named_bool(w, "connected", nvme_qpair_is_connected(io_path->qpair));
 	spdk_json_write_named_bool(w, "accessible", nvme_ns_is_accessible(nvme_ns));
+	spdk_json_write_named_uint32(w, "weight", io_path->weight);
 
 	spdk_json_write_named_object_begin(w, "transport");
 	spdk_json_write_named_string(w, "trtype", trid->trstring);
@@ -56,6 +56,8 @@ struct nvme_ns {
 	bool				ana_transition_timedout;
 	struct spdk_poller		*anatt_timer;
 	struct nvme_async_probe_ctx	*probe_ctx;
+	/* Relative weight of this path for the weighted multipath selector. */
+	uint32_t			weight;
 	TAILQ_ENTRY(nvme_ns)		tailq;
 	RB_ENTRY(nvme_ns)		node;
 
@@ -201,6 +203,12 @@ struct nvme_io_path {
 
 	/* allocation of stat is decided by option io_path_stat of RPC bdev_nvme_set_options */
 	struct spdk_bdev_io_stat	*stat;
+
+	/* The following are used by the service_time, numa and weighted selectors. */
+	uint64_t			ewma_latency_ticks;
+	int64_t				current_weight;
+	uint32_t			weight;
+	int32_t				numa_id;
 };
 
 struct nvme_bdev_channel {
@@ -209,6 +217,7 @@ struct nvme_bdev_channel {
 	enum spdk_bdev_nvme_multipath_selector	mp_selector;
 	uint32_t				rr_min_io;
 	uint32_t				rr_counter;
+	int32_t					numa_id;
 	STAILQ_HEAD(, nvme_io_path)		io_path_list;
 	TAILQ_HEAD(retry_io_head, nvme_bdev_io)	retry_io_list;
 	struct spdk_poller			*retry_io_poller;
@@ -415,4 +424,19 @@ typedef void (*bdev_nvme_set_preferred_path_cb)(void *cb_arg, int rc);
 void bdev_nvme_set_preferred_path(const char *name, uint16_t cntlid,
 				  bdev_nvme_set_preferred_path_cb cb_fn, void *cb_arg);
 
+typedef void (*bdev_nvme_set_path_weight_cb)(void *cb_arg, int rc);
+
+/**
+ * Set the weight of an I/O path for an NVMe bdev in multipath mode. The weight is
+ * used by the weighted multipath selector to distribute I/Os across paths.
+ *
+ * \param name NVMe bdev name
+ * \param cntlid NVMe-oF controller ID
+ * \param weight Relative weight of the I/O path. Must be greater than zero.
+ * \param cb_fn Function to be called back after completion.
+ * \param cb_arg Argument for callback function.
+ */
+void bdev_nvme_set_path_weight(const char *name, uint16_t cntlid, uint32_t weight,
+			       bdev_nvme_set_path_weight_cb cb_fn, void *cb_arg);
+
 #endif /* SPDK_BDEV_NVME_H */
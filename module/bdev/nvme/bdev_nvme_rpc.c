@@ -2286,6 +2286,78 @@ cleanup:
 SPDK_RPC_REGISTER("bdev_nvme_set_preferred_path", rpc_bdev_nvme_set_preferred_path,
 		  SPDK_RPC_RUNTIME)
 
+struct rpc_bdev_nvme_set_path_weight {
+	char *name;
+	uint16_t cntlid;
+	uint32_t weight;
+};
+
+static void
+free_rpc_bdev_nvme_set_path_weight(struct rpc_bdev_nvme_set_path_weight *req)
+{
+	free(req->name);
+}
+
+static const struct spdk_json_object_decoder rpc_bdev_nvme_set_path_weight_decoders[] = {
+	{"name", offsetof(struct rpc_bdev_nvme_set_path_weight, name), spdk_json_decode_string},
+	{"cntlid", offsetof(struct rpc_bdev_nvme_set_path_weight, cntlid), spdk_json_decode_uint16},
+	{"weight", offsetof(struct rpc_bdev_nvme_set_path_weight, weight), spdk_json_decode_uint32},
+};
+
+struct rpc_bdev_nvme_set_path_weight_ctx {
+	struct rpc_bdev_nvme_set_path_weight req;
+	struct spdk_jsonrpc_request *request;
+};
+
+static void
+rpc_bdev_nvme_set_path_weight_done(void *cb_arg, int rc)
+{
+	struct rpc_bdev_nvme_set_path_weight_ctx *ctx = cb_arg;
+
+	if (rc == 0) {
+		spdk_jsonrpc_send_bool_response(ctx->request, true);
+	} else {
+		spdk_jsonrpc_send_error_response(ctx->request, rc, spdk_strerror(-rc));
+	}
+
+	free_rpc_bdev_nvme_set_path_weight(&ctx->req);
+	free(ctx);
+}
+
+static void
+rpc_bdev_nvme_set_path_weight(struct spdk_jsonrpc_request *request,
+			      const struct spdk_json_val *params)
+{
+	struct rpc_bdev_nvme_set_path_weight_ctx *ctx;
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		spdk_jsonrpc_send_error_response(request, -ENOMEM, spdk_strerror(ENOMEM));
+		return;
+	}
+
+	if (spdk_json_decode_object(params, rpc_bdev_nvme_set_path_weight_decoders,
+				    SPDK_COUNTOF(rpc_bdev_nvme_set_path_weight_decoders),
+				    &ctx->req)) {
+		SPDK_ERRLOG("spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "spdk_json_decode_object failed");
+		goto cleanup;
+	}
+
+	ctx->request = request;
+
+	bdev_nvme_set_path_weight(ctx->req.name, ctx->req.cntlid, ctx->req.weight,
+				  rpc_bdev_nvme_set_path_weight_done, ctx);
+	return;
+
+cleanup:
+	free_rpc_bdev_nvme_set_path_weight(&ctx->req);
+	free(ctx);
+}
+SPDK_RPC_REGISTER("bdev_nvme_set_path_weight", rpc_bdev_nvme_set_path_weight,
+		  SPDK_RPC_RUNTIME)
+
 struct rpc_set_multipath_policy {
 	char *name;
 	enum spdk_bdev_nvme_multipath_policy policy;
@@ -2325,6 +2397,12 @@ rpc_decode_mp_selector(const struct spdk_json_val *val, void *out)
 		*selector = BDEV_NVME_MP_SELECTOR_ROUND_ROBIN;
 	} else if (spdk_json_strequal(val, "queue_depth") == true) {
 		*selector = BDEV_NVME_MP_SELECTOR_QUEUE_DEPTH;
+	} else if (spdk_json_strequal(val, "service_time") == true) {
+		*selector = BDEV_NVME_MP_SELECTOR_SERVICE_TIME;
+	} else if (spdk_json_strequal(val, "numa") == true) {
+		*selector = BDEV_NVME_MP_SELECTOR_NUMA;
+	} else if (spdk_json_strequal(val, "weighted") == true) {
+		*selector = BDEV_NVME_MP_SELECTOR_WEIGHTED;
 	} else {
 		SPDK_NOTICELOG("Invalid parameter value: selector\n");
 		return -EINVAL;
@@ -47,13 +47,14 @@ struct nvmf_tgt_poll_group {
 
 struct spdk_nvmf_tgt_conf g_spdk_nvmf_tgt_conf = {
 	.opts = {
-		.size = SPDK_SIZEOF(&g_spdk_nvmf_tgt_conf.opts, dhchap_dhgroups),
+		.size = SPDK_SIZEOF(&g_spdk_nvmf_tgt_conf.opts, rebalance_period_us),
 		.name = "nvmf_tgt",
 		.max_subsystems = 0,
 		.crdt = { 0, 0, 0 },
 		.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_ANY,
 		.dhchap_digests = NVMF_TGT_DEFAULT_DIGESTS,
 		.dhchap_dhgroups = NVMF_TGT_DEFAULT_DHGROUPS,
+		.rebalance_period_us = 0,
 	},
 	.admin_passthru.identify_ctrlr = false
 };
@@ -593,6 +594,8 @@ nvmf_subsystem_write_config_json(struct spdk_json_write_ctx *w)
 		}
 	}
 	spdk_json_write_array_end(w);
+	spdk_json_write_named_uint32(w, "rebalance_period_us",
+				     g_spdk_nvmf_tgt_conf.opts.rebalance_period_us);
 	spdk_json_write_object_end(w);
 	spdk_json_write_object_end(w);
 
@@ -51,6 +51,8 @@ struct spdk_posix_sock {
 	bool			pipe_has_data;
 	bool			socket_has_data;
 	bool			zcopy;
+	bool			ktls_send;
+	bool			ktls_checked;
 
 	int			placement_id;
 
@@ -59,10 +61,14 @@ struct spdk_posix_sock {
 
 	TAILQ_ENTRY(spdk_posix_sock)	link;
 
+	bool				pending_flush;
+	TAILQ_ENTRY(spdk_posix_sock)	flush_link;
+
 	char			interface_name[IFNAMSIZ];
 };
 
 TAILQ_HEAD(spdk_has_data_list, spdk_posix_sock);
+TAILQ_HEAD(spdk_flush_list, spdk_posix_sock);
 
 struct spdk_posix_sock_group_impl {
 	struct spdk_sock_group_impl	base;
@@ -71,6 +77,12 @@ struct spdk_posix_sock_group_impl {
 	struct spdk_has_data_list	socks_with_data;
 	int				placement_id;
 	struct spdk_pipe_group		*pipe_group;
+
+	/* Sockets with queued writes */
+	struct spdk_flush_list		socks_to_flush;
+	uint64_t			flush_tsc;
+	uint32_t			flush_batch_size;
+	uint64_t			flush_batch_timeout_ticks;
 };
 
 static struct spdk_sock_impl_opts g_posix_impl_opts = {
@@ -89,7 +101,11 @@ static struct spdk_sock_impl_opts g_posix_impl_opts = {
 	.psk_identity = NULL,
 	.get_key = NULL,
 	.get_key_ctx = NULL,
-	.tls_cipher_suites = NULL
+	.tls_cipher_suites = NULL,
+	.flush_batch_size = 0,
+	.flush_batch_timeout_us = DEFAULT_FLUSH_BATCH_TIMEOUT_US,
+	.busy_poll_usecs = 0,
+	.busy_poll_budget = 0
 };
 
 static struct spdk_sock_impl_opts g_ssl_impl_opts = {
@@ -104,7 +120,11 @@ static struct spdk_sock_impl_opts g_ssl_impl_opts = {
 	.tls_version = 0,
 	.enable_ktls = false,
 	.psk_key = NULL,
-	.psk_identity = NULL
+	.psk_identity = NULL,
+	.flush_batch_size = 0,
+	.flush_batch_timeout_us = DEFAULT_FLUSH_BATCH_TIMEOUT_US,
+	.busy_poll_usecs = 0,
+	.busy_poll_budget = 0
 };
 
 static struct spdk_sock_map g_map = {
@@ -150,6 +170,10 @@ posix_sock_copy_impl_opts(struct spdk_sock_impl_opts *dest, const struct spdk_so
 	SET_FIELD(get_key);
 	SET_FIELD(get_key_ctx);
 	SET_FIELD(tls_cipher_suites);
+	SET_FIELD(flush_batch_size);
+	SET_FIELD(flush_batch_timeout_us);
+	SET_FIELD(busy_poll_usecs);
+	SET_FIELD(busy_poll_budget);
 
 #undef SET_FIELD
 #undef FIELD_OK
@@ -417,6 +441,39 @@ posix_sock_set_sendbuf(struct spdk_sock *_sock, int sz)
 	return 0;
 }
 
+#if defined(__linux__)
+static void
+posix_sock_enable_busy_poll(struct spdk_posix_sock *sock)
+{
+	struct spdk_sock_impl_opts *impl_opts = &sock->base.impl_opts;
+	int val, rc;
+
+	val = impl_opts->busy_poll_usecs;
+	rc = setsockopt(sock->fd, SOL_SOCKET, SO_BUSY_POLL, &val, sizeof(val));
+	if (rc != 0) {
+		SPDK_ERRLOG("Failed to set SO_BUSY_POLL: %s\n", spdk_strerror(errno));
+		return;
+	}
+
+#if defined(SO_PREFER_BUSY_POLL)
+	val = 1;
+	rc = setsockopt(sock->fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &val, sizeof(val));
+	if (rc != 0) {
+		SPDK_ERRLOG("Failed to set SO_PREFER_BUSY_POLL: %s\n", spdk_strerror(errno));
+	}
+#endif
+#if defined(SO_BUSY_POLL_BUDGET)
+	if (impl_opts->busy_poll_budget > 0) {
+		val = impl_opts->busy_poll_budget;
+		rc = setsockopt(sock->fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &val, sizeof(val));
+		if (rc != 0) {
+			SPDK_ERRLOG("Failed to set SO_BUSY_POLL_BUDGET: %s\n", spdk_strerror(errno));
+		}
+	}
+#endif
+}
+#endif
+
 static void
 posix_sock_init(struct spdk_posix_sock *sock, bool enable_zero_copy)
 {
@@ -447,6 +504,10 @@ posix_sock_init(struct spdk_posix_sock *sock, bool enable_zero_copy)
 		}
 	}
 
+	if (sock->base.impl_opts.busy_poll_usecs > 0) {
+		posix_sock_enable_busy_poll(sock);
+	}
+
 	spdk_sock_get_placement_id(sock->fd, sock->base.impl_opts.enable_placement_id,
 				   &sock->placement_id);
 
@@ -927,6 +988,34 @@ SSL_writev(SSL *ssl, struct iovec *iov, int iovcnt)
 	}
 }
 
+/* Once the handshake is done, OpenSSL installs the session keys into the kernel if kTLS
+ * is enabled.  The kernel then frames and encrypts the records itself, so writes can go
+ * straight to the socket instead of being copied and encrypted by SSL_write(). */
+static bool
+posix_sock_use_ktls_send(struct spdk_posix_sock *sock)
+{
+	if (spdk_likely(sock->ktls_checked)) {
+		return sock->ktls_send;
+	}
+
+	if (!sock->base.impl_opts.enable_ktls) {
+		sock->ktls_checked = true;
+		return false;
+	}
+
+	/* Let OpenSSL send out whatever it still has buffered first */
+	if (!SSL_is_init_finished(sock->ssl) || !SSL_want_nothing(sock->ssl)) {
+		return false;
+	}
+
+	sock->ktls_checked = true;
+	sock->ktls_send = BIO_get_ktls_send(SSL_get_wbio(sock->ssl));
+	SPDK_DEBUGLOG(sock_posix, "kTLS send %s for sock %p\n",
+		      sock->ktls_send ? "enabled" : "not available", sock);
+
+	return sock->ktls_send;
+}
+
 static struct spdk_sock *
 posix_sock_create(const char *ip, int port,
 		  enum posix_sock_create_type type,
@@ -1387,7 +1476,7 @@ _sock_flush(struct spdk_sock *sock)
 	msg.msg_iov = iovs;
 	msg.msg_iovlen = iovcnt;
 
-	if (psock->ssl) {
+	if (psock->ssl && !posix_sock_use_ktls_send(psock)) {
 		rc = SSL_writev(psock->ssl, iovs, iovcnt);
 	} else {
 		rc = sendmsg(psock->fd, &msg, flags);
@@ -1653,7 +1742,7 @@ posix_sock_writev(struct spdk_sock *_sock, struct iovec *iov, int iovcnt)
 		return -1;
 	}
 
-	if (sock->ssl) {
+	if (sock->ssl && !posix_sock_use_ktls_send(sock)) {
 		return SSL_writev(sock->ssl, iov, iovcnt);
 	} else {
 		return writev(sock->fd, iov, iovcnt);
@@ -1689,6 +1778,23 @@ posix_sock_recv_next(struct spdk_sock *_sock, void **buf, void **ctx)
 	return rc;
 }
 
+static void
+posix_sock_queue_flush(struct spdk_posix_sock *psock)
+{
+	struct spdk_posix_sock_group_impl *group = __posix_group_impl(psock->base.group_impl);
+
+	if (psock->pending_flush) {
+		return;
+	}
+
+	if (TAILQ_EMPTY(&group->socks_to_flush)) {
+		group->flush_tsc = spdk_get_ticks();
+	}
+
+	TAILQ_INSERT_TAIL(&group->socks_to_flush, psock, flush_link);
+	psock->pending_flush = true;
+}
+
 static void
 posix_sock_writev_async(struct spdk_sock *sock, struct spdk_sock_request *req)
 {
@@ -1696,6 +1802,10 @@ posix_sock_writev_async(struct spdk_sock *sock, struct spdk_sock_request *req)
 
 	spdk_sock_request_queue(sock, req);
 
+	if (sock->group_impl) {
+		posix_sock_queue_flush(__posix_sock(sock));
+	}
+
 	/* If there are a sufficient number queued, just flush them out immediately. */
 	if (sock->queued_iovcnt >= IOV_BATCH_SIZE) {
 		rc = _sock_flush(sock);
@@ -1802,7 +1912,7 @@ posix_sock_group_impl_get_optimal(struct spdk_sock *_sock, struct spdk_sock_grou
 }
 
 static struct spdk_sock_group_impl *
-_sock_group_impl_create(uint32_t enable_placement_id)
+_sock_group_impl_create(const struct spdk_sock_impl_opts *impl_opts)
 {
 	struct spdk_posix_sock_group_impl *group_impl;
 	int fd;
@@ -1833,9 +1943,13 @@ _sock_group_impl_create(uint32_t enable_placement_id)
 
 	group_impl->fd = fd;
 	TAILQ_INIT(&group_impl->socks_with_data);
+	TAILQ_INIT(&group_impl->socks_to_flush);
+	group_impl->flush_batch_size = impl_opts->flush_batch_size;
+	group_impl->flush_batch_timeout_ticks = impl_opts->flush_batch_timeout_us *
+						spdk_get_ticks_hz() / SPDK_SEC_TO_USEC;
 	group_impl->placement_id = -1;
 
-	if (enable_placement_id == PLACEMENT_CPU) {
+	if (impl_opts->enable_placement_id == PLACEMENT_CPU) {
 		spdk_sock_map_insert(&g_map, spdk_env_get_current_core(), &group_impl->base);
 		group_impl->placement_id = spdk_env_get_current_core();
 	}
@@ -1846,13 +1960,13 @@ _sock_group_impl_create(uint32_t enable_placement_id)
 static struct spdk_sock_group_impl *
 posix_sock_group_impl_create(void)
 {
-	return _sock_group_impl_create(g_posix_impl_opts.enable_placement_id);
+	return _sock_group_impl_create(&g_posix_impl_opts);
 }
 
 static struct spdk_sock_group_impl *
 ssl_sock_group_impl_create(void)
 {
-	return _sock_group_impl_create(g_ssl_impl_opts.enable_placement_id);
+	return _sock_group_impl_create(&g_ssl_impl_opts);
 }
 
 static void
@@ -1977,6 +2091,11 @@ posix_sock_group_impl_remove_sock(struct spdk_sock_group_impl *_group, struct sp
 		assert(rc == 0);
 	}
 
+	if (sock->pending_flush) {
+		TAILQ_REMOVE(&group->socks_to_flush, sock, flush_link);
+		sock->pending_flush = false;
+	}
+
 	if (sock->placement_id != -1) {
 		spdk_sock_map_release(&g_map, sock->placement_id);
 	}
@@ -2004,12 +2123,85 @@ posix_sock_group_impl_remove_sock(struct spdk_sock_group_impl *_group, struct sp
 	return rc;
 }
 
+static void
+posix_sock_group_flush(struct spdk_posix_sock_group_impl *group)
+{
+	struct spdk_posix_sock *psock, *ptmp;
+	uint32_t num_socks = 0;
+	int rc;
+
+	/* Drop the sockets that had all of their requests sent out by the previous flush */
+	TAILQ_FOREACH_SAFE(psock, &group->socks_to_flush, flush_link, ptmp) {
+		if (TAILQ_EMPTY(&psock->base.queued_reqs)) {
+			TAILQ_REMOVE(&group->socks_to_flush, psock, flush_link);
+			psock->pending_flush = false;
+		} else {
+			num_socks++;
+		}
+	}
+
+	if (num_socks == 0) {
+		return;
+	}
+
+	/* Hold the writes back until enough sockets have some or the oldest of them ran out of
+	 * its latency budget.  There's no poll to come back to in interrupt mode, so flush right
+	 * away there. */
+	if (num_socks < group->flush_batch_size && group->intr == NULL &&
+	    spdk_get_ticks() - group->flush_tsc < group->flush_batch_timeout_ticks) {
+		return;
+	}
+
+	/* This must be a TAILQ_FOREACH_SAFE because while flushing,
+	 * a completion callback could remove the sock from the
+	 * group. */
+	TAILQ_FOREACH_SAFE(psock, &group->socks_to_flush, flush_link, ptmp) {
+		rc = _sock_flush(&psock->base);
+		if (rc < 0 && errno != EAGAIN) {
+			spdk_sock_abort_requests(&psock->base);
+		}
+	}
+
+	group->flush_tsc = spdk_get_ticks();
+}
+
+#if defined(__linux__)
+/* Busy poll the NIC receive queues of the group's sockets, so that packets received since the
+ * last poll are processed on this core before epoll_wait() collects the events.  With
+ * SO_BUSY_POLL set, a non-blocking recv() on a socket with an empty receive queue makes the
+ * kernel run one pass of the NAPI instance the socket's traffic arrives on.  Sockets with the
+ * same placement_id share that instance, so only one of them needs to be polled.  Sockets
+ * without a placement_id are all treated as sharing the queue of the first one.
+ */
+static void
+posix_sock_group_busy_poll(struct spdk_posix_sock_group_impl *group)
+{
+	struct spdk_sock *sock;
+	struct spdk_posix_sock *psock;
+	int last_placement_id = -1;
+	bool polled = false;
+
+	TAILQ_FOREACH(sock, &group->base.socks, link) {
+		psock = __posix_sock(sock);
+		if (sock->impl_opts.busy_poll_usecs == 0 ||
+		    (polled && psock->placement_id == last_placement_id)) {
+			continue;
+		}
+
+		/* The zero length peek never consumes data; EAGAIN is the expected result. */
+		recv(psock->fd, NULL, 0, MSG_DONTWAIT | MSG_PEEK);
+		last_placement_id = psock->placement_id;
+		polled = true;
+	}
+}
+#endif
+
 static int
 posix_sock_group_impl_poll(struct spdk_sock_group_impl *_group, int max_events,
 			   struct spdk_sock **socks)
 {
 	struct spdk_posix_sock_group_impl *group = __posix_group_impl(_group);
-	struct spdk_sock *sock, *tmp;
+	struct spdk_sock *sock;
 	int num_events, i, rc;
 	struct spdk_posix_sock *psock, *ptmp;
 #if defined(SPDK_EPOLL)
@@ -2064,15 +2256,11 @@ posix_sock_group_impl_poll(struct spdk_sock_group_impl *_group, int max_events,
 	}
 #endif
 
-	/* This must be a TAILQ_FOREACH_SAFE because while flushing,
-	 * a completion callback could remove the sock from the
-	 * group. */
-	TAILQ_FOREACH_SAFE(sock, &_group->socks, link, tmp) {
-		rc = _sock_flush(sock);
-		if (rc < 0 && errno != EAGAIN) {
-			spdk_sock_abort_requests(sock);
-		}
-	}
+	posix_sock_group_flush(group);
+
+#if defined(__linux__)
+	posix_sock_group_busy_poll(group);
+#endif
 
 	assert(max_events > 0);
 
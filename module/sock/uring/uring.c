@@ -52,6 +52,10 @@ enum uring_task_type {
 /* We use 1 just so it's not zero and we can validate it's right. */
 #define URING_BUF_GROUP_ID 1
 
+/* Number of sockets per group that get a registered file descriptor. The rest of them
+ * fall back to regular file descriptors. */
+#define URING_MAX_FIXED_FILES 1024
+
 enum spdk_uring_sock_task_status {
 	SPDK_URING_SOCK_TASK_NOT_IN_USE = 0,
 	SPDK_URING_SOCK_TASK_IN_PROCESS,
@@ -89,9 +93,11 @@ struct spdk_uring_sock {
 	int					zcopy_send_flags;
 	int					connection_status;
 	int					placement_id;
-	uint8_t                                 reserved[4];
+	int					fixed_file;
 	uint8_t					buf[SPDK_SOCK_CMG_INFO_SIZE];
 	TAILQ_ENTRY(spdk_uring_sock)		link;
+	bool					pending_flush;
+	TAILQ_ENTRY(spdk_uring_sock)		flush_link;
 	char					interface_name[IFNAMSIZ];
 };
 /* 'struct cmsghdr' is mapped to the buffer 'buf', and while first element
@@ -102,6 +108,7 @@ SPDK_STATIC_ASSERT(offsetof(struct spdk_uring_sock, buf) % 8 == 0,
 		   "Incorrect alignment: `buf` must be aligned to 8 bytes");
 
 TAILQ_HEAD(pending_recv_list, spdk_uring_sock);
+TAILQ_HEAD(pending_flush_list, spdk_uring_sock);
 
 struct spdk_uring_buf_tracker {
 	void					*buf;
@@ -120,10 +127,20 @@ struct spdk_uring_sock_group_impl {
 	uint32_t				io_avail;
 	struct pending_recv_list		pending_recv;
 
+	/* Sockets with queued writes */
+	struct pending_flush_list		pending_flush;
+	uint64_t				flush_tsc;
+	uint32_t				flush_batch_size;
+	uint64_t				flush_batch_timeout_ticks;
+
 	struct io_uring_buf_ring		*buf_ring;
 	uint32_t				buf_ring_count;
 	struct spdk_uring_buf_tracker		*trackers;
 	STAILQ_HEAD(, spdk_uring_buf_tracker)	free_trackers;
+
+	bool					recv_multishot;
+	int					*free_fixed_files;
+	uint32_t				num_free_fixed_files;
 };
 
 static struct spdk_sock_impl_opts g_spdk_uring_sock_impl_opts = {
@@ -138,7 +155,9 @@ static struct spdk_sock_impl_opts g_spdk_uring_sock_impl_opts = {
 	.tls_version = 0,
 	.enable_ktls = false,
 	.psk_key = NULL,
-	.psk_identity = NULL
+	.psk_identity = NULL,
+	.flush_batch_size = 0,
+	.flush_batch_timeout_us = DEFAULT_FLUSH_BATCH_TIMEOUT_US
 };
 
 static struct spdk_sock_map g_map = {
@@ -181,6 +200,8 @@ uring_sock_copy_impl_opts(struct spdk_sock_impl_opts *dest, const struct spdk_so
 	SET_FIELD(enable_ktls);
 	SET_FIELD(psk_key);
 	SET_FIELD(psk_identity);
+	SET_FIELD(flush_batch_size);
+	SET_FIELD(flush_batch_timeout_us);
 
 #undef SET_FIELD
 #undef FIELD_OK
@@ -1138,6 +1159,15 @@ sock_complete_write_reqs(struct spdk_sock *_sock, ssize_t rc, bool is_zcopy)
 	return 0;
 }
 
+static inline void
+_sock_sqe_set_file(struct io_uring_sqe *sqe, struct spdk_uring_sock *sock)
+{
+	if (sock->fixed_file >= 0) {
+		sqe->fd = sock->fixed_file;
+		sqe->flags |= IOSQE_FIXED_FILE;
+	}
+}
+
 #ifdef SPDK_ZEROCOPY
 static int
 _sock_check_zcopy(struct spdk_sock *_sock, int status)
@@ -1225,6 +1255,7 @@ _sock_prep_errqueue(struct spdk_sock *_sock)
 
 	sqe = io_uring_get_sqe(&sock->group->uring);
 	io_uring_prep_recvmsg(sqe, sock->fd, &task->msg, MSG_ERRQUEUE);
+	_sock_sqe_set_file(sqe, sock);
 	io_uring_sqe_set_data(sqe, task);
 	task->status = SPDK_URING_SOCK_TASK_IN_PROCESS;
 }
@@ -1269,6 +1300,7 @@ _sock_flush(struct spdk_sock *_sock)
 
 	sqe = io_uring_get_sqe(&sock->group->uring);
 	io_uring_prep_sendmsg(sqe, sock->fd, &sock->write_task.msg, flags);
+	_sock_sqe_set_file(sqe, sock);
 	io_uring_sqe_set_data(sqe, task);
 	task->status = SPDK_URING_SOCK_TASK_IN_PROCESS;
 }
@@ -1293,9 +1325,19 @@ _sock_prep_read(struct spdk_sock *_sock)
 	sock->group->io_queued++;
 
 	sqe = io_uring_get_sqe(&sock->group->uring);
-	io_uring_prep_recv(sqe, sock->fd, NULL, URING_MAX_RECV_SIZE, 0);
+#ifdef IORING_RECV_MULTISHOT
+	/* A multishot receive stays armed and posts a completion for every buffer it fills, so
+	 * it only needs to be resubmitted once the kernel terminates it. */
+	if (sock->group->recv_multishot) {
+		io_uring_prep_recv_multishot(sqe, sock->fd, NULL, 0, 0);
+	} else
+#endif
+	{
+		io_uring_prep_recv(sqe, sock->fd, NULL, URING_MAX_RECV_SIZE, 0);
+	}
 	sqe->buf_group = URING_BUF_GROUP_ID;
 	sqe->flags |= IOSQE_BUFFER_SELECT;
+	_sock_sqe_set_file(sqe, sock);
 	io_uring_sqe_set_data(sqe, task);
 	task->status = SPDK_URING_SOCK_TASK_IN_PROCESS;
 }
@@ -1364,17 +1406,25 @@ sock_uring_group_reap(struct spdk_uring_sock_group_impl *group, int max, int max
 		assert(sock != NULL);
 		assert(sock->group != NULL);
 		assert(sock->group == group);
-		sock->group->io_inflight--;
-		sock->group->io_avail++;
 		status = cqe->res;
 		flags = cqe->flags;
 		io_uring_cqe_seen(&group->uring, cqe);
 
-		task->status = SPDK_URING_SOCK_TASK_NOT_IN_USE;
+		/* A multishot request stays in flight until its last completion */
+		if (!(flags & IORING_CQE_F_MORE)) {
+			sock->group->io_inflight--;
+			sock->group->io_avail++;
+			task->status = SPDK_URING_SOCK_TASK_NOT_IN_USE;
+		}
 
 		switch (task->type) {
 		case URING_TASK_READ:
-			if (status == -EAGAIN || status == -EWOULDBLOCK) {
+			if (status == -EINVAL && group->recv_multishot) {
+				/* The kernel doesn't support multishot receives */
+				SPDK_NOTICELOG("Multishot receive not supported, falling back to single shot\n");
+				group->recv_multishot = false;
+				_sock_prep_read(&sock->base);
+			} else if (status == -EAGAIN || status == -EWOULDBLOCK) {
 				/* This likely shouldn't happen, but would indicate that the
 				 * kernel didn't have enough resources to queue a task internally. */
 				_sock_prep_read(&sock->base);
@@ -1549,6 +1599,12 @@ uring_sock_writev_async(struct spdk_sock *_sock, struct spdk_sock_request *req)
 				spdk_sock_abort_requests(_sock);
 			}
 		}
+	} else if (!sock->pending_flush) {
+		if (TAILQ_EMPTY(&sock->group->pending_flush)) {
+			sock->group->flush_tsc = spdk_get_ticks();
+		}
+		TAILQ_INSERT_TAIL(&sock->group->pending_flush, sock, flush_link);
+		sock->pending_flush = true;
 	}
 }
 
@@ -1710,6 +1766,28 @@ uring_sock_group_impl_buf_pool_alloc(struct spdk_uring_sock_group_impl *group_im
 	return 0;
 }
 
+static void
+uring_sock_group_register_files(struct spdk_uring_sock_group_impl *group)
+{
+	uint32_t i;
+
+	/* Without registered files, the sockets just use their regular file descriptors */
+	if (io_uring_register_files_sparse(&group->uring, URING_MAX_FIXED_FILES) != 0) {
+		return;
+	}
+
+	group->free_fixed_files = calloc(URING_MAX_FIXED_FILES, sizeof(*group->free_fixed_files));
+	if (group->free_fixed_files == NULL) {
+		io_uring_unregister_files(&group->uring);
+		return;
+	}
+
+	for (i = 0; i < URING_MAX_FIXED_FILES; i++) {
+		group->free_fixed_files[i] = URING_MAX_FIXED_FILES - i - 1;
+	}
+	group->num_free_fixed_files = URING_MAX_FIXED_FILES;
+}
+
 static struct spdk_sock_group_impl *
 uring_sock_group_impl_create(void)
 {
@@ -1723,13 +1801,24 @@ uring_sock_group_impl_create(void)
 
 	group_impl->io_avail = SPDK_SOCK_GROUP_QUEUE_DEPTH;
 
+	/* The ring is set up without IORING_SETUP_SINGLE_ISSUER: the scheduler may move the
+	 * group's spdk_thread to another reactor, and the ring has to keep working there. */
 	if (io_uring_queue_init(SPDK_SOCK_GROUP_QUEUE_DEPTH, &group_impl->uring, 0) < 0) {
 		SPDK_ERRLOG("uring I/O context setup failure\n");
 		free(group_impl);
 		return NULL;
 	}
 
+	uring_sock_group_register_files(group_impl);
+#ifdef IORING_RECV_MULTISHOT
+	group_impl->recv_multishot = true;
+#endif
+
 	TAILQ_INIT(&group_impl->pending_recv);
+	TAILQ_INIT(&group_impl->pending_flush);
+	group_impl->flush_batch_size = g_spdk_uring_sock_impl_opts.flush_batch_size;
+	group_impl->flush_batch_timeout_ticks = g_spdk_uring_sock_impl_opts.flush_batch_timeout_us *
+						spdk_get_ticks_hz() / SPDK_SEC_TO_USEC;
 
 	if (uring_sock_group_impl_buf_pool_alloc(group_impl) < 0) {
 		SPDK_ERRLOG("Failed to create buffer ring."
@@ -1752,7 +1841,7 @@ uring_sock_group_impl_add_sock(struct spdk_sock_group_impl *_group,
 {
 	struct spdk_uring_sock *sock = __uring_sock(_sock);
 	struct spdk_uring_sock_group_impl *group = __uring_group_impl(_group);
-	int rc;
+	int idx, rc;
 
 	sock->group = group;
 	sock->write_task.sock = sock;
@@ -1769,6 +1858,16 @@ uring_sock_group_impl_add_sock(struct spdk_sock_group_impl *_group,
 	sock->cancel_task.sock = sock;
 	sock->cancel_task.type = URING_TASK_CANCEL;
 
+	sock->fixed_file = -1;
+	if (group->num_free_fixed_files > 0) {
+		idx = group->free_fixed_files[--group->num_free_fixed_files];
+		if (io_uring_register_files_update(&group->uring, idx, &sock->fd, 1) == 1) {
+			sock->fixed_file = idx;
+		} else {
+			group->num_free_fixed_files++;
+		}
+	}
+
 	/* switched from another polling group due to scheduling */
 	if (spdk_unlikely(sock->recv_pipe != NULL &&
 			  (spdk_pipe_reader_bytes_available(sock->recv_pipe) > 0))) {
@@ -1832,6 +1931,39 @@ uring_sock_group_populate_buf_ring(struct spdk_uring_sock_group_impl *group)
 	}
 }
 
+static void
+uring_sock_group_flush(struct spdk_uring_sock_group_impl *group)
+{
+	struct spdk_uring_sock *sock, *tmp;
+	uint32_t num_socks = 0;
+
+	TAILQ_FOREACH_SAFE(sock, &group->pending_flush, flush_link, tmp) {
+		if (TAILQ_EMPTY(&sock->base.queued_reqs) || sock->connection_status) {
+			TAILQ_REMOVE(&group->pending_flush, sock, flush_link);
+			sock->pending_flush = false;
+		} else if (sock->write_task.status != SPDK_URING_SOCK_TASK_IN_PROCESS) {
+			num_socks++;
+		}
+	}
+
+	if (num_socks == 0) {
+		return;
+	}
+
+	/* Hold the writes back until enough sockets have some, so that they're all sent with
+	 * a single submission, or until the oldest of them ran out of its latency budget. */
+	if (num_socks < group->flush_batch_size &&
+	    spdk_get_ticks() - group->flush_tsc < group->flush_batch_timeout_ticks) {
+		return;
+	}
+
+	TAILQ_FOREACH(sock, &group->pending_flush, flush_link) {
+		_sock_flush(&sock->base);
+	}
+
+	group->flush_tsc = spdk_get_ticks();
+}
+
 static int
 uring_sock_group_impl_poll(struct spdk_sock_group_impl *_group, int max_events,
 			   struct spdk_sock **socks)
@@ -1839,17 +1971,9 @@ uring_sock_group_impl_poll(struct spdk_sock_group_impl *_group, int max_events,
 	struct spdk_uring_sock_group_impl *group = __uring_group_impl(_group);
 	int count, ret;
 	int to_complete, to_submit;
-	struct spdk_sock *_sock, *tmp;
-	struct spdk_uring_sock *sock;
 
 	if (spdk_likely(socks)) {
-		TAILQ_FOREACH_SAFE(_sock, &group->base.socks, link, tmp) {
-			sock = __uring_sock(_sock);
-			if (spdk_unlikely(sock->connection_status)) {
-				continue;
-			}
-			_sock_flush(_sock);
-		}
+		uring_sock_group_flush(group);
 	}
 
 	/* Try to re-populate the io_uring's buffer pool using user-provided buffers */
@@ -1885,6 +2009,7 @@ uring_sock_group_impl_remove_sock(struct spdk_sock_group_impl *_group,
 {
 	struct spdk_uring_sock *sock = __uring_sock(_sock);
 	struct spdk_uring_sock_group_impl *group = __uring_group_impl(_group);
+	int fd;
 
 	sock->pending_group_remove = true;
 
@@ -1929,6 +2054,11 @@ uring_sock_group_impl_remove_sock(struct spdk_sock_group_impl *_group,
 	}
 	assert(sock->pending_recv == false);
 
+	if (sock->pending_flush) {
+		TAILQ_REMOVE(&group->pending_flush, sock, flush_link);
+		sock->pending_flush = false;
+	}
+
 	/* We have no way to handle this case. We could let the user read this
 	 * buffer, but the buffer came from a group and we have lost the association
 	 * to that so we couldn't release it. */
@@ -1938,6 +2068,14 @@ uring_sock_group_impl_remove_sock(struct spdk_sock_group_impl *_group,
 		spdk_sock_map_release(&g_map, sock->placement_id);
 	}
 
+	if (sock->fixed_file >= 0) {
+		/* The registered file holds a reference to the socket, so drop it */
+		fd = -1;
+		io_uring_register_files_update(&group->uring, sock->fixed_file, &fd, 1);
+		group->free_fixed_files[group->num_free_fixed_files++] = sock->fixed_file;
+		sock->fixed_file = -1;
+	}
+
 	sock->pending_group_remove = false;
 	sock->group = NULL;
 	return 0;
@@ -1958,6 +2096,7 @@ uring_sock_group_impl_close(struct spdk_sock_group_impl *_group)
 	uring_sock_group_impl_buf_pool_free(group);
 
 	io_uring_queue_exit(&group->uring);
+	free(group->free_fixed_files);
 
 	if (g_spdk_uring_sock_impl_opts.enable_placement_id == PLACEMENT_CPU) {
 		spdk_sock_map_release(&g_map, spdk_env_get_current_core());
@@ -94,7 +94,7 @@ def accel_set_driver(client, name):
 
 
 def accel_set_options(client, small_cache_size, large_cache_size,
-                      task_count, sequence_count, buf_count):
+                      task_count, sequence_count, buf_count, cost_model=None):
     """Set accel framework's options."""
     params = {}
 
@@ -108,6 +108,8 @@ def accel_set_options(client, small_cache_size, large_cache_size,
         params['sequence_count'] = sequence_count
     if buf_count is not None:
         params['buf_count'] = buf_count
+    if cost_model is not None:
+        params['cost_model'] = cost_model
 
     return client.call('accel_set_options', params)
 
@@ -118,6 +120,12 @@ def accel_get_stats(client):
     return client.call('accel_get_stats')
 
 
+def accel_get_cost_model(client):
+    """Get costs of operations measured by accel framework's cost model"""
+
+    return client.call('accel_get_cost_model')
+
+
 def accel_error_inject_error(client, opcode, type, count=None, interval=None, errcode=None):
     """Inject an error to processing accel operation"""
     params = {}
@@ -53,7 +53,7 @@ def bdev_compress_create(client, base_bdev_name, pm_path, lb_size=None, comp_alg
         base_bdev_name: name of the underlying base bdev
         pm_path: path to persistent memory
         lb_size: logical block size for the compressed vol in bytes.  Must be 4K or 512.
-        comp_algo: compression algorithm for the compressed vol. Default is deflate.
+        comp_algo: compression algorithm for the compressed vol (deflate, lz4, zstd). Default is deflate.
         comp_level: compression algorithm level for the compressed vol. Default is 1.
     Returns:
         Name of created virtual block device.
@@ -1034,12 +1034,26 @@ def bdev_nvme_set_preferred_path(client, name, cntlid):
     return client.call('bdev_nvme_set_preferred_path', params)
 
 
+def bdev_nvme_set_path_weight(client, name, cntlid, weight):
+    """Set the weight of an I/O path for an NVMe bdev used by the weighted multipath selector
+    Args:
+        name: NVMe bdev name
+        cntlid: NVMe-oF controller ID
+        weight: Relative weight of the I/O path (greater than zero)
+    """
+    params = dict()
+    params['name'] = name
+    params['cntlid'] = cntlid
+    params['weight'] = weight
+    return client.call('bdev_nvme_set_path_weight', params)
+
+
 def bdev_nvme_set_multipath_policy(client, name, policy, selector=None, rr_min_io=None):
     """Set multipath policy of the NVMe bdev
     Args:
         name: NVMe bdev name
         policy: Multipath policy (active_passive or active_active)
-        selector: Multipath selector (round_robin, queue_depth)
+        selector: Multipath selector (round_robin, queue_depth, service_time, numa, weighted)
         rr_min_io: Number of IO to route to a path before switching to another one (optional)
     """
     params = dict()
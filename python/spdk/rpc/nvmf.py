@@ -24,7 +24,8 @@ def nvmf_set_max_subsystems(client,
 def nvmf_set_config(client,
                     passthru_identify_ctrlr=None,
                     poll_groups_mask=None,
-                    discovery_filter=None, dhchap_digests=None, dhchap_dhgroups=None):
+                    discovery_filter=None, dhchap_digests=None, dhchap_dhgroups=None,
+                    rebalance_period_us=None):
     """Set NVMe-oF target subsystem configuration.
 
     Args:
@@ -32,6 +33,7 @@ def nvmf_set_config(client,
          comma separated values: `transport`, `address`, `svcid`
         dhchap_digests: List of allowed DH-HMAC-CHAP digests. (optional)
         dhchap_dhgroups: List of allowed DH-HMAC-CHAP DH groups. (optional)
+        rebalance_period_us: Interval of moving I/O qpairs between poll groups, 0 disables. (optional)
     Returns:
         True or False
     """
@@ -49,6 +51,8 @@ def nvmf_set_config(client,
         params['dhchap_digests'] = dhchap_digests
     if dhchap_dhgroups is not None:
         params['dhchap_dhgroups'] = dhchap_dhgroups
+    if rebalance_period_us is not None:
+        params['rebalance_period_us'] = rebalance_period_us
 
     return client.call('nvmf_set_config', params)
 
@@ -116,6 +120,7 @@ def nvmf_create_transport(client, **params):
         num_shared_buffers: The number of pooled data buffers available to the transport (optional)
         buf_cache_size: The number of shared buffers to reserve for each poll group (optional)
         zcopy: Use zero-copy operations if the underlying bdev supports them (optional)
+        zcopy_read: Use zero-copy operations for reads only if the underlying bdev supports them (optional)
         num_cqe: The number of CQ entries to configure CQ size. Only used when no_srq=true - RDMA specific (optional)
         max_srq_depth: Max number of outstanding I/O per shared receive queue - RDMA specific (optional)
         no_srq: Boolean flag to disable SRQ even for devices that support it - RDMA specific (optional)
@@ -510,6 +515,28 @@ def nvmf_subsystem_set_ns_ana_group(client, nqn, nsid, anagrpid, tgt_name=None):
     return client.call('nvmf_subsystem_set_ns_ana_group', params)
 
 
+def nvmf_subsystem_set_ns_io_depth(client, nqn, nsid, io_depth, tgt_name=None):
+    """Limit the I/O depth of a namespace per poll group and share it fairly between hosts.
+
+    Args:
+        nqn: Subsystem NQN.
+        nsid: Namespace ID.
+        io_depth: Maximum number of I/Os outstanding per poll group (0 disables the limit).
+        tgt_name: name of the parent NVMe-oF target (optional).
+
+    Returns:
+        True or False
+    """
+    params = {'nqn': nqn,
+              'nsid': nsid,
+              'io_depth': io_depth}
+
+    if tgt_name:
+        params['tgt_name'] = tgt_name
+
+    return client.call('nvmf_subsystem_set_ns_io_depth', params)
+
+
 def nvmf_subsystem_remove_ns(client, nqn, nsid, tgt_name=None):
     """Remove a existing namespace from a subsystem.
 
@@ -630,6 +657,26 @@ def nvmf_subsystem_set_keys(client, nqn, host, tgt_name=None,
     return client.call('nvmf_subsystem_set_keys', params)
 
 
+def nvmf_subsystem_set_host_weight(client, nqn, host, weight, tgt_name=None):
+    """Set the share of the namespaces' I/O depth a host gets relative to other hosts.
+
+    Args:
+        nqn: Subsystem NQN.
+        host: Host NQN.
+        weight: Weight of the host.
+        tgt_name: Name of the NVMe-oF target (optional).
+    """
+
+    params = {'nqn': nqn,
+              'host': host,
+              'weight': weight}
+
+    if tgt_name is not None:
+        params['tgt_name'] = tgt_name
+
+    return client.call('nvmf_subsystem_set_host_weight', params)
+
+
 def nvmf_subsystem_allow_any_host(client, nqn, disable, tgt_name=None):
     """Configure a subsystem to allow any host to connect or to enforce the host NQN list.
 
@@ -27,7 +27,11 @@ def sock_impl_set_options(client,
                           enable_zerocopy_send_client=None,
                           zerocopy_threshold=None,
                           tls_version=None,
-                          enable_ktls=None):
+                          enable_ktls=None,
+                          flush_batch_size=None,
+                          flush_batch_timeout_us=None,
+                          busy_poll_usecs=None,
+                          busy_poll_budget=None):
     """Set parameters for the socket layer implementation.
 
     Args:
@@ -42,6 +46,10 @@ def sock_impl_set_options(client,
         zerocopy_threshold: set zerocopy_threshold in bytes(optional)
         tls_version: set TLS protocol version (optional)
         enable_ktls: enable or disable Kernel TLS (optional)
+        flush_batch_size: number of sockets in a group with queued writes to flush them together (optional)
+        flush_batch_timeout_us: time in microseconds queued writes may wait for a batch (optional)
+        busy_poll_usecs: time in microseconds to busy poll the NIC queues of a sock group, 0 disables (optional)
+        busy_poll_budget: maximum number of packets processed per busy poll (optional)
     """
     params = {}
 
@@ -66,6 +74,14 @@ def sock_impl_set_options(client,
         params['tls_version'] = tls_version
     if enable_ktls is not None:
         params['enable_ktls'] = enable_ktls
+    if flush_batch_size is not None:
+        params['flush_batch_size'] = flush_batch_size
+    if flush_batch_timeout_us is not None:
+        params['flush_batch_timeout_us'] = flush_batch_timeout_us
+    if busy_poll_usecs is not None:
+        params['busy_poll_usecs'] = busy_poll_usecs
+    if busy_poll_budget is not None:
+        params['busy_poll_budget'] = busy_poll_budget
 
     return client.call('sock_impl_set_options', params)
 
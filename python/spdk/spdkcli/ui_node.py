@@ -891,9 +891,9 @@ class UICompressBdev(UIBdev):
         base_bdev_name - Name of the base bdev.
         pm_path - Path to persistent memory.
         lb_size - Optional argument. Integer, compressed vol logical block size (optional, if used must be 512 or 4096).
-        comp_algo - Optional argument. Compression algorithm, (deflate, lz4). Default is deflate.
+        comp_algo - Optional argument. Compression algorithm, (deflate, lz4, zstd). Default is deflate.
         comp_level - Optional argument. Integer, compression algorithm level. if algo == deflate, level ranges from 0 to 3.
-                     if algo == lz4, level ranges from 1 to 65537
+                     if algo == lz4, level ranges from 1 to 65537. if algo == zstd, level ranges from 1 to 22.
         """
 
         lb_size = self.ui_eval_param(lb_size, "number", None)
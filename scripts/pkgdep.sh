@@ -28,6 +28,7 @@ function usage() {
 	echo "  -G --golang                 Additional dependencies for go API generation"
 	echo "  -I --idxd                   Additional dependencies for IDXD"
 	echo "  -l --lz4                    Additional dependencies for lz4"
+	echo "  -z --zstd                   Additional dependencies for zstd"
 	echo ""
 	exit 0
 }
@@ -44,6 +45,7 @@ function install_all_dependencies() {
 	INSTALL_GOLANG=true
 	INSTALL_IDXD=true
 	INSTALL_LZ4=true
+	INSTALL_ZSTD=true
 }
 
 INSTALL_CRYPTO=false
@@ -59,8 +61,9 @@ INSTALL_GOLANG=false
 INSTALL_IDXD=false
 INSTALL_UADK=false
 INSTALL_LZ4=false
+INSTALL_ZSTD=false
 
-while getopts 'abdfhilpruADGIR-:' optchar; do
+while getopts 'abdfhilpruzADGIR-:' optchar; do
 	case "$optchar" in
 		-)
 			case "$OPTARG" in
@@ -78,6 +81,7 @@ while getopts 'abdfhilpruADGIR-:' optchar; do
 				golang) INSTALL_GOLANG=true ;;
 				idxd) INSTALL_IDXD=true ;;
 				lz4) INSTALL_LZ4=true ;;
+				zstd) INSTALL_ZSTD=true ;;
 				*)
 					echo "Invalid argument '$OPTARG'"
 					usage
@@ -97,6 +101,7 @@ while getopts 'abdfhilpruADGIR-:' optchar; do
 		G) INSTALL_GOLANG=true ;;
 		I) INSTALL_IDXD=true ;;
 		l) INSTALL_LZ4=true ;;
+		z) INSTALL_ZSTD=true ;;
 		*)
 			echo "Invalid argument '$OPTARG'"
 			usage
@@ -91,3 +91,6 @@ fi
 if [[ $INSTALL_LZ4 == "true" ]]; then
 	apt-get install -y liblz4-dev
 fi
+if [[ $INSTALL_ZSTD == "true" ]]; then
+	apt-get install -y libzstd-dev
+fi
@@ -36,3 +36,6 @@ fi
 if [[ $INSTALL_LZ4 == "true" ]]; then
 	pkg install -y liblz4
 fi
+if [[ $INSTALL_ZSTD == "true" ]]; then
+	pkg install -y zstd
+fi
@@ -53,6 +53,9 @@ additional_dependencies() {
 	if [[ $INSTALL_LZ4 == "true" ]]; then
 		tdnf install -y liblz4
 	fi
+	if [[ $INSTALL_ZSTD == "true" ]]; then
+		tdnf install -y zstd-devel
+	fi
 }
 
 tdnf install -y ca-certificates build-essential
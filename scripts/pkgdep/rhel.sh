@@ -224,3 +224,6 @@ fi
 if [[ $INSTALL_LZ4 == "true" ]]; then
 	yum install -y lz4-devel
 fi
+if [[ $INSTALL_ZSTD == "true" ]]; then
+	yum install -y libzstd-devel
+fi
@@ -46,3 +46,6 @@ fi
 if [[ $INSTALL_LZ4 == "true" ]]; then
 	zypper install -y liblz4-devel
 fi
+if [[ $INSTALL_ZSTD == "true" ]]; then
+	zypper install -y libzstd-devel
+fi
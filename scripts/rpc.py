@@ -269,11 +269,12 @@ if __name__ == "__main__":
     p.add_argument('-b', '--base-bdev-name', help="Name of the base bdev", required=True)
     p.add_argument('-p', '--pm-path', help="Path to persistent memory", required=True)
     p.add_argument('-l', '--lb-size', help="Compressed vol logical block size (optional, if used must be 512 or 4096)", type=int)
-    p.add_argument('-c', '--comp-algo', help='Compression algorithm, (deflate, lz4). Default is deflate')
+    p.add_argument('-c', '--comp-algo', help='Compression algorithm, (deflate, lz4, zstd). Default is deflate')
     p.add_argument('-L', '--comp-level',
                    help="""Compression algorithm level.
                    if algo == deflate, level ranges from 0 to 3.
-                   if algo == lz4, level ranges from 1 to 65537""",
+                   if algo == lz4, level ranges from 1 to 65537.
+                   if algo == zstd, level ranges from 1 to 22""",
                    default=1, type=int)
     p.set_defaults(func=bdev_compress_create)
 
@@ -969,6 +970,19 @@ if __name__ == "__main__":
     p.add_argument('-c', '--cntlid', help='NVMe-oF controller ID', type=int, required=True)
     p.set_defaults(func=bdev_nvme_set_preferred_path)
 
+    def bdev_nvme_set_path_weight(args):
+        rpc.bdev.bdev_nvme_set_path_weight(args.client,
+                                           name=args.name,
+                                           cntlid=args.cntlid,
+                                           weight=args.weight)
+
+    p = subparsers.add_parser('bdev_nvme_set_path_weight',
+                              help="""Set the weight of an I/O path for an NVMe bdev used by the weighted multipath selector""")
+    p.add_argument('-b', '--name', help='Name of the NVMe bdev', required=True)
+    p.add_argument('-c', '--cntlid', help='NVMe-oF controller ID', type=int, required=True)
+    p.add_argument('-w', '--weight', help='Relative weight of the I/O path', type=int, required=True)
+    p.set_defaults(func=bdev_nvme_set_path_weight)
+
     def bdev_nvme_set_multipath_policy(args):
         rpc.bdev.bdev_nvme_set_multipath_policy(args.client,
                                                 name=args.name,
@@ -980,7 +994,7 @@ if __name__ == "__main__":
                               help="""Set multipath policy of the NVMe bdev""")
     p.add_argument('-b', '--name', help='Name of the NVMe bdev', required=True)
     p.add_argument('-p', '--policy', help='Multipath policy (active_passive or active_active)', required=True)
-    p.add_argument('-s', '--selector', help='Multipath selector (round_robin, queue_depth)')
+    p.add_argument('-s', '--selector', help='Multipath selector (round_robin, queue_depth, service_time, numa, weighted)')
     p.add_argument('-r', '--rr-min-io',
                    help='Number of IO to route to a path before switching to another for round-robin',
                    type=int)
@@ -2465,7 +2479,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                                             overprovisioning=args.overprovisioning,
                                             l2p_dram_limit=args.l2p_dram_limit,
                                             core_mask=args.core_mask,
-                                            fast_shutdown=args.fast_shutdown))
+                                            fast_shutdown=args.fast_shutdown,
+                                            gc_policy=args.gc_policy))
 
     p = subparsers.add_parser('bdev_ftl_create', help='Add FTL bdev')
     p.add_argument('-b', '--name', help="Name of the bdev", required=True)
@@ -2482,6 +2497,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('--core-mask', help='CPU core mask - which cores will be used for ftl core thread, '
                    'by default core thread will be set to the main application core (optional)')
     p.add_argument('-f', '--fast-shutdown', help="Enable fast shutdown", action='store_true')
+    p.add_argument('--gc-policy', help='Policy of picking bands to garbage collect (optional); '
+                   'default greedy', choices=['greedy', 'cost_benefit'])
     p.set_defaults(func=bdev_ftl_create)
 
     def bdev_ftl_load(args):
@@ -2493,7 +2510,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                                           overprovisioning=args.overprovisioning,
                                           l2p_dram_limit=args.l2p_dram_limit,
                                           core_mask=args.core_mask,
-                                          fast_shutdown=args.fast_shutdown))
+                                          fast_shutdown=args.fast_shutdown,
+                                          gc_policy=args.gc_policy))
 
     p = subparsers.add_parser('bdev_ftl_load', help='Load FTL bdev')
     p.add_argument('-b', '--name', help="Name of the bdev", required=True)
@@ -2509,6 +2527,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('--core-mask', help='CPU core mask - which cores will be used for ftl core thread, '
                    'by default core thread will be set to the main application core (optional)')
     p.add_argument('-f', '--fast-shutdown', help="Enable fast shutdown", action='store_true')
+    p.add_argument('--gc-policy', help='Policy of picking bands to garbage collect (optional); '
+                   'default greedy', choices=['greedy', 'cost_benefit'])
     p.set_defaults(func=bdev_ftl_load)
 
     def bdev_ftl_unload(args):
@@ -2690,7 +2710,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                                  poll_groups_mask=args.poll_groups_mask,
                                  discovery_filter=args.discovery_filter,
                                  dhchap_digests=args.dhchap_digests,
-                                 dhchap_dhgroups=args.dhchap_dhgroups)
+                                 dhchap_dhgroups=args.dhchap_dhgroups,
+                                 rebalance_period_us=args.rebalance_period_us)
 
     p = subparsers.add_parser('nvmf_set_config', help='Set NVMf target config')
     p.add_argument('-i', '--passthru-identify-ctrlr', help="""Passthrough fields like serial number and model number
@@ -2702,6 +2723,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                    type=lambda d: d.split(','))
     p.add_argument('--dhchap-dhgroups', help='Comma-separated list of allowed DH-HMAC-CHAP DH groups',
                    type=lambda d: d.split(','))
+    p.add_argument('--rebalance-period-us', help='''Interval at which an I/O qpair is moved from the most
+    to the least loaded poll group, in microseconds. 0 disables it (default)''', type=int)
     p.set_defaults(func=nvmf_set_config)
 
     def nvmf_create_transport(args):
@@ -2720,6 +2743,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('-b', '--buf-cache-size', help='The number of shared buffers to reserve for each poll group', type=int)
     p.add_argument('-z', '--zcopy', action='store_true', help='''Use zero-copy operations if the
     underlying bdev supports them''')
+    p.add_argument('--zcopy-read', action='store_true', help='''Use zero-copy operations for reads only if the
+    underlying bdev supports them''')
     p.add_argument('-d', '--num-cqe', help="""The number of CQ entries. Only used when no_srq=true.
     Relevant only for RDMA transport""", type=int)
     p.add_argument('-s', '--max-srq-depth', help='Max number of outstanding I/O per SRQ. Relevant only for RDMA transport', type=int)
@@ -2934,6 +2959,21 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('-t', '--tgt-name', help='The name of the parent NVMe-oF target (optional)', type=str)
     p.set_defaults(func=nvmf_subsystem_set_ns_ana_group)
 
+    def nvmf_subsystem_set_ns_io_depth(args):
+        rpc.nvmf.nvmf_subsystem_set_ns_io_depth(args.client,
+                                                nqn=args.nqn,
+                                                nsid=args.nsid,
+                                                io_depth=args.io_depth,
+                                                tgt_name=args.tgt_name)
+
+    p = subparsers.add_parser('nvmf_subsystem_set_ns_io_depth',
+                              help='Limit the I/O depth of a namespace per poll group and share it fairly between hosts')
+    p.add_argument('nqn', help='NVMe-oF subsystem NQN')
+    p.add_argument('nsid', help='The requested NSID', type=int)
+    p.add_argument('io_depth', help='Maximum number of I/Os outstanding per poll group, 0 to disable the limit', type=int)
+    p.add_argument('-t', '--tgt-name', help='The name of the parent NVMe-oF target (optional)', type=str)
+    p.set_defaults(func=nvmf_subsystem_set_ns_io_depth)
+
     def nvmf_subsystem_remove_ns(args):
         rpc.nvmf.nvmf_subsystem_remove_ns(args.client,
                                           nqn=args.nqn,
@@ -3022,6 +3062,21 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('--dhchap-ctrlr-key', help='DH-HMAC-CHAP controller key name')
     p.set_defaults(func=nvmf_subsystem_set_keys)
 
+    def nvmf_subsystem_set_host_weight(args):
+        rpc.nvmf.nvmf_subsystem_set_host_weight(args.client,
+                                                nqn=args.nqn,
+                                                host=args.host,
+                                                weight=args.weight,
+                                                tgt_name=args.tgt_name)
+
+    p = subparsers.add_parser('nvmf_subsystem_set_host_weight',
+                              help='Set the share of the namespaces\' I/O depth a host gets relative to other hosts')
+    p.add_argument('nqn', help='Subsystem NQN')
+    p.add_argument('host', help='Host NQN')
+    p.add_argument('weight', help='Weight of the host', type=int)
+    p.add_argument('-t', '--tgt-name', help='Name of the NVMe-oF target')
+    p.set_defaults(func=nvmf_subsystem_set_host_weight)
+
     def nvmf_subsystem_allow_any_host(args):
         rpc.nvmf.nvmf_subsystem_allow_any_host(args.client,
                                                nqn=args.nqn,
@@ -3423,7 +3478,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
 
     def accel_set_options(args):
         rpc.accel.accel_set_options(args.client, args.small_cache_size, args.large_cache_size,
-                                    args.task_count, args.sequence_count, args.buf_count)
+                                    args.task_count, args.sequence_count, args.buf_count,
+                                    args.cost_model)
 
     p = subparsers.add_parser('accel_set_options', help='Set accel framework\'s options')
     p.add_argument('--small-cache-size', type=int, help='Size of the small iobuf cache')
@@ -3431,6 +3487,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('--task-count', type=int, help='Maximum number of tasks per IO channel')
     p.add_argument('--sequence-count', type=int, help='Maximum number of sequences per IO channel')
     p.add_argument('--buf-count', type=int, help='Maximum number of buffers per IO channel')
+    p.add_argument('--cost-model', action='store_true', default=None,
+                   help='Dispatch operations to the module with the lowest measured cost')
     p.set_defaults(func=accel_set_options)
 
     def accel_get_stats(args):
@@ -3439,6 +3497,13 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p = subparsers.add_parser('accel_get_stats', help='Display accel framework\'s statistics')
     p.set_defaults(func=accel_get_stats)
 
+    def accel_get_cost_model(args):
+        print_dict(rpc.accel.accel_get_cost_model(args.client))
+
+    p = subparsers.add_parser('accel_get_cost_model',
+                              help='Display costs of operations measured by accel framework\'s cost model')
+    p.set_defaults(func=accel_get_cost_model)
+
     # ioat
     def ioat_scan_accel_module(args):
         rpc.ioat.ioat_scan_accel_module(args.client)
@@ -3817,7 +3882,11 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                                        enable_zerocopy_send_client=args.enable_zerocopy_send_client,
                                        zerocopy_threshold=args.zerocopy_threshold,
                                        tls_version=args.tls_version,
-                                       enable_ktls=args.enable_ktls)
+                                       enable_ktls=args.enable_ktls,
+                                       flush_batch_size=args.flush_batch_size,
+                                       flush_batch_timeout_us=args.flush_batch_timeout_us,
+                                       busy_poll_usecs=args.busy_poll_usecs,
+                                       busy_poll_budget=args.busy_poll_budget)
 
     p = subparsers.add_parser('sock_impl_set_options', help="""Set options of socket layer implementation""")
     p.add_argument('-i', '--impl', help='Socket implementation name, e.g. posix', required=True)
@@ -3846,6 +3915,10 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                    action='store_true', dest='enable_ktls')
     p.add_argument('--disable-ktls', help='Disable Kernel TLS',
                    action='store_false', dest='enable_ktls')
+    p.add_argument('--flush-batch-size', help='Number of sockets in a sock group with queued writes to flush them together', type=int)
+    p.add_argument('--flush-batch-timeout-us', help='Time in microseconds queued writes may wait for a batch', type=int)
+    p.add_argument('--busy-poll-usecs', help='Time in microseconds to busy poll the NIC queues of a sock group. 0 disables', type=int)
+    p.add_argument('--busy-poll-budget', help='Maximum number of packets processed per busy poll', type=int)
     p.set_defaults(func=sock_impl_set_options, enable_recv_pipe=None, enable_quickack=None,
                    enable_placement_id=None, enable_zerocopy_send_server=None, enable_zerocopy_send_client=None,
                    zerocopy_threshold=None, tls_version=None, enable_ktls=None)
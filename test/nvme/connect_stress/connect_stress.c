@@ -14,6 +14,7 @@
 #include "spdk/sock.h"
 
 static int g_time_in_sec;
+static int g_num_ctrlrs;
 
 static struct spdk_nvme_transport_id g_trid;
 
@@ -23,6 +24,8 @@ usage(char *program_name)
 	printf("%s options", program_name);
 	printf("\n");
 	printf("\t[-t, --time <sec> time in seconds]\n");
+	printf("\t[-n, --num-ctrlrs <num> connect this many controllers at once, each on behalf\n");
+	printf("\t\tof a different host, and report the connect rate]\n");
 	printf("\t[-c, --core-mask <mask>]\n");
 	printf("\t\t(default: 1)\n");
 	printf("\t[-r, --transport <fmt> Transport ID for local PCIe NVMe or NVMeoF]\n");
@@ -67,13 +70,15 @@ add_trid(const char *trid_str)
 	return 0;
 }
 
-#define PERF_GETOPT_SHORT "c:i:r:s:t:GS:T:"
+#define PERF_GETOPT_SHORT "c:i:n:r:s:t:GS:T:"
 
 static const struct option g_cmdline_opts[] = {
 #define PERF_CORE_MASK	'c'
 	{"core-mask",			required_argument,	NULL, PERF_CORE_MASK},
 #define PERF_SHMEM_GROUP_ID	'i'
 	{"shmem-grp-id",		required_argument,	NULL, PERF_SHMEM_GROUP_ID},
+#define PERF_NUM_CTRLRS	'n'
+	{"num-ctrlrs",			required_argument,	NULL, PERF_NUM_CTRLRS},
 #define PERF_TRANSPORT	'r'
 	{"transport",			required_argument,	NULL, PERF_TRANSPORT},
 #define PERF_HUGEMEM_SIZE	's'
@@ -105,6 +110,7 @@ parse_args(int argc, char **argv, struct spdk_env_opts *env_opts)
 	while ((op = getopt_long(argc, argv, PERF_GETOPT_SHORT, g_cmdline_opts, &long_idx)) != -1) {
 		switch (op) {
 		case PERF_SHMEM_GROUP_ID:
+		case PERF_NUM_CTRLRS:
 		case PERF_HUGEMEM_SIZE:
 		case PERF_TIME:
 			val = spdk_strtol(optarg, 10);
@@ -116,6 +122,9 @@ parse_args(int argc, char **argv, struct spdk_env_opts *env_opts)
 			case PERF_SHMEM_GROUP_ID:
 				env_opts->shm_id = val;
 				break;
+			case PERF_NUM_CTRLRS:
+				g_num_ctrlrs = val;
+				break;
 			case PERF_HUGEMEM_SIZE:
 				env_opts->mem_size = val;
 				break;
@@ -243,6 +252,125 @@ test_controller(void)
 	return 0;
 }
 
+struct storm_ctrlr {
+	struct spdk_nvme_ctrlr_opts	opts;
+	struct spdk_nvme_probe_ctx	*probe_ctx;
+	struct spdk_nvme_ctrlr		*ctrlr;
+	bool				log_page_pending;
+	bool				failed;
+};
+
+static void
+storm_attach_cb(void *cb_ctx, const struct spdk_nvme_transport_id *trid,
+		struct spdk_nvme_ctrlr *ctrlr, const struct spdk_nvme_ctrlr_opts *opts)
+{
+	struct storm_ctrlr *sctrlr = SPDK_CONTAINEROF(cb_ctx, struct storm_ctrlr, opts);
+
+	sctrlr->ctrlr = ctrlr;
+}
+
+static void
+storm_discovery_cb(void *cb_arg, int rc, const struct spdk_nvme_cpl *cpl,
+		   struct spdk_nvmf_discovery_log_page *log_page)
+{
+	struct storm_ctrlr *sctrlr = cb_arg;
+
+	if (rc != 0 || spdk_nvme_cpl_is_error(cpl)) {
+		fprintf(stderr, "could not get discovery log page for host %s\n", sctrlr->opts.hostnqn);
+		sctrlr->failed = true;
+	}
+
+	sctrlr->log_page_pending = false;
+	free(log_page);
+}
+
+/*
+ * Connect g_num_ctrlrs controllers at once, as if that many hosts reconnected after a
+ * network outage.  Discovery controllers also read the whole discovery log page.
+ */
+static int
+test_connect_storm(void)
+{
+	struct storm_ctrlr *ctrlrs, *sctrlr;
+	uint64_t tsc_start, tsc_elapsed, elapsed_us;
+	int i, num_started, pending, num_failed = 0;
+
+	ctrlrs = calloc(g_num_ctrlrs, sizeof(*ctrlrs));
+	if (ctrlrs == NULL) {
+		fprintf(stderr, "could not allocate controller contexts\n");
+		return -1;
+	}
+
+	tsc_start = spdk_get_ticks();
+	for (num_started = 0; num_started < g_num_ctrlrs; num_started++) {
+		sctrlr = &ctrlrs[num_started];
+		spdk_nvme_ctrlr_get_default_ctrlr_opts(&sctrlr->opts, sizeof(sctrlr->opts));
+		snprintf(sctrlr->opts.hostnqn, sizeof(sctrlr->opts.hostnqn),
+			 "nqn.2016-06.io.spdk:connect-storm-host%d", num_started);
+
+		sctrlr->probe_ctx = spdk_nvme_connect_async(&g_trid, &sctrlr->opts, storm_attach_cb);
+		if (sctrlr->probe_ctx == NULL) {
+			fprintf(stderr, "spdk_nvme_connect_async() failed for transport address '%s'\n",
+				g_trid.traddr);
+			num_failed++;
+			break;
+		}
+	}
+
+	do {
+		pending = 0;
+		for (i = 0; i < num_started; i++) {
+			sctrlr = &ctrlrs[i];
+			if (sctrlr->probe_ctx != NULL) {
+				if (spdk_nvme_probe_poll_async(sctrlr->probe_ctx) == -EAGAIN) {
+					pending++;
+					continue;
+				}
+
+				sctrlr->probe_ctx = NULL;
+				if (sctrlr->ctrlr == NULL) {
+					fprintf(stderr, "could not connect host %s\n", sctrlr->opts.hostnqn);
+					sctrlr->failed = true;
+					continue;
+				}
+
+				if (spdk_nvme_ctrlr_is_discovery(sctrlr->ctrlr)) {
+					if (spdk_nvme_ctrlr_get_discovery_log_page(sctrlr->ctrlr, storm_discovery_cb,
+							sctrlr) != 0) {
+						fprintf(stderr, "could not get discovery log page for host %s\n",
+							sctrlr->opts.hostnqn);
+						sctrlr->failed = true;
+						continue;
+					}
+					sctrlr->log_page_pending = true;
+				}
+			}
+
+			if (sctrlr->log_page_pending) {
+				spdk_nvme_ctrlr_process_admin_completions(sctrlr->ctrlr);
+				pending += sctrlr->log_page_pending;
+			}
+		}
+	} while (pending > 0);
+	tsc_elapsed = spdk_get_ticks() - tsc_start;
+
+	for (i = 0; i < num_started; i++) {
+		sctrlr = &ctrlrs[i];
+		num_failed += sctrlr->failed;
+		if (sctrlr->ctrlr != NULL) {
+			spdk_nvme_detach(sctrlr->ctrlr);
+		}
+	}
+	free(ctrlrs);
+
+	elapsed_us = tsc_elapsed * SPDK_SEC_TO_USEC / spdk_get_ticks_hz();
+	printf("Connected %d controllers in %" PRIu64 " us (%.1f connects/s)\n",
+	       num_started - num_failed, elapsed_us,
+	       (double)(num_started - num_failed) * SPDK_SEC_TO_USEC / spdk_max(elapsed_us, 1));
+
+	return num_failed == 0 ? 0 : -1;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -272,7 +400,7 @@ main(int argc, char **argv)
 
 	tsc_end = spdk_get_ticks() + g_time_in_sec * spdk_get_ticks_hz();
 	while (spdk_get_ticks() < tsc_end && rc == 0) {
-		rc = test_controller();
+		rc = g_num_ctrlrs > 0 ? test_connect_storm() : test_controller();
 	}
 
 	return rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+#  SPDX-License-Identifier: BSD-3-Clause
+#  Copyright (C) 2024 Intel Corporation.
+#  All rights reserved.
+#
+
+testdir=$(readlink -f $(dirname $0))
+rootdir=$(readlink -f $testdir/../../..)
+source $rootdir/test/common/autotest_common.sh
+source $rootdir/test/nvmf/common.sh
+
+DISCOVERY_NQN=nqn.2014-08.org.nvmexpress.discovery
+NQN=nqn.2016-06.io.spdk:cnode1
+# Number of hosts connecting at the same time
+NUM_HOSTS=64
+
+nvmftestinit
+nvmfappstart -m 0xE
+
+$rpc_py nvmf_create_transport $NVMF_TRANSPORT_OPTS -u 8192
+$rpc_py bdev_null_create NULL1 1000 512
+$rpc_py nvmf_create_subsystem $NQN -a -s SPDK00000000000001
+$rpc_py nvmf_subsystem_add_ns $NQN NULL1
+$rpc_py nvmf_subsystem_add_listener $NQN -t $TEST_TRANSPORT -a $NVMF_FIRST_TARGET_IP -s $NVMF_PORT
+$rpc_py nvmf_subsystem_add_listener discovery -t $TEST_TRANSPORT -a $NVMF_FIRST_TARGET_IP -s $NVMF_PORT
+
+# Reconnect storm against an NVM subsystem
+$rootdir/test/nvme/connect_stress/connect_stress -c 0x1 -n $NUM_HOSTS -t 5 "${NO_HUGE[@]}" \
+	-r "trtype:$TEST_TRANSPORT adrfam:IPv4 traddr:$NVMF_FIRST_TARGET_IP trsvcid:$NVMF_PORT subnqn:$NQN"
+
+# Discovery storm, every host reads the whole discovery log page
+$rootdir/test/nvme/connect_stress/connect_stress -c 0x1 -n $NUM_HOSTS -t 5 "${NO_HUGE[@]}" \
+	-r "trtype:$TEST_TRANSPORT adrfam:IPv4 traddr:$NVMF_FIRST_TARGET_IP trsvcid:$NVMF_PORT subnqn:$DISCOVERY_NQN"
+
+trap - SIGINT SIGTERM EXIT
+
+nvmftestfini
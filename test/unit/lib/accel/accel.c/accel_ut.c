@@ -575,6 +575,563 @@ test_spdk_accel_submit_xor(void)
 	CU_ASSERT(expected_accel_task == &task);
 }
 
+static int g_cost_submit_rc[2];
+static struct spdk_accel_task *g_cost_submitted[2];
+
+static int
+ut_cost_submit(int idx, struct spdk_accel_task *task)
+{
+	if (g_cost_submit_rc[idx] != 0) {
+		return g_cost_submit_rc[idx];
+	}
+
+	g_cost_submitted[idx] = task;
+
+	return 0;
+}
+
+static int
+ut_cost_submit_tasks0(struct spdk_io_channel *ch, struct spdk_accel_task *task)
+{
+	return ut_cost_submit(0, task);
+}
+
+static int
+ut_cost_submit_tasks1(struct spdk_io_channel *ch, struct spdk_accel_task *task)
+{
+	return ut_cost_submit(1, task);
+}
+
+static void
+ut_cost_cb(void *cb_arg, int status)
+{
+	CU_ASSERT(status == 0);
+}
+
+static void
+test_accel_cost_model(void)
+{
+	struct spdk_accel_module_if module0 = { .name = "module0", .submit_tasks = ut_cost_submit_tasks0 };
+	struct spdk_accel_module_if module1 = { .name = "module1", .submit_tasks = ut_cost_submit_tasks1 };
+	struct accel_cost_opc *opc = &g_cost_opc[SPDK_ACCEL_OPC_COPY];
+	struct accel_cost_channel *cost;
+	struct spdk_accel_task task = {};
+	struct spdk_accel_task_aux_data task_aux;
+	uint8_t large = accel_cost_bucket(0x10000);
+	uint8_t *src, *dst;
+	int rc;
+
+	CU_ASSERT(accel_cost_bucket(1) == 0);
+	CU_ASSERT(accel_cost_bucket(512) == 0);
+	CU_ASSERT(accel_cost_bucket(513) == 1);
+	CU_ASSERT(accel_cost_bucket(0x10000) == 7);
+	CU_ASSERT(accel_cost_bucket(UINT64_MAX) == ACCEL_COST_NUM_BUCKETS - 1);
+
+	src = calloc(1, 0x10000);
+	dst = calloc(1, 0x10000);
+	cost = calloc(1, sizeof(*cost));
+	SPDK_CU_ASSERT_FATAL(src != NULL && dst != NULL && cost != NULL);
+
+	opc->modules[0] = &module0;
+	opc->modules[1] = &module1;
+	opc->num_modules = 2;
+	g_accel_ch->cost[SPDK_ACCEL_OPC_COPY] = cost;
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+	task.accel_ch = g_accel_ch;
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux, link);
+
+	/* Modules without samples are tried first, in order */
+	rc = spdk_accel_submit_copy(g_ch, dst, src, 512, ut_cost_cb, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_cost_submitted[0] == &task);
+	CU_ASSERT(task.cost_module == 0);
+	CU_ASSERT(task.cost_bucket == 0);
+	spdk_accel_task_complete(&task, 0);
+	CU_ASSERT(cost->entries[0][0].samples == 1);
+
+	rc = spdk_accel_submit_copy(g_ch, dst, src, 512, ut_cost_cb, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_cost_submitted[1] == &task);
+	CU_ASSERT(task.cost_module == 1);
+	spdk_accel_task_complete(&task, 0);
+	CU_ASSERT(cost->entries[1][0].samples == 1);
+
+	/* Each size is dispatched to the module with the lowest cost for it */
+	cost->entries[0][0].ticks = 10;
+	cost->entries[1][0].ticks = 100;
+	cost->entries[0][large].ticks = 1000;
+	cost->entries[0][large].samples = 1;
+	cost->entries[1][large].ticks = 100;
+	cost->entries[1][large].samples = 1;
+	g_cost_submitted[0] = g_cost_submitted[1] = NULL;
+
+	rc = spdk_accel_submit_copy(g_ch, dst, src, 512, ut_cost_cb, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_cost_submitted[0] == &task);
+	CU_ASSERT(g_cost_submitted[1] == NULL);
+	spdk_accel_task_complete(&task, 0);
+	g_cost_submitted[0] = NULL;
+
+	rc = spdk_accel_submit_copy(g_ch, dst, src, 0x10000, ut_cost_cb, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_cost_submitted[0] == NULL);
+	CU_ASSERT(g_cost_submitted[1] == &task);
+	CU_ASSERT(task.cost_bucket == large);
+	spdk_accel_task_complete(&task, 0);
+	CU_ASSERT(cost->entries[1][large].samples == 2);
+	g_cost_submitted[1] = NULL;
+
+	/* Fall back to the next cheapest module if the cheapest one is busy */
+	g_cost_submit_rc[1] = -EBUSY;
+	rc = spdk_accel_submit_copy(g_ch, dst, src, 0x10000, ut_cost_cb, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_cost_submitted[0] == &task);
+	CU_ASSERT(task.cost_module == 0);
+	CU_ASSERT(cost->fallbacks == 1);
+	spdk_accel_task_complete(&task, 0);
+	g_cost_submitted[0] = NULL;
+
+	/* Fail if all of them are busy */
+	g_cost_submit_rc[0] = -EBUSY;
+	rc = spdk_accel_submit_copy(g_ch, dst, src, 0x10000, ut_cost_cb, NULL);
+	CU_ASSERT(rc == -EBUSY);
+	CU_ASSERT(cost->fallbacks == 3);
+	g_cost_submit_rc[0] = g_cost_submit_rc[1] = 0;
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+	task.has_aux = false;
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux, link);
+
+	/* Periodically, the more expensive module is used to keep its cost up to date */
+	cost->entries[0][0].ticks = 10;
+	cost->entries[1][0].ticks = 100;
+	cost->submitted[0] = ACCEL_COST_EXPLORE_INTERVAL - 1;
+	rc = spdk_accel_submit_copy(g_ch, dst, src, 512, ut_cost_cb, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_cost_submitted[1] == &task);
+	spdk_accel_task_complete(&task, 0);
+	g_cost_submitted[1] = NULL;
+
+	rc = spdk_accel_submit_copy(g_ch, dst, src, 512, ut_cost_cb, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_cost_submitted[0] == &task);
+	spdk_accel_task_complete(&task, 0);
+	g_cost_submitted[0] = NULL;
+
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+	g_accel_ch->cost[SPDK_ACCEL_OPC_COPY] = NULL;
+	opc->num_modules = 0;
+	free(cost);
+	free(src);
+	free(dst);
+}
+
+struct ut_batch_call {
+	int				module;
+	int				num_tasks;
+	struct spdk_accel_task		*first;
+};
+
+static struct ut_batch_call g_batch_calls[4];
+static int g_batch_num_calls;
+static int g_batch_submit_rc;
+
+static int
+ut_batch_submit(int module, struct spdk_accel_task *task)
+{
+	struct ut_batch_call *call = &g_batch_calls[g_batch_num_calls++];
+	struct spdk_accel_task *next;
+
+	call->module = module;
+	call->first = task;
+	call->num_tasks = 0;
+	if (g_batch_submit_rc != 0) {
+		return g_batch_submit_rc;
+	}
+
+	while (task != NULL) {
+		next = STAILQ_NEXT(task, link);
+		call->num_tasks++;
+		spdk_accel_task_complete(task, 0);
+		task = next;
+	}
+
+	return 0;
+}
+
+static int
+ut_batch_submit_list(struct spdk_io_channel *ch, struct spdk_accel_task *task)
+{
+	return ut_batch_submit(0, task);
+}
+
+static int
+ut_batch_submit_single(struct spdk_io_channel *ch, struct spdk_accel_task *task)
+{
+	CU_ASSERT(STAILQ_NEXT(task, link) == NULL);
+
+	return ut_batch_submit(1, task);
+}
+
+static void
+ut_batch_cb(void *cb_arg, int status)
+{
+	*(int *)cb_arg = status;
+}
+
+static void
+test_accel_batch(void)
+{
+	struct spdk_accel_module_if list_module = {
+		.name = "list",
+		.submit_tasks = ut_batch_submit_list,
+		.supports_task_list = true,
+	};
+	struct spdk_accel_module_if single_module = {
+		.name = "single",
+		.submit_tasks = ut_batch_submit_single,
+	};
+	struct accel_module modules_opc[SPDK_ACCEL_OPC_LAST];
+	struct spdk_io_channel *single_ch = (struct spdk_io_channel *)0xfeedbeef;
+	struct spdk_accel_task task[4] = {}, *tmp;
+	struct spdk_accel_task_aux_data task_aux[4];
+	struct spdk_accel_batch batch;
+	uint8_t src[TEST_SUBMIT_SIZE] = {}, dst[TEST_SUBMIT_SIZE] = {};
+	uint32_t crc_dst;
+	int status[4];
+	int i, rc;
+
+	memcpy(modules_opc, g_modules_opc, sizeof(modules_opc));
+	g_modules_opc[SPDK_ACCEL_OPC_COPY].module = &list_module;
+	g_modules_opc[SPDK_ACCEL_OPC_CRC32C].module = &list_module;
+	g_modules_opc[SPDK_ACCEL_OPC_FILL].module = &single_module;
+	g_accel_ch->module_ch[SPDK_ACCEL_OPC_FILL] = single_ch;
+
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+	for (i = 0; i < 4; i++) {
+		STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task[i], link);
+		SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux[i], link);
+		status[i] = 1;
+	}
+
+	/* Consecutive operations executed by a module accepting task lists are submitted at once */
+	spdk_accel_batch_init(&batch, g_ch);
+	rc = spdk_accel_batch_append_copy(&batch, dst, src, TEST_SUBMIT_SIZE, ut_batch_cb, &status[0]);
+	CU_ASSERT(rc == 0);
+	rc = spdk_accel_batch_append_crc32c(&batch, &crc_dst, src, 0, TEST_SUBMIT_SIZE, ut_batch_cb,
+					    &status[1]);
+	CU_ASSERT(rc == 0);
+	rc = spdk_accel_batch_append_fill(&batch, dst, 0xa5, TEST_SUBMIT_SIZE, ut_batch_cb, &status[2]);
+	CU_ASSERT(rc == 0);
+	rc = spdk_accel_batch_append_copy(&batch, dst, src, TEST_SUBMIT_SIZE, ut_batch_cb, &status[3]);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(batch.count == 4);
+	CU_ASSERT(STAILQ_EMPTY(&g_accel_ch->task_pool));
+
+	/* No more tasks available */
+	rc = spdk_accel_batch_append_copy(&batch, dst, src, TEST_SUBMIT_SIZE, ut_batch_cb, NULL);
+	CU_ASSERT(rc == -ENOMEM);
+	CU_ASSERT(batch.count == 4);
+
+	spdk_accel_batch_submit(&batch);
+	CU_ASSERT(batch.count == 0);
+	CU_ASSERT(STAILQ_EMPTY(&batch.tasks));
+	CU_ASSERT(g_batch_num_calls == 3);
+	CU_ASSERT(g_batch_calls[0].module == 0);
+	CU_ASSERT(g_batch_calls[0].num_tasks == 2);
+	CU_ASSERT(g_batch_calls[0].first == &task[0]);
+	CU_ASSERT(g_batch_calls[1].module == 1);
+	CU_ASSERT(g_batch_calls[1].num_tasks == 1);
+	CU_ASSERT(g_batch_calls[1].first == &task[2]);
+	CU_ASSERT(g_batch_calls[2].module == 0);
+	CU_ASSERT(g_batch_calls[2].num_tasks == 1);
+	CU_ASSERT(g_batch_calls[2].first == &task[3]);
+	for (i = 0; i < 4; i++) {
+		CU_ASSERT(status[i] == 0);
+		status[i] = 1;
+	}
+
+	/* All tasks of a run are completed with an error if the module rejects them */
+	g_batch_num_calls = 0;
+	g_batch_submit_rc = -EINVAL;
+	rc = spdk_accel_batch_append_copy(&batch, dst, src, TEST_SUBMIT_SIZE, ut_batch_cb, &status[0]);
+	CU_ASSERT(rc == 0);
+	rc = spdk_accel_batch_append_copy(&batch, dst, src, TEST_SUBMIT_SIZE, ut_batch_cb, &status[1]);
+	CU_ASSERT(rc == 0);
+	spdk_accel_batch_submit(&batch);
+	CU_ASSERT(g_batch_num_calls == 1);
+	CU_ASSERT(status[0] == -EINVAL);
+	CU_ASSERT(status[1] == -EINVAL);
+	g_batch_submit_rc = 0;
+
+	/* Aborting a batch releases its tasks without executing them */
+	g_batch_num_calls = 0;
+	status[0] = status[1] = 1;
+	rc = spdk_accel_batch_append_copy(&batch, dst, src, TEST_SUBMIT_SIZE, ut_batch_cb, &status[0]);
+	CU_ASSERT(rc == 0);
+	rc = spdk_accel_batch_append_fill(&batch, dst, 0xa5, TEST_SUBMIT_SIZE, ut_batch_cb, &status[1]);
+	CU_ASSERT(rc == 0);
+	spdk_accel_batch_abort(&batch);
+	CU_ASSERT(batch.count == 0);
+	CU_ASSERT(g_batch_num_calls == 0);
+	CU_ASSERT(status[0] == 1);
+	CU_ASSERT(status[1] == 1);
+	i = 0;
+	STAILQ_FOREACH(tmp, &g_accel_ch->task_pool, link) {
+		i++;
+	}
+	CU_ASSERT(i == 4);
+
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+	g_accel_ch->module_ch[SPDK_ACCEL_OPC_FILL] = g_module_ch;
+	memcpy(g_modules_opc, modules_opc, sizeof(modules_opc));
+}
+
+static bool
+_hash_supports_algo(enum spdk_accel_hash_algo algo)
+{
+	return algo == SPDK_ACCEL_HASH_ALGO_SHA256 || algo == SPDK_ACCEL_HASH_ALGO_MURMUR3_128;
+}
+
+static void
+test_spdk_accel_submit_hash(void)
+{
+	const uint8_t sha256_abc[SPDK_ACCEL_SHA256_DIGEST_SIZE] = {
+		0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+		0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+	};
+	const uint8_t murmur3_fox[SPDK_ACCEL_MURMUR3_128_DIGEST_SIZE] = {
+		0x6c, 0x1b, 0x07, 0xbc, 0x7b, 0xbc, 0x4b, 0xe3, 0x47, 0x93, 0x9a, 0xc4, 0xa9, 0x3c, 0x43, 0x7a
+	};
+	char abc[] = "abc";
+	char fox[] = "The quick brown fox jumps over the lazy dog";
+	uint8_t digest[SPDK_ACCEL_SHA256_DIGEST_SIZE];
+	struct iovec iovs[3];
+	struct spdk_accel_task task;
+	struct spdk_accel_task_aux_data task_aux;
+	struct spdk_accel_task *expected_accel_task = NULL;
+	int rc;
+
+	g_module_if.hash_supports_algo = _hash_supports_algo;
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+
+	iovs[0].iov_base = abc;
+	iovs[0].iov_len = strlen(abc);
+
+	/* Fail with no tasks on _get_task() */
+	rc = spdk_accel_submit_hash(g_ch, SPDK_ACCEL_HASH_ALGO_SHA256, digest, iovs, 1, NULL, NULL);
+	CU_ASSERT(rc == -ENOMEM);
+
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux, link);
+
+	/* Unknown algorithm */
+	rc = spdk_accel_submit_hash(g_ch, SPDK_ACCEL_HASH_ALGO_MURMUR3_128 + 1, digest, iovs, 1,
+				    NULL, NULL);
+	CU_ASSERT(rc == -ENOTSUP);
+
+	/* No data */
+	rc = spdk_accel_submit_hash(g_ch, SPDK_ACCEL_HASH_ALGO_SHA256, digest, iovs, 0, NULL, NULL);
+	CU_ASSERT(rc == -EINVAL);
+
+	/* SHA-256 */
+	memset(digest, 0, sizeof(digest));
+	rc = spdk_accel_submit_hash(g_ch, SPDK_ACCEL_HASH_ALGO_SHA256, digest, iovs, 1, NULL, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(task.op_code == SPDK_ACCEL_OPC_HASH);
+	CU_ASSERT(memcmp(digest, sha256_abc, sizeof(sha256_abc)) == 0);
+	expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+	CU_ASSERT(expected_accel_task->status == 0);
+
+	/* SHA-256 of the same data split into several buffers */
+	iovs[0].iov_len = 1;
+	iovs[1].iov_base = &abc[1];
+	iovs[1].iov_len = 0;
+	iovs[2].iov_base = &abc[1];
+	iovs[2].iov_len = 2;
+	memset(digest, 0, sizeof(digest));
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	rc = spdk_accel_submit_hash(g_ch, SPDK_ACCEL_HASH_ALGO_SHA256, digest, iovs, 3, NULL, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(memcmp(digest, sha256_abc, sizeof(sha256_abc)) == 0);
+	expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+
+	/* MurmurHash3 with a 16B block straddling the buffers and a partial tail */
+	iovs[0].iov_base = fox;
+	iovs[0].iov_len = 5;
+	iovs[1].iov_base = &fox[5];
+	iovs[1].iov_len = 20;
+	iovs[2].iov_base = &fox[25];
+	iovs[2].iov_len = strlen(fox) - 25;
+	memset(digest, 0, sizeof(digest));
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	rc = spdk_accel_submit_hash(g_ch, SPDK_ACCEL_HASH_ALGO_MURMUR3_128, digest, iovs, 3,
+				    NULL, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(memcmp(digest, murmur3_fox, sizeof(murmur3_fox)) == 0);
+	expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+	CU_ASSERT(expected_accel_task->status == 0);
+
+	/* Same hash in a single buffer */
+	iovs[0].iov_len = strlen(fox);
+	memset(digest, 0, sizeof(digest));
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	rc = spdk_accel_submit_hash(g_ch, SPDK_ACCEL_HASH_ALGO_MURMUR3_128, digest, iovs, 1,
+				    NULL, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(memcmp(digest, murmur3_fox, sizeof(murmur3_fox)) == 0);
+	expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+
+	g_module_if.hash_supports_algo = NULL;
+#ifdef SPDK_CONFIG_ISAL_CRYPTO
+	free(g_sw_ch->sha256_mgr);
+	g_sw_ch->sha256_mgr = NULL;
+	free(g_sw_ch->sha256_jobs);
+	g_sw_ch->sha256_jobs = NULL;
+#else
+	EVP_MD_CTX_free(g_sw_ch->sha256_ctx);
+	g_sw_ch->sha256_ctx = NULL;
+#endif
+}
+
+#define TEST_CDC_SIZE (64 * 1024)
+#define TEST_CDC_SHIFT 100
+#define TEST_CDC_MAX_CUTS (TEST_CDC_SIZE / 256 + 1)
+
+static uint32_t
+ut_cdc(uint8_t *buf, uint32_t len, const struct spdk_accel_cdc_params *params, uint32_t *cuts,
+       uint32_t max_cuts, int *status)
+{
+	struct spdk_accel_task task;
+	struct spdk_accel_task_aux_data task_aux;
+	struct spdk_accel_task *expected_accel_task;
+	struct iovec iovs[2];
+	uint32_t num_cuts = 0;
+	int rc;
+
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux, link);
+
+	/* Split the data to make sure the hash is carried across buffers */
+	iovs[0].iov_base = buf;
+	iovs[0].iov_len = len / 3;
+	iovs[1].iov_base = buf + len / 3;
+	iovs[1].iov_len = len - len / 3;
+
+	rc = spdk_accel_submit_cdc(g_ch, params, iovs, 2, cuts, max_cuts, &num_cuts, NULL, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(task.op_code == SPDK_ACCEL_OPC_CDC);
+	expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+	*status = expected_accel_task->status;
+
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+
+	return num_cuts;
+}
+
+static void
+test_accel_cdc(void)
+{
+	struct spdk_accel_cdc_params params = { .min_size = 256, .avg_size = 1024, .max_size = 4096 };
+	uint32_t cuts[TEST_CDC_MAX_CUTS], shifted_cuts[TEST_CDC_MAX_CUTS];
+	uint32_t num_cuts, num_shifted_cuts, prev, i, j, matched;
+	struct iovec iov;
+	uint8_t *buf;
+	int status, rc;
+
+	sw_accel_cdc_init_gear();
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+
+	buf = calloc(1, TEST_CDC_SIZE + TEST_CDC_SHIFT);
+	SPDK_CU_ASSERT_FATAL(buf != NULL);
+	srand(0);
+	for (i = 0; i < TEST_CDC_SIZE + TEST_CDC_SHIFT; i++) {
+		buf[i] = rand();
+	}
+
+	/* Invalid parameters */
+	iov.iov_base = buf;
+	iov.iov_len = TEST_CDC_SIZE;
+	params.avg_size = 1000;
+	rc = spdk_accel_submit_cdc(g_ch, &params, &iov, 1, cuts, TEST_CDC_MAX_CUTS, &num_cuts,
+				   NULL, NULL);
+	CU_ASSERT(rc == -EINVAL);
+	params.avg_size = 8192;
+	rc = spdk_accel_submit_cdc(g_ch, &params, &iov, 1, cuts, TEST_CDC_MAX_CUTS, &num_cuts,
+				   NULL, NULL);
+	CU_ASSERT(rc == -EINVAL);
+	params.avg_size = 1024;
+	params.min_size = 0;
+	rc = spdk_accel_submit_cdc(g_ch, &params, &iov, 1, cuts, TEST_CDC_MAX_CUTS, &num_cuts,
+				   NULL, NULL);
+	CU_ASSERT(rc == -EINVAL);
+	params.min_size = 256;
+
+	/* All chunks are within [min_size, max_size], except for the last one, which ends with
+	 * the data */
+	num_cuts = ut_cdc(buf + TEST_CDC_SHIFT, TEST_CDC_SIZE, &params, cuts, TEST_CDC_MAX_CUTS,
+			  &status);
+	CU_ASSERT(status == 0);
+	CU_ASSERT(num_cuts > TEST_CDC_SIZE / params.max_size);
+	CU_ASSERT(num_cuts <= TEST_CDC_SIZE / params.min_size + 1);
+	for (i = 0, prev = 0; i < num_cuts; i++) {
+		CU_ASSERT(cuts[i] - prev <= params.max_size);
+		if (i < num_cuts - 1) {
+			CU_ASSERT(cuts[i] - prev >= params.min_size);
+		}
+		prev = cuts[i];
+	}
+	CU_ASSERT(cuts[num_cuts - 1] == TEST_CDC_SIZE);
+
+	/* Prepending data only moves the boundaries of the first chunks */
+	num_shifted_cuts = ut_cdc(buf, TEST_CDC_SIZE + TEST_CDC_SHIFT, &params, shifted_cuts,
+				  TEST_CDC_MAX_CUTS, &status);
+	CU_ASSERT(status == 0);
+	for (i = 0, j = 0, matched = 0; i < num_cuts && j < num_shifted_cuts;) {
+		if (cuts[i] + TEST_CDC_SHIFT == shifted_cuts[j]) {
+			matched++;
+			i++;
+			j++;
+		} else if (cuts[i] + TEST_CDC_SHIFT < shifted_cuts[j]) {
+			i++;
+		} else {
+			j++;
+		}
+	}
+	CU_ASSERT(matched >= num_cuts - 2);
+
+	/* Not enough space for the cut points */
+	ut_cdc(buf, TEST_CDC_SIZE, &params, cuts, num_cuts / 2, &status);
+	CU_ASSERT(status == -ENOSPC);
+
+	/* Data shorter than min_size makes a single chunk */
+	num_cuts = ut_cdc(buf, 100, &params, cuts, TEST_CDC_MAX_CUTS, &status);
+	CU_ASSERT(status == 0);
+	CU_ASSERT(num_cuts == 1);
+	CU_ASSERT(cuts[0] == 100);
+
+	free(buf);
+}
+
 static void
 test_spdk_accel_module_find_by_name(void)
 {
@@ -955,6 +1512,9 @@ test_sequence_append_error(void)
 	struct spdk_io_channel *ioch;
 	struct accel_io_channel *accel_ch;
 	struct iovec src_iovs, dst_iovs;
+	struct spdk_accel_cdc_params cdc_params = { .min_size = 256, .avg_size = 1024, .max_size = 4096 };
+	uint32_t cuts[4], num_cuts;
+	uint8_t digest[SPDK_ACCEL_SHA256_DIGEST_SIZE];
 	char buf[4096];
 	STAILQ_HEAD(, spdk_accel_task) tasks = STAILQ_HEAD_INITIALIZER(tasks);
 	SLIST_HEAD(, spdk_accel_sequence) seqs = SLIST_HEAD_INITIALIZER(seqs);
@@ -1019,6 +1579,30 @@ test_sequence_append_error(void)
 	CU_ASSERT_PTR_NULL(seq);
 
 	STAILQ_SWAP(&tasks, &accel_ch->task_pool, spdk_accel_task);
+	SLIST_SWAP(&seqs, &accel_ch->seq_pool, spdk_accel_sequence);
+
+	/* Check that hash and CDC operations reject missing source buffers */
+	src_iovs.iov_base = buf;
+	src_iovs.iov_len = sizeof(buf);
+	rc = spdk_accel_append_hash(&seq, ioch, SPDK_ACCEL_HASH_ALGO_SHA256, digest, NULL, 1,
+				    NULL, NULL, ut_sequence_step_cb, NULL);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+	CU_ASSERT_PTR_NULL(seq);
+
+	rc = spdk_accel_append_hash(&seq, ioch, SPDK_ACCEL_HASH_ALGO_SHA256, digest, &src_iovs, 0,
+				    NULL, NULL, ut_sequence_step_cb, NULL);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+	CU_ASSERT_PTR_NULL(seq);
+
+	rc = spdk_accel_append_cdc(&seq, ioch, &cdc_params, NULL, 1, NULL, NULL, cuts,
+				   SPDK_COUNTOF(cuts), &num_cuts, ut_sequence_step_cb, NULL);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+	CU_ASSERT_PTR_NULL(seq);
+
+	rc = spdk_accel_append_cdc(&seq, ioch, &cdc_params, &src_iovs, 0, NULL, NULL, cuts,
+				   SPDK_COUNTOF(cuts), &num_cuts, ut_sequence_step_cb, NULL);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+	CU_ASSERT_PTR_NULL(seq);
 
 	spdk_put_io_channel(ioch);
 	poll_threads();
@@ -4109,6 +4693,77 @@ test_sequence_crc32(void)
 	g_seq_operations[SPDK_ACCEL_OPC_DECOMPRESS].count = 0;
 	g_seq_operations[SPDK_ACCEL_OPC_COPY].count = 0;
 
+	/* Check copy+crc when only one of the operations has a callback - the two operations
+	 * should be fused into a single copy_crc32c. */
+	seq = NULL;
+	completed = 0;
+	crc = 0;
+	memset(buf, 0x5a, sizeof(buf));
+	memset(&tmp[0], 0, sizeof(tmp[0]));
+
+	dst_iovs[0].iov_base = tmp[0];
+	dst_iovs[0].iov_len = sizeof(tmp[0]);
+	src_iovs[0].iov_base = buf;
+	src_iovs[0].iov_len = sizeof(buf);
+	rc = spdk_accel_append_copy(&seq, ioch, &dst_iovs[0], 1, NULL, NULL,
+				    &src_iovs[0], 1, NULL, NULL, NULL, NULL);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	src_iovs[1].iov_base = tmp[0];
+	src_iovs[1].iov_len = sizeof(tmp[0]);
+	rc = spdk_accel_append_crc32c(&seq, ioch, &crc, &src_iovs[1], 1, NULL, NULL, 0,
+				      ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 1);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count, 1);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY].count, 0);
+	CU_ASSERT_EQUAL(memcmp(buf, tmp[0], sizeof(buf)), 0);
+	CU_ASSERT_EQUAL(crc, spdk_crc32c_update(buf, sizeof(buf), ~0u));
+	g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count = 0;
+
+	/* Same thing with crc+copy */
+	seq = NULL;
+	completed = 0;
+	crc = 0;
+	memset(buf, 0, sizeof(buf));
+	memset(&tmp[0], 0xa5, sizeof(tmp[0]));
+
+	src_iovs[0].iov_base = tmp[0];
+	src_iovs[0].iov_len = sizeof(tmp[0]);
+	rc = spdk_accel_append_crc32c(&seq, ioch, &crc, &src_iovs[0], 1, NULL, NULL, 0,
+				      ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	dst_iovs[1].iov_base = buf;
+	dst_iovs[1].iov_len = sizeof(buf);
+	src_iovs[1].iov_base = tmp[0];
+	src_iovs[1].iov_len = sizeof(tmp[0]);
+	rc = spdk_accel_append_copy(&seq, ioch, &dst_iovs[1], 1, NULL, NULL,
+				    &src_iovs[1], 1, NULL, NULL, NULL, NULL);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 1);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count, 1);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY].count, 0);
+	CU_ASSERT_EQUAL(crc, spdk_crc32c_update(tmp[0], sizeof(tmp[0]), ~0u));
+	CU_ASSERT_EQUAL(memcmp(buf, tmp[0], sizeof(buf)), 0);
+	g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count = 0;
+
 	for (i = 0; i < SPDK_ACCEL_OPC_LAST; ++i) {
 		g_modules_opc[i] = modules[i];
 	}
@@ -4436,6 +5091,10 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_spdk_accel_submit_crc32cv);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_copy_crc32c);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_xor);
+	CU_ADD_TEST(suite, test_accel_cost_model);
+	CU_ADD_TEST(suite, test_accel_batch);
+	CU_ADD_TEST(suite, test_spdk_accel_submit_hash);
+	CU_ADD_TEST(suite, test_accel_cdc);
 	CU_ADD_TEST(suite, test_spdk_accel_module_find_by_name);
 	CU_ADD_TEST(suite, test_spdk_accel_module_register);
 
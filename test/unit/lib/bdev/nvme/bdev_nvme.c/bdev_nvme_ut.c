@@ -1150,12 +1150,20 @@ spdk_nvme_ns_cmd_write_zeroes(struct spdk_nvme_ns *ns, struct spdk_nvme_qpair *q
 	return ut_submit_nvme_request(ns, qpair, SPDK_NVME_OPC_WRITE_ZEROES, cb_fn, cb_arg);
 }
 
+static struct spdk_nvme_scc_source_range g_ut_copy_ranges[SPDK_NVME_SIMPLE_COPY_MAX_RANGES];
+static uint16_t g_ut_copy_num_ranges;
+static uint64_t g_ut_copy_dest_lba;
+
 int
 spdk_nvme_ns_cmd_copy(struct spdk_nvme_ns *ns, struct spdk_nvme_qpair *qpair,
 		      const struct spdk_nvme_scc_source_range *ranges,
 		      uint16_t num_ranges, uint64_t dest_lba,
 		      spdk_nvme_cmd_cb cb_fn, void *cb_arg)
 {
+	memcpy(g_ut_copy_ranges, ranges, num_ranges * sizeof(*ranges));
+	g_ut_copy_num_ranges = num_ranges;
+	g_ut_copy_dest_lba = dest_lba;
+
 	return ut_submit_nvme_request(ns, qpair, SPDK_NVME_OPC_COPY, cb_fn, cb_arg);
 }
 
@@ -6194,6 +6202,195 @@ test_find_io_path_min_qd(void)
 	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path1);
 }
 
+static void
+test_find_io_path_service_time(void)
+{
+	struct nvme_bdev_channel nbdev_ch = {
+		.io_path_list = STAILQ_HEAD_INITIALIZER(nbdev_ch.io_path_list),
+		.mp_policy = BDEV_NVME_MP_POLICY_ACTIVE_ACTIVE,
+		.mp_selector = BDEV_NVME_MP_SELECTOR_SERVICE_TIME,
+	};
+	struct spdk_nvme_qpair qpair1 = {}, qpair2 = {}, qpair3 = {};
+	struct spdk_nvme_ctrlr ctrlr1 = {}, ctrlr2 = {}, ctrlr3 = {};
+	struct spdk_nvme_ns ns1 = {}, ns2 = {}, ns3 = {};
+	struct nvme_ctrlr nvme_ctrlr1 = { .ctrlr = &ctrlr1, };
+	struct nvme_ctrlr nvme_ctrlr2 = { .ctrlr = &ctrlr2, };
+	struct nvme_ctrlr nvme_ctrlr3 = { .ctrlr = &ctrlr3, };
+	struct nvme_ctrlr_channel ctrlr_ch1 = {};
+	struct nvme_ctrlr_channel ctrlr_ch2 = {};
+	struct nvme_ctrlr_channel ctrlr_ch3 = {};
+	struct nvme_qpair nvme_qpair1 = { .ctrlr_ch = &ctrlr_ch1, .ctrlr = &nvme_ctrlr1, .qpair = &qpair1, };
+	struct nvme_qpair nvme_qpair2 = { .ctrlr_ch = &ctrlr_ch2, .ctrlr = &nvme_ctrlr2, .qpair = &qpair2, };
+	struct nvme_qpair nvme_qpair3 = { .ctrlr_ch = &ctrlr_ch3, .ctrlr = &nvme_ctrlr3, .qpair = &qpair3, };
+	struct nvme_ns nvme_ns1 = { .ns = &ns1, }, nvme_ns2 = { .ns = &ns2, }, nvme_ns3 = { .ns = &ns3, };
+	struct nvme_io_path io_path1 = { .qpair = &nvme_qpair1, .nvme_ns = &nvme_ns1, .nbdev_ch = &nbdev_ch, };
+	struct nvme_io_path io_path2 = { .qpair = &nvme_qpair2, .nvme_ns = &nvme_ns2, .nbdev_ch = &nbdev_ch, };
+	struct nvme_io_path io_path3 = { .qpair = &nvme_qpair3, .nvme_ns = &nvme_ns3, .nbdev_ch = &nbdev_ch, };
+	struct nvme_bdev_io bio = {};
+
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path1, stailq);
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path2, stailq);
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path3, stailq);
+
+	nvme_ns1.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nvme_ns2.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nvme_ns3.ana_state = SPDK_NVME_ANA_NON_OPTIMIZED_STATE;
+
+	/* A path which has no latency sample yet is probed first. */
+	io_path1.ewma_latency_ticks = 100;
+	io_path2.ewma_latency_ticks = 0;
+	io_path3.ewma_latency_ticks = 0;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path2);
+
+	/* The expected service time is latency * (outstanding + 1). ANA optimized
+	 * paths are preferred even if a non-optimized path is faster.
+	 */
+	io_path2.ewma_latency_ticks = 40;
+	qpair1.num_outstanding_reqs = 0;
+	qpair2.num_outstanding_reqs = 1;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path2);
+
+	qpair2.num_outstanding_reqs = 2;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path1);
+
+	nvme_ns1.ana_state = SPDK_NVME_ANA_INACCESSIBLE_STATE;
+	nvme_ns2.ana_state = SPDK_NVME_ANA_INACCESSIBLE_STATE;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path3);
+
+	/* The first completion sets the moving average and later ones are blended in. */
+	bio.io_path = &io_path3;
+	bio.submit_tsc = spdk_get_ticks();
+	bdev_nvme_update_io_path_latency(&bio);
+	CU_ASSERT(io_path3.ewma_latency_ticks == 1);
+
+	io_path3.ewma_latency_ticks = 80;
+	bdev_nvme_update_io_path_latency(&bio);
+	CU_ASSERT(io_path3.ewma_latency_ticks == 70);
+
+	/* The moving average is not updated if the io_path was removed. */
+	io_path3.nbdev_ch = NULL;
+	bdev_nvme_update_io_path_latency(&bio);
+	CU_ASSERT(io_path3.ewma_latency_ticks == 70);
+}
+
+static void
+test_find_io_path_numa(void)
+{
+	struct nvme_bdev_channel nbdev_ch = {
+		.io_path_list = STAILQ_HEAD_INITIALIZER(nbdev_ch.io_path_list),
+		.mp_policy = BDEV_NVME_MP_POLICY_ACTIVE_ACTIVE,
+		.mp_selector = BDEV_NVME_MP_SELECTOR_NUMA,
+		.numa_id = 1,
+	};
+	struct spdk_nvme_qpair qpair1 = {}, qpair2 = {}, qpair3 = {};
+	struct spdk_nvme_ctrlr ctrlr1 = {}, ctrlr2 = {}, ctrlr3 = {};
+	struct spdk_nvme_ns ns1 = {}, ns2 = {}, ns3 = {};
+	struct nvme_ctrlr nvme_ctrlr1 = { .ctrlr = &ctrlr1, };
+	struct nvme_ctrlr nvme_ctrlr2 = { .ctrlr = &ctrlr2, };
+	struct nvme_ctrlr nvme_ctrlr3 = { .ctrlr = &ctrlr3, };
+	struct nvme_ctrlr_channel ctrlr_ch1 = {};
+	struct nvme_ctrlr_channel ctrlr_ch2 = {};
+	struct nvme_ctrlr_channel ctrlr_ch3 = {};
+	struct nvme_qpair nvme_qpair1 = { .ctrlr_ch = &ctrlr_ch1, .ctrlr = &nvme_ctrlr1, .qpair = &qpair1, };
+	struct nvme_qpair nvme_qpair2 = { .ctrlr_ch = &ctrlr_ch2, .ctrlr = &nvme_ctrlr2, .qpair = &qpair2, };
+	struct nvme_qpair nvme_qpair3 = { .ctrlr_ch = &ctrlr_ch3, .ctrlr = &nvme_ctrlr3, .qpair = &qpair3, };
+	struct nvme_ns nvme_ns1 = { .ns = &ns1, }, nvme_ns2 = { .ns = &ns2, }, nvme_ns3 = { .ns = &ns3, };
+	struct nvme_io_path io_path1 = { .qpair = &nvme_qpair1, .nvme_ns = &nvme_ns1, .numa_id = 0, };
+	struct nvme_io_path io_path2 = { .qpair = &nvme_qpair2, .nvme_ns = &nvme_ns2, .numa_id = 1, };
+	struct nvme_io_path io_path3 = { .qpair = &nvme_qpair3, .nvme_ns = &nvme_ns3, .numa_id = 1, };
+
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path1, stailq);
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path2, stailq);
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path3, stailq);
+
+	nvme_ns1.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nvme_ns2.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nvme_ns3.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+
+	/* A local path is preferred even if a remote path has fewer outstanding I/Os. */
+	qpair1.num_outstanding_reqs = 0;
+	qpair2.num_outstanding_reqs = 8;
+	qpair3.num_outstanding_reqs = 4;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path3);
+
+	qpair2.num_outstanding_reqs = 2;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path2);
+
+	/* Fall back to a remote path if no local path is available. */
+	nvme_ns2.ana_state = SPDK_NVME_ANA_INACCESSIBLE_STATE;
+	nvme_ns3.ana_state = SPDK_NVME_ANA_INACCESSIBLE_STATE;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path1);
+
+	/* ANA state takes precedence over locality. */
+	nvme_ns1.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nvme_ns2.ana_state = SPDK_NVME_ANA_NON_OPTIMIZED_STATE;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path1);
+
+	/* A path of unknown locality is treated as local. */
+	nvme_ns2.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	io_path1.numa_id = SPDK_ENV_NUMA_ID_ANY;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path1);
+}
+
+static void
+test_find_io_path_weighted(void)
+{
+	struct nvme_bdev_channel nbdev_ch = {
+		.io_path_list = STAILQ_HEAD_INITIALIZER(nbdev_ch.io_path_list),
+		.mp_policy = BDEV_NVME_MP_POLICY_ACTIVE_ACTIVE,
+		.mp_selector = BDEV_NVME_MP_SELECTOR_WEIGHTED,
+	};
+	struct spdk_nvme_qpair qpair1 = {}, qpair2 = {}, qpair3 = {};
+	struct spdk_nvme_ctrlr ctrlr1 = {}, ctrlr2 = {}, ctrlr3 = {};
+	struct spdk_nvme_ns ns1 = {}, ns2 = {}, ns3 = {};
+	struct nvme_ctrlr nvme_ctrlr1 = { .ctrlr = &ctrlr1, };
+	struct nvme_ctrlr nvme_ctrlr2 = { .ctrlr = &ctrlr2, };
+	struct nvme_ctrlr nvme_ctrlr3 = { .ctrlr = &ctrlr3, };
+	struct nvme_ctrlr_channel ctrlr_ch1 = {};
+	struct nvme_ctrlr_channel ctrlr_ch2 = {};
+	struct nvme_ctrlr_channel ctrlr_ch3 = {};
+	struct nvme_qpair nvme_qpair1 = { .ctrlr_ch = &ctrlr_ch1, .ctrlr = &nvme_ctrlr1, .qpair = &qpair1, };
+	struct nvme_qpair nvme_qpair2 = { .ctrlr_ch = &ctrlr_ch2, .ctrlr = &nvme_ctrlr2, .qpair = &qpair2, };
+	struct nvme_qpair nvme_qpair3 = { .ctrlr_ch = &ctrlr_ch3, .ctrlr = &nvme_ctrlr3, .qpair = &qpair3, };
+	struct nvme_ns nvme_ns1 = { .ns = &ns1, }, nvme_ns2 = { .ns = &ns2, }, nvme_ns3 = { .ns = &ns3, };
+	struct nvme_io_path io_path1 = { .qpair = &nvme_qpair1, .nvme_ns = &nvme_ns1, .weight = 2, };
+	struct nvme_io_path io_path2 = { .qpair = &nvme_qpair2, .nvme_ns = &nvme_ns2, .weight = 1, };
+	struct nvme_io_path io_path3 = { .qpair = &nvme_qpair3, .nvme_ns = &nvme_ns3, .weight = 5, };
+	int i, count1 = 0, count2 = 0;
+
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path1, stailq);
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path2, stailq);
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path3, stailq);
+
+	nvme_ns1.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nvme_ns2.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nvme_ns3.ana_state = SPDK_NVME_ANA_NON_OPTIMIZED_STATE;
+
+	/* Smooth weighted round-robin interleaves paths as 1, 2, 1. */
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path1);
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path2);
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path1);
+
+	/* I/Os are distributed in proportion to weights, and the non-optimized path is not used. */
+	for (i = 0; i < 300; i++) {
+		if (bdev_nvme_find_io_path(&nbdev_ch) == &io_path1) {
+			count1++;
+		} else {
+			count2++;
+		}
+	}
+	CU_ASSERT(count1 == 200);
+	CU_ASSERT(count2 == 100);
+
+	/* Only the non-optimized path is left. */
+	nvme_ns1.ana_state = SPDK_NVME_ANA_INACCESSIBLE_STATE;
+	nvme_ns2.ana_state = SPDK_NVME_ANA_INACCESSIBLE_STATE;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path3);
+
+	nvme_ns3.ana_state = SPDK_NVME_ANA_INACCESSIBLE_STATE;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == NULL);
+}
+
 static void
 test_disable_auto_failback(void)
 {
@@ -7555,6 +7752,80 @@ test_io_path_is_current(void)
 	CU_ASSERT(nvme_io_path_is_current(&io_path3) == false);
 }
 
+static void
+test_copy_multiple_ranges(void)
+{
+	struct spdk_nvme_ns_data nsdata = { .mssrl = 16, .msrc = 3, };
+	struct spdk_nvme_ctrlr ctrlr = { .nsdata = &nsdata, };
+	struct spdk_nvme_ns ns = { .ctrlr = &ctrlr, .id = 1, };
+	struct spdk_nvme_qpair qpair = {};
+	struct nvme_qpair nvme_qpair = { .qpair = &qpair, };
+	struct nvme_ns nvme_ns = { .ns = &ns, };
+	struct nvme_io_path io_path = { .qpair = &nvme_qpair, .nvme_ns = &nvme_ns, };
+	struct nvme_bdev_io bio = { .io_path = &io_path, };
+	struct ut_nvme_req *req;
+	int rc;
+
+	TAILQ_INIT(&qpair.outstanding_reqs);
+
+	/* MSSRL * (MSRC + 1) bounds the maximum copy size, and MCL does too if reported. */
+	CU_ASSERT(bdev_nvme_get_max_copy(&nsdata) == 64);
+	nsdata.mcl = 40;
+	CU_ASSERT(bdev_nvme_get_max_copy(&nsdata) == 40);
+	nsdata.mcl = 0;
+
+	/* A copy which fits into a single source range. */
+	rc = bdev_nvme_copy(&bio, 100, 10, 16);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_ut_copy_num_ranges == 1);
+	CU_ASSERT(g_ut_copy_dest_lba == 100);
+	CU_ASSERT(g_ut_copy_ranges[0].slba == 10);
+	CU_ASSERT(g_ut_copy_ranges[0].nlb == 15);
+
+	/* A larger copy is described by multiple source ranges of a single command. */
+	rc = bdev_nvme_copy(&bio, 200, 20, 40);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_ut_copy_num_ranges == 3);
+	CU_ASSERT(g_ut_copy_dest_lba == 200);
+	CU_ASSERT(g_ut_copy_ranges[0].slba == 20);
+	CU_ASSERT(g_ut_copy_ranges[0].nlb == 15);
+	CU_ASSERT(g_ut_copy_ranges[1].slba == 36);
+	CU_ASSERT(g_ut_copy_ranges[1].nlb == 15);
+	CU_ASSERT(g_ut_copy_ranges[2].slba == 52);
+	CU_ASSERT(g_ut_copy_ranges[2].nlb == 7);
+	CU_ASSERT(qpair.num_outstanding_reqs == 2);
+
+	/* If MSSRL is not reported, each range is limited by the NLB field. */
+	nsdata.mssrl = 0;
+	CU_ASSERT(bdev_nvme_get_max_copy(&nsdata) == 4 * SPDK_NVME_SIMPLE_COPY_RANGE_MAX_BLOCKS);
+
+	rc = bdev_nvme_copy(&bio, 0, 0, SPDK_NVME_SIMPLE_COPY_RANGE_MAX_BLOCKS + 1);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_ut_copy_num_ranges == 2);
+	CU_ASSERT(g_ut_copy_ranges[0].nlb == UINT16_MAX);
+	CU_ASSERT(g_ut_copy_ranges[1].slba == SPDK_NVME_SIMPLE_COPY_RANGE_MAX_BLOCKS);
+	CU_ASSERT(g_ut_copy_ranges[1].nlb == 0);
+
+	/* Up to MSRC + 1 ranges are described by a single command. */
+	nsdata.mssrl = 1;
+	rc = bdev_nvme_copy(&bio, 300, 30, 4);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_ut_copy_num_ranges == 4);
+	CU_ASSERT(g_ut_copy_ranges[3].slba == 33);
+	CU_ASSERT(g_ut_copy_ranges[3].nlb == 0);
+
+	/* Too many ranges for a single command. */
+	rc = bdev_nvme_copy(&bio, 0, 0, 5);
+	CU_ASSERT(rc == -EINVAL);
+	rc = bdev_nvme_copy(&bio, 0, 0, SPDK_NVME_SIMPLE_COPY_MAX_RANGES + 1);
+	CU_ASSERT(rc == -EINVAL);
+
+	while ((req = TAILQ_FIRST(&qpair.outstanding_reqs)) != NULL) {
+		TAILQ_REMOVE(&qpair.outstanding_reqs, req, tailq);
+		free(req);
+	}
+}
+
 static void
 test_bdev_reset_abort_io(void)
 {
@@ -7771,6 +8042,9 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_set_preferred_path);
 	CU_ADD_TEST(suite, test_find_next_io_path);
 	CU_ADD_TEST(suite, test_find_io_path_min_qd);
+	CU_ADD_TEST(suite, test_find_io_path_service_time);
+	CU_ADD_TEST(suite, test_find_io_path_numa);
+	CU_ADD_TEST(suite, test_find_io_path_weighted);
 	CU_ADD_TEST(suite, test_disable_auto_failback);
 	CU_ADD_TEST(suite, test_set_multipath_policy);
 	CU_ADD_TEST(suite, test_uuid_generation);
@@ -7783,6 +8057,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_ns_remove_during_reset);
 	CU_ADD_TEST(suite, test_io_path_is_current);
 	CU_ADD_TEST(suite, test_bdev_reset_abort_io);
+	CU_ADD_TEST(suite, test_copy_multiple_ranges);
 
 	allocate_threads(3);
 	set_thread(0);
@@ -385,6 +385,157 @@ test_next_xfer_addr(void)
 	cleanup_band();
 }
 
+static void
+setup_gc_bands(void)
+{
+	struct ftl_band *band;
+	uint64_t i;
+
+	g_dev = test_init_ftl_dev(&g_geo);
+	g_dev->sb = calloc(1, sizeof(*g_dev->sb));
+	SPDK_CU_ASSERT_FATAL(g_dev->sb != NULL);
+	g_dev->sb_shm = calloc(1, sizeof(*g_dev->sb_shm));
+	SPDK_CU_ASSERT_FATAL(g_dev->sb_shm != NULL);
+	g_dev->sb_shm->gc_info.current_band_id = FTL_BAND_ID_INVALID;
+	g_dev->sb_shm->gc_info.band_id_high_prio = FTL_BAND_ID_INVALID;
+	g_dev->sb_shm->gc_info.band_phys_id = FTL_BAND_PHYS_ID_INVALID;
+
+	/* Group the bands by two, dropping the last one */
+	g_dev->num_logical_bands_in_physical = 2;
+	g_dev->num_bands--;
+
+	for (i = 0; i < ftl_get_num_bands(g_dev); i++) {
+		band = &g_dev->bands[i];
+		band->dev = g_dev;
+		band->id = i;
+		band->phys_id = i / 2;
+		band->md->state = FTL_BAND_STATE_CLOSED;
+		band->p2l_map.num_valid = ftl_band_user_blocks(band);
+		TAILQ_INSERT_TAIL(&g_dev->shut_bands, band, queue_entry);
+	}
+}
+
+static void
+cleanup_gc_bands(void)
+{
+	ftl_band_gc_index_fini(g_dev);
+	free(g_dev->sb);
+	free(g_dev->sb_shm);
+	g_dev->num_bands++;
+	test_free_ftl_dev(g_dev);
+}
+
+static void
+test_gc_victim_greedy(void)
+{
+	struct ftl_band *band;
+	uint64_t user_blocks, i;
+	int rc;
+
+	setup_gc_bands();
+	user_blocks = ftl_band_user_blocks(&g_dev->bands[0]);
+
+	/* Physical band 5 is half invalid, physical band 7 has 3/8 of invalid blocks */
+	g_dev->bands[10].p2l_map.num_valid = user_blocks / 2;
+	g_dev->bands[11].p2l_map.num_valid = user_blocks / 2;
+	g_dev->bands[14].p2l_map.num_valid = user_blocks / 4;
+
+	rc = ftl_band_gc_index_init(g_dev);
+	CU_ASSERT_EQUAL(rc, 0);
+	CU_ASSERT_EQUAL(g_dev->gc_index.num_phys, ftl_get_num_bands(g_dev) / 2);
+	CU_ASSERT_EQUAL(g_dev->gc_index.phys[0].bucket, FTL_BAND_GC_BUCKETS);
+	CU_ASSERT_EQUAL(g_dev->gc_index.phys[5].num_invalid, 2 * (user_blocks - user_blocks / 2));
+	CU_ASSERT_EQUAL(g_dev->gc_index.phys[7].num_invalid, user_blocks - user_blocks / 4);
+	CU_ASSERT(g_dev->gc_index.phys[5].bucket > g_dev->gc_index.phys[7].bucket);
+
+	/* Both logical bands of the most invalid physical band are relocated first */
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_EQUAL(band, &g_dev->bands[10]);
+	CU_ASSERT(band->reloc);
+	CU_ASSERT_EQUAL(g_dev->gc_index.phys[5].num_invalid, user_blocks - user_blocks / 2);
+
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_EQUAL(band, &g_dev->bands[11]);
+	CU_ASSERT_EQUAL(g_dev->gc_index.phys[5].num_invalid, 0);
+	CU_ASSERT_EQUAL(g_dev->gc_index.phys[5].bucket, FTL_BAND_GC_BUCKETS);
+
+	/* Invalidating blocks moves the physical band up in the index */
+	g_dev->bands[3].p2l_map.num_valid = 0;
+	for (i = 0; i < user_blocks; i++) {
+		ftl_band_gc_index_invalidate(&g_dev->bands[2]);
+	}
+	CU_ASSERT_EQUAL(g_dev->gc_index.phys[1].num_invalid, user_blocks);
+	CU_ASSERT(g_dev->gc_index.phys[1].bucket > g_dev->gc_index.phys[7].bucket);
+
+	/* Blocks of bands under relocation aren't counted */
+	ftl_band_gc_index_invalidate(&g_dev->bands[10]);
+	CU_ASSERT_EQUAL(g_dev->gc_index.phys[5].num_invalid, 0);
+
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_EQUAL(band, &g_dev->bands[2]);
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_EQUAL(band, &g_dev->bands[3]);
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_EQUAL(band, &g_dev->bands[14]);
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_EQUAL(band, &g_dev->bands[15]);
+
+	/* Nothing left to relocate */
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_NULL(band);
+
+	cleanup_gc_bands();
+}
+
+static void
+test_gc_victim_cost_benefit(void)
+{
+	struct ftl_band *band;
+	uint64_t user_blocks;
+	int rc;
+
+	setup_gc_bands();
+	user_blocks = ftl_band_user_blocks(&g_dev->bands[0]);
+	g_dev->sb->seq_id = 100;
+
+	/* Physical band 1 is half invalid, but was just written */
+	g_dev->bands[2].p2l_map.num_valid = 0;
+	g_dev->bands[2].md->close_seq_id = 100;
+	g_dev->bands[3].md->close_seq_id = 99;
+	/* Physical band 2 is a quarter invalid, but its data hasn't changed for a long time */
+	g_dev->bands[4].p2l_map.num_valid = user_blocks / 2;
+	g_dev->bands[4].md->close_seq_id = 1;
+	g_dev->bands[5].md->close_seq_id = 2;
+
+	rc = ftl_band_gc_index_init(g_dev);
+	CU_ASSERT_EQUAL(rc, 0);
+	CU_ASSERT_EQUAL(g_dev->gc_index.phys[1].close_seq_id, 100);
+	CU_ASSERT_EQUAL(g_dev->gc_index.phys[2].close_seq_id, 2);
+
+	g_dev->conf.gc_policy = SPDK_FTL_GC_POLICY_COST_BENEFIT;
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_EQUAL(band, &g_dev->bands[4]);
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_EQUAL(band, &g_dev->bands[5]);
+
+	/* A physical band without valid data is always taken first */
+	g_dev->bands[6].p2l_map.num_valid = 0;
+	g_dev->bands[7].p2l_map.num_valid = 0;
+	g_dev->bands[7].md->close_seq_id = 100;
+	ftl_band_gc_index_update(&g_dev->bands[6]);
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_EQUAL(band, &g_dev->bands[6]);
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_EQUAL(band, &g_dev->bands[7]);
+
+	/* The greedy policy goes for the most invalid band regardless of its age */
+	g_dev->conf.gc_policy = SPDK_FTL_GC_POLICY_GREEDY;
+	band = ftl_band_search_next_to_reloc(g_dev);
+	CU_ASSERT_PTR_EQUAL(band, &g_dev->bands[2]);
+
+	cleanup_gc_bands();
+}
+
 int
 main(int argc, char **argv)
 {
@@ -402,6 +553,8 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_band_set_addr);
 	CU_ADD_TEST(suite, test_invalidate_addr);
 	CU_ADD_TEST(suite, test_next_xfer_addr);
+	CU_ADD_TEST(suite, test_gc_victim_greedy);
+	CU_ADD_TEST(suite, test_gc_victim_cost_benefit);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
@@ -0,0 +1,172 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "spdk_internal/cunit.h"
+
+#include "ftl/utils/ftl_heat.c"
+
+#define TEST_NUM_LBAS		(64 * 1024)
+#define TEST_DECAY_NUM_LBAS	1024
+
+static void
+test_ftl_heat_create(void)
+{
+	struct ftl_heat *heat;
+
+	CU_ASSERT_PTR_NULL(ftl_heat_create(0, 16));
+	CU_ASSERT_PTR_NULL(ftl_heat_create(TEST_NUM_LBAS, 0));
+
+	/* Each LBA gets its own counter */
+	heat = ftl_heat_create(100, 1000);
+	SPDK_CU_ASSERT_FATAL(heat != NULL);
+	CU_ASSERT_EQUAL(heat->range_shift, 0);
+	CU_ASSERT_EQUAL(heat->num_ranges, 100);
+	ftl_heat_destroy(heat);
+
+	/* LBAs are grouped by 16 to fit into 100 counters */
+	heat = ftl_heat_create(1000, 100);
+	SPDK_CU_ASSERT_FATAL(heat != NULL);
+	CU_ASSERT_EQUAL(heat->range_shift, 4);
+	CU_ASSERT_EQUAL(heat->num_ranges, 63);
+	ftl_heat_destroy(heat);
+
+	heat = ftl_heat_create(1024, 64);
+	SPDK_CU_ASSERT_FATAL(heat != NULL);
+	CU_ASSERT_EQUAL(heat->range_shift, 4);
+	CU_ASSERT_EQUAL(heat->num_ranges, 64);
+	ftl_heat_destroy(heat);
+}
+
+static void
+test_ftl_heat_update(void)
+{
+	struct ftl_heat *heat;
+	uint64_t i, lba = TEST_NUM_LBAS / 2;
+
+	/* Map large enough for the aging to not reach the tested ranges */
+	heat = ftl_heat_create(TEST_NUM_LBAS, TEST_NUM_LBAS);
+	SPDK_CU_ASSERT_FATAL(heat != NULL);
+
+	/* Range becomes hot once written often enough */
+	for (i = 0; i < FTL_HEAT_HOT_THRESHOLD - 1; i++) {
+		ftl_heat_update(heat, lba, 1);
+		CU_ASSERT_FALSE(ftl_heat_is_hot(heat, lba, 1));
+	}
+	ftl_heat_update(heat, lba, 1);
+	CU_ASSERT_TRUE(ftl_heat_is_hot(heat, lba, 1));
+	CU_ASSERT_FALSE(ftl_heat_is_hot(heat, lba + 1, 1));
+
+	/* Any hot range makes the whole write hot */
+	CU_ASSERT_TRUE(ftl_heat_is_hot(heat, lba - 2, 4));
+	CU_ASSERT_FALSE(ftl_heat_is_hot(heat, lba + 1, 4));
+
+	/* Write spanning multiple ranges updates all of them */
+	ftl_heat_update(heat, lba + 100, 3);
+	CU_ASSERT_EQUAL(heat->counters[lba + 99], 0);
+	CU_ASSERT_EQUAL(heat->counters[lba + 100], 1);
+	CU_ASSERT_EQUAL(heat->counters[lba + 101], 1);
+	CU_ASSERT_EQUAL(heat->counters[lba + 102], 1);
+	CU_ASSERT_EQUAL(heat->counters[lba + 103], 0);
+
+	/* Counters saturate */
+	for (i = 0; i < 2 * UINT8_MAX; i++) {
+		ftl_heat_update(heat, TEST_NUM_LBAS - 1, 1);
+	}
+	CU_ASSERT_EQUAL(heat->counters[TEST_NUM_LBAS - 1], UINT8_MAX);
+
+	ftl_heat_destroy(heat);
+}
+
+static void
+test_ftl_heat_decay(void)
+{
+	struct ftl_heat *heat;
+	uint64_t i;
+
+	heat = ftl_heat_create(TEST_DECAY_NUM_LBAS, TEST_DECAY_NUM_LBAS);
+	SPDK_CU_ASSERT_FATAL(heat != NULL);
+
+	for (i = 0; i < 2 * FTL_HEAT_HOT_THRESHOLD; i++) {
+		ftl_heat_update(heat, 10, 1);
+	}
+	CU_ASSERT_TRUE(ftl_heat_is_hot(heat, 10, 1));
+
+	/* Range written once per sweep of the whole map stays cold */
+	for (i = 0; i < 4 * TEST_DECAY_NUM_LBAS; i++) {
+		ftl_heat_update(heat, (i * 7) % TEST_DECAY_NUM_LBAS, 1);
+		if (i >= TEST_DECAY_NUM_LBAS) {
+			CU_ASSERT_FALSE(ftl_heat_is_hot(heat, (i * 7) % TEST_DECAY_NUM_LBAS, 1));
+		}
+	}
+
+	/* Range no longer written cools down */
+	CU_ASSERT_FALSE(ftl_heat_is_hot(heat, 10, 1));
+
+	/* Range written more often than the map is swept becomes hot again */
+	for (i = 0; i < TEST_DECAY_NUM_LBAS; i++) {
+		ftl_heat_update(heat, (i * 7) % TEST_DECAY_NUM_LBAS, 1);
+		if (i % 8 == 0) {
+			ftl_heat_update(heat, 10, 1);
+		}
+	}
+	CU_ASSERT_TRUE(ftl_heat_is_hot(heat, 10, 1));
+
+	ftl_heat_destroy(heat);
+}
+
+static void
+test_ftl_heat_seq_id(void)
+{
+	struct ftl_heat *heat;
+
+	heat = ftl_heat_create(1024, 64);
+	SPDK_CU_ASSERT_FATAL(heat != NULL);
+
+	CU_ASSERT_EQUAL(ftl_heat_get_seq_id(heat, 0, 1024), 0);
+
+	/* Sequence id is tracked per range */
+	ftl_heat_set_seq_id(heat, 20, 1, 5);
+	CU_ASSERT_EQUAL(ftl_heat_get_seq_id(heat, 16, 16), 5);
+	CU_ASSERT_EQUAL(ftl_heat_get_seq_id(heat, 0, 16), 0);
+	CU_ASSERT_EQUAL(ftl_heat_get_seq_id(heat, 32, 16), 0);
+
+	/* Write spanning multiple ranges updates all of them, the highest one is returned */
+	ftl_heat_set_seq_id(heat, 30, 4, 7);
+	CU_ASSERT_EQUAL(ftl_heat_get_seq_id(heat, 16, 1), 7);
+	CU_ASSERT_EQUAL(ftl_heat_get_seq_id(heat, 32, 1), 7);
+	CU_ASSERT_EQUAL(ftl_heat_get_seq_id(heat, 0, 17), 7);
+
+	/* Lower sequence id doesn't replace a higher one */
+	ftl_heat_set_seq_id(heat, 20, 1, 6);
+	CU_ASSERT_EQUAL(ftl_heat_get_seq_id(heat, 20, 1), 7);
+
+	/* Aging doesn't affect sequence ids */
+	ftl_heat_update(heat, 0, 1024);
+	CU_ASSERT_EQUAL(ftl_heat_get_seq_id(heat, 20, 1), 7);
+
+	ftl_heat_destroy(heat);
+}
+
+int
+main(int argc, char **argv)
+{
+	CU_pSuite suite = NULL;
+	unsigned int num_failures;
+
+	CU_initialize_registry();
+
+	suite = CU_add_suite("ftl_heat", NULL, NULL);
+	CU_ADD_TEST(suite, test_ftl_heat_create);
+	CU_ADD_TEST(suite, test_ftl_heat_update);
+	CU_ADD_TEST(suite, test_ftl_heat_decay);
+	CU_ADD_TEST(suite, test_ftl_heat_seq_id);
+
+	num_failures = spdk_ut_run_tests(argc, argv, NULL);
+	CU_cleanup_registry();
+
+	return num_failures;
+}
@@ -0,0 +1,493 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "spdk_internal/cunit.h"
+#include "common/lib/test_env.c"
+
+#include "ftl/ftl_l2p_cache.c"
+#include "ftl/utils/ftl_bitmap.c"
+#include "ftl/utils/ftl_l2p_extent.c"
+#include "ftl/utils/ftl_mempool.c"
+
+#define TEST_NUM_PAGES		64
+#define TEST_RESIDENT_PAGES	16
+#define TEST_MAX_IOS		16
+
+void *g_ftl_read_buf;
+void *g_ftl_write_buf;
+
+DEFINE_STUB(spdk_bdev_desc_get_bdev, struct spdk_bdev *, (struct spdk_bdev_desc *desc), NULL);
+DEFINE_STUB_V(spdk_bdev_free_io, (struct spdk_bdev_io *bdev_io));
+DEFINE_STUB(spdk_bdev_get_md_size, uint32_t, (const struct spdk_bdev *bdev), 0);
+DEFINE_STUB(spdk_bdev_queue_io_wait, int, (struct spdk_bdev *bdev, struct spdk_io_channel *ch,
+		struct spdk_bdev_io_wait_entry *entry), 0);
+DEFINE_STUB(spdk_bdev_write_blocks, int, (struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
+		void *buf, uint64_t offset_blocks, uint64_t num_blocks, spdk_bdev_io_completion_cb cb,
+		void *cb_arg), 0);
+DEFINE_STUB(spdk_bdev_write_blocks_with_md, int, (struct spdk_bdev_desc *desc,
+		struct spdk_io_channel *ch, void *buf, void *md, uint64_t offset_blocks,
+		uint64_t num_blocks, spdk_bdev_io_completion_cb cb, void *cb_arg), 0);
+DEFINE_STUB(spdk_bdev_read_blocks_with_md, int, (struct spdk_bdev_desc *desc,
+		struct spdk_io_channel *ch, void *buf, void *md, uint64_t offset_blocks,
+		uint64_t num_blocks, spdk_bdev_io_completion_cb cb, void *cb_arg), 0);
+DEFINE_STUB(spdk_bdev_readv_blocks_with_md, int, (struct spdk_bdev_desc *desc,
+		struct spdk_io_channel *ch, struct iovec *iov, int iovcnt, void *md,
+		uint64_t offset_blocks, uint64_t num_blocks, spdk_bdev_io_completion_cb cb,
+		void *cb_arg), 0);
+DEFINE_STUB_V(ftl_invalidate_addr, (struct spdk_ftl_dev *dev, ftl_addr addr));
+DEFINE_STUB_V(ftl_stats_bdev_io_completed, (struct spdk_ftl_dev *dev, enum ftl_stats_type type,
+		struct spdk_bdev_io *bdev_io));
+
+struct ut_io {
+	spdk_bdev_io_completion_cb cb;
+	void *cb_arg;
+	uint64_t offset_blocks;
+	uint64_t num_blocks;
+};
+
+static struct ut_io g_io[TEST_MAX_IOS];
+static uint64_t g_io_count;
+static void *g_l1_buf;
+
+static void
+ut_queue_io(uint64_t offset_blocks, uint64_t num_blocks, spdk_bdev_io_completion_cb cb,
+	    void *cb_arg)
+{
+	SPDK_CU_ASSERT_FATAL(g_io_count < TEST_MAX_IOS);
+	g_io[g_io_count].cb = cb;
+	g_io[g_io_count].cb_arg = cb_arg;
+	g_io[g_io_count].offset_blocks = offset_blocks;
+	g_io[g_io_count].num_blocks = num_blocks;
+	g_io_count++;
+}
+
+int
+spdk_bdev_read_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch, void *buf,
+		      uint64_t offset_blocks, uint64_t num_blocks, spdk_bdev_io_completion_cb cb,
+		      void *cb_arg)
+{
+	ut_queue_io(offset_blocks, num_blocks, cb, cb_arg);
+	return 0;
+}
+
+int
+spdk_bdev_readv_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
+		       struct iovec *iov, int iovcnt, uint64_t offset_blocks, uint64_t num_blocks,
+		       spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	CU_ASSERT_EQUAL((uint64_t)iovcnt, num_blocks);
+	ut_queue_io(offset_blocks, num_blocks, cb, cb_arg);
+	return 0;
+}
+
+void *
+ftl_md_get_buffer(struct ftl_md *md)
+{
+	return g_l1_buf;
+}
+
+void
+ftl_l2p_pin_complete(struct spdk_ftl_dev *dev, int status, struct ftl_l2p_pin_ctx *pin_ctx)
+{
+	pin_ctx->cb(dev, status, pin_ctx);
+}
+
+static struct spdk_ftl_dev *g_dev;
+static struct ftl_l2p_cache *g_cache;
+static void *g_l2_ctx_buf;
+
+static void
+setup_cache(void)
+{
+	struct ftl_l2p_cache *cache;
+	uint64_t bitmap_size;
+
+	g_dev = calloc(1, sizeof(*g_dev));
+	SPDK_CU_ASSERT_FATAL(g_dev != NULL);
+	g_dev->layout.l2p.addr_size = sizeof(uint64_t);
+	g_dev->layout.l2p.lbas_in_page = FTL_BLOCK_SIZE / sizeof(uint64_t);
+	g_dev->num_lbas = TEST_NUM_PAGES * g_dev->layout.l2p.lbas_in_page;
+
+	/* Set up the cache the way ftl_l2p_cache_init() does, without the metadata regions */
+	cache = calloc(1, sizeof(*cache));
+	SPDK_CU_ASSERT_FATAL(cache != NULL);
+	g_dev->l2p = cache;
+	g_cache = cache;
+	cache->dev = g_dev;
+	cache->lbas_in_page = g_dev->layout.l2p.lbas_in_page;
+	cache->num_pages = TEST_NUM_PAGES;
+	cache->l2_mapping = malloc(TEST_NUM_PAGES * sizeof(*cache->l2_mapping));
+	SPDK_CU_ASSERT_FATAL(cache->l2_mapping != NULL);
+	memset(cache->l2_mapping, (int)FTL_DF_OBJ_ID_INVALID,
+	       TEST_NUM_PAGES * sizeof(*cache->l2_mapping));
+
+	TAILQ_INIT(&cache->deferred_page_set_list);
+	TAILQ_INIT(&cache->lru_list[L2P_CACHE_LRU_PROBATION]);
+	TAILQ_INIT(&cache->lru_list[L2P_CACHE_LRU_PROTECTED]);
+
+	cache->page_sets_pool = ftl_mempool_create(16, sizeof(struct ftl_l2p_page_set), 64,
+				SPDK_ENV_NUMA_ID_ANY);
+	SPDK_CU_ASSERT_FATAL(cache->page_sets_pool != NULL);
+	cache->page_in_batch_pool = ftl_mempool_create(4, sizeof(struct ftl_l2p_page_in_batch), 64,
+				    SPDK_ENV_NUMA_ID_ANY);
+	SPDK_CU_ASSERT_FATAL(cache->page_in_batch_pool != NULL);
+
+	g_l2_ctx_buf = calloc(TEST_RESIDENT_PAGES, SPDK_ALIGN_CEIL(sizeof(struct ftl_l2p_page), 64));
+	SPDK_CU_ASSERT_FATAL(g_l2_ctx_buf != NULL);
+	cache->l2_ctx_pool = ftl_mempool_create_ext(g_l2_ctx_buf, TEST_RESIDENT_PAGES,
+			     sizeof(struct ftl_l2p_page), 64);
+	SPDK_CU_ASSERT_FATAL(cache->l2_ctx_pool != NULL);
+	ftl_mempool_initialize_ext(cache->l2_ctx_pool);
+	g_l1_buf = calloc(TEST_RESIDENT_PAGES, FTL_BLOCK_SIZE);
+	SPDK_CU_ASSERT_FATAL(g_l1_buf != NULL);
+
+	cache->l2_pgs_resident_max = TEST_RESIDENT_PAGES;
+	cache->l2_pgs_avail = TEST_RESIDENT_PAGES;
+	cache->probation_max = spdk_divide_round_up(TEST_RESIDENT_PAGES *
+			       FTL_L2P_CACHE_PROBATION_RATIO, 100);
+
+	cache->ghost.size = TEST_RESIDENT_PAGES * FTL_L2P_CACHE_GHOST_RATIO / 100;
+	cache->ghost.pages = malloc(cache->ghost.size * sizeof(*cache->ghost.pages));
+	SPDK_CU_ASSERT_FATAL(cache->ghost.pages != NULL);
+	memset(cache->ghost.pages, 0xff, cache->ghost.size * sizeof(*cache->ghost.pages));
+	bitmap_size = ftl_bitmap_bits_to_size(TEST_NUM_PAGES);
+	cache->ghost.bitmap_buf = calloc(1, bitmap_size);
+	SPDK_CU_ASSERT_FATAL(cache->ghost.bitmap_buf != NULL);
+	cache->ghost.bitmap = ftl_bitmap_create(cache->ghost.bitmap_buf, bitmap_size);
+	SPDK_CU_ASSERT_FATAL(cache->ghost.bitmap != NULL);
+
+	/* No slabs, so evicted pages are always read back from the disk */
+	cache->zpages.slot = malloc(TEST_NUM_PAGES * sizeof(*cache->zpages.slot));
+	SPDK_CU_ASSERT_FATAL(cache->zpages.slot != NULL);
+	memset(cache->zpages.slot, 0xff, TEST_NUM_PAGES * sizeof(*cache->zpages.slot));
+	TAILQ_INIT(&cache->zpages.free_list);
+
+	/* Pages are evicted only by ut_evict() */
+	cache->evict_keep = 0;
+	cache->state = L2P_CACHE_RUNNING;
+
+	g_io_count = 0;
+}
+
+static void
+cleanup_cache(void)
+{
+	CU_ASSERT_EQUAL(g_io_count, 0);
+
+	ftl_bitmap_destroy(g_cache->ghost.bitmap);
+	free(g_cache->ghost.bitmap_buf);
+	free(g_cache->ghost.pages);
+	free(g_cache->zpages.slot);
+	ftl_mempool_destroy_ext(g_cache->l2_ctx_pool);
+	ftl_mempool_destroy(g_cache->page_in_batch_pool);
+	ftl_mempool_destroy(g_cache->page_sets_pool);
+	free(g_cache->l2_mapping);
+	free(g_cache);
+	free(g_l2_ctx_buf);
+	free(g_l1_buf);
+	free(g_dev);
+	g_cache = NULL;
+	g_dev = NULL;
+}
+
+static void
+ut_complete_ios(void)
+{
+	uint64_t i, count = g_io_count;
+
+	g_io_count = 0;
+	for (i = 0; i < count; i++) {
+		g_io[i].cb(NULL, true, g_io[i].cb_arg);
+	}
+}
+
+static void
+ut_pin_cb(struct spdk_ftl_dev *dev, int status, struct ftl_l2p_pin_ctx *pin_ctx)
+{
+	int *pin_status = pin_ctx->cb_ctx;
+
+	*pin_status = status;
+}
+
+static void
+ut_pin(uint64_t page_no, struct ftl_l2p_pin_ctx *pin_ctx, int *pin_status)
+{
+	*pin_status = 1;
+	pin_ctx->lba = page_no * g_cache->lbas_in_page;
+	pin_ctx->count = 1;
+	pin_ctx->cb = ut_pin_cb;
+	pin_ctx->cb_ctx = pin_status;
+	ftl_l2p_cache_pin(g_dev, pin_ctx);
+}
+
+static void
+ut_unpin(uint64_t page_no)
+{
+	ftl_l2p_cache_unpin(g_dev, page_no * g_cache->lbas_in_page, 1);
+}
+
+/* Faults the page in and releases it, like a single L2P lookup */
+static void
+ut_access(uint64_t page_no)
+{
+	struct ftl_l2p_pin_ctx pin_ctx;
+	int pin_status;
+
+	ut_pin(page_no, &pin_ctx, &pin_status);
+	ftl_l2p_cache_process(g_dev);
+	ut_complete_ios();
+	CU_ASSERT_EQUAL(pin_status, 0);
+	ut_unpin(page_no);
+}
+
+static void
+ut_evict(void)
+{
+	g_cache->evict_keep = g_cache->l2_pgs_avail + 1;
+	ftl_l2p_cache_process_eviction(g_dev, g_cache);
+	g_cache->evict_keep = 0;
+}
+
+static bool
+ut_resident(uint64_t page_no)
+{
+	return get_l2p_page_by_df_id(g_cache, page_no) != NULL;
+}
+
+static bool
+ut_ghost(uint64_t page_no)
+{
+	return ftl_bitmap_get(g_cache->ghost.bitmap, page_no);
+}
+
+static void
+test_l2p_cache_lru(void)
+{
+	struct ftl_l2p_pin_ctx pin_ctx;
+	struct ftl_l2p_page *page;
+	int pin_status;
+
+	setup_cache();
+
+	/* Pages read from the disk start on the probation list */
+	ut_access(0);
+	ut_access(10);
+	page = get_l2p_page_by_df_id(g_cache, 0);
+	SPDK_CU_ASSERT_FATAL(page != NULL);
+	CU_ASSERT_EQUAL(page->state, L2P_CACHE_PAGE_READY);
+	CU_ASSERT_EQUAL(page->lru, L2P_CACHE_LRU_PROBATION);
+	CU_ASSERT(page->on_lru_list);
+	CU_ASSERT_EQUAL(g_cache->lru_count[L2P_CACHE_LRU_PROBATION], 2);
+	CU_ASSERT_EQUAL(g_cache->lru_count[L2P_CACHE_LRU_PROTECTED], 0);
+	CU_ASSERT_EQUAL(g_cache->l2_pgs_avail, TEST_RESIDENT_PAGES - 2);
+	CU_ASSERT_PTR_EQUAL(ftl_l2p_cache_get_coldest_page(g_cache), page);
+
+	/* A pinned page leaves the list, it's the hottest one once released */
+	ut_access(0);
+	CU_ASSERT_EQUAL(page->lru, L2P_CACHE_LRU_PROBATION);
+	CU_ASSERT_PTR_EQUAL(TAILQ_FIRST(&g_cache->lru_list[L2P_CACHE_LRU_PROBATION]), page);
+	CU_ASSERT_PTR_EQUAL(ftl_l2p_cache_get_coldest_page(g_cache), get_l2p_page_by_df_id(g_cache, 10));
+
+	/* Hitting a resident page doesn't do any IO */
+	ut_pin(0, &pin_ctx, &pin_status);
+	CU_ASSERT_EQUAL(pin_status, 0);
+	CU_ASSERT_EQUAL(g_io_count, 0);
+	CU_ASSERT_FALSE(page->on_lru_list);
+	CU_ASSERT_EQUAL(g_cache->lru_count[L2P_CACHE_LRU_PROBATION], 1);
+	ut_unpin(0);
+
+	ut_evict();
+	CU_ASSERT_FALSE(ut_resident(10));
+	CU_ASSERT(ut_resident(0));
+	CU_ASSERT_EQUAL(g_cache->l2_pgs_avail, TEST_RESIDENT_PAGES - 1);
+
+	ut_evict();
+	CU_ASSERT_FALSE(ut_resident(0));
+	CU_ASSERT_EQUAL(g_cache->lru_count[L2P_CACHE_LRU_PROBATION], 0);
+	CU_ASSERT_EQUAL(g_cache->l2_pgs_avail, TEST_RESIDENT_PAGES);
+
+	cleanup_cache();
+}
+
+static void
+test_l2p_cache_ghost_hit(void)
+{
+	struct ftl_l2p_page *page;
+	uint64_t page_no;
+
+	setup_cache();
+	CU_ASSERT_EQUAL(g_cache->probation_max, 4);
+
+	ut_access(0);
+	ut_access(10);
+
+	/* Page evicted from probation is remembered on the ghost list */
+	ut_evict();
+	CU_ASSERT_FALSE(ut_resident(0));
+	CU_ASSERT(ut_resident(10));
+	CU_ASSERT(ut_ghost(0));
+	CU_ASSERT_FALSE(ut_ghost(10));
+
+	/* Faulting it in again promotes it to the protected list */
+	ut_access(0);
+	page = get_l2p_page_by_df_id(g_cache, 0);
+	SPDK_CU_ASSERT_FATAL(page != NULL);
+	CU_ASSERT_EQUAL(page->lru, L2P_CACHE_LRU_PROTECTED);
+	CU_ASSERT_FALSE(ut_ghost(0));
+	CU_ASSERT_EQUAL(g_cache->lru_count[L2P_CACHE_LRU_PROBATION], 1);
+	CU_ASSERT_EQUAL(g_cache->lru_count[L2P_CACHE_LRU_PROTECTED], 1);
+
+	/* Protected pages stay while the probation list is above its limit */
+	for (page_no = 20; page_no <= 50; page_no += 10) {
+		ut_access(page_no);
+		CU_ASSERT_EQUAL(get_l2p_page_by_df_id(g_cache, page_no)->lru, L2P_CACHE_LRU_PROBATION);
+	}
+	CU_ASSERT_EQUAL(g_cache->lru_count[L2P_CACHE_LRU_PROBATION], 5);
+
+	ut_evict();
+	CU_ASSERT_FALSE(ut_resident(10));
+	CU_ASSERT(ut_resident(0));
+	CU_ASSERT(ut_ghost(10));
+	CU_ASSERT_EQUAL(g_cache->lru_count[L2P_CACHE_LRU_PROBATION], 4);
+
+	/* Then the protected ones go first, and aren't remembered */
+	ut_evict();
+	CU_ASSERT_FALSE(ut_resident(0));
+	CU_ASSERT_FALSE(ut_ghost(0));
+	CU_ASSERT_EQUAL(g_cache->lru_count[L2P_CACHE_LRU_PROBATION], 4);
+	CU_ASSERT_EQUAL(g_cache->lru_count[L2P_CACHE_LRU_PROTECTED], 0);
+
+	/* The ghost list keeps only the most recently evicted pages */
+	for (page_no = 1; page_no <= g_cache->ghost.size; page_no++) {
+		ftl_l2p_cache_ghost_add(g_cache, page_no);
+	}
+	CU_ASSERT_FALSE(ut_ghost(10));
+	CU_ASSERT(ut_ghost(1));
+	CU_ASSERT(ut_ghost(g_cache->ghost.size));
+
+	/* Reloading the page, which dropped out of the ghost list, keeps it on probation */
+	ut_access(10);
+	CU_ASSERT_EQUAL(get_l2p_page_by_df_id(g_cache, 10)->lru, L2P_CACHE_LRU_PROBATION);
+
+	while (g_cache->l2_pgs_avail != TEST_RESIDENT_PAGES) {
+		ut_evict();
+	}
+
+	cleanup_cache();
+}
+
+static void
+test_l2p_cache_prefetch(void)
+{
+	struct ftl_l2p_pin_ctx pin_ctx[3];
+	struct ftl_l2p_page *page;
+	uint64_t page_no;
+	int pin_status[3];
+
+	setup_cache();
+
+	/* Page 7 is resident, page 5 is being loaded */
+	ut_access(7);
+	ut_access(0);
+	ut_access(1);
+	ut_pin(5, &pin_ctx[0], &pin_status[0]);
+	ftl_l2p_cache_process(g_dev);
+	CU_ASSERT_EQUAL(g_io_count, 1);
+	CU_ASSERT_EQUAL(pin_status[0], 1);
+	page = get_l2p_page_by_df_id(g_cache, 5);
+	SPDK_CU_ASSERT_FATAL(page != NULL);
+	CU_ASSERT_EQUAL(page->state, L2P_CACHE_PAGE_INIT);
+
+	/* Third consecutive page starts the read ahead, skipping pages already in memory */
+	ut_pin(2, &pin_ctx[1], &pin_status[1]);
+	ftl_l2p_cache_process(g_dev);
+	CU_ASSERT_EQUAL(g_io_count, 5);
+	CU_ASSERT_EQUAL(g_io[1].offset_blocks, 2);
+	CU_ASSERT_EQUAL(g_io[1].num_blocks, 1);
+	CU_ASSERT_EQUAL(g_io[2].offset_blocks, 3);
+	CU_ASSERT_EQUAL(g_io[2].num_blocks, 2);
+	CU_ASSERT_EQUAL(g_io[3].offset_blocks, 6);
+	CU_ASSERT_EQUAL(g_io[3].num_blocks, 1);
+	CU_ASSERT_EQUAL(g_io[4].offset_blocks, 8);
+	CU_ASSERT_EQUAL(g_io[4].num_blocks, 3);
+	CU_ASSERT_EQUAL(g_cache->ios_in_flight, 8);
+
+	for (page_no = 2; page_no <= 10; page_no++) {
+		page = get_l2p_page_by_df_id(g_cache, page_no);
+		SPDK_CU_ASSERT_FATAL(page != NULL);
+		CU_ASSERT_EQUAL(page->prefetched, page_no != 2 && page_no != 5 && page_no != 7);
+	}
+
+	/* Nothing more is read ahead until the stream moves on */
+	ftl_l2p_cache_process(g_dev);
+	CU_ASSERT_EQUAL(g_io_count, 5);
+
+	/* Pin of a page being read ahead waits for the read to complete */
+	ut_pin(4, &pin_ctx[2], &pin_status[2]);
+	page = get_l2p_page_by_df_id(g_cache, 4);
+	CU_ASSERT_EQUAL(g_io_count, 5);
+	CU_ASSERT_EQUAL(pin_status[2], 1);
+	CU_ASSERT_FALSE(TAILQ_EMPTY(&page->ppe_list));
+	CU_ASSERT(TAILQ_EMPTY(&g_cache->deferred_page_set_list));
+
+	ut_complete_ios();
+	CU_ASSERT_EQUAL(g_cache->ios_in_flight, 0);
+	CU_ASSERT_EQUAL(pin_status[0], 0);
+	CU_ASSERT_EQUAL(pin_status[1], 0);
+	CU_ASSERT_EQUAL(pin_status[2], 0);
+	CU_ASSERT_EQUAL(page->pin_ref_cnt, 1);
+	CU_ASSERT_FALSE(page->prefetched);
+	CU_ASSERT_FALSE(page->on_lru_list);
+
+	/* Pages read ahead and not pinned go to the probation list */
+	for (page_no = 3; page_no <= 10; page_no++) {
+		page = get_l2p_page_by_df_id(g_cache, page_no);
+		CU_ASSERT_EQUAL(page->state, L2P_CACHE_PAGE_READY);
+		CU_ASSERT_EQUAL(page->on_lru_list, page_no != 4 && page_no != 5);
+	}
+	CU_ASSERT_EQUAL(g_cache->lru_count[L2P_CACHE_LRU_PROBATION], 8);
+
+	ut_unpin(2);
+	ut_unpin(4);
+	ut_unpin(5);
+
+	/* Evicted pages which were never used aren't remembered on the ghost list */
+	while (ut_resident(1)) {
+		ut_evict();
+	}
+	ut_evict();
+	CU_ASSERT_FALSE(ut_resident(3));
+	CU_ASSERT(ut_ghost(7));
+	CU_ASSERT(ut_ghost(0));
+	CU_ASSERT(ut_ghost(1));
+	CU_ASSERT_FALSE(ut_ghost(3));
+
+	while (g_cache->l2_pgs_avail != TEST_RESIDENT_PAGES) {
+		ut_evict();
+	}
+
+	cleanup_cache();
+}
+
+int
+main(int argc, char **argv)
+{
+	CU_pSuite suite = NULL;
+	unsigned int num_failures;
+
+	CU_initialize_registry();
+
+	suite = CU_add_suite("ftl_l2p_cache", NULL, NULL);
+	CU_ADD_TEST(suite, test_l2p_cache_lru);
+	CU_ADD_TEST(suite, test_l2p_cache_ghost_hit);
+	CU_ADD_TEST(suite, test_l2p_cache_prefetch);
+
+	num_failures = spdk_ut_run_tests(argc, argv, NULL);
+	CU_cleanup_registry();
+
+	return num_failures;
+}
@@ -0,0 +1,140 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "spdk_internal/cunit.h"
+
+#include "ftl/utils/ftl_l2p_extent.c"
+
+#define TEST_PAGE_SIZE		4096
+#define TEST_ZPAGE_SIZE		256
+
+static uint8_t g_page[TEST_PAGE_SIZE];
+static uint8_t g_decoded[TEST_PAGE_SIZE];
+static uint8_t g_zpage[TEST_ZPAGE_SIZE];
+
+static void
+page_fill_sequential(uint64_t addr_size, uint64_t first, uint64_t start_addr, uint64_t count)
+{
+	uint64_t i;
+
+	for (i = 0; i < count; i++) {
+		entry_store(g_page, first + i, addr_size, start_addr + i);
+	}
+}
+
+static void
+page_fill_invalid(void)
+{
+	memset(g_page, 0xff, sizeof(g_page));
+}
+
+static void
+check_round_trip(uint64_t addr_size, size_t expected_extents)
+{
+	uint64_t num_entries = TEST_PAGE_SIZE / addr_size;
+	size_t size;
+
+	size = ftl_l2p_extent_encode(g_zpage, sizeof(g_zpage), g_page, num_entries, addr_size);
+	CU_ASSERT_EQUAL(size, sizeof(struct ftl_l2p_extent_hdr) +
+			expected_extents * sizeof(struct ftl_l2p_extent));
+	if (!size) {
+		return;
+	}
+
+	memset(g_decoded, 0, sizeof(g_decoded));
+	ftl_l2p_extent_decode(g_decoded, g_zpage, num_entries, addr_size);
+	CU_ASSERT_EQUAL(memcmp(g_decoded, g_page, sizeof(g_page)), 0);
+}
+
+static void
+test_ftl_l2p_extent_encode(void)
+{
+	uint64_t addr_size;
+
+	for (addr_size = sizeof(uint32_t); addr_size <= sizeof(uint64_t); addr_size *= 2) {
+		uint64_t num_entries = TEST_PAGE_SIZE / addr_size;
+
+		/* Unmapped page */
+		page_fill_invalid();
+		check_round_trip(addr_size, 1);
+
+		/* Sequentially written page */
+		page_fill_sequential(addr_size, 0, 1000, num_entries);
+		check_round_trip(addr_size, 1);
+
+		/* Two sequential runs with a hole in between */
+		page_fill_invalid();
+		page_fill_sequential(addr_size, 0, 5000, 100);
+		page_fill_sequential(addr_size, 200, 100, num_entries - 200);
+		check_round_trip(addr_size, 3);
+
+		/* Single overwritten entry splits an extent */
+		page_fill_sequential(addr_size, 0, 1000, num_entries);
+		entry_store(g_page, 10, addr_size, 7);
+		check_round_trip(addr_size, 3);
+
+		/* Address zero */
+		page_fill_sequential(addr_size, 0, 0, num_entries);
+		check_round_trip(addr_size, 1);
+	}
+}
+
+static void
+test_ftl_l2p_extent_overflow(void)
+{
+	uint64_t max_extents = (TEST_ZPAGE_SIZE - sizeof(struct ftl_l2p_extent_hdr)) /
+			       sizeof(struct ftl_l2p_extent);
+	uint64_t num_entries = TEST_PAGE_SIZE / sizeof(uint64_t);
+	uint64_t i;
+
+	/* As many extents as fit into the buffer */
+	page_fill_sequential(sizeof(uint64_t), 0, 0, num_entries);
+	for (i = 0; i < max_extents - 1; i++) {
+		entry_store(g_page, i, sizeof(uint64_t), 10000 + i * 2);
+	}
+	check_round_trip(sizeof(uint64_t), max_extents);
+
+	/* One more doesn't fit */
+	entry_store(g_page, max_extents, sizeof(uint64_t), 20000);
+	CU_ASSERT_EQUAL(ftl_l2p_extent_encode(g_zpage, sizeof(g_zpage), g_page, num_entries,
+					      sizeof(uint64_t)), 0);
+
+	/* Randomly written page */
+	for (i = 0; i < num_entries; i++) {
+		entry_store(g_page, i, sizeof(uint64_t), (i * 7919) % 65521);
+	}
+	CU_ASSERT_EQUAL(ftl_l2p_extent_encode(g_zpage, sizeof(g_zpage), g_page, num_entries,
+					      sizeof(uint64_t)), 0);
+
+	/* Addresses not representable in an extent */
+	page_fill_sequential(sizeof(uint64_t), 0, FTL_L2P_EXTENT_ADDR_INVALID, num_entries);
+	CU_ASSERT_EQUAL(ftl_l2p_extent_encode(g_zpage, sizeof(g_zpage), g_page, num_entries,
+					      sizeof(uint64_t)), 0);
+
+	/* Buffer too small */
+	page_fill_invalid();
+	CU_ASSERT_EQUAL(ftl_l2p_extent_encode(g_zpage, sizeof(struct ftl_l2p_extent_hdr), g_page,
+					      num_entries, sizeof(uint64_t)), 0);
+}
+
+int
+main(int argc, char **argv)
+{
+	CU_pSuite suite = NULL;
+	unsigned int num_failures;
+
+	CU_initialize_registry();
+
+	suite = CU_add_suite("ftl_l2p_extent", NULL, NULL);
+	CU_ADD_TEST(suite, test_ftl_l2p_extent_encode);
+	CU_ADD_TEST(suite, test_ftl_l2p_extent_overflow);
+
+	num_failures = spdk_ut_run_tests(argc, argv, NULL);
+	CU_cleanup_registry();
+
+	return num_failures;
+}
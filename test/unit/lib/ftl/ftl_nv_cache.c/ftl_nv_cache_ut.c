@@ -0,0 +1,473 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "spdk_internal/cunit.h"
+#include "common/lib/test_env.c"
+
+#include "ftl/ftl_nv_cache.c"
+#include "ftl/mngt/ftl_mngt_recovery.c"
+#include "ftl/utils/ftl_heat.c"
+
+#define TEST_NUM_LBAS		1024
+#define TEST_NUM_CHUNKS		8
+#define TEST_CHUNK_BLOCKS	16
+#define TEST_BASE_BLOCKS	4096
+#define TEST_COMPACTOR_BLOCKS	100
+
+void *g_ftl_write_buf;
+
+DEFINE_STUB(spdk_bdev_desc_get_bdev, struct spdk_bdev *, (struct spdk_bdev_desc *desc), NULL);
+DEFINE_STUB_V(spdk_bdev_free_io, (struct spdk_bdev_io *bdev_io));
+DEFINE_STUB(spdk_bdev_get_md_size, uint32_t, (const struct spdk_bdev *bdev), 0);
+DEFINE_STUB(spdk_bdev_queue_io_wait, int, (struct spdk_bdev *bdev, struct spdk_io_channel *ch,
+		struct spdk_bdev_io_wait_entry *entry), 0);
+DEFINE_STUB(spdk_bdev_write_blocks, int, (struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
+		void *buf, uint64_t offset_blocks, uint64_t num_blocks, spdk_bdev_io_completion_cb cb,
+		void *cb_arg), 0);
+DEFINE_STUB(spdk_bdev_write_blocks_with_md, int, (struct spdk_bdev_desc *desc,
+		struct spdk_io_channel *ch, void *buf, void *md, uint64_t offset_blocks,
+		uint64_t num_blocks, spdk_bdev_io_completion_cb cb, void *cb_arg), 0);
+DEFINE_STUB(ftl_layout_region_get, struct ftl_layout_region *, (struct spdk_ftl_dev *dev,
+		enum ftl_layout_region_type reg_type), NULL);
+DEFINE_STUB_V(ftl_md_persist_entries, (struct ftl_md *md, uint64_t start_entry,
+				       uint64_t num_entries, void *buffer, void *vss_buffer,
+				       ftl_md_io_entry_cb cb, void *cb_arg,
+				       struct ftl_md_io_entry_ctx *ctx));
+DEFINE_STUB_V(ftl_mempool_put, (struct ftl_mempool *mpool, void *element));
+DEFINE_STUB_V(ftl_stats_bdev_io_completed, (struct spdk_ftl_dev *dev, enum ftl_stats_type type,
+		struct spdk_bdev_io *bdev_io));
+DEFINE_STUB_V(ftl_stats_crc_error, (struct spdk_ftl_dev *dev, enum ftl_stats_type type));
+
+static struct spdk_ftl_dev *g_dev;
+
+static void
+setup_nv_cache(void)
+{
+	struct ftl_nv_cache *nv_cache;
+	struct ftl_nv_cache_chunk *chunk;
+	uint64_t i;
+
+	g_dev = calloc(1, sizeof(*g_dev));
+	SPDK_CU_ASSERT_FATAL(g_dev != NULL);
+
+	g_dev->num_lbas = TEST_NUM_LBAS;
+	g_dev->layout.l2p.addr_size = sizeof(uint64_t);
+	g_dev->layout.base.total_blocks = TEST_BASE_BLOCKS;
+	g_dev->layout.nvc.chunk_data_blocks = TEST_CHUNK_BLOCKS - 1;
+	g_dev->heat = ftl_heat_create(TEST_NUM_LBAS, TEST_NUM_LBAS);
+	SPDK_CU_ASSERT_FATAL(g_dev->heat != NULL);
+
+	nv_cache = &g_dev->nv_cache;
+	nv_cache->chunk_blocks = TEST_CHUNK_BLOCKS;
+	nv_cache->tail_md_chunk_blocks = ftl_nv_cache_chunk_tail_md_num_blocks(nv_cache);
+	nv_cache->chunk_count = TEST_NUM_CHUNKS;
+	nv_cache->chunks = calloc(TEST_NUM_CHUNKS, sizeof(*nv_cache->chunks));
+	SPDK_CU_ASSERT_FATAL(nv_cache->chunks != NULL);
+	TAILQ_INIT(&nv_cache->chunk_open_list);
+
+	/* All chunks are open, in the order of their sequence ids */
+	for (i = 0; i < TEST_NUM_CHUNKS; i++) {
+		chunk = &nv_cache->chunks[i];
+		chunk->nv_cache = nv_cache;
+		chunk->offset = i * TEST_CHUNK_BLOCKS;
+		chunk->md = calloc(1, sizeof(*chunk->md));
+		SPDK_CU_ASSERT_FATAL(chunk->md != NULL);
+		chunk->md->seq_id = i + 1;
+		chunk->md->state = FTL_CHUNK_STATE_OPEN;
+		chunk->p2l_map.chunk_map = calloc(nv_cache->tail_md_chunk_blocks, FTL_BLOCK_SIZE);
+		SPDK_CU_ASSERT_FATAL(chunk->p2l_map.chunk_map != NULL);
+		memset(chunk->p2l_map.chunk_map, 0xff, nv_cache->tail_md_chunk_blocks * FTL_BLOCK_SIZE);
+		TAILQ_INSERT_TAIL(&nv_cache->chunk_open_list, chunk, entry);
+	}
+}
+
+static void
+cleanup_nv_cache(void)
+{
+	uint64_t i;
+
+	for (i = 0; i < TEST_NUM_CHUNKS; i++) {
+		free(g_dev->nv_cache.chunks[i].md);
+		free(g_dev->nv_cache.chunks[i].p2l_map.chunk_map);
+	}
+
+	free(g_dev->nv_cache.chunks);
+	ftl_heat_destroy(g_dev->heat);
+	free(g_dev);
+	g_dev = NULL;
+}
+
+static struct ftl_nv_cache_chunk *
+ut_write_blocks(uint64_t lba, uint64_t num_blocks, enum ftl_stream stream, ftl_addr *addr)
+{
+	struct ftl_io io = {
+		.dev = g_dev,
+		.lba = lba,
+		.num_blocks = num_blocks,
+		.stream = stream,
+	};
+	uint64_t cache_offset, i;
+
+	cache_offset = ftl_nv_cache_get_wr_buffer(&g_dev->nv_cache, &io);
+	SPDK_CU_ASSERT_FATAL(cache_offset != FTL_LBA_INVALID);
+
+	/* Record the LBAs in the chunk's P2L map, like the write completion does */
+	*addr = ftl_addr_from_nvc_offset(g_dev, cache_offset);
+	for (i = 0; i < num_blocks; i++) {
+		ftl_nv_cache_chunk_set_addr(io.nv_cache_chunk, lba + i, *addr + i);
+	}
+
+	return io.nv_cache_chunk;
+}
+
+static struct ftl_nv_cache_chunk *
+ut_write(uint64_t lba, enum ftl_stream stream, ftl_addr *addr)
+{
+	return ut_write_blocks(lba, 1, stream, addr);
+}
+
+static void
+ut_restore_l2p(uint64_t *l2p)
+{
+	struct ftl_nv_cache *nv_cache = &g_dev->nv_cache;
+	struct ftl_mngt_recovery_ctx *pctx;
+	struct ftl_nv_cache_chunk *chunk;
+	uint64_t i;
+	int rc;
+
+	pctx = calloc(1, sizeof(*pctx));
+	SPDK_CU_ASSERT_FATAL(pctx != NULL);
+	pctx->l2p_snippet.l2p = l2p;
+	pctx->l2p_snippet.seq_id = calloc(TEST_NUM_LBAS, sizeof(uint64_t));
+	pctx->range.chunk = calloc(TEST_NUM_CHUNKS, sizeof(*pctx->range.chunk));
+	SPDK_CU_ASSERT_FATAL(pctx->l2p_snippet.seq_id != NULL);
+	SPDK_CU_ASSERT_FATAL(pctx->range.chunk != NULL);
+	pctx->iter.lba_first = 0;
+	pctx->iter.lba_last = TEST_NUM_LBAS;
+
+	for (i = 0; i < TEST_NUM_LBAS; i++) {
+		ftl_addr_store(g_dev, l2p, i, FTL_ADDR_INVALID);
+	}
+
+	/* Chunks are restored in their on-disk order, not in the order of their sequence ids */
+	for (i = 0; i < TEST_NUM_CHUNKS; i++) {
+		chunk = &nv_cache->chunks[i];
+		chunk->md->p2l_map_checksum = spdk_crc32c_update(chunk->p2l_map.chunk_map,
+					      nv_cache->tail_md_chunk_blocks * FTL_BLOCK_SIZE, 0);
+		rc = restore_chunk_l2p_cb(chunk, pctx);
+		CU_ASSERT_EQUAL(rc, 0);
+	}
+
+	free(pctx->l2p_snippet.seq_id);
+	free(pctx->range.chunk);
+	free(pctx);
+}
+
+static void
+test_stream_switch_restore(void)
+{
+	struct ftl_nv_cache *nv_cache;
+	struct ftl_nv_cache_chunk *hot, *cold, *chunk;
+	ftl_addr addr_hot, addr_cold, addr, addr_x;
+	uint64_t l2p[TEST_NUM_LBAS];
+	uint64_t lba;
+
+	setup_nv_cache();
+	nv_cache = &g_dev->nv_cache;
+
+	/* Hot stream takes the oldest chunk, cold stream the next one */
+	hot = ut_write(100, FTL_STREAM_HOT, &addr_hot);
+	CU_ASSERT_PTR_EQUAL(hot, &nv_cache->chunks[0]);
+	cold = ut_write(10, FTL_STREAM_COLD, &addr);
+	CU_ASSERT_PTR_EQUAL(cold, &nv_cache->chunks[1]);
+
+	/* LBAs not written by the other stream stay in the current chunk */
+	chunk = ut_write(200, FTL_STREAM_COLD, &addr_cold);
+	CU_ASSERT_PTR_EQUAL(chunk, cold);
+	chunk = ut_write(101, FTL_STREAM_HOT, &addr);
+	CU_ASSERT_PTR_EQUAL(chunk, hot);
+
+	/* LBA moves from cold to hot, its data stays in the newer cold chunk */
+	chunk = ut_write(10, FTL_STREAM_HOT, &addr_x);
+	CU_ASSERT_PTR_EQUAL(chunk, cold);
+	CU_ASSERT_PTR_EQUAL(nv_cache->chunk_current[FTL_STREAM_HOT], hot);
+	CU_ASSERT_EQUAL(hot->md->write_pointer, 2);
+	CU_ASSERT_EQUAL(hot->md->blocks_skipped, 0);
+
+	ut_restore_l2p(l2p);
+	CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, 10), addr_x);
+
+	/* Leave a single free block in the cold chunk */
+	for (lba = 300; chunk_get_free_space(nv_cache, cold) > 1; lba++) {
+		chunk = ut_write(lba, FTL_STREAM_COLD, &addr);
+		CU_ASSERT_PTR_EQUAL(chunk, cold);
+	}
+
+	/* With no newer chunk to go to, the older hot chunk is closed instead */
+	chunk = ut_write_blocks(10, 2, FTL_STREAM_HOT, &addr_x);
+	CU_ASSERT(chunk->md->seq_id > cold->md->seq_id);
+	CU_ASSERT_PTR_EQUAL(chunk, &nv_cache->chunks[2]);
+	CU_ASSERT_PTR_EQUAL(nv_cache->chunk_current[FTL_STREAM_HOT], chunk);
+	CU_ASSERT_EQUAL(hot->md->write_pointer, chunk_tail_md_offset(nv_cache));
+	CU_ASSERT_EQUAL(hot->md->blocks_skipped, chunk_tail_md_offset(nv_cache) - 2);
+	hot = chunk;
+
+	/* Dirty restore finds the newest copy of each LBA */
+	ut_restore_l2p(l2p);
+	CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, 10), addr_x);
+	CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, 100), addr_hot);
+	CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, 200), addr_cold);
+
+	/* LBA moves back from hot to cold, it stays in the newer hot chunk */
+	chunk = ut_write(10, FTL_STREAM_COLD, &addr_x);
+	CU_ASSERT_PTR_EQUAL(chunk, hot);
+	CU_ASSERT_PTR_EQUAL(nv_cache->chunk_current[FTL_STREAM_COLD], cold);
+	CU_ASSERT_EQUAL(cold->md->blocks_skipped, 0);
+
+	ut_restore_l2p(l2p);
+	CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, 10), addr_x);
+	CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, 200), addr_cold);
+
+	cleanup_nv_cache();
+}
+
+static void
+test_stream_oscillation(void)
+{
+	struct ftl_nv_cache *nv_cache;
+	enum ftl_stream stream;
+	ftl_addr addr[8];
+	uint64_t l2p[TEST_NUM_LBAS];
+	uint64_t round, lba, i, skipped = 0, used = 0, written = 0;
+
+	setup_nv_cache();
+	nv_cache = &g_dev->nv_cache;
+
+	/* A set of LBAs near the hot threshold flips stream on every rewrite */
+	for (round = 0; round < 10; round++) {
+		stream = round % 2 ? FTL_STREAM_HOT : FTL_STREAM_COLD;
+		for (lba = 0; lba < SPDK_COUNTOF(addr); lba++) {
+			ut_write(lba, stream, &addr[lba]);
+			written++;
+		}
+	}
+
+	/* Writes follow the newest chunk, no chunk is closed early */
+	for (i = 0; i < TEST_NUM_CHUNKS; i++) {
+		skipped += nv_cache->chunks[i].md->blocks_skipped;
+		used += nv_cache->chunks[i].md->write_pointer;
+	}
+	CU_ASSERT_EQUAL(skipped, 0);
+	CU_ASSERT_EQUAL(used, written);
+	CU_ASSERT_EQUAL(nv_cache->chunks[TEST_NUM_CHUNKS - 1].md->write_pointer, 0);
+
+	ut_restore_l2p(l2p);
+	for (lba = 0; lba < SPDK_COUNTOF(addr); lba++) {
+		CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, lba), addr[lba]);
+	}
+
+	cleanup_nv_cache();
+}
+
+static void
+ut_chunk_map_lba(struct ftl_nv_cache_chunk *chunk, uint64_t lba)
+{
+	ftl_addr addr = ftl_addr_from_nvc_offset(g_dev, chunk->offset + chunk->md->write_pointer);
+
+	ftl_nv_cache_chunk_set_addr(chunk, lba, addr);
+	chunk->md->write_pointer++;
+}
+
+/* Restores the L2P of LBAs [lba_first, lba_last) from the chunks, returns mask of chunks read */
+static uint64_t
+ut_restore_iteration(struct ftl_mngt_recovery_ctx *pctx, uint64_t lba_first, uint64_t lba_last)
+{
+	struct ftl_nv_cache *nv_cache = &g_dev->nv_cache;
+	struct ftl_nv_cache_chunk *chunk;
+	uint64_t i, mask = 0;
+
+	pctx->iter.lba_first = lba_first;
+	pctx->iter.lba_last = lba_last;
+	for (i = 0; i < lba_last - lba_first; i++) {
+		ftl_addr_store(g_dev, pctx->l2p_snippet.l2p, i, FTL_ADDR_INVALID);
+		pctx->l2p_snippet.seq_id[i] = 0;
+	}
+
+	for (i = 0; i < TEST_NUM_CHUNKS; i++) {
+		chunk = &nv_cache->chunks[i];
+		if (!restore_chunk_l2p_filter(chunk, pctx)) {
+			continue;
+		}
+
+		CU_ASSERT_EQUAL(restore_chunk_l2p_cb(chunk, pctx), 0);
+		mask |= 1ULL << i;
+	}
+
+	return mask;
+}
+
+static void
+test_recovery_chunk_range_skip(void)
+{
+	struct ftl_nv_cache *nv_cache;
+	struct ftl_mngt_recovery_ctx *pctx;
+	struct ftl_nv_cache_chunk *chunks;
+	uint64_t l2p[TEST_NUM_LBAS];
+	uint64_t i, iter_lbas = TEST_NUM_LBAS / 4;
+
+	setup_nv_cache();
+	nv_cache = &g_dev->nv_cache;
+	chunks = nv_cache->chunks;
+
+	/* Iterations cover LBAs [0, 256), [256, 512), [512, 768) and [768, 1024) */
+	ut_chunk_map_lba(&chunks[0], iter_lbas);
+	ut_chunk_map_lba(&chunks[0], iter_lbas + 3);
+	ut_chunk_map_lba(&chunks[1], iter_lbas - 1);
+	ut_chunk_map_lba(&chunks[2], iter_lbas - 1);
+	ut_chunk_map_lba(&chunks[2], iter_lbas);
+	ut_chunk_map_lba(&chunks[3], 2 * iter_lbas - 1);
+	ut_chunk_map_lba(&chunks[3], 100);
+	/* Chunks 4-7 have no valid LBAs */
+
+	for (i = 0; i < TEST_NUM_CHUNKS; i++) {
+		chunks[i].md->p2l_map_checksum = spdk_crc32c_update(chunks[i].p2l_map.chunk_map,
+						 nv_cache->tail_md_chunk_blocks * FTL_BLOCK_SIZE, 0);
+	}
+
+	pctx = calloc(1, sizeof(*pctx));
+	SPDK_CU_ASSERT_FATAL(pctx != NULL);
+	pctx->l2p_snippet.l2p = l2p;
+	pctx->l2p_snippet.seq_id = calloc(iter_lbas, sizeof(uint64_t));
+	pctx->range.chunk = calloc(TEST_NUM_CHUNKS, sizeof(*pctx->range.chunk));
+	SPDK_CU_ASSERT_FATAL(pctx->l2p_snippet.seq_id != NULL);
+	SPDK_CU_ASSERT_FATAL(pctx->range.chunk != NULL);
+	for (i = 0; i < TEST_NUM_CHUNKS; i++) {
+		recovery_lba_range_init(&pctx->range.chunk[i]);
+	}
+
+	/* First iteration doesn't know the ranges yet, all chunks are read */
+	CU_ASSERT_EQUAL(ut_restore_iteration(pctx, 0, iter_lbas), 0xff);
+	CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, iter_lbas - 1),
+			ftl_addr_from_nvc_offset(g_dev, chunks[2].offset));
+	CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, 100),
+			ftl_addr_from_nvc_offset(g_dev, chunks[3].offset + 1));
+	for (i = 0; i < TEST_NUM_CHUNKS; i++) {
+		CU_ASSERT(pctx->range.chunk[i].known);
+	}
+	CU_ASSERT_EQUAL(pctx->range.chunk[0].first, iter_lbas);
+	CU_ASSERT_EQUAL(pctx->range.chunk[0].last, iter_lbas + 3);
+	CU_ASSERT_EQUAL(pctx->range.chunk[3].first, 100);
+	CU_ASSERT_EQUAL(pctx->range.chunk[3].last, 2 * iter_lbas - 1);
+
+	/* Ranges ending right before the iteration or starting at its end are skipped */
+	pctx->iter.lba_first = 0;
+	pctx->iter.lba_last = iter_lbas;
+	CU_ASSERT_FALSE(recovery_lba_range_overlaps(&pctx->range.chunk[0], pctx));
+	CU_ASSERT(recovery_lba_range_overlaps(&pctx->range.chunk[1], pctx));
+	CU_ASSERT(recovery_lba_range_overlaps(&pctx->range.chunk[2], pctx));
+	CU_ASSERT(recovery_lba_range_overlaps(&pctx->range.chunk[3], pctx));
+	CU_ASSERT_FALSE(recovery_lba_range_overlaps(&pctx->range.chunk[4], pctx));
+
+	/* Chunk 2 holds the newest copy of the LBAs it shares with chunk 0 and 1 */
+	CU_ASSERT_EQUAL(ut_restore_iteration(pctx, iter_lbas, 2 * iter_lbas), 0xd);
+	CU_ASSERT_EQUAL(pctx->range.chunks_skipped, 5);
+	CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, 0),
+			ftl_addr_from_nvc_offset(g_dev, chunks[2].offset + 1));
+	CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, 3),
+			ftl_addr_from_nvc_offset(g_dev, chunks[0].offset + 1));
+	CU_ASSERT_EQUAL(ftl_addr_load(g_dev, l2p, iter_lbas - 1),
+			ftl_addr_from_nvc_offset(g_dev, chunks[3].offset));
+
+	/* No chunk has LBAs of the last two iterations */
+	CU_ASSERT_EQUAL(ut_restore_iteration(pctx, 2 * iter_lbas, 3 * iter_lbas), 0);
+	CU_ASSERT_EQUAL(ut_restore_iteration(pctx, 3 * iter_lbas, TEST_NUM_LBAS), 0);
+	CU_ASSERT_EQUAL(pctx->range.chunks_read, TEST_NUM_CHUNKS + 3);
+	CU_ASSERT_EQUAL(pctx->range.chunks_skipped, 5 + 2 * TEST_NUM_CHUNKS);
+
+	free(pctx->l2p_snippet.seq_id);
+	free(pctx->range.chunk);
+	free(pctx);
+	cleanup_nv_cache();
+}
+
+static void
+ut_throttle_interval(struct ftl_nv_cache *nv_cache, uint64_t demand)
+{
+	uint64_t active = nv_cache->ctrl.compaction_target;
+
+	/* Each active compactor moves the same number of blocks per interval */
+	nv_cache->compaction_active_count = active;
+	nv_cache->ctrl.active_sum = active * 10;
+	nv_cache->ctrl.polls = 10;
+	nv_cache->ctrl.blocks_compacted = active * TEST_COMPACTOR_BLOCKS;
+	nv_cache->throttle.blocks_submitted = spdk_min(demand,
+					      nv_cache->throttle.blocks_submitted_limit);
+
+	ftl_nv_cache_throttle_update(nv_cache);
+}
+
+static void
+test_throttle_full_cache(void)
+{
+	struct ftl_nv_cache *nv_cache;
+	uint64_t i, demand;
+
+	setup_nv_cache();
+	nv_cache = &g_dev->nv_cache;
+	/* The controller only looks at chunk counts, model a cache with a 5% free chunk target */
+	nv_cache->chunk_count = 100;
+	nv_cache->chunk_compaction_threshold = 80;
+	nv_cache->chunk_free_target = 5;
+	nv_cache->chunk_full_count = 100;
+	nv_cache->chunk_free_count = 0;
+	nv_cache->throttle.blocks_submitted_limit = UINT64_MAX;
+	nv_cache->ctrl.compaction_target = FTL_NV_CACHE_NUM_COMPACTORS;
+
+	/* User writes outrun all compactors with the cache full, none of them may be stopped */
+	demand = 4 * FTL_NV_CACHE_NUM_COMPACTORS * TEST_COMPACTOR_BLOCKS;
+	for (i = 0; i < 100; i++) {
+		ut_throttle_interval(nv_cache, demand);
+		CU_ASSERT_EQUAL(nv_cache->ctrl.compaction_target, FTL_NV_CACHE_NUM_COMPACTORS);
+		CU_ASSERT(nv_cache->throttle.blocks_submitted_limit < demand);
+	}
+
+	/* User writes get the minimum share of the full compaction bandwidth, not of one compactor */
+	CU_ASSERT(nv_cache->throttle.blocks_submitted_limit + 1 >= FTL_NV_CACHE_NUM_COMPACTORS *
+		  TEST_COMPACTOR_BLOCKS * (1.0 + FTL_NV_CACHE_THROTTLE_MODIFIER_MIN));
+
+	/* Once free chunks are back and user writes stay below the limit, compactors scale down */
+	nv_cache->chunk_free_count = 20;
+	nv_cache->ctrl.last_free_count = 20;
+	demand = 5 * TEST_COMPACTOR_BLOCKS / 2;
+	for (i = 0; i < 100; i++) {
+		ut_throttle_interval(nv_cache, demand);
+	}
+	CU_ASSERT(nv_cache->throttle.blocks_submitted_limit > demand);
+	CU_ASSERT_EQUAL(nv_cache->ctrl.compaction_target, 3);
+
+	cleanup_nv_cache();
+}
+
+int
+main(int argc, char **argv)
+{
+	CU_pSuite suite = NULL;
+	unsigned int num_failures;
+
+	CU_initialize_registry();
+
+	suite = CU_add_suite("ftl_nv_cache", NULL, NULL);
+	CU_ADD_TEST(suite, test_stream_switch_restore);
+	CU_ADD_TEST(suite, test_stream_oscillation);
+	CU_ADD_TEST(suite, test_recovery_chunk_range_skip);
+	CU_ADD_TEST(suite, test_throttle_full_cache);
+
+	num_failures = spdk_ut_run_tests(argc, argv, NULL);
+	CU_cleanup_registry();
+
+	return num_failures;
+}
@@ -92,8 +92,9 @@ DEFINE_STUB(nvmf_ctrlr_copy_supported,
 	    false);
 
 DEFINE_STUB_V(nvmf_get_discovery_log_page,
-	      (struct spdk_nvmf_tgt *tgt, const char *hostnqn, struct iovec *iov,
-	       uint32_t iovcnt, uint64_t offset, uint32_t length, struct spdk_nvme_transport_id *cmd_src_trid));
+	      (struct spdk_nvmf_tgt *tgt, const char *hostnqn, struct nvmf_discovery_log_cache *cache,
+	       struct iovec *iov, uint32_t iovcnt, uint64_t offset, uint32_t length,
+	       struct spdk_nvme_transport_id *cmd_src_trid));
 
 DEFINE_STUB(spdk_nvmf_qpair_get_listen_trid,
 	    int,
@@ -228,6 +229,14 @@ DEFINE_STUB(spdk_nvmf_subsystem_get_nqn, const char *,
 DEFINE_STUB(spdk_bdev_io_type_supported, bool,
 	    (struct spdk_bdev *bdev, enum spdk_bdev_io_type io_type), false);
 
+static uint32_t g_ut_host2_weight = 1;
+
+uint32_t
+nvmf_subsystem_get_host_weight(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn)
+{
+	return strcmp(hostnqn, "nqn.2016-06.io.spdk:host2") == 0 ? g_ut_host2_weight : 1;
+}
+
 void
 nvmf_qpair_set_state(struct spdk_nvmf_qpair *qpair, enum spdk_nvmf_qpair_state state)
 {
@@ -509,6 +518,7 @@ test_connect(void)
 	subsystem.thread = spdk_get_thread();
 	subsystem.id = 1;
 	TAILQ_INIT(&subsystem.ctrlrs);
+	STAILQ_INIT(&subsystem.pending_connects);
 	subsystem.tgt = &tgt;
 	subsystem.subtype = SPDK_NVMF_SUBTYPE_NVME;
 	subsystem.state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
@@ -545,8 +555,12 @@ test_connect(void)
 	sgroups[subsystem.id].mgmt_io_outstanding++;
 	TAILQ_INSERT_TAIL(&qpair.outstanding, &req, link);
 	rc = nvmf_ctrlr_cmd_connect(&req);
-	poll_threads();
 	CU_ASSERT(rc == SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS);
+	CU_ASSERT(STAILQ_FIRST(&subsystem.pending_connects) == &req);
+	CU_ASSERT(subsystem.connect_msg_pending);
+	poll_threads();
+	CU_ASSERT(STAILQ_EMPTY(&subsystem.pending_connects));
+	CU_ASSERT(!subsystem.connect_msg_pending);
 	CU_ASSERT(nvme_status_success(&rsp.nvme_cpl.status));
 	CU_ASSERT(qpair.ctrlr != NULL);
 	CU_ASSERT(qpair.state == SPDK_NVMF_QPAIR_ENABLED);
@@ -2580,6 +2594,7 @@ test_nvmf_ctrlr_create_destruct(void)
 	subsystem.thread = spdk_get_thread();
 	subsystem.id = 1;
 	TAILQ_INIT(&subsystem.ctrlrs);
+	STAILQ_INIT(&subsystem.pending_connects);
 	subsystem.tgt = &tgt;
 	subsystem.subtype = SPDK_NVMF_SUBTYPE_NVME;
 	subsystem.state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
@@ -2730,6 +2745,16 @@ test_nvmf_ctrlr_use_zcopy(void)
 	/* ZCOPY disabled on transport level */
 	transport.opts.zcopy = false;
 	CU_ASSERT(nvmf_ctrlr_use_zcopy(&req) == false);
+
+	/* ZCOPY enabled for reads only */
+	transport.opts.zcopy_read = true;
+	CU_ASSERT(nvmf_ctrlr_use_zcopy(&req) == false);
+	cmd.nvme_cmd.opc = SPDK_NVME_OPC_READ;
+	CU_ASSERT(nvmf_ctrlr_use_zcopy(&req));
+	CU_ASSERT(req.zcopy_phase == NVMF_ZCOPY_PHASE_INIT);
+	req.zcopy_phase = NVMF_ZCOPY_PHASE_NONE;
+	cmd.nvme_cmd.opc = SPDK_NVME_OPC_WRITE;
+	transport.opts.zcopy_read = false;
 	transport.opts.zcopy = true;
 
 	/* Success */
@@ -3439,6 +3464,204 @@ test_nvmf_check_qpair_active(void)
 	}
 }
 
+static void
+test_nvmf_fair_sched(void)
+{
+	struct spdk_nvmf_request req[8] = {};
+	struct spdk_nvme_cmd cmd[8] = {};
+	union nvmf_c2h_msg rsp[8] = {};
+	struct spdk_nvmf_qpair qpair[2] = {};
+	struct spdk_nvmf_ctrlr ctrlr[2] = {};
+	struct spdk_nvmf_transport transport = {};
+	struct spdk_nvmf_subsystem subsystem = {};
+	struct spdk_nvmf_ns ns = {};
+	struct spdk_nvmf_ns *subsys_ns[1] = {};
+	enum spdk_nvme_ana_state ana_state[1];
+	struct spdk_nvmf_subsystem_listener listener = { .ana_state = ana_state };
+	struct spdk_bdev bdev = { .blockcnt = 100, .blocklen = 512};
+	struct spdk_nvmf_poll_group group = {};
+	struct spdk_nvmf_subsystem_poll_group sgroups = {};
+	struct spdk_nvmf_subsystem_pg_ns_info ns_info = {};
+	struct spdk_io_channel io_ch = {};
+	struct nvmf_fair_sched *sched;
+	struct nvmf_fair_flow *flow1, *flow2;
+	/* host1 sends requests 0-5 and host2 6-7, the namespace admits two at a time */
+	int completed[] = { 0, 1, 2, 6, 3, 7 };
+	int started[] = { 2, 6, 3, 7, 4, 5 };
+	int i;
+
+	ns.nsid = 1;
+	ns.subsystem = &subsystem;
+	ns.bdev = &bdev;
+	ns.anagrpid = 1;
+	ns.fair_io_depth = 2;
+
+	subsystem.id = 0;
+	subsystem.max_nsid = 1;
+	subsys_ns[0] = &ns;
+	subsystem.ns = (struct spdk_nvmf_ns **)&subsys_ns;
+
+	listener.ana_state[0] = SPDK_NVME_ANA_OPTIMIZED_STATE;
+
+	group.thread = spdk_get_thread();
+	group.num_sgroups = 1;
+	sgroups.state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	sgroups.num_ns = 1;
+	ns_info.state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	ns_info.channel = &io_ch;
+	sgroups.ns_info = &ns_info;
+	TAILQ_INIT(&sgroups.queued);
+	group.sgroups = &sgroups;
+	TAILQ_INIT(&group.qpairs);
+
+	for (i = 0; i < 2; i++) {
+		ctrlr[i].vcprop.cc.bits.en = 1;
+		ctrlr[i].subsys = &subsystem;
+		ctrlr[i].listener = &listener;
+		ctrlr[i].visible_ns = spdk_bit_array_create(1);
+		spdk_bit_array_set(ctrlr[i].visible_ns, 0);
+		snprintf(ctrlr[i].hostnqn, sizeof(ctrlr[i].hostnqn), "nqn.2016-06.io.spdk:host%d", i + 1);
+
+		qpair[i].ctrlr = &ctrlr[i];
+		qpair[i].group = &group;
+		qpair[i].transport = &transport;
+		qpair[i].qid = 1;
+		qpair[i].state = SPDK_NVMF_QPAIR_ENABLED;
+		TAILQ_INIT(&qpair[i].outstanding);
+		TAILQ_INSERT_TAIL(&group.qpairs, &qpair[i], link);
+	}
+
+	for (i = 0; i < 8; i++) {
+		cmd[i].opc = SPDK_NVME_OPC_READ;
+		cmd[i].nsid = 1;
+		req[i].qpair = i < 6 ? &qpair[0] : &qpair[1];
+		req[i].cmd = (union nvmf_h2c_msg *)&cmd[i];
+		req[i].rsp = &rsp[i];
+		/* Each request uses up a whole quantum */
+		req[i].length = NVMF_FAIR_QUANTUM - NVMF_FAIR_IO_COST;
+	}
+
+	MOCK_SET(nvmf_bdev_ctrlr_read_cmd, SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS);
+
+	for (i = 0; i < 8; i++) {
+		spdk_nvmf_request_exec(&req[i]);
+	}
+
+	sched = ns_info.fair;
+	SPDK_CU_ASSERT_FATAL(sched != NULL);
+	flow1 = TAILQ_FIRST(&sched->flows);
+	SPDK_CU_ASSERT_FATAL(flow1 != NULL);
+	flow2 = TAILQ_NEXT(flow1, link);
+	SPDK_CU_ASSERT_FATAL(flow2 != NULL);
+	CU_ASSERT(strcmp(flow1->hostnqn, ctrlr[0].hostnqn) == 0);
+	CU_ASSERT(strcmp(flow2->hostnqn, ctrlr[1].hostnqn) == 0);
+	CU_ASSERT(sched->io_inflight == 2);
+	CU_ASSERT(req[0].fair_sched == 1);
+	CU_ASSERT(req[1].fair_sched == 1);
+	CU_ASSERT(flow1->stat.queued_ios == 4);
+	CU_ASSERT(flow2->stat.queued_ios == 2);
+	CU_ASSERT(ns_info.io_outstanding == 8);
+
+	/* Each qpair looks its host's flow up only once */
+	SPDK_CU_ASSERT_FATAL(qpair[0].num_fair_flows == 1);
+	CU_ASSERT(qpair[0].fair_flows[0] == flow1);
+	SPDK_CU_ASSERT_FATAL(qpair[1].num_fair_flows == 1);
+	CU_ASSERT(qpair[1].fair_flows[0] == flow2);
+
+	/* Hosts with equal weights take turns as slots free up */
+	for (i = 0; i < (int)SPDK_COUNTOF(completed); i++) {
+		CU_ASSERT(req[started[i]].fair_sched == 0);
+		_nvmf_request_complete(&req[completed[i]]);
+		CU_ASSERT(req[completed[i]].fair_sched == 0);
+		CU_ASSERT(req[started[i]].fair_sched == 1);
+		CU_ASSERT(sched->io_inflight == 2);
+	}
+
+	_nvmf_request_complete(&req[4]);
+	_nvmf_request_complete(&req[5]);
+	CU_ASSERT(sched->io_inflight == 0);
+	CU_ASSERT(TAILQ_EMPTY(&sched->active));
+	CU_ASSERT(ns_info.io_outstanding == 0);
+	CU_ASSERT(flow1->stat.submitted_ios == 6);
+	CU_ASSERT(flow1->stat.deferred_ios == 4);
+	CU_ASSERT(flow1->stat.queued_ios == 0);
+	CU_ASSERT(flow2->stat.submitted_ios == 2);
+	CU_ASSERT(flow2->stat.deferred_ios == 2);
+	CU_ASSERT(flow2->stat.submitted_bytes == 2 * req[6].length);
+
+	/* A host with twice the weight gets two requests in for every one of the other host */
+	g_ut_host2_weight = 2;
+	subsystem.host_weight_gen++;
+
+	for (i = 0; i < 4; i++) {
+		spdk_nvmf_request_exec(&req[i]);
+	}
+	spdk_nvmf_request_exec(&req[6]);
+	spdk_nvmf_request_exec(&req[7]);
+	CU_ASSERT(sched->io_inflight == 2);
+
+	_nvmf_request_complete(&req[0]);
+	CU_ASSERT(req[2].fair_sched == 1);
+	_nvmf_request_complete(&req[1]);
+	CU_ASSERT(req[6].fair_sched == 1);
+	CU_ASSERT(flow2->weight == 2);
+	_nvmf_request_complete(&req[2]);
+	CU_ASSERT(req[7].fair_sched == 1);
+	CU_ASSERT(req[3].fair_sched == 0);
+	_nvmf_request_complete(&req[6]);
+	CU_ASSERT(req[3].fair_sched == 1);
+	_nvmf_request_complete(&req[7]);
+	_nvmf_request_complete(&req[3]);
+	CU_ASSERT(sched->io_inflight == 0);
+	CU_ASSERT(ns_info.io_outstanding == 0);
+
+	/* Without a limit, requests bypass the scheduler */
+	ns.fair_io_depth = 0;
+	for (i = 0; i < 8; i++) {
+		spdk_nvmf_request_exec(&req[i]);
+		CU_ASSERT(req[i].fair_sched == 0);
+	}
+	CU_ASSERT(sched->io_inflight == 0);
+	CU_ASSERT(flow1->stat.submitted_ios == 10);
+	CU_ASSERT(ns_info.io_outstanding == 8);
+	for (i = 0; i < 8; i++) {
+		_nvmf_request_complete(&req[i]);
+	}
+	CU_ASSERT(ns_info.io_outstanding == 0);
+
+	/* Requests queued when the limit is lifted still get through */
+	ns.fair_io_depth = 1;
+	for (i = 0; i < 3; i++) {
+		spdk_nvmf_request_exec(&req[i]);
+	}
+	CU_ASSERT(req[0].fair_sched == 1);
+	CU_ASSERT(flow1->stat.queued_ios == 2);
+	ns.fair_io_depth = 0;
+	spdk_nvmf_request_exec(&req[6]);
+	CU_ASSERT(req[6].fair_sched == 0);
+	_nvmf_request_complete(&req[6]);
+	_nvmf_request_complete(&req[0]);
+	CU_ASSERT(req[1].fair_sched == 1);
+	_nvmf_request_complete(&req[1]);
+	CU_ASSERT(req[2].fair_sched == 1);
+	_nvmf_request_complete(&req[2]);
+	CU_ASSERT(sched->io_inflight == 0);
+	CU_ASSERT(TAILQ_EMPTY(&sched->active));
+	CU_ASSERT(ns_info.io_outstanding == 0);
+
+	MOCK_CLEAR(nvmf_bdev_ctrlr_read_cmd);
+	g_ut_host2_weight = 1;
+	/* Freeing the scheduler drops the flows the qpairs cached */
+	nvmf_fair_sched_free(&group, &ns_info);
+	CU_ASSERT(ns_info.fair == NULL);
+	CU_ASSERT(qpair[0].fair_flows[0] == NULL);
+	CU_ASSERT(qpair[1].fair_flows[0] == NULL);
+	nvmf_fair_qpair_reset(&qpair[0]);
+	nvmf_fair_qpair_reset(&qpair[1]);
+	spdk_bit_array_free(&ctrlr[0].visible_ns);
+	spdk_bit_array_free(&ctrlr[1].visible_ns);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -3480,6 +3703,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvmf_ctrlr_set_features_host_behavior_support);
 	CU_ADD_TEST(suite, test_nvmf_ctrlr_ns_attachment);
 	CU_ADD_TEST(suite, test_nvmf_check_qpair_active);
+	CU_ADD_TEST(suite, test_nvmf_fair_sched);
 
 	allocate_threads(1);
 	set_thread(0);
@@ -284,6 +284,8 @@ test_discovery_log(void)
 	struct iovec iov;
 	struct spdk_nvmf_discovery_log_page *disc_log;
 	struct spdk_nvmf_discovery_log_page_entry *entry;
+	struct spdk_nvmf_discovery_log_page *cached_log_page;
+	struct nvmf_discovery_log_cache cache = {};
 	struct spdk_nvme_transport_id trid = {};
 	const char *hostnqn = "nqn.2016-06.io.spdk:host1";
 	int rc;
@@ -306,7 +308,7 @@ test_discovery_log(void)
 	/* Get only genctr (first field in the header) */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(disc_log->genctr),
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, sizeof(disc_log->genctr),
 				    &trid);
 	/* No listeners yet on new subsystem, so genctr should still be 0. */
 	CU_ASSERT(disc_log->genctr == 0);
@@ -318,14 +320,14 @@ test_discovery_log(void)
 	/* Get only genctr (first field in the header) */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(disc_log->genctr),
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, sizeof(disc_log->genctr),
 				    &trid);
 	CU_ASSERT(disc_log->genctr == 1); /* one added subsystem and listener */
 
 	/* Get only the header, no entries */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(*disc_log),
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, sizeof(*disc_log),
 				    &trid);
 	CU_ASSERT(disc_log->genctr == 1);
 	CU_ASSERT(disc_log->numrec == 1);
@@ -333,7 +335,7 @@ test_discovery_log(void)
 	/* Offset 0, exact size match */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0,
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0,
 				    sizeof(*disc_log) + sizeof(disc_log->entries[0]), &trid);
 	CU_ASSERT(disc_log->genctr != 0);
 	CU_ASSERT(disc_log->numrec == 1);
@@ -342,7 +344,7 @@ test_discovery_log(void)
 	/* Offset 0, oversize buffer */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(buffer), &trid);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, sizeof(buffer), &trid);
 	CU_ASSERT(disc_log->genctr != 0);
 	CU_ASSERT(disc_log->numrec == 1);
 	CU_ASSERT(disc_log->entries[0].trtype == 42);
@@ -352,18 +354,40 @@ test_discovery_log(void)
 	/* Get just the first entry, no header */
 	memset(buffer, 0xCC, sizeof(buffer));
 	entry = (struct spdk_nvmf_discovery_log_page_entry *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1,
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1,
 				    offsetof(struct spdk_nvmf_discovery_log_page, entries[0]), sizeof(*entry), &trid);
 	CU_ASSERT(entry->trtype == 42);
 
+	/* The cached log page is reused until the discovery log changes */
+	memset(buffer, 0xCC, sizeof(buffer));
+	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
+	nvmf_get_discovery_log_page(&tgt, hostnqn, &cache, &iov, 1, 0, sizeof(*disc_log), &trid);
+	CU_ASSERT(disc_log->numrec == 1);
+	SPDK_CU_ASSERT_FATAL(cache.log_page != NULL);
+	cached_log_page = cache.log_page;
+
+	memset(buffer, 0xCC, sizeof(buffer));
+	entry = (struct spdk_nvmf_discovery_log_page_entry *)buffer;
+	nvmf_get_discovery_log_page(&tgt, hostnqn, &cache, &iov, 1,
+				    offsetof(struct spdk_nvmf_discovery_log_page, entries[0]), sizeof(*entry), &trid);
+	CU_ASSERT(entry->trtype == 42);
+	CU_ASSERT(cache.log_page == cached_log_page);
+
 	/* remove the host and verify that the discovery log contains nothing */
 	rc = spdk_nvmf_subsystem_remove_host(subsystem, hostnqn);
 	CU_ASSERT(rc == 0);
 
+	memset(buffer, 0xCC, sizeof(buffer));
+	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
+	nvmf_get_discovery_log_page(&tgt, hostnqn, &cache, &iov, 1, 0, sizeof(*disc_log), &trid);
+	CU_ASSERT(disc_log->numrec == 0);
+	CU_ASSERT(cache.gen == tgt.discovery_log_gen);
+	free(cache.log_page);
+
 	/* Get only the header, no entries */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(*disc_log),
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, sizeof(*disc_log),
 				    &trid);
 	CU_ASSERT(disc_log->genctr != 0);
 	CU_ASSERT(disc_log->numrec == 0);
@@ -376,7 +400,7 @@ test_discovery_log(void)
 	/* Get only the header, no entries */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(*disc_log),
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, sizeof(*disc_log),
 				    &trid);
 	CU_ASSERT(disc_log->genctr != 0);
 	CU_ASSERT(disc_log->numrec == 0);
@@ -505,12 +529,12 @@ test_discovery_log_with_filters(void)
 
 	/* Test case 1 - check that all trids are reported */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_ANY;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 8);
 
 	/* Test case 2 - check that only entries of the same transport type are returned */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_TYPE;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 5);
 	CU_ASSERT(disc_log->entries[0].trtype == rdma_trid_1.trtype);
 	CU_ASSERT(disc_log->entries[1].trtype == rdma_trid_1.trtype);
@@ -518,7 +542,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[3].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[4].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 5);
 	CU_ASSERT(disc_log->entries[0].trtype == tcp_trid_1.trtype);
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_1.trtype);
@@ -528,7 +552,7 @@ test_discovery_log_with_filters(void)
 
 	/* Test case 3 - check that only entries of the same transport address are returned */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_ADDRESS;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 5);
 	/* 1 tcp and 3 rdma  */
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_1.traddr) == 0);
@@ -537,7 +561,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(strcasecmp(disc_log->entries[3].traddr, tcp_trid_4.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[4].traddr, rdma_trid_4.traddr) == 0);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 5);
 	/* 1 rdma and 3 tcp */
 	CU_ASSERT((disc_log->entries[0].trtype ^ disc_log->entries[1].trtype ^ disc_log->entries[2].trtype)
@@ -551,7 +575,7 @@ test_discovery_log_with_filters(void)
 	/* Test case 4 - check that only entries of the same transport address and type returned */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_TYPE |
 			       SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_ADDRESS;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 4);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, rdma_trid_1.traddr) == 0);
@@ -562,7 +586,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[2].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[3].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_2);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -571,7 +595,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 4);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_1.traddr) == 0);
@@ -582,7 +606,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[2].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[3].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_2);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -594,7 +618,7 @@ test_discovery_log_with_filters(void)
 	/* Test case 5 - check that only entries of the same transport address and type returned */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_TYPE |
 			       SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_SVCID;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 4);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].trsvcid, rdma_trid_1.trsvcid) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].trsvcid, rdma_trid_2.trsvcid) == 0);
@@ -605,7 +629,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[2].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[3].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_3);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_3);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].trsvcid, rdma_trid_3.trsvcid) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].trsvcid, tcp_trid_4.trsvcid) == 0);
@@ -614,7 +638,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].trsvcid, tcp_trid_1.trsvcid) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].trsvcid, tcp_trid_4.trsvcid) == 0);
@@ -623,7 +647,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_2);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &tcp_trid_2);
 	CU_ASSERT(disc_log->numrec == 4);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].trsvcid, tcp_trid_2.trsvcid) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].trsvcid, tcp_trid_2.trsvcid) == 0);
@@ -638,7 +662,7 @@ test_discovery_log_with_filters(void)
 	 * That also implies trtype since RDMA and TCP listeners can't occupy the same socket */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_ADDRESS |
 			       SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_SVCID;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -650,7 +674,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_2);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -662,7 +686,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_3);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_3);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_3.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -674,7 +698,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -686,7 +710,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_2);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &tcp_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -698,7 +722,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_3);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &tcp_trid_3);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_3.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -714,7 +738,7 @@ test_discovery_log_with_filters(void)
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_TYPE |
 			       SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_ADDRESS |
 			       SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_SVCID;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -726,7 +750,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_2);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -738,7 +762,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_3);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &rdma_trid_3);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_3.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -750,7 +774,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -762,7 +786,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_2);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &tcp_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -774,7 +798,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_3);
+	nvmf_get_discovery_log_page(&tgt, hostnqn, NULL, &iov, 1, 0, 8192, &tcp_trid_3);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_3.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
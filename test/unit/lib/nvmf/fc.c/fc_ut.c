@@ -170,6 +170,9 @@ DEFINE_STUB_V(nvmf_fc_dump_all_queues, (struct spdk_nvmf_fc_hwqp *ls_queue,
 					struct spdk_nvmf_fc_hwqp *io_queues,
 					uint32_t num_io_queues,
 					struct spdk_nvmf_fc_queue_dump_info *dump_info));
+DEFINE_STUB_V(nvmf_fair_sched_free, (struct spdk_nvmf_poll_group *group,
+		struct spdk_nvmf_subsystem_pg_ns_info *ns_info));
+DEFINE_STUB_V(nvmf_fair_qpair_reset, (struct spdk_nvmf_qpair *qpair));
 
 uint32_t
 nvmf_fc_process_queue(struct spdk_nvmf_fc_hwqp *hwqp)
@@ -117,6 +117,18 @@ DEFINE_STUB(spdk_key_get_name, const char *, (struct spdk_key *k), NULL);
 DEFINE_STUB(nvmf_qpair_auth_init, int, (struct spdk_nvmf_qpair *q), 0);
 DEFINE_STUB_V(nvmf_qpair_auth_destroy, (struct spdk_nvmf_qpair *q));
 DEFINE_STUB_V(nvmf_tgt_stop_mdns_prr, (struct spdk_nvmf_tgt *tgt));
+DEFINE_STUB(nvmf_transport_supports_migration, bool, (struct spdk_nvmf_transport *transport),
+	    false);
+DEFINE_STUB_V(nvmf_transport_qpair_quiesce, (struct spdk_nvmf_qpair *qpair, bool quiesce));
+DEFINE_STUB(nvmf_transport_poll_group_detach, int,
+	    (struct spdk_nvmf_transport_poll_group *group,
+	     struct spdk_nvmf_qpair *qpair), 0);
+DEFINE_STUB(nvmf_transport_poll_group_attach, int,
+	    (struct spdk_nvmf_transport_poll_group *group,
+	     struct spdk_nvmf_qpair *qpair), 0);
+DEFINE_STUB_V(nvmf_fair_sched_free, (struct spdk_nvmf_poll_group *group,
+		struct spdk_nvmf_subsystem_pg_ns_info *ns_info));
+DEFINE_STUB_V(nvmf_fair_qpair_reset, (struct spdk_nvmf_qpair *qpair));
 
 struct spdk_io_channel {
 	struct spdk_thread		*thread;
@@ -223,6 +235,316 @@ test_nvmf_tgt_create_poll_group(void)
 	MOCK_CLEAR(spdk_bdev_get_io_channel);
 }
 
+static void
+test_nvmf_poll_group_load_cmp(void)
+{
+	struct spdk_nvmf_poll_group group1 = {}, group2 = {};
+
+	pthread_mutex_init(&group1.mutex, NULL);
+	pthread_mutex_init(&group2.mutex, NULL);
+
+	CU_ASSERT(nvmf_poll_group_load_cmp(&group1, &group2) == 0);
+
+	/* Qpairs that are still connecting count as I/O qpairs */
+	group1.current_unassociated_qpairs = 1;
+	CU_ASSERT(nvmf_poll_group_load_cmp(&group1, &group2) > 0);
+	group2.stat.current_io_qpairs = 2;
+	CU_ASSERT(nvmf_poll_group_load_cmp(&group1, &group2) < 0);
+
+	/* Outstanding I/O weighs more than the number of qpairs */
+	group1.load.outstanding_io = 64;
+	group2.load.outstanding_io = 8;
+	CU_ASSERT(nvmf_poll_group_load_cmp(&group1, &group2) > 0);
+
+	/* A small difference in how busy the threads are doesn't matter... */
+	group1.load.busy_permille = 110;
+	group2.load.busy_permille = 150;
+	CU_ASSERT(nvmf_poll_group_load_cmp(&group1, &group2) > 0);
+
+	/* ...but a large one does */
+	group2.load.busy_permille = 500;
+	CU_ASSERT(nvmf_poll_group_load_cmp(&group1, &group2) < 0);
+	CU_ASSERT(nvmf_poll_group_load_cmp(&group2, &group1) > 0);
+
+	pthread_mutex_destroy(&group1.mutex);
+	pthread_mutex_destroy(&group2.mutex);
+}
+
+static void
+ut_qpair_migrate_done(void *cb_arg, int status)
+{
+	*(int *)cb_arg = status;
+}
+
+static void
+ut_poll_thread(struct spdk_thread *thread)
+{
+	while (spdk_thread_poll(thread, 0, 0) > 0) {
+	}
+}
+
+static void
+test_nvmf_qpair_migrate(void)
+{
+	struct spdk_thread *thread;
+	struct spdk_nvmf_transport transport = {};
+	struct spdk_nvmf_poll_group group1 = {}, group2 = {};
+	struct spdk_nvmf_transport_poll_group tgroup1 = {}, tgroup2 = {};
+	struct spdk_nvmf_ctrlr ctrlr = {};
+	struct spdk_nvmf_qpair qpair = {};
+	int rc, status;
+
+	thread = spdk_thread_create(NULL, NULL);
+	SPDK_CU_ASSERT_FATAL(thread != NULL);
+	spdk_set_thread(thread);
+
+	group1.thread = thread;
+	TAILQ_INIT(&group1.tgroups);
+	TAILQ_INIT(&group1.qpairs);
+	tgroup1.transport = &transport;
+	tgroup1.group = &group1;
+	TAILQ_INSERT_TAIL(&group1.tgroups, &tgroup1, link);
+	group2.thread = thread;
+	TAILQ_INIT(&group2.tgroups);
+	TAILQ_INIT(&group2.qpairs);
+	tgroup2.transport = &transport;
+	tgroup2.group = &group2;
+	TAILQ_INSERT_TAIL(&group2.tgroups, &tgroup2, link);
+
+	ctrlr.vcprop.cc.bits.en = 1;
+	qpair.transport = &transport;
+	qpair.ctrlr = &ctrlr;
+	qpair.qid = 1;
+	qpair.group = &group1;
+	qpair.state = SPDK_NVMF_QPAIR_ENABLED;
+	TAILQ_INIT(&qpair.outstanding);
+	TAILQ_INSERT_TAIL(&group1.qpairs, &qpair, link);
+	group1.stat.current_io_qpairs = 1;
+
+	/* The transport doesn't support migration */
+	rc = spdk_nvmf_qpair_migrate(&qpair, &group2, ut_qpair_migrate_done, &status);
+	CU_ASSERT(rc == -ENOTSUP);
+
+	MOCK_SET(nvmf_transport_supports_migration, true);
+
+	/* Admin qpairs stay with their controller */
+	qpair.qid = 0;
+	rc = spdk_nvmf_qpair_migrate(&qpair, &group2, ut_qpair_migrate_done, &status);
+	CU_ASSERT(rc == -EINVAL);
+	qpair.qid = 1;
+
+	rc = spdk_nvmf_qpair_migrate(&qpair, &group1, ut_qpair_migrate_done, &status);
+	CU_ASSERT(rc == -EINVAL);
+
+	/* The qpair is moved once the transport manages to detach it */
+	MOCK_SET(nvmf_transport_poll_group_detach, -EBUSY);
+	status = 1;
+	rc = spdk_nvmf_qpair_migrate(&qpair, &group2, ut_qpair_migrate_done, &status);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(qpair.migrate != NULL);
+	rc = spdk_nvmf_qpair_migrate(&qpair, &group2, ut_qpair_migrate_done, &status);
+	CU_ASSERT(rc == -EBUSY);
+
+	spdk_delay_us(NVMF_QPAIR_MIGRATE_POLL_US);
+	ut_poll_thread(thread);
+	CU_ASSERT(status == 1);
+	CU_ASSERT(qpair.group == &group1);
+
+	MOCK_SET(nvmf_transport_poll_group_detach, 0);
+	spdk_delay_us(NVMF_QPAIR_MIGRATE_POLL_US);
+	ut_poll_thread(thread);
+	CU_ASSERT(status == 0);
+	CU_ASSERT(qpair.migrate == NULL);
+	CU_ASSERT(qpair.group == &group2);
+	CU_ASSERT(TAILQ_EMPTY(&group1.qpairs));
+	CU_ASSERT(TAILQ_FIRST(&group2.qpairs) == &qpair);
+	CU_ASSERT(group1.stat.current_io_qpairs == 0);
+	CU_ASSERT(group2.stat.current_io_qpairs == 1);
+
+	/* Give up if the qpair doesn't become idle in time */
+	MOCK_SET(nvmf_transport_poll_group_detach, -EBUSY);
+	status = 1;
+	rc = spdk_nvmf_qpair_migrate(&qpair, &group1, ut_qpair_migrate_done, &status);
+	CU_ASSERT(rc == 0);
+	spdk_delay_us(NVMF_QPAIR_MIGRATE_TIMEOUT_US);
+	ut_poll_thread(thread);
+	CU_ASSERT(status == -ETIMEDOUT);
+	CU_ASSERT(qpair.migrate == NULL);
+	CU_ASSERT(qpair.group == &group2);
+	CU_ASSERT(TAILQ_FIRST(&group2.qpairs) == &qpair);
+
+	MOCK_CLEAR(nvmf_transport_poll_group_detach);
+	MOCK_CLEAR(nvmf_transport_supports_migration);
+
+	spdk_thread_exit(thread);
+	while (!spdk_thread_is_exited(thread)) {
+		spdk_thread_poll(thread, 0, 0);
+	}
+	spdk_thread_destroy(thread);
+}
+
+static int
+ut_poll_group_create(void *io_device, void *ctx_buf)
+{
+	return 0;
+}
+
+static void
+ut_poll_group_destroy(void *io_device, void *ctx_buf)
+{
+}
+
+static void
+test_nvmf_tgt_rebalance_poll_groups(void)
+{
+	struct spdk_nvmf_tgt tgt = {};
+	struct spdk_thread *thread1, *thread2;
+	struct spdk_io_channel *ch1, *ch2;
+	struct spdk_nvmf_poll_group *group1, *group2, *src, *dst;
+	struct spdk_nvmf_transport transport = {};
+	struct spdk_nvmf_transport_poll_group tgroup1 = {}, tgroup2 = {};
+	struct spdk_nvmf_ctrlr ctrlr = {};
+	struct spdk_nvmf_qpair qpair1 = {}, qpair2 = {};
+
+	thread1 = spdk_thread_create(NULL, NULL);
+	SPDK_CU_ASSERT_FATAL(thread1 != NULL);
+	thread2 = spdk_thread_create(NULL, NULL);
+	SPDK_CU_ASSERT_FATAL(thread2 != NULL);
+
+	pthread_mutex_init(&tgt.mutex, NULL);
+	TAILQ_INIT(&tgt.poll_groups);
+	tgt.state = NVMF_TGT_RUNNING;
+	spdk_set_thread(thread1);
+	spdk_io_device_register(&tgt, ut_poll_group_create, ut_poll_group_destroy,
+				sizeof(struct spdk_nvmf_poll_group), NULL);
+
+	ch1 = spdk_get_io_channel(&tgt);
+	SPDK_CU_ASSERT_FATAL(ch1 != NULL);
+	group1 = spdk_io_channel_get_ctx(ch1);
+	spdk_set_thread(thread2);
+	ch2 = spdk_get_io_channel(&tgt);
+	SPDK_CU_ASSERT_FATAL(ch2 != NULL);
+	group2 = spdk_io_channel_get_ctx(ch2);
+
+	group1->thread = thread1;
+	pthread_mutex_init(&group1->mutex, NULL);
+	TAILQ_INIT(&group1->tgroups);
+	TAILQ_INIT(&group1->qpairs);
+	tgroup1.transport = &transport;
+	tgroup1.group = group1;
+	TAILQ_INSERT_TAIL(&group1->tgroups, &tgroup1, link);
+	TAILQ_INSERT_TAIL(&tgt.poll_groups, group1, link);
+	group2->thread = thread2;
+	pthread_mutex_init(&group2->mutex, NULL);
+	TAILQ_INIT(&group2->tgroups);
+	TAILQ_INIT(&group2->qpairs);
+	tgroup2.transport = &transport;
+	tgroup2.group = group2;
+	TAILQ_INSERT_TAIL(&group2->tgroups, &tgroup2, link);
+	TAILQ_INSERT_TAIL(&tgt.poll_groups, group2, link);
+
+	ctrlr.vcprop.cc.bits.en = 1;
+	qpair1.transport = &transport;
+	qpair1.ctrlr = &ctrlr;
+	qpair1.qid = 1;
+	qpair1.group = group1;
+	qpair1.state = SPDK_NVMF_QPAIR_ENABLED;
+	qpair1.queue_depth = 8;
+	TAILQ_INIT(&qpair1.outstanding);
+	TAILQ_INSERT_TAIL(&group1->qpairs, &qpair1, link);
+	group1->stat.current_io_qpairs = 1;
+
+	/* A poll group with a single qpair is left alone, however busy it is */
+	group1->load.busy_permille = 900;
+	CU_ASSERT(!nvmf_tgt_get_rebalance_poll_groups(&tgt, &src, &dst));
+
+	qpair2 = qpair1;
+	qpair2.qid = 2;
+	qpair2.queue_depth = 40;
+	TAILQ_INIT(&qpair2.outstanding);
+	TAILQ_INSERT_TAIL(&group1->qpairs, &qpair2, link);
+	group1->stat.current_io_qpairs = 2;
+
+	CU_ASSERT(nvmf_tgt_get_rebalance_poll_groups(&tgt, &src, &dst));
+	CU_ASSERT(src == group1);
+	CU_ASSERT(dst == group2);
+
+	/* Similar loads are left alone */
+	group1->load.busy_permille = 400;
+	group2->load.busy_permille = 300;
+	group2->stat.current_io_qpairs = 1;
+	CU_ASSERT(!nvmf_tgt_get_rebalance_poll_groups(&tgt, &src, &dst));
+
+	/* A large difference in busy ratio or in the number of qpairs is not */
+	group1->load.busy_permille = 500;
+	CU_ASSERT(nvmf_tgt_get_rebalance_poll_groups(&tgt, &src, &dst));
+	group1->load.busy_permille = 400;
+	group2->stat.current_io_qpairs = 0;
+	CU_ASSERT(nvmf_tgt_get_rebalance_poll_groups(&tgt, &src, &dst));
+
+	/* The qpair that evens out the outstanding I/O the most is moved */
+	group1->load.outstanding_io = 64;
+	MOCK_SET(nvmf_transport_supports_migration, false);
+	CU_ASSERT(nvmf_poll_group_get_rebalance_qpair(group1, group2) == NULL);
+	MOCK_SET(nvmf_transport_supports_migration, true);
+	CU_ASSERT(nvmf_poll_group_get_rebalance_qpair(group1, group2) == &qpair2);
+	group1->load.outstanding_io = 16;
+	CU_ASSERT(nvmf_poll_group_get_rebalance_qpair(group1, group2) == &qpair1);
+
+	/* Qpairs that are already being moved aren't picked again */
+	qpair1.migrate = (void *)0xdeadbeef;
+	CU_ASSERT(nvmf_poll_group_get_rebalance_qpair(group1, group2) == &qpair2);
+	qpair1.migrate = NULL;
+
+	MOCK_SET(nvmf_transport_poll_group_detach, 0);
+	spdk_set_thread(thread1);
+	CU_ASSERT(nvmf_tgt_rebalance_poll_groups(&tgt) == SPDK_POLLER_BUSY);
+	CU_ASSERT(tgt.rebalance_in_progress);
+	CU_ASSERT(nvmf_tgt_rebalance_poll_groups(&tgt) == SPDK_POLLER_IDLE);
+
+	while (tgt.rebalance_in_progress) {
+		spdk_delay_us(NVMF_QPAIR_MIGRATE_POLL_US);
+		ut_poll_thread(thread1);
+		ut_poll_thread(thread2);
+	}
+	CU_ASSERT(qpair1.group == group2);
+	CU_ASSERT(qpair2.group == group1);
+	CU_ASSERT(TAILQ_FIRST(&group1->qpairs) == &qpair2);
+	CU_ASSERT(TAILQ_FIRST(&group2->qpairs) == &qpair1);
+	CU_ASSERT(group1->stat.current_io_qpairs == 1);
+	CU_ASSERT(group2->stat.current_io_qpairs == 1);
+
+	/* Once the load is even, nothing moves */
+	CU_ASSERT(nvmf_tgt_rebalance_poll_groups(&tgt) == SPDK_POLLER_IDLE);
+
+	MOCK_CLEAR(nvmf_transport_poll_group_detach);
+	MOCK_CLEAR(nvmf_transport_supports_migration);
+
+	pthread_mutex_destroy(&group1->mutex);
+	pthread_mutex_destroy(&group2->mutex);
+	spdk_put_io_channel(ch1);
+	spdk_set_thread(thread2);
+	spdk_put_io_channel(ch2);
+	spdk_set_thread(thread1);
+	spdk_io_device_unregister(&tgt, NULL);
+	ut_poll_thread(thread1);
+	ut_poll_thread(thread2);
+	pthread_mutex_destroy(&tgt.mutex);
+
+	spdk_set_thread(thread1);
+	spdk_thread_exit(thread1);
+	while (!spdk_thread_is_exited(thread1)) {
+		spdk_thread_poll(thread1, 0, 0);
+	}
+	spdk_thread_destroy(thread1);
+	spdk_set_thread(thread2);
+	spdk_thread_exit(thread2);
+	while (!spdk_thread_is_exited(thread2)) {
+		spdk_thread_poll(thread2, 0, 0);
+	}
+	spdk_thread_destroy(thread2);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -234,6 +556,9 @@ main(int argc, char **argv)
 	suite = CU_add_suite("nvmf", NULL, NULL);
 
 	CU_ADD_TEST(suite, test_nvmf_tgt_create_poll_group);
+	CU_ADD_TEST(suite, test_nvmf_poll_group_load_cmp);
+	CU_ADD_TEST(suite, test_nvmf_qpair_migrate);
+	CU_ADD_TEST(suite, test_nvmf_tgt_rebalance_poll_groups);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
@@ -52,6 +52,8 @@ DEFINE_STUB(ibv_dereg_mr, int, (struct ibv_mr *mr), 0);
 DEFINE_STUB(ibv_resize_cq, int, (struct ibv_cq *cq, int cqe), 0);
 DEFINE_STUB(spdk_mempool_lookup, struct spdk_mempool *, (const char *name), NULL);
 DEFINE_STUB(spdk_rdma_cm_id_get_numa_id, int32_t, (struct rdma_cm_id *cm_id), 0);
+DEFINE_STUB(nvmf_poll_group_load_cmp, int, (struct spdk_nvmf_poll_group *group1,
+		struct spdk_nvmf_poll_group *group2), 0);
 
 /* ibv_reg_mr can be a macro, need to undefine it */
 #ifdef ibv_reg_mr
@@ -1286,11 +1288,13 @@ test_nvmf_rdma_resources_create(void)
 
 	rdma_resource = nvmf_rdma_resources_create(&opts);
 	CU_ASSERT(rdma_resource != NULL);
+	CU_ASSERT(rdma_resource->active_depth == DEPTH);
+	CU_ASSERT(rdma_resource->num_buf_chunks == 1);
 	/* Just check first and last entry */
 	recv = &rdma_resource->recvs[0];
 	req = &rdma_resource->reqs[0];
 	CU_ASSERT(recv->rdma_wr.type == RDMA_WR_TYPE_RECV);
-	CU_ASSERT((uintptr_t)recv->buf == (uintptr_t)(rdma_resource->bufs));
+	CU_ASSERT((uintptr_t)recv->buf == (uintptr_t)(rdma_resource->buf_chunks[0]));
 	CU_ASSERT(recv->sgl[0].addr == (uintptr_t)&rdma_resource->cmds[0]);
 	CU_ASSERT(recv->sgl[0].length == sizeof(rdma_resource->cmds[0]));
 	CU_ASSERT(recv->sgl[0].lkey == RDMA_UT_LKEY);
@@ -1319,7 +1323,7 @@ test_nvmf_rdma_resources_create(void)
 	recv = &rdma_resource->recvs[DEPTH - 1];
 	req = &rdma_resource->reqs[DEPTH - 1];
 	CU_ASSERT(recv->rdma_wr.type == RDMA_WR_TYPE_RECV);
-	CU_ASSERT((uintptr_t)recv->buf == (uintptr_t)(rdma_resource->bufs +
+	CU_ASSERT((uintptr_t)recv->buf == (uintptr_t)(rdma_resource->buf_chunks[0] +
 			(DEPTH - 1) * 4096));
 	CU_ASSERT(recv->sgl[0].addr == (uintptr_t)&rdma_resource->cmds[DEPTH - 1]);
 	CU_ASSERT(recv->sgl[0].length == sizeof(rdma_resource->cmds[DEPTH - 1]));
@@ -1349,6 +1353,106 @@ test_nvmf_rdma_resources_create(void)
 	nvmf_rdma_resources_destroy(rdma_resource);
 }
 
+static void
+test_nvmf_rdma_resources_grow_srq(void)
+{
+	struct spdk_nvmf_rdma_resources *rdma_resource;
+	struct spdk_nvmf_rdma_resource_opts opts = {};
+	struct spdk_nvmf_rdma_recv *recv;
+	const uint32_t DEPTH = NVMF_RDMA_SRQ_GROW_DEPTH + 16;
+	int rc;
+
+	opts.max_queue_depth = DEPTH;
+	opts.in_capsule_data_size = 4096;
+	opts.shared = true;
+	opts.qp = &g_spdk_rdma_srq;
+
+	/* Only the first chunk of receives is set up on creation */
+	rdma_resource = nvmf_rdma_resources_create(&opts);
+	SPDK_CU_ASSERT_FATAL(rdma_resource != NULL);
+	CU_ASSERT(rdma_resource->active_depth == NVMF_RDMA_SRQ_GROW_DEPTH);
+	CU_ASSERT(rdma_resource->num_buf_chunks == 1);
+	recv = &rdma_resource->recvs[NVMF_RDMA_SRQ_GROW_DEPTH];
+	CU_ASSERT(recv->buf == NULL);
+	CU_ASSERT(recv->wr.sg_list == NULL);
+
+	/* Requests are set up for the whole depth */
+	CU_ASSERT(rdma_resource->reqs[DEPTH - 1].state == RDMA_REQUEST_STATE_FREE);
+
+	/* Growing sets up the remaining receives with a new chunk of buffers */
+	rc = nvmf_rdma_resources_grow_srq(rdma_resource, &g_spdk_rdma_srq);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(rdma_resource->active_depth == DEPTH);
+	CU_ASSERT(rdma_resource->num_buf_chunks == 2);
+	CU_ASSERT(recv->buf == rdma_resource->buf_chunks[1]);
+	CU_ASSERT(recv->sgl[1].addr == (uintptr_t)rdma_resource->buf_chunks[1]);
+	CU_ASSERT(recv->sgl[1].length == 4096);
+	CU_ASSERT(recv->wr.num_sge == 2);
+	CU_ASSERT(recv->wr.sg_list == recv->sgl);
+	recv = &rdma_resource->recvs[DEPTH - 1];
+	CU_ASSERT((uintptr_t)recv->buf == (uintptr_t)rdma_resource->buf_chunks[1] + 15 * 4096);
+
+	/* Nothing left to grow */
+	rc = nvmf_rdma_resources_grow_srq(rdma_resource, &g_spdk_rdma_srq);
+	CU_ASSERT(rc == -ENOSPC);
+	CU_ASSERT(rdma_resource->active_depth == DEPTH);
+
+	nvmf_rdma_resources_destroy(rdma_resource);
+}
+
+static void
+test_nvmf_rdma_poller_grow_srq(void)
+{
+	struct spdk_nvmf_rdma_resource_opts opts = {};
+	struct spdk_nvmf_rdma_poller rpoller = {};
+	const uint32_t DEPTH = NVMF_RDMA_SRQ_GROW_DEPTH * 2;
+
+	opts.max_queue_depth = DEPTH;
+	opts.in_capsule_data_size = 4096;
+	opts.shared = true;
+	opts.qp = &g_spdk_rdma_srq;
+
+	rpoller.resources = nvmf_rdma_resources_create(&opts);
+	SPDK_CU_ASSERT_FATAL(rpoller.resources != NULL);
+	rpoller.srq = &g_spdk_rdma_srq;
+	rpoller.stat.qp_stats.recv.num_submitted_wrs = NVMF_RDMA_SRQ_GROW_DEPTH;
+
+	/* Enough receives are still posted */
+	rpoller.srq_recvs_completed = NVMF_RDMA_SRQ_GROW_DEPTH / 2;
+	nvmf_rdma_poller_grow_srq(&rpoller);
+	CU_ASSERT(rpoller.resources->active_depth == NVMF_RDMA_SRQ_GROW_DEPTH);
+
+	/* A failed allocation keeps the maximum depth and delays the next attempt */
+	rpoller.srq_recvs_completed = NVMF_RDMA_SRQ_GROW_DEPTH;
+	MOCK_SET(spdk_zmalloc, NULL);
+	nvmf_rdma_poller_grow_srq(&rpoller);
+	CU_ASSERT(rpoller.resources->active_depth == NVMF_RDMA_SRQ_GROW_DEPTH);
+	CU_ASSERT(rpoller.resources->max_queue_depth == DEPTH);
+	CU_ASSERT(rpoller.srq_grow_backoff_us == NVMF_RDMA_SRQ_GROW_MIN_BACKOFF_US);
+	MOCK_CLEAR(spdk_zmalloc);
+
+	/* No retry before the backoff expires */
+	spdk_delay_us(NVMF_RDMA_SRQ_GROW_MIN_BACKOFF_US - 1);
+	nvmf_rdma_poller_grow_srq(&rpoller);
+	CU_ASSERT(rpoller.resources->active_depth == NVMF_RDMA_SRQ_GROW_DEPTH);
+
+	/* Another failure doubles the backoff */
+	spdk_delay_us(1);
+	MOCK_SET(spdk_zmalloc, NULL);
+	nvmf_rdma_poller_grow_srq(&rpoller);
+	CU_ASSERT(rpoller.resources->active_depth == NVMF_RDMA_SRQ_GROW_DEPTH);
+	CU_ASSERT(rpoller.srq_grow_backoff_us == 2 * NVMF_RDMA_SRQ_GROW_MIN_BACKOFF_US);
+	MOCK_CLEAR(spdk_zmalloc);
+
+	/* Once it expires, the queue grows and the backoff is reset */
+	spdk_delay_us(2 * NVMF_RDMA_SRQ_GROW_MIN_BACKOFF_US);
+	nvmf_rdma_poller_grow_srq(&rpoller);
+	CU_ASSERT(rpoller.resources->active_depth == DEPTH);
+	CU_ASSERT(rpoller.srq_grow_backoff_us == 0);
+
+	nvmf_rdma_resources_destroy(rpoller.resources);
+}
+
 static void
 test_nvmf_rdma_qpair_compare(void)
 {
@@ -1454,6 +1558,8 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvmf_rdma_opts_init);
 	CU_ADD_TEST(suite, test_nvmf_rdma_request_free_data);
 	CU_ADD_TEST(suite, test_nvmf_rdma_resources_create);
+	CU_ADD_TEST(suite, test_nvmf_rdma_resources_grow_srq);
+	CU_ADD_TEST(suite, test_nvmf_rdma_poller_grow_srq);
 	CU_ADD_TEST(suite, test_nvmf_rdma_qpair_compare);
 	CU_ADD_TEST(suite, test_nvmf_rdma_resize_cq);
 
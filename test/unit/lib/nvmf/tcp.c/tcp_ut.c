@@ -38,6 +38,8 @@ DEFINE_STUB(spdk_nvmf_qpair_get_listen_trid,
 	    (struct spdk_nvmf_qpair *qpair, struct spdk_nvme_transport_id *trid),
 	    0);
 DEFINE_STUB(spdk_nvmf_qpair_disconnect, int, (struct spdk_nvmf_qpair *qpair), 0);
+DEFINE_STUB(nvmf_poll_group_load_cmp, int, (struct spdk_nvmf_poll_group *group1,
+		struct spdk_nvmf_poll_group *group2), 0);
 
 DEFINE_STUB(nvmf_subsystem_add_ctrlr,
 	    int,
@@ -73,8 +75,9 @@ DEFINE_STUB(spdk_nvmf_ns_find_host,
 	    NULL);
 
 DEFINE_STUB_V(nvmf_get_discovery_log_page,
-	      (struct spdk_nvmf_tgt *tgt, const char *hostnqn, struct iovec *iov,
-	       uint32_t iovcnt, uint64_t offset, uint32_t length, struct spdk_nvme_transport_id *cmd_src_trid));
+	      (struct spdk_nvmf_tgt *tgt, const char *hostnqn, struct nvmf_discovery_log_cache *cache,
+	       struct iovec *iov, uint32_t iovcnt, uint64_t offset, uint32_t length,
+	       struct spdk_nvme_transport_id *cmd_src_trid));
 
 DEFINE_STUB_V(nvmf_subsystem_remove_ctrlr,
 	      (struct spdk_nvmf_subsystem *subsystem, struct spdk_nvmf_ctrlr *ctrlr));
@@ -261,6 +264,8 @@ DEFINE_STUB_V(spdk_keyring_put_key, (struct spdk_key *k));
 DEFINE_STUB(nvmf_ns_is_ptpl_capable, bool, (const struct spdk_nvmf_ns *ns), false);
 DEFINE_STUB(nvmf_subsystem_host_auth_required, bool, (struct spdk_nvmf_subsystem *s, const char *n),
 	    false);
+DEFINE_STUB(nvmf_subsystem_get_host_weight, uint32_t,
+	    (struct spdk_nvmf_subsystem *s, const char *n), 1);
 DEFINE_STUB(nvmf_qpair_auth_init, int, (struct spdk_nvmf_qpair *q), 0);
 DEFINE_STUB(nvmf_auth_request_exec, int, (struct spdk_nvmf_request *r),
 	    SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS);
@@ -273,6 +278,9 @@ spdk_accel_get_io_channel(void)
 	return spdk_get_io_channel(g_accel_p);
 }
 
+DEFINE_STUB(spdk_accel_get_opc_module_name, int,
+	    (enum spdk_accel_opcode opcode, const char **module_name), 0);
+
 DEFINE_STUB(spdk_accel_submit_crc32cv,
 	    int,
 	    (struct spdk_io_channel *ch, uint32_t *dst, struct iovec *iovs,
@@ -1327,6 +1335,121 @@ test_nvmf_tcp_pdu_ch_handle(void)
 			  struct spdk_nvme_tcp_common_pdu_hdr));
 }
 
+static void
+test_nvmf_tcp_pdu_update_data_digest(void)
+{
+	struct nvme_tcp_pdu pdu = {};
+	uint8_t data[4099];
+	uint32_t expected, offset, len, i;
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = (uint8_t)(i * 7);
+	}
+
+	/* Payload split across three buffers, length not dword aligned */
+	pdu.data_iov[0].iov_base = data;
+	pdu.data_iov[0].iov_len = 1000;
+	pdu.data_iov[1].iov_base = &data[1000];
+	pdu.data_iov[1].iov_len = 3000;
+	pdu.data_iov[2].iov_base = &data[4000];
+	pdu.data_iov[2].iov_len = 99;
+	pdu.data_iovcnt = 3;
+	pdu.data_len = sizeof(data);
+	expected = nvme_tcp_pdu_calc_data_digest(&pdu);
+
+	/* Receive the payload in uneven chunks crossing the buffer boundaries */
+	pdu.data_digest_crc32 = SPDK_CRC32C_XOR;
+	for (offset = 0; offset < pdu.data_len; offset += len) {
+		len = spdk_min(offset % 3 == 0 ? 777 : 1234, pdu.data_len - offset);
+		nvmf_tcp_pdu_update_data_digest(&pdu, offset, len);
+	}
+	CU_ASSERT(nvme_tcp_pdu_pad_data_digest(&pdu, pdu.data_digest_crc32) == expected);
+
+	/* A single read of the whole payload */
+	pdu.data_digest_crc32 = SPDK_CRC32C_XOR;
+	nvmf_tcp_pdu_update_data_digest(&pdu, 0, pdu.data_len);
+	CU_ASSERT(nvme_tcp_pdu_pad_data_digest(&pdu, pdu.data_digest_crc32) == expected);
+}
+
+static void
+test_nvmf_tcp_poll_group_detach_attach(void)
+{
+	struct spdk_nvmf_tcp_transport ttransport = {};
+	struct spdk_nvmf_tcp_poll_group tgroup1 = {}, tgroup2 = {};
+	struct spdk_nvmf_tcp_qpair tqpair = {};
+	struct nvme_tcp_pdu pdu = {};
+	int rc;
+
+	TAILQ_INIT(&tgroup1.qpairs);
+	TAILQ_INIT(&tgroup1.await_req);
+	TAILQ_INIT(&tgroup2.qpairs);
+	TAILQ_INIT(&tgroup2.await_req);
+	TAILQ_INIT(&tqpair.tcp_req_free_queue);
+	TAILQ_INIT(&tqpair.tcp_req_working_queue);
+
+	tqpair.qpair.transport = &ttransport.transport;
+	tqpair.group = &tgroup1;
+	tqpair.state = NVMF_TCP_QPAIR_STATE_RUNNING;
+	tqpair.recv_state = NVME_TCP_PDU_RECV_STATE_AWAIT_REQ;
+	tqpair.pdu_in_progress = &pdu;
+	tqpair.tcp_pdu_working_count = 1;
+	TAILQ_INSERT_TAIL(&tgroup1.await_req, &tqpair, link);
+
+	/* A quiesced qpair holds new commands instead of allocating requests */
+	nvmf_tcp_qpair_quiesce(&tqpair.qpair, true);
+	pdu.hdr.common.pdu_type = SPDK_NVME_TCP_PDU_TYPE_CAPSULE_CMD;
+	nvmf_tcp_capsule_cmd_hdr_handle(&ttransport, &tqpair, &pdu);
+	CU_ASSERT(tqpair.recv_state == NVME_TCP_PDU_RECV_STATE_AWAIT_REQ);
+	CU_ASSERT(pdu.req == NULL);
+
+	/* The qpair can't be detached while it has requests in flight */
+	tqpair.qpair.queue_depth = 1;
+	rc = nvmf_tcp_poll_group_detach(&tgroup1.group, &tqpair.qpair);
+	CU_ASSERT(rc == -EBUSY);
+	CU_ASSERT(tqpair.group == &tgroup1);
+	tqpair.qpair.queue_depth = 0;
+
+	/* Nor while a received PDU is still being processed */
+	tqpair.tcp_pdu_working_count = 2;
+	rc = nvmf_tcp_poll_group_detach(&tgroup1.group, &tqpair.qpair);
+	CU_ASSERT(rc == -EBUSY);
+	tqpair.tcp_pdu_working_count = 1;
+
+	rc = nvmf_tcp_poll_group_detach(&tgroup1.group, &tqpair.qpair);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(tqpair.group == NULL);
+	CU_ASSERT(TAILQ_EMPTY(&tgroup1.await_req));
+	CU_ASSERT(TAILQ_EMPTY(&tgroup1.qpairs));
+
+	/* The held command stays with the qpair and is waiting in the new group */
+	rc = nvmf_tcp_poll_group_attach(&tgroup2.group, &tqpair.qpair);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(tqpair.group == &tgroup2);
+	CU_ASSERT(TAILQ_FIRST(&tgroup2.await_req) == &tqpair);
+	CU_ASSERT(TAILQ_EMPTY(&tgroup2.qpairs));
+	CU_ASSERT(tqpair.pdu_in_progress == &pdu);
+
+	nvmf_tcp_qpair_quiesce(&tqpair.qpair, false);
+	CU_ASSERT(!tqpair.quiesced);
+
+	/* A qpair waiting for the next PDU goes back to the main list */
+	TAILQ_REMOVE(&tgroup2.await_req, &tqpair, link);
+	TAILQ_INSERT_TAIL(&tgroup2.qpairs, &tqpair, link);
+	tqpair.recv_state = NVME_TCP_PDU_RECV_STATE_AWAIT_PDU_READY;
+	tqpair.pdu_in_progress = NULL;
+	tqpair.tcp_pdu_working_count = 0;
+	nvmf_tcp_qpair_quiesce(&tqpair.qpair, true);
+
+	rc = nvmf_tcp_poll_group_detach(&tgroup2.group, &tqpair.qpair);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(TAILQ_EMPTY(&tgroup2.qpairs));
+
+	rc = nvmf_tcp_poll_group_attach(&tgroup1.group, &tqpair.qpair);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(TAILQ_FIRST(&tgroup1.qpairs) == &tqpair);
+	CU_ASSERT(TAILQ_EMPTY(&tgroup1.await_req));
+}
+
 static void
 test_nvmf_tcp_tls_add_remove_credentials(void)
 {
@@ -1545,6 +1668,8 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvmf_tcp_check_xfer_type);
 	CU_ADD_TEST(suite, test_nvmf_tcp_invalid_sgl);
 	CU_ADD_TEST(suite, test_nvmf_tcp_pdu_ch_handle);
+	CU_ADD_TEST(suite, test_nvmf_tcp_pdu_update_data_digest);
+	CU_ADD_TEST(suite, test_nvmf_tcp_poll_group_detach_attach);
 	CU_ADD_TEST(suite, test_nvmf_tcp_tls_add_remove_credentials);
 	CU_ADD_TEST(suite, test_nvmf_tcp_tls_generate_psk_id);
 	CU_ADD_TEST(suite, test_nvmf_tcp_tls_generate_retained_psk);
@@ -136,6 +136,80 @@ flush(void)
 	free(req2);
 }
 
+static void
+flush_batch(void)
+{
+	struct spdk_posix_sock_group_impl group = {};
+	struct spdk_posix_sock psock[2] = {};
+	struct spdk_sock_request *req[2];
+	bool cb_arg[2];
+	int i;
+
+	TAILQ_INIT(&group.socks_to_flush);
+	group.flush_batch_size = 2;
+	group.flush_batch_timeout_ticks = 10;
+
+	for (i = 0; i < 2; i++) {
+		TAILQ_INIT(&psock[i].base.queued_reqs);
+		TAILQ_INIT(&psock[i].base.pending_reqs);
+		psock[i].base.group_impl = &group.base;
+
+		req[i] = calloc(1, sizeof(struct spdk_sock_request) + sizeof(struct iovec));
+		SPDK_CU_ASSERT_FATAL(req[i] != NULL);
+		SPDK_SOCK_REQUEST_IOV(req[i], 0)->iov_base = (void *)100;
+		SPDK_SOCK_REQUEST_IOV(req[i], 0)->iov_len = 32;
+		req[i]->iovcnt = 1;
+		req[i]->cb_fn = _req_cb;
+		req[i]->cb_arg = &cb_arg[i];
+		cb_arg[i] = false;
+	}
+
+	MOCK_SET(sendmsg, 32);
+
+	/* A single socket with a queued write is held back */
+	posix_sock_writev_async(&psock[0].base, req[0]);
+	CU_ASSERT(psock[0].pending_flush);
+	CU_ASSERT(TAILQ_FIRST(&group.socks_to_flush) == &psock[0]);
+	posix_sock_group_flush(&group);
+	CU_ASSERT(cb_arg[0] == false);
+
+	/* Once the batch is full, both sockets get flushed */
+	posix_sock_writev_async(&psock[1].base, req[1]);
+	posix_sock_group_flush(&group);
+	CU_ASSERT(cb_arg[0] == true);
+	CU_ASSERT(cb_arg[1] == true);
+	CU_ASSERT(TAILQ_EMPTY(&psock[0].base.queued_reqs));
+	CU_ASSERT(TAILQ_EMPTY(&psock[1].base.queued_reqs));
+
+	/* Sockets with nothing left to send are dropped on the next pass */
+	posix_sock_group_flush(&group);
+	CU_ASSERT(TAILQ_EMPTY(&group.socks_to_flush));
+	CU_ASSERT(!psock[0].pending_flush);
+	CU_ASSERT(!psock[1].pending_flush);
+
+	/* A lone write goes out once it has waited for the timeout */
+	cb_arg[0] = false;
+	posix_sock_writev_async(&psock[0].base, req[0]);
+	spdk_delay_us(9);
+	posix_sock_group_flush(&group);
+	CU_ASSERT(cb_arg[0] == false);
+	spdk_delay_us(1);
+	posix_sock_group_flush(&group);
+	CU_ASSERT(cb_arg[0] == true);
+
+	/* Without batching, queued writes are flushed on the next poll */
+	group.flush_batch_size = 0;
+	cb_arg[1] = false;
+	posix_sock_writev_async(&psock[1].base, req[1]);
+	posix_sock_group_flush(&group);
+	CU_ASSERT(cb_arg[1] == true);
+	CU_ASSERT(!psock[0].pending_flush);
+
+	MOCK_CLEAR(sendmsg);
+	free(req[0]);
+	free(req[1]);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -147,6 +221,7 @@ main(int argc, char **argv)
 	suite = CU_add_suite("posix", NULL, NULL);
 
 	CU_ADD_TEST(suite, flush);
+	CU_ADD_TEST(suite, flush_batch);
 
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
@@ -112,6 +112,25 @@ test_crc32c(void)
 	crc = spdk_crc32c_update(buf, strlen(buf), crc);
 	crc ^= 0xFFFFFFFFu;
 	CU_ASSERT(crc == 0x6087809A);
+
+	/* Short buffers that don't start on an 8-byte boundary give the same results */
+	snprintf(buf, sizeof(buf), "%s", "x1");
+	crc = 0xFFFFFFFFu;
+	crc = spdk_crc32c_update(&buf[1], 1, crc);
+	crc ^= 0xFFFFFFFFu;
+	CU_ASSERT(crc == 0x90F599E3);
+
+	snprintf(buf, sizeof(buf), "%s", "xxxxx123");
+	crc = 0xFFFFFFFFu;
+	crc = spdk_crc32c_update(&buf[5], 3, crc);
+	crc ^= 0xFFFFFFFFu;
+	CU_ASSERT(crc == 0x107B2FB2);
+
+	snprintf(buf, sizeof(buf), "%s", "xxx12345678");
+	crc = 0xFFFFFFFFu;
+	crc = spdk_crc32c_update(&buf[3], 8, crc);
+	crc ^= 0xFFFFFFFFu;
+	CU_ASSERT(crc == 0x6087809A);
 }
 
 static void
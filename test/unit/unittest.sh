@@ -55,10 +55,14 @@ function unittest_event() {
 function unittest_ftl() {
 	$valgrind $testdir/lib/ftl/ftl_band.c/ftl_band_ut
 	$valgrind $testdir/lib/ftl/ftl_bitmap.c/ftl_bitmap_ut
+	$valgrind $testdir/lib/ftl/ftl_heat.c/ftl_heat_ut
+	$valgrind $testdir/lib/ftl/ftl_l2p_extent.c/ftl_l2p_extent_ut
 	$valgrind $testdir/lib/ftl/ftl_io.c/ftl_io_ut
 	$valgrind $testdir/lib/ftl/ftl_mngt/ftl_mngt_ut
 	$valgrind $testdir/lib/ftl/ftl_mempool.c/ftl_mempool_ut
+	$valgrind $testdir/lib/ftl/ftl_nv_cache.c/ftl_nv_cache_ut
 	$valgrind $testdir/lib/ftl/ftl_l2p/ftl_l2p_ut
+	$valgrind $testdir/lib/ftl/ftl_l2p_cache.c/ftl_l2p_cache_ut
 	$valgrind $testdir/lib/ftl/ftl_sb/ftl_sb_ut
 	$valgrind $testdir/lib/ftl/ftl_layout_upgrade/ftl_layout_upgrade_ut
 	$valgrind $testdir/lib/ftl/ftl_p2l.c/ftl_p2l_ut